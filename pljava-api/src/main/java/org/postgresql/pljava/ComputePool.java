@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+package org.postgresql.pljava;
+
+import java.sql.SQLException;
+
+import java.util.Collection;
+import java.util.List;
+
+import java.util.concurrent.Callable;
+import java.util.concurrent.Future;
+
+/**
+ * A pool of worker threads, owned by the backend, for running CPU-bound parts
+ * of a PL/Java function in parallel.
+ *<p>
+ * Obtain the pool from the {@link Session} by calling
+ * {@link Session#getComputePool getComputePool}. The number of worker threads
+ * is fixed for the session by the setting {@code pljava.compute_pool_size};
+ * when that is zero (the default), submitted tasks simply run on the calling
+ * thread when submitted.
+ *<p>
+ * Tasks run on the worker threads may not call into PostgreSQL, directly or
+ * indirectly (for example, through JDBC); an attempt to do so will incur an
+ * {@code IllegalStateException}. Tasks should compute with Java data only,
+ * and leave their results to be collected and used by the thread that
+ * submitted them.
+ *<p>
+ * A task does not outlive the PL/Java function invocation that submitted it.
+ * When that invocation returns, normally or with an error, any of its tasks
+ * not yet finished are cancelled, and their threads interrupted. Waiting for
+ * a result with {@link #await await} or {@link #invokeAll invokeAll} also
+ * responds to a query cancel request, cancelling outstanding tasks and throwing
+ * an exception with SQLSTATE {@code 57014}.
+ */
+public interface ComputePool
+{
+	/**
+	 * The number of worker threads in the pool, which may be zero.
+	 */
+	int parallelism();
+
+	/**
+	 * Submit a task to be run on a worker thread.
+	 *<p>
+	 * The task will run with the access control context and context class
+	 * loader of the caller. Only the thread that may call into PostgreSQL may
+	 * submit tasks.
+	 * @param task The computation to run.
+	 * @return A {@code Future} from which the result can be obtained,
+	 * preferably by passing it to {@link #await await}.
+	 */
+	<T> Future<T> submit(Callable<T> task) throws SQLException;
+
+	/**
+	 * Wait for the result of a submitted task, responding to any query cancel
+	 * request that arrives in the meantime.
+	 * @param future A {@code Future} returned by {@link #submit submit}.
+	 * @return The task's result.
+	 * @throws SQLException If the task threw an exception (which will be the
+	 * exception thrown, if it was an {@code SQLException}, or the cause of the
+	 * one thrown, otherwise), or if the wait was cancelled.
+	 */
+	<T> T await(Future<T> future) throws SQLException;
+
+	/**
+	 * Submit all of the given tasks and wait for all of their results.
+	 *<p>
+	 * If any task fails, or the wait is cancelled, the remaining tasks are
+	 * cancelled and the exception is thrown as described for
+	 * {@link #await await}.
+	 * @param tasks The computations to run.
+	 * @return The results, in the iteration order of {@code tasks}.
+	 */
+	<T> List<T> invokeAll(Collection<? extends Callable<T>> tasks)
+	throws SQLException;
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+package org.postgresql.pljava;
+
+import java.sql.SQLException;
+import java.sql.SQLFeatureNotSupportedException;
+
+import java.util.List;
+
+/**
+ * A foreign data wrapper implemented in Java, making some external source of
+ * rows queryable as a PostgreSQL foreign table.
+ *<p>
+ * A wrapper is declared (by a superuser) using PL/Java's handler and validator
+ * functions, and naming the implementing class and the schema whose class path
+ * it is to be loaded from:
+ *<pre>
+ * CREATE FOREIGN DATA WRAPPER csv_files
+ *   HANDLER sqlj.java_fdw_handler VALIDATOR sqlj.java_fdw_validator
+ *   OPTIONS (class 'com.example.CsvWrapper', schema 'public');
+ *</pre>
+ * The {@code class} and {@code schema} options may only be given for the
+ * wrapper itself. A {@code batch_size} option (default 100), which may be
+ * given at any level, sets how many rows {@link Scan#next Scan.next} is asked
+ * to supply at a time. All other options given for the wrapper, the server,
+ * and the foreign table are merged, in that order (so a table option overrides
+ * a server option of the same name), and passed to the implementing class's
+ * public constructor, which must accept a single
+ * {@code Map<String,String>}. An instance is constructed for each planning or
+ * execution of a scan.
+ *<p>
+ * Because only a superuser can choose the class, its code runs with the
+ * permissions the policy grants to functions in an untrusted language, under
+ * a {@link PLPrincipal.Unsandboxed PLPrincipal.Unsandboxed} named
+ * {@code java_fdw}.
+ *<p>
+ * Conditions from the query of the form <em>column</em> <em>operator</em>
+ * <em>constant</em> are passed to the wrapper as {@link Qual Qual}s, so that it
+ * may use them to estimate the number of rows, and to skip rows that cannot
+ * match. PostgreSQL still checks every condition against each row returned,
+ * so a wrapper is free to ignore any or all of them.
+ */
+public interface ForeignDataWrapper
+{
+	/**
+	 * Return an estimate of the number of rows a scan with the given
+	 * conditions will return, for use by the planner.
+	 *<p>
+	 * The default implementation returns 1000, with no regard to the
+	 * conditions.
+	 * @param quals Conditions from the query that the rows must satisfy.
+	 */
+	default double estimateRows(List<Qual> quals) throws SQLException
+	{
+		return 1000;
+	}
+
+	/**
+	 * Begin a scan.
+	 * @param columns Names of the columns the query uses, in the order their
+	 * values are to be supplied in each row. Other columns will be null. The
+	 * list may be empty, as for {@code SELECT count(*)}, in which case only the
+	 * number of rows matters.
+	 * @param quals Conditions from the query that the rows must satisfy.
+	 * @return A {@code Scan} that will supply the rows.
+	 */
+	Scan beginScan(List<String> columns, List<Qual> quals)
+	throws SQLException;
+
+	/**
+	 * A condition <em>column</em> <em>operator</em> <em>value</em> from
+	 * a query's {@code WHERE} clause.
+	 */
+	interface Qual
+	{
+		/**
+		 * Name of the column the condition tests.
+		 */
+		String column();
+
+		/**
+		 * Name of the operator, such as {@code =} or {@code <}.
+		 */
+		String operator();
+
+		/**
+		 * The value compared to, as the Java type PL/Java maps the constant's
+		 * SQL type to; never null.
+		 */
+		Object value();
+	}
+
+	/**
+	 * A scan in progress, supplying rows in batches.
+	 */
+	interface Scan extends AutoCloseable
+	{
+		/**
+		 * Supply the next rows of the scan.
+		 *<p>
+		 * Each row is stored in {@code batch} as an {@code Object[]} with a
+		 * value (or null) for each of the {@code columns} passed to
+		 * {@link ForeignDataWrapper#beginScan beginScan}, in that order, and of
+		 * the Java type PL/Java maps that column's SQL type to. The row arrays
+		 * may be reused from one call to the next.
+		 * @param batch Array to fill, starting at index zero.
+		 * @return The number of rows stored; zero only when the scan is
+		 * complete.
+		 */
+		int next(Object[][] batch) throws SQLException;
+
+		/**
+		 * Restart the scan from the beginning.
+		 *<p>
+		 * The default implementation throws
+		 * {@code SQLFeatureNotSupportedException}.
+		 */
+		default void rescan() throws SQLException
+		{
+			throw new SQLFeatureNotSupportedException(
+				"this foreign table scan cannot be restarted", "0A000");
+		}
+
+		/**
+		 * End the scan, releasing any resources it holds.
+		 *<p>
+		 * This is not called if the query fails before the scan completes, so
+		 * a scan should not hold anything that would not be released by
+		 * becoming unreachable.
+		 */
+		@Override
+		void close() throws SQLException;
+	}
+}
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+package org.postgresql.pljava;
+
+import java.sql.SQLException;
+
+/**
+ * The Java types of the {@code internal} arguments in the protocol of GiST
+ * index support functions, so that an operator class for a type (a Java
+ * user-defined type, or any other) can have its support functions in Java.
+ *<p>
+ * A support function is an ordinary PL/Java function whose parameters (and,
+ * where the protocol returns {@code internal}, return type) are of the types
+ * nested here, in the positions the protocol gives them. The annotation
+ * processor maps each of these to SQL {@code internal}. Declared with these
+ * Java methods, where {@code K} is the Java type of the storage type (the
+ * operator class's {@code STORAGE}, or the indexed type if it has none) and
+ * {@code Q} the Java type of the query argument of an operator:
+ *<table>
+ *<caption>GiST support functions</caption>
+ *<tr><th>Number</th><th>Function</th><th>Java method</th></tr>
+ *<tr><td>1</td><td>consistent</td><td>{@code boolean consistent(Entry e,
+ * Q query, short strategy, @SQLType("oid") int subtype, Recheck recheck)}
+ *</td></tr>
+ *<tr><td>2</td><td>union</td><td>{@code K union(EntryVector entries,
+ * UnionSize size)}</td></tr>
+ *<tr><td>3</td><td>compress</td><td>{@code Entry compress(Entry e)}</td></tr>
+ *<tr><td>4</td><td>decompress</td><td>{@code Entry decompress(Entry e)}
+ *</td></tr>
+ *<tr><td>5</td><td>penalty</td><td>{@code Penalty penalty(Entry original,
+ * Entry added, Penalty penalty)}</td></tr>
+ *<tr><td>6</td><td>picksplit</td><td>{@code Split picksplit(
+ * EntryVector entries, Split split)}</td></tr>
+ *<tr><td>7</td><td>same</td><td>{@code Same same(K a, K b, Same result)}
+ *</td></tr>
+ *<tr><td>8</td><td>distance</td><td>{@code double distance(Entry e,
+ * Q query, short strategy, @SQLType("oid") int subtype, Recheck recheck)}
+ *</td></tr>
+ *<tr><td>9</td><td>fetch</td><td>{@code Entry fetch(Entry e)}</td></tr>
+ *</table>
+ * As in C, a function that stores its result through an {@code internal}
+ * argument returns that argument, and an entry returned from compress,
+ * decompress, or fetch can be the one passed in, if its key needs no change.
+ * The functions are named in the {@code FUNCTION} clauses of a
+ * {@code CREATE OPERATOR CLASS ... USING gist}, which can be given in an
+ * {@code @SQLAction}.
+ *<p>
+ * A key is passed to and from Java as the type PL/Java maps its SQL type to.
+ * Its SQL type is known from the index column, so a support function can
+ * serve only an operator class whose storage type (and, for compress and
+ * fetch, indexed type) is the one it was written for. With a distance function
+ * and ordering operators, the operator class supports nearest-neighbor
+ * ({@code ORDER BY column <-> value}) index scans.
+ *<p>
+ * The objects passed to a support function can only be used during that call.
+ */
+public final class GiST
+{
+	private GiST() { } // do not instantiate
+
+	/**
+	 * A {@code GISTENTRY}: one key, on an index page or being prepared for one.
+	 */
+	public interface Entry
+	{
+		/**
+		 * Whether the key is a leaf key; in compress, whether it is a value of
+		 * the indexed type still to be compressed.
+		 */
+		boolean isLeaf();
+
+		/**
+		 * The key: in compress, of the indexed type for a leaf key, otherwise
+		 * of the storage type.
+		 */
+		Object key() throws SQLException;
+
+		/**
+		 * A new entry for the same index position with the given key, of the
+		 * storage type (of the indexed type, in fetch), to return from
+		 * compress, decompress, or fetch.
+		 */
+		Entry withKey(Object key) throws SQLException;
+	}
+
+	/**
+	 * A {@code GistEntryVector}: the entries to be united by union, or split
+	 * by picksplit, numbered from zero in either case.
+	 */
+	public interface EntryVector
+	{
+		/**
+		 * The number of entries.
+		 */
+		int size();
+
+		/**
+		 * The entry at an index from zero to {@code size() - 1}.
+		 */
+		Entry get(int index) throws SQLException;
+
+		/**
+		 * The keys of all the entries, converted in one call into the
+		 * backend.
+		 */
+		Object[] keys() throws SQLException;
+	}
+
+	/**
+	 * A {@code GIST_SPLITVEC}, to be filled in by picksplit.
+	 */
+	public interface Split
+	{
+		/**
+		 * Divide the entries between the left and right pages, each index of
+		 * the {@code EntryVector} appearing on exactly one side, and give the
+		 * union key of each side.
+		 */
+		void set(int[] left, Object leftUnion, int[] right, Object rightUnion)
+		throws SQLException;
+	}
+
+	/**
+	 * Where consistent or distance says whether the result must be rechecked
+	 * against the heap row; it starts {@code true} in consistent and
+	 * {@code false} in distance.
+	 */
+	public interface Recheck
+	{
+		void set(boolean recheck) throws SQLException;
+	}
+
+	/**
+	 * Where penalty stores the cost of adding an entry under another.
+	 */
+	public interface Penalty
+	{
+		void set(float penalty) throws SQLException;
+	}
+
+	/**
+	 * Where same stores whether two keys are equal.
+	 */
+	public interface Same
+	{
+		void set(boolean same) throws SQLException;
+	}
+
+	/**
+	 * Where union may store the size of its result; PostgreSQL does not rely
+	 * on it, and a union function need not set it.
+	 */
+	public interface UnionSize
+	{
+		void set(int size) throws SQLException;
+	}
+}
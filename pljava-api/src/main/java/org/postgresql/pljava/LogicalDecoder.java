@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+package org.postgresql.pljava;
+
+import java.sql.ResultSet;
+import java.sql.SQLException;
+
+import java.util.List;
+
+/**
+ * A logical decoding output plugin implemented in Java, turning the changes
+ * of committed transactions into text.
+ *<p>
+ * PL/Java's shared library is itself the output plugin, so a slot is created
+ * naming the library as its plugin (as found, for example, in the declaration
+ * of PL/Java's call handler), and the implementing class and the schema whose
+ * class path it is to be loaded from are given as options when changes are
+ * read:
+ *<pre>
+ * SELECT pg_create_logical_replication_slot('cdc', probin)
+ *   FROM pg_proc WHERE oid = 'sqlj.java_call_handler()'::regprocedure;
+ *
+ * SELECT data FROM pg_logical_slot_get_changes('cdc', NULL, NULL,
+ *   'class', 'com.example.ChangesAsJson', 'schema', 'public');
+ *</pre>
+ * A {@code batch_size} option (default 100) sets how many changes are
+ * collected before being passed together to {@link #changes changes}; all the
+ * changes of a transaction are delivered, in order, between its
+ * {@link #begin begin} and {@link #commit commit}. All other options are
+ * passed to the implementing class's public constructor, which must accept
+ * a single {@code Map<String,String>}. An instance is constructed each time
+ * decoding starts, and {@link #close close}d when it ends normally.
+ *<p>
+ * Decoding runs under a historic snapshot, in which only the system catalogs
+ * (and tables marked {@code user_catalog_table}) can be read. Any classes the
+ * plugin will need should be loaded by its constructor, which runs before
+ * decoding starts. The plugin's code runs with the permissions the policy
+ * grants to functions in a trusted language, under a
+ * {@link PLPrincipal.Sandboxed PLPrincipal.Sandboxed} named
+ * {@code java_decoding}.
+ *<p>
+ * The output is meant to be read through the SQL functions such as
+ * {@code pg_logical_slot_get_changes}, each string written becoming one row
+ * of their result.
+ */
+public interface LogicalDecoder extends AutoCloseable
+{
+	/**
+	 * Called at the start of each committed transaction.
+	 *<p>
+	 * The default implementation writes nothing.
+	 * @param xid The transaction ID.
+	 * @param out Where to write any output.
+	 */
+	default void begin(long xid, Output out) throws SQLException
+	{
+	}
+
+	/**
+	 * Called with the next changes of the transaction, in order.
+	 * @param xid The transaction ID.
+	 * @param changes The changes; valid only until this method returns.
+	 * @param out Where to write any output.
+	 */
+	void changes(long xid, List<Change> changes, Output out)
+	throws SQLException;
+
+	/**
+	 * Called at the end of each committed transaction, after all of its
+	 * changes.
+	 *<p>
+	 * The default implementation writes nothing.
+	 * @param xid The transaction ID.
+	 * @param commitLSN The log sequence number of the commit record.
+	 * @param out Where to write any output.
+	 */
+	default void commit(long xid, long commitLSN, Output out)
+	throws SQLException
+	{
+	}
+
+	/**
+	 * Called when decoding ends normally.
+	 *<p>
+	 * The default implementation does nothing.
+	 */
+	@Override
+	default void close() throws SQLException
+	{
+	}
+
+	/**
+	 * The kinds of change delivered.
+	 */
+	enum Kind { INSERT, UPDATE, DELETE }
+
+	/**
+	 * One row inserted, updated, or deleted.
+	 */
+	interface Change
+	{
+		Kind kind();
+
+		/**
+		 * Name of the schema of the changed table.
+		 */
+		String schema();
+
+		/**
+		 * Name of the changed table.
+		 */
+		String table();
+
+		/**
+		 * The old row, as a read-only {@code ResultSet} positioned on it, or
+		 * null.
+		 *<p>
+		 * There is no old row for an {@code INSERT}. For an {@code UPDATE}
+		 * or {@code DELETE}, what is available depends on the table's
+		 * {@code REPLICA IDENTITY}: by default only the primary key columns,
+		 * and for an {@code UPDATE}, only if they changed.
+		 */
+		ResultSet oldRow() throws SQLException;
+
+		/**
+		 * The new row, as a read-only {@code ResultSet} positioned on it, or
+		 * null for a {@code DELETE}.
+		 */
+		ResultSet newRow() throws SQLException;
+	}
+
+	/**
+	 * Destination for a plugin's output.
+	 */
+	interface Output
+	{
+		/**
+		 * Write one unit of output, which will be one row in the result of
+		 * {@code pg_logical_slot_get_changes} and similar functions.
+		 */
+		void write(CharSequence data);
+	}
+}
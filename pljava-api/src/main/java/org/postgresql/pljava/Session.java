@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2022 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -81,6 +81,15 @@ public interface Session
 	 */
 	<T extends PooledObject> ObjectPool<T> getObjectPool(Class<T> cls);
 
+	/**
+	 * Return the backend's pool of worker threads for parallel computation.
+	 *<p>
+	 * The pool is created on first use, with the number of threads given by
+	 * the setting {@code pljava.compute_pool_size} at that time.
+	 * @return The session's compute pool.
+	 */
+	ComputePool getComputePool() throws SQLException;
+
 	/**
 	 * Return the current <em>effective</em> database user name.
 	 *<p>
@@ -185,6 +194,22 @@ public interface Session
 	 */
 	void removeTransactionListener(TransactionListener listener);
 
+	/**
+	 * Show the progress of the calling function to monitoring, as
+	 * {@code done} units of work out of {@code total}.
+	 *<p>
+	 * The figures can be seen, by roles allowed to see this session's
+	 * statistics, in the {@code sqlj.pljava_stat_progress} view, with the
+	 * function and the process id, until the function returns. They can be
+	 * updated as often as convenient; each update is cheap. If the progress of
+	 * a command that called the function is already being shown, such as a
+	 * {@code CREATE INDEX}, or of a PL/Java function that called this one,
+	 * the report is ignored. Progress is not reported before PostgreSQL 14.
+	 * @param done The units of work completed so far.
+	 * @param total The units of work expected in all, or zero if not known.
+	 */
+	void reportProgress(long done, long total) throws SQLException;
+
 	/**
 	 * Set an attribute to a value in the current session.
 	 *
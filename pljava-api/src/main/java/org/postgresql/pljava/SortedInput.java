@@ -0,0 +1,135 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+package org.postgresql.pljava;
+
+import java.sql.SQLException;
+
+import java.util.Iterator;
+import java.util.PrimitiveIterator;
+
+/**
+ * The sorted rows of one group of an ordered-set or hypothetical-set
+ * aggregate, passed to a finisher written in Java.
+ *<p>
+ * PostgreSQL does the sorting, spilling to disk if the rows will not fit in
+ * {@code work_mem}, and the rows are read back in batches, so a finisher that
+ * needs only a few of them, such as a percentile, runs in constant Java heap
+ * however large the group. The aggregate uses PL/Java's transition function,
+ * and its state type is {@code internal}, which is the SQL type of a
+ * {@code SortedInput} parameter:
+ *<pre>
+ * &#64;Aggregate(name = "median",
+ *     directArguments = {}, arguments = "value float8")
+ * &#64;Function
+ * public static Double median(SortedInput in) throws SQLException
+ * {
+ *     long n = in.size();
+ *     if ( 0 == n )
+ *         return null;
+ *     in.skip((n - 1) / 2);
+ *     PrimitiveIterator.OfDouble it = in.doubles();
+ *     double lo = it.nextDouble();
+ *     return 0 == n % 2 ? (lo + it.nextDouble()) / 2 : lo;
+ * }
+ *</pre>
+ * With {@code directArguments} given and no {@code accumulate} function
+ * named, the annotation processor supplies PL/Java's transition function,
+ * {@code sqlj.java_ordered_set_transition} (or, for {@code VARIADIC "any"}
+ * aggregated arguments, {@code sqlj.java_ordered_set_transition_multi}).
+ *<p>
+ * With one aggregated argument, rows where it is null are left out, as they
+ * are by PostgreSQL's own percentile and mode aggregates; with more than one,
+ * or in a hypothetical-set aggregate, all rows are kept. In a hypothetical-set
+ * aggregate, the row given by the trailing direct arguments is sorted with the
+ * others, ahead of any it compares equal to, and its position can be learned
+ * from {@link #hypotheticalPosition hypotheticalPosition}.
+ *<p>
+ * All of the reading methods, and the iterators, consume the same single pass
+ * over the rows; an iterator may read a batch ahead of what it has returned.
+ * A {@code SortedInput} can only be used during the finisher call it was
+ * passed to.
+ */
+public interface SortedInput
+{
+	/**
+	 * The number of rows, counting the hypothetical row of a hypothetical-set
+	 * aggregate.
+	 */
+	long size();
+
+	/**
+	 * Skip up to {@code n} rows.
+	 * @return the number of rows skipped, less than {@code n} only at the end
+	 */
+	long skip(long n) throws SQLException;
+
+	/**
+	 * Read the next rows of a single aggregated column of a numeric type as
+	 * {@code double} values, a null as {@code NaN}.
+	 * @return the number of values stored in {@code into}, starting at index
+	 * zero; zero only at the end
+	 */
+	int read(double[] into) throws SQLException;
+
+	/**
+	 * Read the next rows of a single aggregated column of type
+	 * {@code smallint}, {@code integer}, or {@code bigint} as {@code long}
+	 * values; a null is an error.
+	 * @return the number of values stored in {@code into}, starting at index
+	 * zero; zero only at the end
+	 */
+	int read(long[] into) throws SQLException;
+
+	/**
+	 * Read the next rows as objects of the Java types PL/Java maps their SQL
+	 * types to: for a single aggregated column, each value itself, otherwise an
+	 * {@code Object[]} of the column values.
+	 * @return the number of rows stored in {@code into}, starting at index
+	 * zero; zero only at the end
+	 */
+	int read(Object[] into) throws SQLException;
+
+	/**
+	 * An iterator over the remaining rows as by {@link #read(double[])}.
+	 *<p>
+	 * An {@code SQLException} from reading is thrown as the cause of an
+	 * {@code IllegalStateException}.
+	 */
+	PrimitiveIterator.OfDouble doubles();
+
+	/**
+	 * An iterator over the remaining rows as by {@link #read(long[])}.
+	 *<p>
+	 * An {@code SQLException} from reading is thrown as the cause of an
+	 * {@code IllegalStateException}.
+	 */
+	PrimitiveIterator.OfLong longs();
+
+	/**
+	 * An iterator over the remaining rows as by {@link #read(Object[])}.
+	 *<p>
+	 * An {@code SQLException} from reading is thrown as the cause of an
+	 * {@code IllegalStateException}.
+	 */
+	Iterator<Object> objects();
+
+	/**
+	 * In a hypothetical-set aggregate, the zero-based position of the
+	 * hypothetical row among all the rows, once it has been read or skipped;
+	 * until then, and in any other aggregate, -1.
+	 *<p>
+	 * Because the hypothetical row sorts ahead of its peers, its position is
+	 * the number of rows that sort before it; for the {@code rank} of the
+	 * hypothetical row, skip until this is not -1, and add one.
+	 */
+	long hypotheticalPosition() throws SQLException;
+}
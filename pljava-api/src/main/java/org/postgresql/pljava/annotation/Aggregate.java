@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2020-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -70,14 +70,12 @@ import java.lang.annotation.Target;
  * if necessary, can be explicitly arranged with {@code provides} and
  * {@code requires}.
  *<p>
- * While this annotation can generate {@code CREATE AGGREGATE} deployment
- * commands with the features available in PostgreSQL,
- * at present there are limits to which aggregate features can be implemented
- * purely in PL/Java. In particular, PL/Java functions currently have no access
- * to the PostgreSQL data structures needed for an ordered-set or
- * hypothetical-set aggregate. Such an aggregate could be implemented by writing
- * some of its support functions in another procedural language; this annotation
- * could still be used to automatically generate the declaration.
+ * An ordered-set or hypothetical-set aggregate can have its {@code finish}
+ * function in PL/Java by taking an {@link org.postgresql.pljava.SortedInput
+ * SortedInput} as the state, which PostgreSQL sorts for it. When this
+ * annotation is on such a method and names no {@code accumulate} function,
+ * PL/Java's own transition function is used, with state type
+ * {@code internal}.
  * @author Chapman Flack
  */
 @Documented
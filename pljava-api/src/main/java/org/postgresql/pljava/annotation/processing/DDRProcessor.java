@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2022 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -111,8 +111,10 @@ import static javax.lang.model.util.ElementFilter.methodsIn;
 
 import static javax.tools.Diagnostic.Kind;
 
+import org.postgresql.pljava.GiST;
 import org.postgresql.pljava.ResultSetHandle;
 import org.postgresql.pljava.ResultSetProvider;
+import org.postgresql.pljava.SortedInput;
 import org.postgresql.pljava.TriggerData;
 
 import org.postgresql.pljava.annotation.Aggregate;
@@ -4712,6 +4714,32 @@ hunt:	for ( ExecutableElement ee : ees )
 			{
 				Identifier.Qualified<Identifier.Simple> funcName =
 					qnameFrom(func.name(), func.schema());
+
+				/*
+				 * An ordered-set aggregate on a finisher taking SortedInput
+				 * (so, internal) needs no accumulator of its own; PL/Java's
+				 * transition function sorts the rows.
+				 */
+				if ( orderedSet  &&  null == _plan.accumulate
+					&& null != aggregateArgs
+					&& 0 < func.parameterTypes.length
+					&& DT_INTERNAL.equals(func.parameterTypes[0]) )
+				{
+					if ( _variadic[AGG_ARGS] )
+						_plan.accumulate = qnameFrom(
+							"java_ordered_set_transition_multi", "sqlj");
+					else if ( aggregateArgs.size() <= 4 )
+						_plan.accumulate = qnameFrom(
+							"java_ordered_set_transition", "sqlj");
+					else
+					{
+						msg(Kind.ERROR, m_targetElement, m_origin,
+							"PL/Java's ordered-set transition function takes " +
+							"at most four aggregated arguments, unless they " +
+							"are VARIADIC \"any\"");
+						ok = false;
+					}
+				}
 				boolean inferAccumulator =
 					null == _plan.accumulate  ||  null == aggregateArgs;
 				boolean inferFinisher =
@@ -5514,6 +5542,14 @@ hunt:	for ( ExecutableElement ee : ees )
 			this.addMap(BigInteger.class, "pg_catalog", "numeric");
 			this.addMap(BigDecimal.class, "pg_catalog", "numeric");
 			this.addMap(ResultSet.class, DT_RECORD);
+			this.addMap(SortedInput.class, DT_INTERNAL);
+			this.addMap(GiST.Entry.class, DT_INTERNAL);
+			this.addMap(GiST.EntryVector.class, DT_INTERNAL);
+			this.addMap(GiST.Split.class, DT_INTERNAL);
+			this.addMap(GiST.Recheck.class, DT_INTERNAL);
+			this.addMap(GiST.Penalty.class, DT_INTERNAL);
+			this.addMap(GiST.Same.class, DT_INTERNAL);
+			this.addMap(GiST.UnionSize.class, DT_INTERNAL);
 			this.addMap(Object.class, DT_ANY);
 
 			this.addMap(byte[].class, DT_BYTEA);
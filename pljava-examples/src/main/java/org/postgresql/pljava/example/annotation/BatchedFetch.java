@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+package org.postgresql.pljava.example.annotation;
+
+import java.sql.Connection;
+import java.sql.DriverManager;
+import java.sql.PreparedStatement;
+import java.sql.ResultSet;
+import java.sql.SQLException;
+import java.sql.Statement;
+
+import org.postgresql.pljava.annotation.Function;
+import org.postgresql.pljava.annotation.SQLAction;
+
+/**
+ * Test that a {@code ResultSet} reads the same rows however they are fetched
+ * in batches: by a fetch size that does not divide the number of rows, by one
+ * larger than it, and all at once with a fetch size of zero, with each batch
+ * converted at once and, with {@code pljava.lazy_row_conversion} on, row by
+ * row; and that a {@code PreparedStatement} does so when its fetch size is
+ * changed between executions.
+ *<p>
+ * The query's rows include nulls and strings of varying length, so both
+ * conversion paths see each kind of value.
+ */
+@SQLAction(requires = "batched_fetch fn", install = {
+	"SELECT" +
+	"  CASE WHEN" +
+	"   9550 = javatest.batched_fetch(7)" +
+	"  AND" +
+	"   9550 = javatest.batched_fetch(1000)" +
+	"  AND" +
+	"   9550 = javatest.batched_fetch(0)" +
+	"  AND" +
+	"   '9550,9550,9550' = javatest.batched_fetch_prepared()" +
+	"  THEN javatest.logmessage('INFO', 'BatchedFetch eager ok')" +
+	"  ELSE javatest.logmessage('WARNING', 'BatchedFetch eager ng')" +
+	"  END",
+
+	"SELECT set_config('pljava.lazy_row_conversion', 'on', true)",
+
+	"SELECT" +
+	"  CASE WHEN" +
+	"   9550 = javatest.batched_fetch(7)" +
+	"  AND" +
+	"   9550 = javatest.batched_fetch(1000)" +
+	"  AND" +
+	"   9550 = javatest.batched_fetch(0)" +
+	"  AND" +
+	"   '9550,9550,9550' = javatest.batched_fetch_prepared()" +
+	"  THEN javatest.logmessage('INFO', 'BatchedFetch lazy ok')" +
+	"  ELSE javatest.logmessage('WARNING', 'BatchedFetch lazy ng')" +
+	"  END",
+
+	"SELECT set_config('pljava.lazy_row_conversion', 'off', true)"
+})
+public class BatchedFetch
+{
+	private BatchedFetch() { }
+
+	/**
+	 * Read a query of 100 rows with the given fetch size, returning the sum of
+	 * its non-null integers (4500) and the lengths of its strings (5050).
+	 */
+	@Function(schema = "javatest", name = "batched_fetch",
+		provides = "batched_fetch fn")
+	public static long batchedFetch(int fetchSize) throws SQLException
+	{
+		Connection c = DriverManager.getConnection("jdbc:default:connection");
+		try ( Statement s = c.createStatement() )
+		{
+			s.setFetchSize(fetchSize);
+			try ( ResultSet rs = s.executeQuery(QUERY) )
+			{
+				return sum(rs);
+			}
+		}
+	}
+
+	/**
+	 * Execute one {@code PreparedStatement} for the same query with fetch
+	 * sizes 7, 0, and 7 again, returning the three sums separated by commas.
+	 */
+	@Function(schema = "javatest", name = "batched_fetch_prepared",
+		provides = "batched_fetch fn")
+	public static String batchedFetchPrepared() throws SQLException
+	{
+		Connection c = DriverManager.getConnection("jdbc:default:connection");
+		StringBuilder sb = new StringBuilder();
+		try ( PreparedStatement ps = c.prepareStatement(QUERY) )
+		{
+			for ( int fetchSize : new int[] { 7, 0, 7 } )
+			{
+				ps.setFetchSize(fetchSize);
+				try ( ResultSet rs = ps.executeQuery() )
+				{
+					if ( 0 < sb.length() )
+						sb.append(',');
+					sb.append(sum(rs));
+				}
+			}
+		}
+		return sb.toString();
+	}
+
+	private static final String QUERY =
+		"SELECT CASE WHEN x % 10 <> 0 THEN x END, repeat('x', x)" +
+		" FROM generate_series(1, 100) AS x";
+
+	private static long sum(ResultSet rs) throws SQLException
+	{
+		long sum = 0;
+		while ( rs.next() )
+		{
+			int v = rs.getInt(1);
+			if ( ! rs.wasNull() )
+				sum += v;
+			sum += rs.getString(2).length();
+		}
+		return sum;
+	}
+}
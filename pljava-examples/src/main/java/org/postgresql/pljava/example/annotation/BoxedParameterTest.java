@@ -0,0 +1,92 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+package org.postgresql.pljava.example.annotation;
+
+import org.postgresql.pljava.annotation.Function;
+import org.postgresql.pljava.annotation.SQLAction;
+import org.postgresql.pljava.annotation.SQLType;
+
+/**
+ * Test that parameters declared with boxed primitive types, which are passed
+ * unboxed with a bitmap of the nulls, arrive with their values and nulls in
+ * the right places, among parameters of other kinds, and past the first eight
+ * parameters; and do so when the SQL type is given explicitly, including one
+ * that must be coerced to the boxed type's own.
+ */
+@SQLAction(requires = "boxed_params fns", install = {
+	"SELECT" +
+	"  CASE WHEN" +
+	"   javatest.boxed_params(true, '1', 2, 3, 0.5, 0.25, 'a', 4," +
+	"    5, 6, 0.125, false)" +
+	"   = 'true,1,2,3,0.5,0.25,a,4,5,6,0.125,false'" +
+	"   AND javatest.boxed_params(NULL, NULL, NULL, NULL, NULL, NULL," +
+	"    NULL, 7, NULL, NULL, NULL, NULL)" +
+	"   = 'null,null,null,null,null,null,null,7,null,null,null,null'" +
+	"   AND javatest.boxed_params(NULL, '-32768', NULL, 9223372036854775807," +
+	"    NULL, -1e300, 'b', -1, NULL, '-9223372036854775808', 1e-300, NULL)" +
+	"   = 'null,-32768,null,9223372036854775807,null,-1.0E300,b,-1," +
+	"null,-9223372036854775808,1.0E-300,null'" +
+	"   AND javatest.boxed_params(false, NULL, 2147483647, NULL, -2.5, NULL," +
+	"    NULL, 0, '-2147483648', NULL, NULL, true)" +
+	"   = 'false,null,2147483647,null,-2.5,null,null,0,-2147483648," +
+	"null,null,true'" +
+	"  THEN javatest.logmessage('INFO', 'boxed parameters ok')" +
+	"  ELSE javatest.logmessage('WARNING', 'boxed parameters ng')" +
+	"  END",
+
+	"SELECT" +
+	"  CASE WHEN" +
+	"   javatest.boxed_params_typed(42.4, 'a', 2.5, 'A', '-5')" +
+	"   = '42,a,2.5,65,-5'" +
+	"   AND javatest.boxed_params_typed(NULL, NULL, NULL, NULL, NULL)" +
+	"   = 'null,null,null,null,null'" +
+	"   AND javatest.boxed_params_typed(-7, NULL, NULL, 'z', NULL)" +
+	"   = '-7,null,null,122,null'" +
+	"   AND javatest.boxed_params_typed(NULL, 'b', -0.125, NULL, '32767')" +
+	"   = 'null,b,-0.125,null,32767'" +
+	"  THEN javatest.logmessage('INFO', 'typed boxed parameters ok')" +
+	"  ELSE javatest.logmessage('WARNING', 'typed boxed parameters ng')" +
+	"  END"
+})
+public class BoxedParameterTest
+{
+	private BoxedParameterTest() { }
+
+	/**
+	 * Return the parameters, as Java shows them, separated by commas.
+	 */
+	@Function(schema = "javatest", name = "boxed_params",
+		provides = "boxed_params fns")
+	public static String boxedParams(
+		Boolean b, Short s, Integer i, Long l, Float f, Double d, String t,
+		int p, Integer i2, Long l2, Double d2, Boolean b2)
+	{
+		return b + "," + s + "," + i + "," + l + "," + f + "," + d + "," + t
+			+ "," + p + "," + i2 + "," + l2 + "," + d2 + "," + b2;
+	}
+
+	/**
+	 * Return the parameters, as Java shows them, separated by commas, where
+	 * the SQL types are given explicitly: {@code numeric} for {@code i} and
+	 * {@code d}, coerced to {@code int4} and {@code float8}, and
+	 * {@code smallint} for {@code s}, coerced to {@code int4}.
+	 */
+	@Function(schema = "javatest", name = "boxed_params_typed",
+		provides = "boxed_params fns")
+	public static String boxedParamsTyped(
+		@SQLType("pg_catalog.numeric") Integer i, String t,
+		@SQLType("pg_catalog.numeric") Double d, @SQLType("\"char\"") Byte b,
+		@SQLType("pg_catalog.int2") Integer s)
+	{
+		return i + "," + t + "," + d + "," + b + "," + s;
+	}
+}
@@ -0,0 +1,117 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+package org.postgresql.pljava.example.annotation;
+
+import java.sql.Connection;
+import java.sql.DriverManager;
+import java.sql.PreparedStatement;
+import java.sql.ResultSet;
+import java.sql.SQLException;
+
+import org.postgresql.pljava.annotation.Function;
+import org.postgresql.pljava.annotation.SQLAction;
+
+/**
+ * Test that a call going over {@code pljava.cpu_budget} fails with SQLSTATE
+ * {@code 57014}, at its next query rather than only when it returns, and
+ * that one going over {@code pljava.allocation_budget} fails with
+ * {@code 54000}.
+ *<p>
+ * The budgets may only be set by a superuser, so the test is skipped when the
+ * jar is deployed by another role.
+ */
+@SQLAction(requires = "budget fns", install =
+	"DO LANGUAGE plpgsql '" +
+	"DECLARE" +
+	" cpu text := ''ng'';" +
+	" alloc text := ''ng'';" +
+	"BEGIN" +
+	" IF NOT (SELECT rolsuper FROM pg_catalog.pg_roles" +
+	"         WHERE rolname OPERATOR(pg_catalog.=) current_user)" +
+	" THEN" +
+	"  RETURN;" +
+	" END IF;" +
+
+	" PERFORM pg_catalog.set_config(''pljava.cpu_budget'', ''50'', true);" +
+	" BEGIN" +
+	"  PERFORM javatest.budget_spin(5000);" +
+	" EXCEPTION WHEN query_canceled THEN" +
+	"  cpu := ''ok'';" +
+	" END;" +
+	" PERFORM pg_catalog.set_config(''pljava.cpu_budget'', ''0'', true);" +
+
+	" PERFORM pg_catalog.set_config(" +
+	"  ''pljava.allocation_budget'', ''1024'', true);" +
+	" BEGIN" +
+	"  PERFORM javatest.budget_allocate(16);" +
+	" EXCEPTION WHEN program_limit_exceeded THEN" +
+	"  alloc := ''ok'';" +
+	" END;" +
+	" PERFORM pg_catalog.set_config(" +
+	"  ''pljava.allocation_budget'', ''0'', true);" +
+
+	" PERFORM javatest.logmessage(" +
+	"  CASE cpu WHEN ''ok'' THEN ''INFO'' ELSE ''WARNING'' END," +
+	"  ''cpu_budget '' || cpu);" +
+	" PERFORM javatest.logmessage(" +
+	"  CASE alloc WHEN ''ok'' THEN ''INFO'' ELSE ''WARNING'' END," +
+	"  ''allocation_budget '' || alloc);" +
+	"END'"
+)
+public class BudgetTest
+{
+	private BudgetTest() { }
+
+	private static volatile Object s_sink;
+
+	/**
+	 * Keep the CPU busy for about {@code millis} milliseconds of wall time,
+	 * running a trivial query now and then.
+	 */
+	@Function(schema = "javatest", name = "budget_spin",
+		provides = "budget fns")
+	public static boolean spin(int millis) throws SQLException
+	{
+		Connection c = DriverManager.getConnection("jdbc:default:connection");
+		long end = System.nanoTime() + 1000000L * millis;
+		long x = 0;
+		try ( PreparedStatement ps = c.prepareStatement("SELECT 1") )
+		{
+			while ( System.nanoTime() < end )
+			{
+				for ( int i = 0 ; i < 100000 ; ++ i )
+					x = x * 31 + i;
+				try ( ResultSet rs = ps.executeQuery() )
+				{
+					rs.next();
+				}
+			}
+		}
+		s_sink = x;
+		return true;
+	}
+
+	/**
+	 * Allocate {@code megabytes} one-megabyte arrays, and return.
+	 */
+	@Function(schema = "javatest", name = "budget_allocate",
+		provides = "budget fns")
+	public static boolean allocate(int megabytes)
+	{
+		byte[][] a = new byte [ megabytes ] [];
+		for ( int i = 0 ; i < megabytes ; ++ i )
+			a[i] = new byte [ 1 << 20 ];
+		s_sink = a;
+		s_sink = null;
+		return true;
+	}
+}
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+package org.postgresql.pljava.example.annotation;
+
+import java.math.BigDecimal;
+
+import java.time.LocalDate;
+
+import org.postgresql.pljava.annotation.Function;
+import org.postgresql.pljava.annotation.SQLAction;
+
+/**
+ * Test that arrays with boxed primitive, {@code LocalDate}, and
+ * {@code BigDecimal} elements, which are converted in bulk, arrive in Java and
+ * come back with their values, nulls, and (for {@code numeric}) scales in the
+ * right places.
+ *<p>
+ * Each function returns its argument reversed, so an element that crossed to
+ * the wrong index, in either direction, shows in the result.
+ */
+@SQLAction(requires = "bulk_reverse fns", install =
+	"SELECT" +
+	"  CASE WHEN" +
+	"   javatest.bulk_reverse(ARRAY[true, NULL, false, false])" +
+	"    IS NOT DISTINCT FROM ARRAY[false, false, NULL, true]" +
+	"   AND javatest.bulk_reverse(CAST(ARRAY[-32768, NULL, 7] AS int2[]))" +
+	"    IS NOT DISTINCT FROM CAST(ARRAY[7, NULL, -32768] AS int2[])" +
+	"   AND javatest.bulk_reverse(ARRAY[1, NULL, NULL, 2147483647])" +
+	"    IS NOT DISTINCT FROM ARRAY[2147483647, NULL, NULL, 1]" +
+	"   AND javatest.bulk_reverse(ARRAY[1, 2, 3])" +
+	"    IS NOT DISTINCT FROM ARRAY[3, 2, 1]" +
+	"   AND javatest.bulk_reverse(CAST(ARRAY[NULL, NULL] AS int4[]))" +
+	"    IS NOT DISTINCT FROM CAST(ARRAY[NULL, NULL] AS int4[])" +
+	"   AND 0 = pg_catalog.cardinality(" +
+	"    javatest.bulk_reverse(CAST('{}' AS int4[])))" +
+	"   AND javatest.bulk_reverse(ARRAY[NULL, -9223372036854775807, 5])" +
+	"    IS NOT DISTINCT FROM ARRAY[5, -9223372036854775807, NULL]" +
+	"   AND javatest.bulk_reverse(CAST(ARRAY[0.5, NULL, -2.25] AS float4[]))" +
+	"    IS NOT DISTINCT FROM CAST(ARRAY[-2.25, NULL, 0.5] AS float4[])" +
+	"   AND javatest.bulk_reverse(" +
+	"    CAST(ARRAY[1e300, NULL, 0.125] AS float8[]))" +
+	"    IS NOT DISTINCT FROM CAST(ARRAY[0.125, NULL, 1e300] AS float8[])" +
+	"   AND javatest.bulk_reverse(" +
+	"    CAST('{1999-12-31,NULL,2000-01-01,2026-10-18}' AS date[]))" +
+	"    IS NOT DISTINCT FROM" +
+	"    CAST('{2026-10-18,2000-01-01,NULL,1999-12-31}' AS date[])" +
+	"   AND CAST(javatest.bulk_reverse(" +
+	"    CAST('{1.50,NULL,-0.001,12345678901234567890.123}' AS numeric[]))" +
+	"    AS text)" +
+	"    = '{12345678901234567890.123,-0.001,NULL,1.50}'" +
+	"  THEN javatest.logmessage('INFO', 'bulk arrays ok')" +
+	"  ELSE javatest.logmessage('WARNING', 'bulk arrays ng')" +
+	"  END"
+)
+public class BulkArrayTest
+{
+	private BulkArrayTest() { }
+
+	private static <T> T[] reverse(T[] a)
+	{
+		T[] r = a.clone();
+		for ( int i = 0, j = r.length - 1 ; i < j ; ++ i, -- j )
+		{
+			T t = r[i];
+			r[i] = r[j];
+			r[j] = t;
+		}
+		return r;
+	}
+
+	/**
+	 * Return the {@code boolean} array reversed.
+	 */
+	@Function(schema = "javatest", name = "bulk_reverse",
+		provides = "bulk_reverse fns")
+	public static Boolean[] reverseBooleans(Boolean[] a)
+	{
+		return reverse(a);
+	}
+
+	/**
+	 * Return the {@code int2} array reversed.
+	 */
+	@Function(schema = "javatest", name = "bulk_reverse",
+		provides = "bulk_reverse fns")
+	public static Short[] reverseShorts(Short[] a)
+	{
+		return reverse(a);
+	}
+
+	/**
+	 * Return the {@code int4} array reversed.
+	 */
+	@Function(schema = "javatest", name = "bulk_reverse",
+		provides = "bulk_reverse fns")
+	public static Integer[] reverseInts(Integer[] a)
+	{
+		return reverse(a);
+	}
+
+	/**
+	 * Return the {@code int8} array reversed.
+	 */
+	@Function(schema = "javatest", name = "bulk_reverse",
+		provides = "bulk_reverse fns")
+	public static Long[] reverseLongs(Long[] a)
+	{
+		return reverse(a);
+	}
+
+	/**
+	 * Return the {@code float4} array reversed.
+	 */
+	@Function(schema = "javatest", name = "bulk_reverse",
+		provides = "bulk_reverse fns")
+	public static Float[] reverseFloats(Float[] a)
+	{
+		return reverse(a);
+	}
+
+	/**
+	 * Return the {@code float8} array reversed.
+	 */
+	@Function(schema = "javatest", name = "bulk_reverse",
+		provides = "bulk_reverse fns")
+	public static Double[] reverseDoubles(Double[] a)
+	{
+		return reverse(a);
+	}
+
+	/**
+	 * Return the {@code date} array reversed.
+	 */
+	@Function(schema = "javatest", name = "bulk_reverse",
+		provides = "bulk_reverse fns")
+	public static LocalDate[] reverseDates(LocalDate[] a)
+	{
+		return reverse(a);
+	}
+
+	/**
+	 * Return the {@code numeric} array reversed.
+	 */
+	@Function(schema = "javatest", name = "bulk_reverse",
+		provides = "bulk_reverse fns")
+	public static BigDecimal[] reverseDecimals(BigDecimal[] a)
+	{
+		return reverse(a);
+	}
+}
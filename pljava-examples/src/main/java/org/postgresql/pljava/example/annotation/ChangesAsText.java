@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+package org.postgresql.pljava.example.annotation;
+
+import java.sql.ResultSet;
+import java.sql.ResultSetMetaData;
+import java.sql.SQLException;
+
+import java.util.List;
+import java.util.Map;
+
+import org.postgresql.pljava.LogicalDecoder;
+
+/**
+ * A logical decoding output plugin writing each change as a line of text
+ * resembling that of PostgreSQL's {@code test_decoding}.
+ *<p>
+ * It cannot be tested as part of deploying the examples jar, which happens in
+ * a transaction that has already written, where a replication slot cannot be
+ * created; the CI scripts test it afterward, over another connection. With
+ * {@code wal_level} set to {@code logical}, and the examples jar on the class
+ * path of the {@code public} schema, it can be tried this way:
+ *<pre>
+ * SELECT pg_create_logical_replication_slot('javatest', probin)
+ *   FROM pg_proc WHERE oid = 'sqlj.java_call_handler()'::regprocedure;
+ * CREATE TABLE javatest.decoded(k integer PRIMARY KEY, v text);
+ * INSERT INTO javatest.decoded VALUES (1, 'one'), (2, 'two');
+ * UPDATE javatest.decoded SET v = 'uno' WHERE k = 1;
+ * DELETE FROM javatest.decoded WHERE k = 2;
+ * SELECT data FROM pg_logical_slot_get_changes('javatest', NULL, NULL,
+ *   'class', 'org.postgresql.pljava.example.annotation.ChangesAsText',
+ *   'schema', 'public', 'batch_size', '2');
+ * SELECT pg_drop_replication_slot('javatest');
+ *</pre>
+ * An {@code include_xids} option of {@code false} leaves the transaction IDs
+ * out of the {@code BEGIN} and {@code COMMIT} lines.
+ */
+public class ChangesAsText implements LogicalDecoder
+{
+	private final boolean m_includeXids;
+
+	public ChangesAsText(Map<String,String> options)
+	{
+		m_includeXids =
+			! "false".equalsIgnoreCase(options.get("include_xids"));
+	}
+
+	@Override
+	public void begin(long xid, Output out)
+	{
+		out.write(m_includeXids ? "BEGIN " + xid : "BEGIN");
+	}
+
+	@Override
+	public void changes(long xid, List<Change> changes, Output out)
+	throws SQLException
+	{
+		for ( Change c : changes )
+		{
+			StringBuilder sb = new StringBuilder("table ")
+				.append(c.schema()).append('.').append(c.table())
+				.append(": ").append(c.kind()).append(':');
+			if ( Kind.INSERT != c.kind()  &&  null != c.oldRow() )
+				appendRow(sb.append(" old-key:"), c.oldRow());
+			if ( Kind.DELETE != c.kind() )
+				appendRow(sb, c.newRow());
+			out.write(sb);
+		}
+	}
+
+	@Override
+	public void commit(long xid, long commitLSN, Output out)
+	{
+		out.write(m_includeXids ? "COMMIT " + xid : "COMMIT");
+	}
+
+	private static void appendRow(StringBuilder sb, ResultSet rs)
+	throws SQLException
+	{
+		ResultSetMetaData md = rs.getMetaData();
+		for ( int i = 1 ; i <= md.getColumnCount() ; ++ i )
+			sb.append(' ').append(md.getColumnName(i))
+				.append('[').append(md.getColumnTypeName(i)).append("]:")
+				.append(rs.getString(i));
+	}
+}
@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+package org.postgresql.pljava.example.annotation;
+
+import java.sql.SQLException;
+
+import java.util.concurrent.CountDownLatch;
+import java.util.concurrent.Future;
+
+import static java.util.concurrent.TimeUnit.SECONDS;
+
+import org.postgresql.pljava.ComputePool;
+import org.postgresql.pljava.SessionManager;
+import org.postgresql.pljava.annotation.Function;
+import org.postgresql.pljava.annotation.SQLAction;
+
+/**
+ * Test that a task submitted to the session's {@link ComputePool} and left
+ * running when the submitting function returns is cancelled, and its thread
+ * interrupted.
+ *<p>
+ * The pool is given two threads if the deploying role may set
+ * {@code pljava.compute_pool_size} and the pool has not yet been created in the
+ * session. If the pool has no threads, a task runs to completion when
+ * submitted, and there is nothing to cancel; the test then only checks that.
+ */
+@SQLAction(requires = "computepool fns", install = {
+	"SELECT CASE WHEN r.rolsuper" +
+	" THEN set_config('pljava.compute_pool_size', '2', true) END" +
+	" FROM pg_catalog.pg_roles AS r WHERE r.rolname = current_user",
+
+	"SELECT javatest.computepool_leave_task()",
+
+	"SELECT" +
+	"  CASE WHEN javatest.computepool_left_task_cancelled()" +
+	"  THEN javatest.logmessage('INFO', 'ComputePool cancel on exit ok')" +
+	"  ELSE javatest.logmessage('WARNING', 'ComputePool cancel on exit ng')" +
+	"  END"
+})
+public class ComputePoolTest
+{
+	private ComputePoolTest() { }
+
+	private static Future<Boolean> s_left;
+	private static int s_parallelism;
+	private static final CountDownLatch s_interrupted = new CountDownLatch(1);
+
+	/**
+	 * Submit a task that waits until interrupted, and return without waiting
+	 * for it.
+	 */
+	@Function(schema = "javatest", name = "computepool_leave_task",
+		provides = "computepool fns")
+	public static boolean leaveTask() throws SQLException
+	{
+		ComputePool pool = SessionManager.current().getComputePool();
+		s_parallelism = pool.parallelism();
+		s_left = pool.submit(() ->
+		{
+			if ( 0 == s_parallelism )
+				return true;
+			try
+			{
+				Thread.sleep(SECONDS.toMillis(60));
+				return false;
+			}
+			catch ( InterruptedException e )
+			{
+				s_interrupted.countDown();
+				return true;
+			}
+		});
+		return true;
+	}
+
+	/**
+	 * Check that the task left by {@link #leaveTask leaveTask} was cancelled
+	 * and interrupted (or simply ran, if the pool has no threads).
+	 */
+	@Function(schema = "javatest", name = "computepool_left_task_cancelled",
+		provides = "computepool fns")
+	public static boolean leftTaskCancelled() throws SQLException
+	{
+		if ( null == s_left )
+			return false;
+		if ( 0 == s_parallelism )
+			return s_left.isDone() && ! s_left.isCancelled();
+		try
+		{
+			return s_left.isCancelled() && s_interrupted.await(5, SECONDS);
+		}
+		catch ( InterruptedException e )
+		{
+			Thread.currentThread().interrupt();
+			return false;
+		}
+	}
+}
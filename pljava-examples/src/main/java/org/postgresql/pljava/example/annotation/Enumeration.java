@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2020 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2015-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -20,7 +20,8 @@ import org.postgresql.pljava.annotation.Function;
 
 /**
  * Confirms the mapping of PG enum and Java String, and arrays of each, as
- * parameter and return types.
+ * parameter and return types, and the mapping of a PG enum to a Java enum
+ * declared with {@code sqlj.add_type_mapping}.
  *<p>
  * This example relies on {@code implementor} tags reflecting the PostgreSQL
  * version, set up in the {@link ConditionalDDR} example. PostgreSQL before 8.3
@@ -39,6 +40,31 @@ import org.postgresql.pljava.annotation.Function;
 		"SELECT moodsToTexts(array['happy','happy','sad','ok']::mood[])"
 	}
 )
+@SQLAction(provides="weather type", implementor="postgresql_ge_80300",
+	install={
+		"CREATE TYPE weather AS ENUM ('rainy', 'cloudy', 'sunny')",
+		"SELECT sqlj.add_type_mapping('weather'," +
+		" 'org.postgresql.pljava.example.annotation.Weather')"
+	},
+	remove={
+		"SELECT sqlj.drop_type_mapping('weather')",
+		"DROP TYPE weather"
+	}
+)
+@SQLAction(implementor="postgresql_ge_80300",
+	requires={"textToWeather", "weatherToText", "brighter", "sunniest"},
+	install=
+	"SELECT" +
+	"  CASE WHEN" +
+	"   textToWeather('cloudy') = 'cloudy'::weather" +
+	"   AND weatherToText('sunny') = 'sunny'" +
+	"   AND brighter('rainy') = 'cloudy'" +
+	"   AND brighter('sunny') = 'sunny'" +
+	"   AND sunniest(array['rainy','sunny','cloudy']::weather[]) = 'sunny'" +
+	"  THEN javatest.logmessage('INFO', 'Java enum mapping ok')" +
+	"  ELSE javatest.logmessage('WARNING', 'Java enum mapping not ok')" +
+	"  END"
+)
 public class Enumeration
 {
 	@Function(requires="mood type", provides="textToMood", type="mood",
@@ -65,4 +91,34 @@ public class Enumeration
 	{
 		return Arrays.asList(ss).iterator();
 	}
+
+	@Function(requires="weather type", provides="textToWeather",
+			  type="weather", implementor="postgresql_ge_80300")
+	public static Weather textToWeather(String s)
+	{
+		return Weather.valueOf(s);
+	}
+	@Function(requires="weather type", provides="weatherToText",
+			  implementor="postgresql_ge_80300")
+	public static String weatherToText(@SQLType("weather")Weather w)
+	{
+		return w.name();
+	}
+	@Function(requires="weather type", provides="brighter", type="weather",
+			  implementor="postgresql_ge_80300")
+	public static Weather brighter(@SQLType("weather")Weather w)
+	{
+		Weather[] all = Weather.values();
+		return all[Math.min(w.ordinal() + 1, all.length - 1)];
+	}
+	@Function(requires="weather type", provides="sunniest", type="weather",
+			  implementor="postgresql_ge_80300")
+	public static Weather sunniest(@SQLType("weather[]")Weather[] ws)
+	{
+		Weather best = null;
+		for ( Weather w : ws )
+			if ( null == best  ||  w.compareTo(best) > 0 )
+				best = w;
+		return best;
+	}
 }
@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+package org.postgresql.pljava.example.annotation;
+
+import java.sql.Connection;
+import java.sql.DriverManager;
+import java.sql.ResultSet;
+import java.sql.SQLException;
+import java.sql.Statement;
+
+import org.postgresql.pljava.annotation.Function;
+import org.postgresql.pljava.annotation.SQLAction;
+
+/**
+ * Test the native accessors that {@code pljava.foreign_downcalls} has called
+ * through foreign-function downcall handles: the position and end state of
+ * a cursor, read when fetching in batches up to a maximum row count, and the
+ * result kind and row count of an SPI statement.
+ *<p>
+ * The setting is checked on each call, so the test runs the checks with it
+ * {@code on} and then {@code off}, covering both the downcall handles and the
+ * JNI natives. With a Java runtime older than 22, a warning is logged and JNI
+ * is used both times. The other accessor called that way, the length of the
+ * buffer a {@code SQLOutput} writes into, is exercised by
+ * {@link VarlenaUDTTest}.
+ */
+@SQLAction(requires = "foreign_downcall_check fn", install = {
+	"SELECT pg_catalog.set_config('pljava.foreign_downcalls', 'on', true)",
+
+	"SELECT" +
+	"  CASE WHEN javatest.foreign_downcall_check()" +
+	"  THEN javatest.logmessage('INFO', 'foreign_downcalls on ok')" +
+	"  ELSE javatest.logmessage('WARNING', 'foreign_downcalls on ng')" +
+	"  END",
+
+	"SELECT pg_catalog.set_config('pljava.foreign_downcalls', 'off', true)",
+
+	"SELECT" +
+	"  CASE WHEN javatest.foreign_downcall_check()" +
+	"  THEN javatest.logmessage('INFO', 'foreign_downcalls off ok')" +
+	"  ELSE javatest.logmessage('WARNING', 'foreign_downcalls off ng')" +
+	"  END",
+
+	"RESET pljava.foreign_downcalls"
+})
+public class ForeignDowncallTest
+{
+	private ForeignDowncallTest() { }
+
+	/**
+	 * Count the rows of a 100-row query read with the given fetch size and
+	 * maximum row count.
+	 */
+	private static int count(Connection c, int fetchSize, int maxRows)
+	throws SQLException
+	{
+		try ( Statement s = c.createStatement() )
+		{
+			s.setFetchSize(fetchSize);
+			s.setMaxRows(maxRows);
+			try ( ResultSet rs = s.executeQuery(
+				"SELECT x FROM pg_catalog.generate_series(1, 100) AS x") )
+			{
+				int n = 0;
+				while ( rs.next() )
+					++ n;
+				return n;
+			}
+		}
+	}
+
+	/**
+	 * Return whether batched reads stop at the right rows, and statements
+	 * report the right kinds of result and row counts.
+	 */
+	@Function(schema = "javatest", name = "foreign_downcall_check",
+		provides = "foreign_downcall_check fn")
+	public static boolean check() throws SQLException
+	{
+		Connection c = DriverManager.getConnection("jdbc:default:connection");
+
+		if ( 100 != count(c, 3, 0)  ||  10 != count(c, 3, 10)
+			||  10 != count(c, 4, 10)  ||  100 != count(c, 7, 1000) )
+			return false;
+
+		try ( Statement s = c.createStatement() )
+		{
+			s.executeUpdate(
+				"CREATE TEMPORARY TABLE foreign_downcall_check (x int4)");
+			try
+			{
+				if ( 5 != s.executeUpdate(
+					"INSERT INTO foreign_downcall_check" +
+					" SELECT pg_catalog.generate_series(1, 5)") )
+					return false;
+
+				if ( s.execute(
+					"UPDATE foreign_downcall_check SET x = -x" +
+					" WHERE x OPERATOR(pg_catalog.>) 2")
+					||  3 != s.getUpdateCount() )
+					return false;
+
+				if ( ! s.execute("SELECT x FROM foreign_downcall_check")
+					||  -1 != s.getUpdateCount() )
+					return false;
+				s.getResultSet().close();
+
+				return 0 == s.executeUpdate(
+					"DELETE FROM foreign_downcall_check" +
+					" WHERE x OPERATOR(pg_catalog.=) 0");
+			}
+			finally
+			{
+				s.executeUpdate("DROP TABLE foreign_downcall_check");
+			}
+		}
+	}
+}
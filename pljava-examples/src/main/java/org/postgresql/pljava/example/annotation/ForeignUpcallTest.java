@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+package org.postgresql.pljava.example.annotation;
+
+import java.sql.SQLDataException;
+
+import org.postgresql.pljava.annotation.Function;
+import org.postgresql.pljava.annotation.SQLAction;
+
+/**
+ * Test functions returning {@code void}, {@code int}, {@code boolean}, and
+ * {@code double}, and one that throws, called with
+ * {@code pljava.foreign_upcalls} on.
+ *<p>
+ * The setting is checked on each call, so it is turned on only for the
+ * duration of the test. With a Java runtime older than 22, a warning is logged
+ * and the calls are made through JNI, so the same results are expected either
+ * way. A call after the one that throws checks that the caught exception does
+ * not disturb the next upcall.
+ */
+@SQLAction(requires = "foreign_upcall fns", install = {
+	"SELECT pg_catalog.set_config('pljava.foreign_upcalls', 'on', true)",
+
+	"DO LANGUAGE plpgsql '" +
+	"DECLARE" +
+	" ok boolean;" +
+	"BEGIN" +
+	" PERFORM javatest.foreign_upcall_void(42);" +
+	" ok := 42 OPERATOR(pg_catalog.=) javatest.foreign_upcall_last()" +
+	"  AND 5 OPERATOR(pg_catalog.=) javatest.foreign_upcall_int(2, 3)" +
+	"  AND javatest.foreign_upcall_boolean(4)" +
+	"  AND NOT javatest.foreign_upcall_boolean(3)" +
+	"  AND 0.625 OPERATOR(pg_catalog.=) javatest.foreign_upcall_double(2.5);" +
+	" BEGIN" +
+	"  PERFORM javatest.foreign_upcall_throws(-1);" +
+	"  ok := false;" +
+	" EXCEPTION WHEN invalid_parameter_value THEN" +
+	"  NULL;" +
+	" END;" +
+	" ok := ok" +
+	"  AND 7 OPERATOR(pg_catalog.=) javatest.foreign_upcall_int(3, 4);" +
+	" PERFORM javatest.logmessage(" +
+	"  CASE WHEN ok THEN ''INFO'' ELSE ''WARNING'' END," +
+	"  CASE WHEN ok THEN ''foreign_upcalls ok''" +
+	"  ELSE ''foreign_upcalls ng'' END);" +
+	"END'",
+
+	"RESET pljava.foreign_upcalls"
+})
+public class ForeignUpcallTest
+{
+	private ForeignUpcallTest() { }
+
+	private static int s_last;
+
+	/**
+	 * Save a value for {@link #last last} to return.
+	 */
+	@Function(schema = "javatest", name = "foreign_upcall_void",
+		provides = "foreign_upcall fns")
+	public static void saveLast(int x)
+	{
+		s_last = x;
+	}
+
+	/**
+	 * Return the value last saved by {@link #saveLast saveLast}.
+	 */
+	@Function(schema = "javatest", name = "foreign_upcall_last",
+		provides = "foreign_upcall fns")
+	public static int last()
+	{
+		return s_last;
+	}
+
+	/**
+	 * Return the sum of two ints.
+	 */
+	@Function(schema = "javatest", name = "foreign_upcall_int",
+		provides = "foreign_upcall fns")
+	public static int sum(int a, int b)
+	{
+		return a + b;
+	}
+
+	/**
+	 * Return whether an int is even.
+	 */
+	@Function(schema = "javatest", name = "foreign_upcall_boolean",
+		provides = "foreign_upcall fns")
+	public static boolean isEven(int a)
+	{
+		return 0 == a % 2;
+	}
+
+	/**
+	 * Return a quarter of a double.
+	 */
+	@Function(schema = "javatest", name = "foreign_upcall_double",
+		provides = "foreign_upcall fns")
+	public static double quarter(double x)
+	{
+		return x / 4;
+	}
+
+	/**
+	 * Return an int, or throw if it is negative.
+	 */
+	@Function(schema = "javatest", name = "foreign_upcall_throws",
+		provides = "foreign_upcall fns")
+	public static int nonNegative(int a) throws SQLDataException
+	{
+		if ( a < 0 )
+			throw new SQLDataException(
+				"foreign_upcall_throws: negative argument", "22023");
+		return a;
+	}
+}
@@ -0,0 +1,294 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+package org.postgresql.pljava.example.annotation;
+
+import java.sql.SQLException;
+
+import java.util.Arrays;
+import java.util.Comparator;
+import java.util.stream.IntStream;
+
+import org.postgresql.pljava.GiST;
+import org.postgresql.pljava.annotation.Function;
+import static org.postgresql.pljava.annotation.Function.Effects.IMMUTABLE;
+import static
+	org.postgresql.pljava.annotation.Function.OnNullInput.RETURNS_NULL;
+import org.postgresql.pljava.annotation.Operator;
+import static org.postgresql.pljava.annotation.Operator.SELF;
+import org.postgresql.pljava.annotation.SQLAction;
+import org.postgresql.pljava.annotation.SQLType;
+
+/**
+ * A GiST operator class for {@code float8} with its support functions in
+ * Java, each key a {@code float8[]} of the lowest and highest values beneath
+ * it, supporting the comparison operators and nearest-neighbor ordering by
+ * the {@code <->} distance operator declared here.
+ *<p>
+ * The {@code SQLAction} builds an index with the operator class and checks
+ * queries that use it against the known contents of the table. It then fills
+ * a table with a two-column index, where splitting a page makes unions of
+ * entries PostgreSQL passes with no relation, and checks it the same way.
+ */
+@SQLAction(requires = "float8_interval_ops support", install = {
+	"CREATE OPERATOR CLASS javatest.float8_interval_ops" +
+	"  FOR TYPE pg_catalog.float8 USING gist" +
+	" AS" +
+	"  OPERATOR 1 pg_catalog.<  ," +
+	"  OPERATOR 2 pg_catalog.<= ," +
+	"  OPERATOR 3 pg_catalog.=  ," +
+	"  OPERATOR 4 pg_catalog.>= ," +
+	"  OPERATOR 5 pg_catalog.>  ," +
+	"  OPERATOR 15 javatest.<-> FOR ORDER BY pg_catalog.float_ops," +
+	"  FUNCTION 1 javatest.float8_interval_consistent(" +
+	"   internal, float8, int2, oid, internal)," +
+	"  FUNCTION 2 javatest.float8_interval_union(internal, internal)," +
+	"  FUNCTION 3 javatest.float8_interval_compress(internal)," +
+	"  FUNCTION 4 javatest.float8_interval_decompress(internal)," +
+	"  FUNCTION 5 javatest.float8_interval_penalty(" +
+	"   internal, internal, internal)," +
+	"  FUNCTION 6 javatest.float8_interval_picksplit(internal, internal)," +
+	"  FUNCTION 7 javatest.float8_interval_same(" +
+	"   float8[], float8[], internal)," +
+	"  FUNCTION 8 javatest.float8_interval_distance(" +
+	"   internal, float8, int2, oid, internal)," +
+	"  STORAGE float8[]",
+
+	"CREATE TEMPORARY TABLE gist_intervals_check AS" +
+	" SELECT CAST(x * 7 % 1000 AS float8) / 10 AS x" +
+	" FROM generate_series(1, 3000) AS x",
+
+	"CREATE INDEX ON gist_intervals_check" +
+	" USING gist (x javatest.float8_interval_ops)",
+
+	"SELECT set_config('enable_seqscan', 'off', true)",
+
+	"SELECT" +
+	"  CASE WHEN" +
+	"   300 = (SELECT count(*) FROM gist_intervals_check WHERE x < 10)" +
+	"  AND" +
+	"   3 = (SELECT count(*) FROM gist_intervals_check WHERE x = 50)" +
+	"  AND" +
+	"   ARRAY[42, 42, 42, 42.1, 42.1, 42.1]::float8[] = (" +
+	"    SELECT array_agg(x ORDER BY x) FROM (" +
+	"     SELECT x FROM gist_intervals_check" +
+	"     ORDER BY x OPERATOR(javatest.<->) 42.05 LIMIT 6" +
+	"    ) AS nearest" +
+	"   )" +
+	"  THEN javatest.logmessage('INFO', 'GiST support functions ok')" +
+	"  ELSE javatest.logmessage('WARNING', 'GiST support functions ng')" +
+	"  END",
+
+	"CREATE TEMPORARY TABLE gist_intervals_pairs (x float8, y float8)",
+
+	"CREATE INDEX ON gist_intervals_pairs USING gist (" +
+	" x javatest.float8_interval_ops, y javatest.float8_interval_ops)",
+
+	"INSERT INTO gist_intervals_pairs" +
+	" SELECT CAST(n * 7 % 1000 AS float8) / 10," +
+	"  CAST(n * 13 % 997 AS float8) / 10" +
+	" FROM generate_series(1, 3000) AS n",
+
+	"SELECT" +
+	"  CASE WHEN" +
+	"   30 = (SELECT count(*) FROM gist_intervals_pairs" +
+	"    WHERE x < 10 AND y > 90)" +
+	"  AND" +
+	"   1 = (SELECT count(*) FROM gist_intervals_pairs" +
+	"    WHERE x = 50 AND y < 55)" +
+	"  AND" +
+	"   33 = (SELECT count(*) FROM gist_intervals_pairs WHERE y <= 1)" +
+	"  THEN javatest.logmessage('INFO', 'GiST two-column index ok')" +
+	"  ELSE javatest.logmessage('WARNING', 'GiST two-column index ng')" +
+	"  END",
+
+	"RESET enable_seqscan",
+
+	"DROP TABLE gist_intervals_pairs",
+
+	"DROP TABLE gist_intervals_check"
+}, remove = {
+	"DROP OPERATOR FAMILY javatest.float8_interval_ops USING gist"
+})
+public class GiSTIntervals
+{
+	private GiSTIntervals() { } // do not instantiate
+
+	/**
+	 * The absolute difference of two {@code float8} values, as the ordering
+	 * operator {@code <->}.
+	 */
+	@Operator(name = "javatest.<->", commutator = SELF,
+		provides = "float8_interval_ops support")
+	@Function(schema = "javatest", name = "float8_distance",
+		effects = IMMUTABLE, onNullInput = RETURNS_NULL)
+	public static double float8Distance(double a, double b)
+	{
+		return Math.abs(a - b);
+	}
+
+	/**
+	 * Whether a row matching the operator could be beneath an entry. A leaf
+	 * key holds exactly one value, so no recheck is needed.
+	 */
+	@Function(schema = "javatest", name = "float8_interval_consistent",
+		effects = IMMUTABLE, provides = "float8_interval_ops support")
+	public static boolean consistent(GiST.Entry entry, double query,
+		short strategy, @SQLType("oid") int subtype, GiST.Recheck recheck)
+	throws SQLException
+	{
+		double[] k = interval(entry.key());
+		recheck.set(false);
+		switch ( strategy )
+		{
+		case 1: return k[0] <  query;
+		case 2: return k[0] <= query;
+		case 3: return k[0] <= query  &&  query <= k[1];
+		case 4: return k[1] >= query;
+		case 5: return k[1] >  query;
+		}
+		throw new SQLException(
+			"float8_interval_ops has no strategy " + strategy, "42809");
+	}
+
+	/**
+	 * The interval covering all of the entries.
+	 */
+	@Function(schema = "javatest", name = "float8_interval_union",
+		effects = IMMUTABLE, provides = "float8_interval_ops support")
+	public static double[] union(
+		GiST.EntryVector entries, GiST.UnionSize size)
+	throws SQLException
+	{
+		return cover(entries.keys(), IntStream.range(0, entries.size()));
+	}
+
+	/**
+	 * Makes a leaf key, the one-value interval {@code [x, x]}.
+	 */
+	@Function(schema = "javatest", name = "float8_interval_compress",
+		effects = IMMUTABLE, provides = "float8_interval_ops support")
+	public static GiST.Entry compress(GiST.Entry entry) throws SQLException
+	{
+		if ( ! entry.isLeaf() )
+			return entry;
+		double x = (Double)entry.key();
+		return entry.withKey(new double[] { x, x });
+	}
+
+	/**
+	 * Leaves an entry as it is; PostgreSQL before 11 requires a decompress
+	 * function.
+	 */
+	@Function(schema = "javatest", name = "float8_interval_decompress",
+		effects = IMMUTABLE, provides = "float8_interval_ops support")
+	public static GiST.Entry decompress(GiST.Entry entry)
+	{
+		return entry;
+	}
+
+	/**
+	 * How far the original interval must grow to cover the added one.
+	 */
+	@Function(schema = "javatest", name = "float8_interval_penalty",
+		effects = IMMUTABLE, provides = "float8_interval_ops support")
+	public static GiST.Penalty penalty(
+		GiST.Entry original, GiST.Entry added, GiST.Penalty penalty)
+	throws SQLException
+	{
+		double[] o = interval(original.key());
+		double[] a = interval(added.key());
+		penalty.set((float)(
+			Math.max(0, o[0] - a[0]) + Math.max(0, a[1] - o[1])));
+		return penalty;
+	}
+
+	/**
+	 * Splits the entries at the median of their midpoints.
+	 */
+	@Function(schema = "javatest", name = "float8_interval_picksplit",
+		effects = IMMUTABLE, provides = "float8_interval_ops support")
+	public static GiST.Split picksplit(
+		GiST.EntryVector entries, GiST.Split split)
+	throws SQLException
+	{
+		Object[] keys = entries.keys();
+		double[] mid = new double [ keys.length ];
+		for ( int i = 0 ; i < keys.length ; ++ i )
+		{
+			double[] k = interval(keys[i]);
+			mid[i] = (k[0] + k[1]) / 2;
+		}
+		int[] order = IntStream.range(0, keys.length).boxed()
+			.sorted(Comparator.comparingDouble(i -> mid[i]))
+			.mapToInt(Integer::intValue).toArray();
+		int half = order.length / 2;
+		int[] left = Arrays.copyOfRange(order, 0, half);
+		int[] right = Arrays.copyOfRange(order, half, order.length);
+		split.set(left, cover(keys, Arrays.stream(left)),
+			right, cover(keys, Arrays.stream(right)));
+		return split;
+	}
+
+	/**
+	 * Whether two keys are the same interval.
+	 */
+	@Function(schema = "javatest", name = "float8_interval_same",
+		effects = IMMUTABLE, provides = "float8_interval_ops support")
+	public static GiST.Same same(double[] a, double[] b, GiST.Same result)
+	throws SQLException
+	{
+		result.set(Arrays.equals(a, b));
+		return result;
+	}
+
+	/**
+	 * The distance from the query value to the nearest point of an interval,
+	 * exact for a leaf key.
+	 */
+	@Function(schema = "javatest", name = "float8_interval_distance",
+		effects = IMMUTABLE, provides = "float8_interval_ops support")
+	public static double distance(GiST.Entry entry, double query,
+		short strategy, @SQLType("oid") int subtype, GiST.Recheck recheck)
+	throws SQLException
+	{
+		double[] k = interval(entry.key());
+		if ( query < k[0] )
+			return k[0] - query;
+		if ( query > k[1] )
+			return query - k[1];
+		return 0;
+	}
+
+	/**
+	 * A key as passed from PL/Java, a {@code Double[]}, as {@code double[]}.
+	 */
+	private static double[] interval(Object key)
+	{
+		Double[] k = (Double[])key;
+		return new double[] { k[0], k[1] };
+	}
+
+	/**
+	 * The interval covering the keys at the given indices.
+	 */
+	private static double[] cover(Object[] keys, IntStream indices)
+	{
+		double[] c = { Double.POSITIVE_INFINITY, Double.NEGATIVE_INFINITY };
+		indices.forEach(i ->
+		{
+			double[] k = interval(keys[i]);
+			c[0] = Math.min(c[0], k[0]);
+			c[1] = Math.max(c[1], k[1]);
+		});
+		return c;
+	}
+}
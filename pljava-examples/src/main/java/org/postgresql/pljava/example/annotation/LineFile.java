@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+package org.postgresql.pljava.example.annotation;
+
+import java.io.BufferedReader;
+import java.io.IOException;
+
+import java.nio.charset.Charset;
+import java.nio.file.Files;
+import java.nio.file.Path;
+import java.nio.file.Paths;
+
+import java.sql.SQLException;
+
+import java.util.List;
+import java.util.Map;
+
+import org.postgresql.pljava.ForeignDataWrapper;
+import org.postgresql.pljava.annotation.SQLAction;
+
+/**
+ * A foreign data wrapper presenting the lines of a text file as rows
+ * {@code (lineno integer, line text)}.
+ *<p>
+ * The file is named by a {@code filename} option, and read in the character
+ * encoding named by an {@code encoding} option, UTF-8 if not given. A query
+ * condition {@code lineno = }<em>n</em> is used to skip straight to the one
+ * line that can match, and stop reading after it.
+ *<p>
+ * Declaring a foreign data wrapper requires superuser privilege, so the
+ * example is installed, and tested by reading the server's {@code PG_VERSION}
+ * file, only when the jar is deployed by a superuser.
+ */
+@SQLAction(provides="javatest.line_file", install=
+	"DO LANGUAGE plpgsql '" +
+	"BEGIN" +
+	" IF NOT (SELECT rolsuper FROM pg_catalog.pg_roles" +
+	"         WHERE rolname OPERATOR(pg_catalog.=) current_user)" +
+	" THEN" +
+	"  RETURN;" +
+	" END IF;" +
+	" EXECUTE pg_catalog.format(" +
+	"  ''CREATE FOREIGN DATA WRAPPER javatest_line_file" +
+	"    HANDLER sqlj.java_fdw_handler VALIDATOR sqlj.java_fdw_validator" +
+	"    OPTIONS (class %L, schema %L)''," +
+	"  ''org.postgresql.pljava.example.annotation.LineFile''," +
+	"  current_schema());" +
+	" CREATE SERVER javatest_line_file" +
+	"  FOREIGN DATA WRAPPER javatest_line_file;" +
+	" EXECUTE pg_catalog.format(" +
+	"  ''CREATE FOREIGN TABLE javatest.pg_version_lines" +
+	"    (lineno integer, line text)" +
+	"    SERVER javatest_line_file" +
+	"    OPTIONS (filename %L, batch_size ''''2'''')''," +
+	"  current_setting(''data_directory'') OPERATOR(pg_catalog.||)" +
+	"  ''/PG_VERSION'');" +
+	" IF" +
+	"  (SELECT pg_catalog.string_agg(line, E''\\n'' ORDER BY lineno)" +
+	"   FROM javatest.pg_version_lines)" +
+	"  OPERATOR(pg_catalog.||) E''\\n''" +
+	"  OPERATOR(pg_catalog.=) pg_catalog.pg_read_file(''PG_VERSION'')" +
+	"  AND" +
+	"  (SELECT pg_catalog.count(*) FROM javatest.pg_version_lines" +
+	"   WHERE lineno OPERATOR(pg_catalog.=) 1) OPERATOR(pg_catalog.=) 1" +
+	" THEN" +
+	"  PERFORM javatest.logmessage(''INFO'', ''LineFile ok'');" +
+	" ELSE" +
+	"  PERFORM javatest.logmessage(''WARNING'', ''LineFile ng'');" +
+	" END IF;" +
+	"END'",
+
+	remove=
+	"DROP FOREIGN DATA WRAPPER IF EXISTS javatest_line_file CASCADE"
+)
+public class LineFile implements ForeignDataWrapper
+{
+	private final Path m_path;
+	private final Charset m_charset;
+
+	public LineFile(Map<String,String> options) throws SQLException
+	{
+		String filename = options.get("filename");
+		if ( null == filename )
+			throw new SQLException(
+				"LineFile requires a \"filename\" option", "HV00J");
+		m_path = Paths.get(filename);
+		m_charset = Charset.forName(options.getOrDefault("encoding", "UTF-8"));
+	}
+
+	@Override
+	public double estimateRows(List<Qual> quals) throws SQLException
+	{
+		if ( 0 != wantedLine(quals) )
+			return 1;
+		try
+		{
+			return Math.max(1, Files.size(m_path) / 80);
+		}
+		catch ( IOException e )
+		{
+			return 1000;
+		}
+	}
+
+	@Override
+	public Scan beginScan(List<String> columns, List<Qual> quals)
+	throws SQLException
+	{
+		boolean[] isLineno = new boolean[columns.size()];
+		for ( int i = 0 ; i < isLineno.length ; ++ i )
+		{
+			String c = columns.get(i);
+			if ( "lineno".equals(c) )
+				isLineno[i] = true;
+			else if ( ! "line".equals(c) )
+				throw new SQLException(
+					"LineFile has no column \"" + c + "\"", "HV007");
+		}
+		return new LineScan(isLineno, wantedLine(quals));
+	}
+
+	/**
+	 * The line number in a {@code lineno = }<em>n</em> condition, -1 if that
+	 * cannot match any line, or zero if there is no such condition.
+	 */
+	private static int wantedLine(List<Qual> quals)
+	{
+		for ( Qual q : quals )
+			if ( "lineno".equals(q.column())  &&  "=".equals(q.operator())
+				&& q.value() instanceof Integer )
+			{
+				int n = (Integer)q.value();
+				return n < 1 ? -1 : n;
+			}
+		return 0;
+	}
+
+	private class LineScan implements Scan
+	{
+		private final boolean[] m_isLineno;
+		private final int m_wanted;
+		private BufferedReader m_reader;
+		private int m_lineno;
+
+		LineScan(boolean[] isLineno, int wanted) throws SQLException
+		{
+			m_isLineno = isLineno;
+			m_wanted = wanted;
+			open();
+		}
+
+		private void open() throws SQLException
+		{
+			try
+			{
+				m_reader = Files.newBufferedReader(m_path, m_charset);
+				m_lineno = 0;
+			}
+			catch ( IOException e )
+			{
+				throw new SQLException(
+					"LineFile cannot open " + m_path + ": " + e, "58030", e);
+			}
+		}
+
+		@Override
+		public int next(Object[][] batch) throws SQLException
+		{
+			int n = 0;
+			try
+			{
+				while ( n < batch.length )
+				{
+					if ( m_wanted < 0
+						||  0 < m_wanted  &&  m_lineno >= m_wanted )
+						break; /* no more lines can match */
+					String line = m_reader.readLine();
+					if ( null == line )
+						break;
+					++ m_lineno;
+					if ( 0 < m_wanted  &&  m_wanted != m_lineno )
+						continue;
+
+					Object[] row = batch[n];
+					if ( null == row )
+						row = batch[n] = new Object[m_isLineno.length];
+					for ( int i = 0 ; i < m_isLineno.length ; ++ i )
+						row[i] = m_isLineno[i] ? (Object)m_lineno : line;
+					++ n;
+				}
+			}
+			catch ( IOException e )
+			{
+				throw new SQLException(
+					"LineFile cannot read " + m_path + ": " + e, "58030", e);
+			}
+			return n;
+		}
+
+		@Override
+		public void rescan() throws SQLException
+		{
+			close();
+			open();
+		}
+
+		@Override
+		public void close() throws SQLException
+		{
+			try
+			{
+				m_reader.close();
+			}
+			catch ( IOException e )
+			{
+				throw new SQLException(
+					"LineFile cannot close " + m_path + ": " + e, "58030", e);
+			}
+		}
+	}
+}
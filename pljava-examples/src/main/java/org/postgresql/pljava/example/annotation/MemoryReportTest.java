@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+package org.postgresql.pljava.example.annotation;
+
+import org.postgresql.pljava.annotation.SQLAction;
+
+/**
+ * Test that {@code sqlj.memory_report()} returns rows, none of them negative,
+ * with and without collecting garbage first, and counts at least one cached
+ * function (itself).
+ *<p>
+ * The test is skipped if the installed PL/Java lacks the function.
+ */
+@SQLAction(install =
+	"DO LANGUAGE plpgsql '" +
+	"DECLARE" +
+	" ok boolean;" +
+	"BEGIN" +
+	" IF pg_catalog.to_regprocedure(''sqlj.memory_report(boolean)'')" +
+	"  IS NULL" +
+	" THEN" +
+	"  RETURN;" +
+	" END IF;" +
+
+	" ok := EXISTS (SELECT 1 FROM sqlj.memory_report())" +
+	"  AND NOT EXISTS (SELECT 1 FROM sqlj.memory_report(gc => true)" +
+	"   WHERE value OPERATOR(pg_catalog.<) 0)" +
+	"  AND EXISTS (SELECT 1 FROM sqlj.memory_report()" +
+	"   WHERE item OPERATOR(pg_catalog.=) ''cached functions''" +
+	"   AND value OPERATOR(pg_catalog.>=) 1);" +
+	" PERFORM javatest.logmessage(" +
+	"  CASE WHEN ok THEN ''INFO'' ELSE ''WARNING'' END," +
+	"  CASE WHEN ok THEN ''memory_report ok''" +
+	"  ELSE ''memory_report ng'' END);" +
+	"END'"
+)
+public class MemoryReportTest
+{
+	private MemoryReportTest() { }
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+package org.postgresql.pljava.example.annotation;
+
+import java.sql.SQLException;
+
+import java.util.PrimitiveIterator;
+
+import org.postgresql.pljava.SortedInput;
+import org.postgresql.pljava.annotation.Aggregate;
+import org.postgresql.pljava.annotation.Function;
+import static org.postgresql.pljava.annotation.Function.Effects.IMMUTABLE;
+import org.postgresql.pljava.annotation.SQLAction;
+
+/**
+ * Examples of an ordered-set and a hypothetical-set aggregate with finishers
+ * in Java, checked at deployment against PostgreSQL's own
+ * {@code percentile_cont} and {@code rank}.
+ *<p>
+ * Each finisher reads only as many of the sorted rows as it needs, so neither
+ * keeps the group's values in Java.
+ */
+@SQLAction(requires = { "percentile", "rank_of" }, install = {
+	"WITH" +
+	" data (x) AS (" +
+	"  SELECT CAST(x % 37 AS float8) FROM generate_series(1, 5000) AS x" +
+	" )," +
+	" expected AS (" +
+	"  SELECT" +
+	"   percentile_cont(0.3) WITHIN GROUP (ORDER BY x) AS p," +
+	"   rank(12.) WITHIN GROUP (ORDER BY x) AS r" +
+	"  FROM data" +
+	" )," +
+	" got AS (" +
+	"  SELECT" +
+	"   javatest.percentile(0.3) WITHIN GROUP (ORDER BY x) AS p," +
+	"   javatest.rank_of(12.) WITHIN GROUP (ORDER BY x) AS r" +
+	"  FROM data" +
+	" )" +
+	"SELECT" +
+	"  CASE WHEN expected IS NOT DISTINCT FROM got" +
+	"  THEN javatest.logmessage('INFO', 'ordered-set aggregates ok')" +
+	"  ELSE javatest.logmessage('WARNING', 'ordered-set aggregates ng')" +
+	"  END" +
+	" FROM" +
+	"  expected, got"
+})
+public class OrderedSetAggregates
+{
+	private OrderedSetAggregates() { } // do not instantiate
+
+	/**
+	 * A continuous percentile, interpolating between the two values nearest
+	 * the requested fraction, as {@code percentile_cont} does.
+	 *<p>
+	 * As the {@code @Aggregate} annotation is on the finisher, and gives
+	 * {@code directArguments} but no {@code accumulate} function, PL/Java's
+	 * own transition function will sort the rows.
+	 */
+	@Aggregate(provides = "percentile",
+		directArguments = "fraction float8",
+		arguments = "value float8"
+	)
+	@Function(schema = "javatest", effects = IMMUTABLE)
+	public static Double percentile(SortedInput in, Double fraction)
+	throws SQLException
+	{
+		if ( null == fraction )
+			return null;
+		if ( fraction < 0  ||  fraction > 1 )
+			throw new SQLException(
+				"percentile value " + fraction +
+				" is not between 0 and 1", "22003");
+
+		long n = in.size();
+		if ( 0 == n )
+			return null;
+
+		double position = fraction * (n - 1);
+		long firstRow = (long)Math.floor(position);
+		in.skip(firstRow);
+
+		PrimitiveIterator.OfDouble it = in.doubles();
+		double first = it.nextDouble();
+		if ( position == firstRow )
+			return first;
+		double second = it.nextDouble();
+		return first + (position - firstRow) * (second - first);
+	}
+
+	/**
+	 * The rank the hypothetical row would have among the aggregated ones, as
+	 * {@code rank} computes it.
+	 */
+	@Aggregate(provides = "rank_of",
+		name = { "javatest", "rank_of" },
+		hypothetical = true,
+		directArguments = "value float8",
+		arguments = "value float8"
+	)
+	@Function(schema = "javatest", effects = IMMUTABLE)
+	public static long hypotheticalRank(SortedInput in, Double value)
+	throws SQLException
+	{
+		while ( -1 == in.hypotheticalPosition() )
+			if ( 0 == in.skip(1024) )
+				break;
+		return in.hypotheticalPosition() + 1;
+	}
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2021 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2018-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -212,6 +212,27 @@ import org.w3c.dom.bootstrap.DOMImplementationRegistry;
 	}
 )
 
+@SQLAction(implementor="postgresql_xml_ge84",
+	requires={"lowLevelXMLEcho", "bounceXMLAsText"},
+	install=
+	"WITH" +
+	" t(x) AS (" +
+	"  SELECT query_to_xml(" +
+	"   'SELECT ''hi'' AS textcol, 1 AS intcol', true, true, '')" +
+	" )" +
+	"SELECT" +
+	" CASE WHEN" +
+	"  CAST(javatest.lowlevelxmlecho(x, 4) AS text) = CAST(x AS text)" +
+	"  AND javatest.bouncexmlastext(x) = CAST(x AS text)" +
+	"  THEN javatest.logmessage('INFO'," +
+	"       'SQLXML unverified copies succeeded')" +
+	"  ELSE javatest.logmessage('WARNING'," +
+	"       'SQLXML unverified copies had problems')" +
+	" END " +
+	"FROM" +
+	" t"
+)
+
 @SQLAction(implementor="postgresql_xml",
 		   requires={"prepareXMLTransform", "transformXML"},
 	install={
@@ -419,6 +440,20 @@ public class PassXML implements SQLData
 		return sx;
 	}
 
+	/**
+	 * Just like {@link bounceXMLParameter} but with the return typed as
+	 * {@code text}, the reverse of {@link castTextXML}.
+	 *<p>
+	 * Fast, because content that arrived as the XML type needs no verifying,
+	 * whatever type it is returned as.
+	 */
+	@Function(schema="javatest", type="text", implementor="postgresql_xml",
+			  provides="bounceXMLAsText")
+	public static SQLXML bounceXMLAsText(SQLXML sx) throws SQLException
+	{
+		return sx;
+	}
+
 	/**
 	 * Precompile an XSL transform {@code source} and save it (for the
 	 * current session) as {@code name}.
@@ -0,0 +1,115 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+package org.postgresql.pljava.example.annotation;
+
+import java.sql.ResultSet;
+import java.sql.SQLException;
+
+import org.postgresql.pljava.ResultSetProvider;
+import org.postgresql.pljava.annotation.Function;
+import org.postgresql.pljava.annotation.SQLAction;
+
+/**
+ * Test that values set with the primitive updaters of a result row, including
+ * into columns of a wider type, arrive as set, and that a column set in one
+ * row but not the next is null in the next.
+ */
+@SQLAction(requires = "primitive_updaters fn", install =
+	"WITH" +
+	" expected(b, s, i, l, f, d, si, il, id, fd, t) AS (VALUES" +
+	"  (true, CAST(1 AS int2), 2, CAST(3 AS int8), CAST(0.5 AS float4)," +
+	"   CAST(0.25 AS float8), 4, CAST(5 AS int8), CAST(6 AS float8)," +
+	"   CAST(1.5 AS float8), 'a')," +
+	"  (false, NULL, NULL, NULL, NULL, 1e300, NULL, NULL, NULL, NULL, NULL)," +
+	"  (NULL, CAST(-32768 AS int2), 2147483647, 9223372036854775807, -2.5," +
+	"   0.001, -1, -2147483648, -3, -0.125, 'c')" +
+	" )" +
+	"SELECT" +
+	"  CASE WHEN every(want IS NOT DISTINCT FROM got)" +
+	"  THEN javatest.logmessage('INFO',    'primitive updaters ok')" +
+	"  ELSE javatest.logmessage('WARNING', 'primitive updaters ng')" +
+	"  END" +
+	" FROM" +
+	"  (SELECT row_number() OVER (), * FROM expected) AS want" +
+	"  FULL JOIN" +
+	"  (SELECT row_number() OVER (), * FROM javatest.primitive_updaters())" +
+	"  AS got" +
+	"  USING (row_number)"
+)
+public class PrimitiveUpdaterTest implements ResultSetProvider.Large
+{
+	/**
+	 * Three rows set with {@code updateBoolean}, {@code updateShort},
+	 * {@code updateInt}, {@code updateLong}, {@code updateFloat}, and
+	 * {@code updateDouble}; the columns {@code si}, {@code il}, {@code id},
+	 * and {@code fd} are set with the updater of a narrower type.
+	 */
+	@Function(
+		schema = "javatest", provides = "primitive_updaters fn", out = {
+			"b boolean", "s int2", "i int4", "l int8", "f float4", "d float8",
+			"si int4", "il int8", "id float8", "fd float8", "t text"
+		}
+	)
+	public static ResultSetProvider primitiveUpdaters()
+	{
+		return new PrimitiveUpdaterTest();
+	}
+
+	private PrimitiveUpdaterTest() { }
+
+	@Override
+	public boolean assignRowValues(ResultSet out, long currentRow)
+	throws SQLException
+	{
+		switch ( (int)currentRow )
+		{
+		case 0:
+			out.updateBoolean(1, true);
+			out.updateShort(2, (short)1);
+			out.updateInt(3, 2);
+			out.updateLong(4, 3L);
+			out.updateFloat(5, 0.5f);
+			out.updateDouble(6, 0.25);
+			out.updateShort(7, (short)4);
+			out.updateInt(8, 5);
+			out.updateInt(9, 6);
+			out.updateFloat(10, 1.5f);
+			out.updateString(11, "a");
+			return true;
+		case 1:
+			out.updateBoolean(1, false);
+			out.updateInt(3, 99);
+			out.updateNull(3);
+			out.updateDouble(6, 1e300);
+			return true;
+		case 2:
+			out.updateShort(2, Short.MIN_VALUE);
+			out.updateInt(3, Integer.MAX_VALUE);
+			out.updateLong(4, Long.MAX_VALUE);
+			out.updateFloat(5, -2.5f);
+			out.updateDouble(6, 0.001);
+			out.updateShort(7, (short)-1);
+			out.updateInt(8, Integer.MIN_VALUE);
+			out.updateInt(9, -3);
+			out.updateFloat(10, -0.125f);
+			out.updateObject(11, "c");
+			return true;
+		default:
+			return false;
+		}
+	}
+
+	@Override
+	public void close()
+	{
+	}
+}
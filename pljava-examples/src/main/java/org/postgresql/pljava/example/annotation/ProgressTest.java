@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+package org.postgresql.pljava.example.annotation;
+
+import java.sql.Connection;
+import java.sql.DriverManager;
+import java.sql.ResultSet;
+import java.sql.SQLException;
+import java.sql.Statement;
+
+import org.postgresql.pljava.SessionManager;
+
+import org.postgresql.pljava.annotation.Function;
+import org.postgresql.pljava.annotation.SQLAction;
+
+/**
+ * Test that progress reported with {@code Session.reportProgress} is shown in
+ * the {@code sqlj.pljava_stat_progress} view while the reporting function
+ * runs, and is gone once it returns.
+ *<p>
+ * The view exists only from PostgreSQL 14, so the test is skipped without it.
+ * The backend status PostgreSQL shows is a snapshot kept until the end of the
+ * transaction, so it is cleared before each look.
+ */
+@SQLAction(requires = "progress_check fn", install =
+	"DO LANGUAGE plpgsql '" +
+	"DECLARE" +
+	" ok boolean;" +
+	"BEGIN" +
+	" IF pg_catalog.to_regclass(''sqlj.pljava_stat_progress'') IS NULL" +
+	" THEN" +
+	"  RETURN;" +
+	" END IF;" +
+
+	" ok := javatest.progress_check(3, 10);" +
+	" PERFORM pg_catalog.pg_stat_clear_snapshot();" +
+	" ok := ok AND NOT EXISTS (SELECT 1 FROM sqlj.pljava_stat_progress" +
+	"  WHERE pid OPERATOR(pg_catalog.=) pg_catalog.pg_backend_pid());" +
+	" PERFORM javatest.logmessage(" +
+	"  CASE WHEN ok THEN ''INFO'' ELSE ''WARNING'' END," +
+	"  CASE WHEN ok THEN ''pljava_stat_progress ok''" +
+	"  ELSE ''pljava_stat_progress ng'' END);" +
+	"END'"
+)
+public class ProgressTest
+{
+	private ProgressTest() { }
+
+	/**
+	 * Report {@code done} of {@code total}, and return whether this session's
+	 * row of {@code sqlj.pljava_stat_progress} then shows exactly that, for
+	 * this function.
+	 */
+	@Function(schema = "javatest", name = "progress_check",
+		provides = "progress_check fn")
+	public static boolean check(long done, long total) throws SQLException
+	{
+		SessionManager.current().reportProgress(done, total);
+
+		Connection c = DriverManager.getConnection("jdbc:default:connection");
+		try ( Statement s = c.createStatement() )
+		{
+			s.execute("SELECT pg_catalog.pg_stat_clear_snapshot()");
+			try ( ResultSet rs = s.executeQuery(
+				"SELECT done, total, funcid OPERATOR(pg_catalog.=) CAST(" +
+				"  'javatest.progress_check(bigint,bigint)'" +
+				"  AS pg_catalog.regprocedure)" +
+				" FROM sqlj.pljava_stat_progress" +
+				" WHERE pid OPERATOR(pg_catalog.=)" +
+				"  pg_catalog.pg_backend_pid()") )
+			{
+				if ( ! rs.next() )
+					return false;
+				return done == rs.getLong(1)  &&  total == rs.getLong(2)
+					&&  rs.getBoolean(3)  &&  ! rs.next();
+			}
+		}
+	}
+}
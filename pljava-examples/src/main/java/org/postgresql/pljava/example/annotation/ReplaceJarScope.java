@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+package org.postgresql.pljava.example.annotation;
+
+import java.io.ByteArrayOutputStream;
+import java.io.IOException;
+
+import static java.nio.charset.StandardCharsets.UTF_8;
+
+import java.sql.SQLException;
+
+import java.util.jar.JarEntry;
+import java.util.jar.JarOutputStream;
+
+import org.postgresql.pljava.annotation.Function;
+import org.postgresql.pljava.annotation.SQLAction;
+
+/**
+ * Test that {@code sqlj.replace_jar} discards the class loaders of only those
+ * schemas whose class path includes the replaced jar, and none at all when the
+ * jar's content has not changed.
+ *<p>
+ * Two small jars are installed, and two schemas given class paths that begin
+ * with one jar each and continue with the jar holding this class, so each can
+ * have a function using this class, loaded by its own schema loader. The
+ * function returns the identity of the loader that loaded it.
+ *<p>
+ * The unchanged replacement must also leave the jar's
+ * {@code sqlj.jar_repository} row as it was, as a new row version would make
+ * other sessions discard their loaders. Within one transaction the row's
+ * {@code xmin} would not show an update, so its {@code ctid} is compared.
+ */
+@SQLAction(requires = "replace_jar_scope fns", install = {
+	"SELECT sqlj.install_jar(" +
+	" javatest.replace_jar_scope_jar('1'), 'javatest_scope_a', false)",
+	"SELECT sqlj.install_jar(" +
+	" javatest.replace_jar_scope_jar('1'), 'javatest_scope_b', false)",
+
+	"CREATE SCHEMA javatest_scope_a",
+	"CREATE SCHEMA javatest_scope_b",
+
+	"SELECT sqlj.set_classpath(s, s || ':' || r.jarName)" +
+	" FROM" +
+	"  sqlj.jar_repository AS r" +
+	"  JOIN sqlj.jar_entry AS e ON e.jarId = r.jarId," +
+	"  (VALUES ('javatest_scope_a'), ('javatest_scope_b')) AS v(s)" +
+	" WHERE e.entryName =" +
+	"  'org/postgresql/pljava/example/annotation/ReplaceJarScope.class'",
+
+	"CREATE FUNCTION javatest_scope_a.loader_id() RETURNS integer" +
+	" LANGUAGE java AS" +
+	" 'org.postgresql.pljava.example.annotation.ReplaceJarScope.loaderId'",
+	"CREATE FUNCTION javatest_scope_b.loader_id() RETURNS integer" +
+	" LANGUAGE java AS" +
+	" 'org.postgresql.pljava.example.annotation.ReplaceJarScope.loaderId'",
+
+	"CREATE TEMPORARY TABLE replace_jar_scope AS SELECT" +
+	" javatest_scope_a.loader_id() AS a, javatest_scope_b.loader_id() AS b," +
+	" CAST(NULL AS pg_catalog.tid) AS t",
+
+	"SELECT sqlj.replace_jar(" +
+	" javatest.replace_jar_scope_jar('2'), 'javatest_scope_a', false)",
+
+	"SELECT" +
+	"  CASE WHEN a <> javatest_scope_a.loader_id()" +
+	"   AND b = javatest_scope_b.loader_id()" +
+	"  THEN javatest.logmessage('INFO', 'replace_jar scope ok')" +
+	"  ELSE javatest.logmessage('WARNING', 'replace_jar scope ng')" +
+	"  END" +
+	" FROM replace_jar_scope",
+
+	"UPDATE replace_jar_scope SET a = javatest_scope_a.loader_id()," +
+	" t = (SELECT ctid FROM sqlj.jar_repository" +
+	"  WHERE jarName = 'javatest_scope_a')",
+
+	"SELECT sqlj.replace_jar(" +
+	" javatest.replace_jar_scope_jar('2'), 'javatest_scope_a', false)",
+
+	"SELECT" +
+	"  CASE WHEN a = javatest_scope_a.loader_id()" +
+	"   AND b = javatest_scope_b.loader_id()" +
+	"   AND t = (SELECT ctid FROM sqlj.jar_repository" +
+	"    WHERE jarName = 'javatest_scope_a')" +
+	"  THEN javatest.logmessage('INFO', 'replace_jar unchanged ok')" +
+	"  ELSE javatest.logmessage('WARNING', 'replace_jar unchanged ng')" +
+	"  END" +
+	" FROM replace_jar_scope",
+
+	"DROP TABLE replace_jar_scope",
+	"SELECT sqlj.set_classpath('javatest_scope_a', '')",
+	"SELECT sqlj.set_classpath('javatest_scope_b', '')",
+	"DROP SCHEMA javatest_scope_a CASCADE",
+	"DROP SCHEMA javatest_scope_b CASCADE",
+	"SELECT sqlj.remove_jar('javatest_scope_a', false)",
+	"SELECT sqlj.remove_jar('javatest_scope_b', false)"
+})
+public class ReplaceJarScope
+{
+	private ReplaceJarScope() { }
+
+	/**
+	 * A jar holding one entry with the given content.
+	 */
+	@Function(schema = "javatest", name = "replace_jar_scope_jar",
+		provides = "replace_jar_scope fns")
+	public static byte[] jar(String content) throws SQLException
+	{
+		ByteArrayOutputStream bytes = new ByteArrayOutputStream();
+		try ( JarOutputStream jos = new JarOutputStream(bytes) )
+		{
+			jos.putNextEntry(new JarEntry("replace_jar_scope.txt"));
+			jos.write(content.getBytes(UTF_8));
+			jos.closeEntry();
+		}
+		catch ( IOException e )
+		{
+			throw new SQLException(e.getMessage(), "58030", e);
+		}
+		return bytes.toByteArray();
+	}
+
+	/**
+	 * The identity hash code of the class loader that loaded this class, for
+	 * the function created in each test schema.
+	 */
+	public static int loaderId()
+	{
+		return System.identityHashCode(ReplaceJarScope.class.getClassLoader());
+	}
+}
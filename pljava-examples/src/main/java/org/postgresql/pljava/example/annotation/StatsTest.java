@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+package org.postgresql.pljava.example.annotation;
+
+import java.sql.Connection;
+import java.sql.DriverManager;
+import java.sql.ResultSet;
+import java.sql.SQLException;
+import java.sql.Statement;
+
+import org.postgresql.pljava.annotation.Function;
+import org.postgresql.pljava.annotation.SQLAction;
+
+/**
+ * Test that the views {@code sqlj.pljava_stat_counters} and
+ * {@code sqlj.pljava_stat_functions} count SPI statements and function calls,
+ * and that {@code sqlj.pljava_stat_reset()} zeroes them.
+ *<p>
+ * The test is skipped where the statistics are not kept (before PostgreSQL 17,
+ * without PL/Java in {@code shared_preload_libraries}). Counting calls needs
+ * {@code track_functions}, and resetting needs the right to execute
+ * {@code pljava_stat_reset}, so those parts run only when the jar is deployed
+ * by a superuser.
+ */
+@SQLAction(requires = "stat_spi fn", install =
+	"DO LANGUAGE plpgsql '" +
+	"DECLARE" +
+	" c bigint;" +
+	" r timestamptz;" +
+	" ok boolean;" +
+	"BEGIN" +
+	" BEGIN" +
+	"  SELECT spi_statements, stats_reset INTO c, r" +
+	"  FROM sqlj.pljava_stat_counters;" +
+	" EXCEPTION WHEN object_not_in_prerequisite_state THEN" +
+	"  RETURN;" +
+	" END;" +
+
+	" PERFORM javatest.stat_spi(10);" +
+	" SELECT spi_statements OPERATOR(pg_catalog.>=) c + 10 INTO ok" +
+	" FROM sqlj.pljava_stat_counters;" +
+	" PERFORM javatest.logmessage(" +
+	"  CASE WHEN ok THEN ''INFO'' ELSE ''WARNING'' END," +
+	"  CASE WHEN ok THEN ''pljava_stat_counters ok''" +
+	"  ELSE ''pljava_stat_counters ng'' END);" +
+
+	" IF NOT (SELECT rolsuper FROM pg_catalog.pg_roles" +
+	"         WHERE rolname OPERATOR(pg_catalog.=) current_user)" +
+	" THEN" +
+	"  RETURN;" +
+	" END IF;" +
+
+	" PERFORM pg_catalog.set_config(''track_functions'', ''pl'', true);" +
+	" PERFORM javatest.stat_spi(0);" +
+	" PERFORM javatest.stat_spi(0);" +
+	" SELECT f.calls OPERATOR(pg_catalog.>=) 2 INTO ok" +
+	" FROM sqlj.pljava_stat_functions AS f" +
+	" WHERE f.datid OPERATOR(pg_catalog.=) (SELECT oid" +
+	"  FROM pg_catalog.pg_database" +
+	"  WHERE datname OPERATOR(pg_catalog.=) pg_catalog.current_database())" +
+	" AND f.funcid OPERATOR(pg_catalog.=)" +
+	"  CAST(''javatest.stat_spi(integer)'' AS pg_catalog.regprocedure);" +
+	" PERFORM javatest.logmessage(" +
+	"  CASE WHEN ok THEN ''INFO'' ELSE ''WARNING'' END," +
+	"  CASE WHEN ok THEN ''pljava_stat_functions ok''" +
+	"  ELSE ''pljava_stat_functions ng'' END);" +
+
+	" PERFORM sqlj.pljava_stat_reset();" +
+	" SELECT stats_reset OPERATOR(pg_catalog.>=) r" +
+	"  AND spi_statements OPERATOR(pg_catalog.<) 10" +
+	"  AND NOT EXISTS (SELECT 1 FROM sqlj.pljava_stat_functions AS f" +
+	"   WHERE f.funcid OPERATOR(pg_catalog.=)" +
+	"    CAST(''javatest.stat_spi(integer)'' AS pg_catalog.regprocedure))" +
+	" INTO ok" +
+	" FROM sqlj.pljava_stat_counters;" +
+	" PERFORM javatest.logmessage(" +
+	"  CASE WHEN ok THEN ''INFO'' ELSE ''WARNING'' END," +
+	"  CASE WHEN ok THEN ''pljava_stat_reset ok''" +
+	"  ELSE ''pljava_stat_reset ng'' END);" +
+	"END'"
+)
+public class StatsTest
+{
+	private StatsTest() { }
+
+	/**
+	 * Execute {@code n} trivial SPI statements.
+	 */
+	@Function(schema = "javatest", name = "stat_spi", provides = "stat_spi fn")
+	public static boolean statSpi(int n) throws SQLException
+	{
+		Connection c = DriverManager.getConnection("jdbc:default:connection");
+		try ( Statement s = c.createStatement() )
+		{
+			for ( int i = 0 ; i < n ; ++ i )
+			{
+				try ( ResultSet rs = s.executeQuery("SELECT 1") )
+				{
+					rs.next();
+				}
+			}
+		}
+		return true;
+	}
+}
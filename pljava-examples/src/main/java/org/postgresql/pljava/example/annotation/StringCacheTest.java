@@ -0,0 +1,89 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+package org.postgresql.pljava.example.annotation;
+
+import java.sql.Connection;
+import java.sql.DriverManager;
+import java.sql.PreparedStatement;
+import java.sql.ResultSet;
+import java.sql.SQLException;
+
+import org.postgresql.pljava.annotation.Function;
+import org.postgresql.pljava.annotation.SQLAction;
+
+/**
+ * Test that {@code pljava.string_cache_size} makes a short value read again
+ * yield the same {@code String} (a hit), while a long value, or a value seen
+ * after the cache is full, yields a new one (a miss), and that the values
+ * read are right either way.
+ */
+@SQLAction(requires = "string_cache_check fn", install =
+	"SELECT" +
+	"  CASE WHEN 'ttf' = javatest.string_cache_check(100)" +
+	"   AND 'tff' = javatest.string_cache_check(1)" +
+	"   AND 'fff' = javatest.string_cache_check(0)" +
+	"  THEN javatest.logmessage('INFO', 'string_cache_size ok')" +
+	"  ELSE javatest.logmessage('WARNING', 'string_cache_size ng')" +
+	"  END"
+)
+public class StringCacheTest
+{
+	private StringCacheTest() { }
+
+	/**
+	 * With {@code pljava.string_cache_size} set to {@code size} for the rest
+	 * of the transaction, read six values and return, as {@code t} or
+	 * {@code f} for each, whether the two reads of {@code ab}, the two of
+	 * {@code cd}, and the two of a 40-character value gave the same
+	 * {@code String}; or return null if any value read is wrong.
+	 */
+	@Function(schema = "javatest", name = "string_cache_check",
+		provides = "string_cache_check fn")
+	public static String check(int size) throws SQLException
+	{
+		Connection c = DriverManager.getConnection("jdbc:default:connection");
+		try ( PreparedStatement ps = c.prepareStatement(
+			"SELECT pg_catalog.set_config(" +
+			" 'pljava.string_cache_size', CAST(? AS pg_catalog.text), true)") )
+		{
+			ps.setInt(1, size);
+			ps.execute();
+		}
+
+		String[] v = new String [ 6 ];
+		String x = "xxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxxx";
+		try (
+			PreparedStatement ps = c.prepareStatement(
+				"SELECT v FROM (VALUES" +
+				" (1, CAST('ab' AS pg_catalog.text)), (2, 'cd'), (3, 'ab')," +
+				" (4, pg_catalog.repeat('x', 40))," +
+				" (5, pg_catalog.repeat('x', 40))," +
+				" (6, 'cd')) AS t(i, v) ORDER BY i");
+			ResultSet rs = ps.executeQuery();
+		)
+		{
+			for ( int i = 0 ; i < v.length ; ++ i )
+			{
+				rs.next();
+				v[i] = rs.getString(1);
+			}
+		}
+
+		if ( ! ( "ab".equals(v[0])  &&  "cd".equals(v[1])  &&  "ab".equals(v[2])
+			&&  x.equals(v[3])  &&  x.equals(v[4])  &&  "cd".equals(v[5]) ) )
+			return null;
+
+		return (v[0] == v[2] ? "t" : "f")
+			+ (v[1] == v[5] ? "t" : "f")
+			+ (v[3] == v[4] ? "t" : "f");
+	}
+}
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+package org.postgresql.pljava.example.annotation;
+
+import java.sql.Connection;
+import java.sql.DriverManager;
+import java.sql.ResultSet;
+import java.sql.SQLException;
+import java.sql.Statement;
+
+import java.time.LocalDate;
+
+import java.util.Objects;
+
+import org.postgresql.pljava.annotation.Function;
+import org.postgresql.pljava.annotation.SQLAction;
+
+/**
+ * Test that fixed-width values read from tuples in Java agree with
+ * PostgreSQL's own reading of them, as text, when they follow nulls, short and
+ * long (and compressed) varlena values, and when they are missing from tuples
+ * stored before their columns were added to the table.
+ *<p>
+ * The table is read with {@code SELECT *} so the tuples are copied as stored,
+ * with fewer attributes in the rows inserted before the {@code ALTER TABLE}.
+ */
+@SQLAction(requires = "tuple_deformer_check fn", install = {
+	"CREATE TEMPORARY TABLE tuple_deformer_check (" +
+	" i2 int2, s text, i4 int4, b boolean, f8 float8, i8 int8," +
+	" v varchar, f4 float4, d date)",
+
+	"INSERT INTO tuple_deformer_check VALUES" +
+	" (1, 'a', 2, true, 0.5, 3, 'x', 0.25, '2000-01-01')," +
+	" (NULL, repeat('y', 300), NULL, false, -2.25, NULL, NULL, NULL," +
+	"  '1999-12-31')," +
+	" (-7, NULL, 123456, NULL, 1e10, -9000000000, 'zz', -1.5, NULL)," +
+	" (32767, repeat('w', 5000), -1, true, NULL, 1, 'q', 2, '2024-02-29')",
+
+	"ALTER TABLE tuple_deformer_check" +
+	" ADD COLUMN m int4 DEFAULT 42, ADD COLUMN n int8",
+
+	"INSERT INTO tuple_deformer_check VALUES" +
+	" (5, 'b', 6, false, 1, 7, 'c', 8, '2026-10-18', 9, 10)",
+
+	"SELECT" +
+	"  CASE WHEN javatest.tuple_deformer_check()" +
+	"  THEN javatest.logmessage('INFO', 'TupleDeformer ok')" +
+	"  ELSE javatest.logmessage('WARNING', 'TupleDeformer ng')" +
+	"  END",
+
+	"DROP TABLE tuple_deformer_check"
+})
+public class TupleDeformerTest
+{
+	private TupleDeformerTest() { }
+
+	/**
+	 * The value expected in column {@code i} from its text.
+	 */
+	private static Object expected(int i, String t)
+	{
+		if ( null == t )
+			return null;
+		switch ( i )
+		{
+		case 1:  return Short.valueOf(t);
+		case 3:
+		case 10: return Integer.valueOf(t);
+		case 4:  return Boolean.valueOf(t);
+		case 5:  return Double.valueOf(t);
+		case 6:
+		case 11: return Long.valueOf(t);
+		case 8:  return Float.valueOf(t);
+		case 9:  return LocalDate.parse(t);
+		default: return t;
+		}
+	}
+
+	/**
+	 * Compare each value of the table, as read in Java, with the value parsed
+	 * from PostgreSQL's text for it.
+	 */
+	@Function(schema = "javatest", name = "tuple_deformer_check",
+		provides = "tuple_deformer_check fn")
+	public static boolean check() throws SQLException
+	{
+		Connection c = DriverManager.getConnection("jdbc:default:connection");
+		try (
+			Statement s1 = c.createStatement();
+			Statement s2 = c.createStatement();
+			ResultSet values = s1.executeQuery(
+				"SELECT * FROM tuple_deformer_check");
+			ResultSet texts = s2.executeQuery(
+				"SELECT CAST(i2 AS text), s, CAST(i4 AS text)," +
+				" CAST(b AS text), CAST(f8 AS text), CAST(i8 AS text), v," +
+				" CAST(f4 AS text), to_char(d, 'YYYY-MM-DD')," +
+				" CAST(m AS text), CAST(n AS text)" +
+				" FROM tuple_deformer_check");
+		)
+		{
+			int rows = 0;
+			while ( values.next() )
+			{
+				if ( ! texts.next() )
+					return false;
+				++ rows;
+				for ( int i = 1 ; i <= 11 ; ++ i )
+				{
+					Object v = 9 == i
+						? values.getObject(i, LocalDate.class)
+						: values.getObject(i);
+					if ( ! Objects.equals(v, expected(i, texts.getString(i))) )
+						return false;
+				}
+			}
+			return 5 == rows  &&  ! texts.next();
+		}
+	}
+}
@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+package org.postgresql.pljava.example.annotation;
+
+import java.sql.Connection;
+import java.sql.DriverManager;
+import java.sql.ResultSet;
+import java.sql.SQLException;
+import java.sql.Statement;
+
+import static java.sql.ResultSet.CONCUR_UPDATABLE;
+import static java.sql.ResultSet.TYPE_FORWARD_ONLY;
+
+import org.postgresql.pljava.annotation.Function;
+import org.postgresql.pljava.annotation.SQLAction;
+
+/**
+ * Test which queries give updatable result sets, and that rows updated,
+ * deleted, and inserted through one end up in the table.
+ *<p>
+ * A query is accepted when it selects only columns, under any names, from one
+ * ordinary table, with or without {@code ONLY}. It is refused when its select
+ * list has an expression or subquery, or it selects from a view or from a
+ * table with inheritance children, or has a join or an aggregate.
+ */
+@SQLAction(requires = "updatable_rs fns", install = {
+	"CREATE TEMPORARY TABLE updatable_check (" +
+	" id int4 PRIMARY KEY, t text, n int4 DEFAULT 7)",
+	"INSERT INTO updatable_check (id, t)" +
+	" VALUES (1, 'a'), (2, 'b'), (3, 'c'), (4, 'd')",
+	"CREATE TEMPORARY VIEW updatable_view AS" +
+	" SELECT id, t FROM updatable_check",
+	"CREATE TEMPORARY TABLE updatable_parent (id int4)",
+	"CREATE TEMPORARY TABLE updatable_child () INHERITS (updatable_parent)",
+
+	"SELECT" +
+	"  CASE WHEN" +
+	"   javatest.updatable_rs_accepts('SELECT * FROM updatable_check')" +
+	"  AND javatest.updatable_rs_accepts(" +
+	"   'SELECT id AS k, t FROM ONLY updatable_check AS u WHERE id > 1')" +
+	"  AND javatest.updatable_rs_accepts(" +
+	"   'SELECT u.t, u.id FROM updatable_check u ORDER BY id FOR UPDATE')" +
+	"  THEN javatest.logmessage('INFO', 'updatable ResultSet accepts ok')" +
+	"  ELSE javatest.logmessage('WARNING', 'updatable ResultSet accepts ng')" +
+	"  END",
+
+	"SELECT" +
+	"  CASE WHEN NOT (" +
+	"   javatest.updatable_rs_accepts(" +
+	"    'SELECT id, (SELECT 1) FROM updatable_check')" +
+	"   OR javatest.updatable_rs_accepts(" +
+	"    'SELECT id + 1 AS id FROM updatable_check')" +
+	"   OR javatest.updatable_rs_accepts('SELECT * FROM updatable_view')" +
+	"   OR javatest.updatable_rs_accepts('SELECT * FROM updatable_parent')" +
+	"   OR javatest.updatable_rs_accepts(" +
+	"    'SELECT count(*) FROM updatable_check')" +
+	"   OR javatest.updatable_rs_accepts(" +
+	"    'SELECT a.id FROM updatable_check a JOIN updatable_check b" +
+	"     USING (id)'))" +
+	"  THEN javatest.logmessage('INFO', 'updatable ResultSet refuses ok')" +
+	"  ELSE javatest.logmessage('WARNING', 'updatable ResultSet refuses ng')" +
+	"  END",
+
+	"SELECT" +
+	"  CASE WHEN '1a7,2b!7,4d!7,5e7' = javatest.updatable_rs_round_trip()" +
+	"  THEN javatest.logmessage('INFO', 'updatable ResultSet changes ok')" +
+	"  ELSE javatest.logmessage('WARNING', 'updatable ResultSet changes ng')" +
+	"  END",
+
+	"DROP TABLE updatable_child",
+	"DROP TABLE updatable_parent",
+	"DROP VIEW updatable_view",
+	"DROP TABLE updatable_check"
+})
+public class UpdatableResultSetTest
+{
+	private UpdatableResultSetTest() { }
+
+	/**
+	 * Whether a statement made for updatable result sets gives one for
+	 * {@code query}, without a warning.
+	 */
+	@Function(schema = "javatest", name = "updatable_rs_accepts",
+		provides = "updatable_rs fns")
+	public static boolean accepts(String query) throws SQLException
+	{
+		Connection c = DriverManager.getConnection("jdbc:default:connection");
+		try (
+			Statement s =
+				c.createStatement(TYPE_FORWARD_ONLY, CONCUR_UPDATABLE);
+			ResultSet rs = s.executeQuery(query);
+		)
+		{
+			return CONCUR_UPDATABLE == rs.getConcurrency()
+				&& null == s.getWarnings();
+		}
+	}
+
+	/**
+	 * Through an updatable result set, with a fetch size small enough that
+	 * changes are applied while it is read, delete row 3, append {@code !} to
+	 * the text of the even rows, and insert row 5 with the default for
+	 * {@code n}; then return the table's rows as text.
+	 */
+	@Function(schema = "javatest", name = "updatable_rs_round_trip",
+		provides = "updatable_rs fns")
+	public static String roundTrip() throws SQLException
+	{
+		Connection c = DriverManager.getConnection("jdbc:default:connection");
+		try (
+			Statement s = c.createStatement(TYPE_FORWARD_ONLY, CONCUR_UPDATABLE)
+		)
+		{
+			s.setFetchSize(2);
+			try ( ResultSet rs = s.executeQuery(
+				"SELECT id AS k, t AS label FROM updatable_check ORDER BY id") )
+			{
+				while ( rs.next() )
+				{
+					int k = rs.getInt(1);
+					if ( 3 == k )
+						rs.deleteRow();
+					else if ( 0 == k % 2 )
+					{
+						rs.updateString(2, rs.getString(2) + "!");
+						rs.updateRow();
+					}
+				}
+				rs.moveToInsertRow();
+				rs.updateInt(1, 5);
+				rs.updateString(2, "e");
+				rs.insertRow();
+				rs.moveToCurrentRow();
+			}
+		}
+
+		try (
+			Statement s = c.createStatement();
+			ResultSet rs = s.executeQuery(
+				"SELECT string_agg(id || t || n, ',' ORDER BY id)" +
+				" FROM updatable_check");
+		)
+		{
+			rs.next();
+			return rs.getString(1);
+		}
+	}
+}
@@ -0,0 +1,22 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+package org.postgresql.pljava.example.annotation;
+
+/**
+ * A Java enum to which the SQL enum type {@code weather} is mapped in the
+ * {@link Enumeration} example, its constants named as the labels of the SQL
+ * type.
+ */
+public enum Weather
+{
+	rainy, cloudy, sunny
+}
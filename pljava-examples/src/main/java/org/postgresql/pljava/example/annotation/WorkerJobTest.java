@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+package org.postgresql.pljava.example.annotation;
+
+import org.postgresql.pljava.annotation.SQLAction;
+
+/**
+ * Test submitting, checking on, and discarding a job with {@code sqlj.submit},
+ * {@code sqlj.job_result}, and {@code sqlj.discard_job}, and that functions
+ * that cannot be run as jobs are refused.
+ *<p>
+ * A job is only seen by the workers once the transaction that submitted it
+ * commits, and the examples are deployed in one transaction, so the job here
+ * is never run: it must still be pending when it is checked and discarded,
+ * and waiting for its result must be refused rather than never ending.
+ * With {@code pljava.worker_count} at its default of zero, the test only
+ * checks that submitting is refused.
+ */
+@SQLAction(install =
+	"DO LANGUAGE plpgsql '" +
+	"DECLARE" +
+	" h bigint;" +
+	" ok boolean := true;" +
+	"BEGIN" +
+	" BEGIN" +
+	"  h := sqlj.submit(''pg_catalog.upper(text)'', ARRAY[''x'']);" +
+	" EXCEPTION WHEN object_not_in_prerequisite_state THEN" +
+	"  ok := ''0'' OPERATOR(pg_catalog.=)" +
+	"   pg_catalog.current_setting(''pljava.worker_count'');" +
+	" END;" +
+
+	" IF h IS NOT NULL THEN" +
+	"  BEGIN" +
+	"   PERFORM sqlj.job_result(h, wait => false);" +
+	"   ok := false;" +
+	"  EXCEPTION WHEN object_not_in_prerequisite_state THEN" +
+	"   NULL;" +
+	"  END;" +
+	"  BEGIN" +
+	"   PERFORM sqlj.job_result(h);" +
+	"   ok := false;" +
+	"  EXCEPTION WHEN object_not_in_prerequisite_state THEN" +
+	"   NULL;" +
+	"  END;" +
+	"  BEGIN" +
+	"   PERFORM sqlj.submit(''pg_catalog.upper(text)'');" +
+	"   ok := false;" +
+	"  EXCEPTION WHEN invalid_parameter_value THEN" +
+	"   NULL;" +
+	"  END;" +
+	"  BEGIN" +
+	"   PERFORM sqlj.submit(" +
+	"    ''pg_catalog.generate_series(integer,integer)''," +
+	"    ARRAY[''1'', ''2'']);" +
+	"   ok := false;" +
+	"  EXCEPTION WHEN feature_not_supported THEN" +
+	"   NULL;" +
+	"  END;" +
+	"  ok := ok AND sqlj.discard_job(h);" +
+	"  BEGIN" +
+	"   PERFORM sqlj.job_result(h, wait => false);" +
+	"   ok := false;" +
+	"  EXCEPTION WHEN undefined_object THEN" +
+	"   NULL;" +
+	"  END;" +
+	" END IF;" +
+
+	" PERFORM javatest.logmessage(" +
+	"  CASE WHEN ok THEN ''INFO'' ELSE ''WARNING'' END," +
+	"  CASE WHEN ok THEN ''sqlj.submit ok'' ELSE ''sqlj.submit ng'' END);" +
+	"END'"
+)
+public class WorkerJobTest
+{
+	private WorkerJobTest() { }
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2020 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2015-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -75,9 +75,11 @@ import javax.sql.rowset.WebRowSet;
 import javax.sql.rowset.RowSetMetaDataImpl;
 
 import java.util.ArrayDeque;
+import java.util.Arrays;
 import java.util.Base64;
 import java.util.HashMap;
 import java.util.Iterator;
+import java.util.LinkedHashMap;
 import java.util.List;
 import java.util.ListIterator;
 import java.util.Map;
@@ -2182,6 +2184,240 @@ public class Node extends JarX {
 		}
 	}
 
+	/**
+	 * A workload for {@link #soak soak} that exercises the main paths through
+	 * PL/Java: set-returning functions, triggers, SPI, a base UDT, SQLXML, and
+	 * a Java exception caught as an SQL error. It uses functions from the
+	 * examples jar, which must be installed and on the class path of
+	 * {@code public} (as by
+	 * {@link #installExamplesAndPath installExamplesAndPath}), and can be
+	 * combined with other statements of interest.
+	 */
+	public static final List<String> SOAK_WORKLOAD = List.of(
+		"SELECT pg_catalog.count(*) FROM javatest.randomInts(100)",
+		"SELECT pg_catalog.count(*) FROM javatest.setReturnExample(1, 50)",
+		"SELECT pg_catalog.count(*) FROM javatest.executeSelect(" +
+		"'SELECT oid, relname FROM pg_catalog.pg_class LIMIT 50')",
+		"INSERT INTO javatest.username_test VALUES ('soak', '1')",
+		"DELETE FROM javatest.username_test WHERE name = 'soak'",
+		"SELECT CAST(CAST('(1,2)' AS javatest.complex) AS pg_catalog.text)",
+		"SELECT javatest.echoXMLParameter('<a>soak</a>', 1, 1)",
+		"DO LANGUAGE plpgsql 'BEGIN" +
+		" PERFORM javatest.java_getSystemProperty(NULL);" +
+		" EXCEPTION WHEN OTHERS THEN NULL; END'"
+	);
+
+	/**
+	 * Allowance for jitter in a sampled item counted in bytes, added to the
+	 * proportional allowance in {@link #soak soak}.
+	 */
+	private static final double SOAK_SLACK_BYTES = 1 << 20;
+
+	/**
+	 * Allowance for jitter in a sampled item that is a count.
+	 */
+	private static final double SOAK_SLACK_COUNT = 64;
+
+	/**
+	 * Runs a workload of statements over and over in one session, sampling
+	 * {@code sqlj.memory_report()} periodically, to catch memory or reference
+	 * leaks that only show as slow growth over many invocations.
+	 *<p>
+	 * Every statement in <em>workload</em> is executed once per iteration, and
+	 * its results (if any) read and discarded. Any {@code SQLException} fails
+	 * the run; a workload meant to exercise error paths should catch the error
+	 * in SQL, as the {@code DO} block in {@link #SOAK_WORKLOAD SOAK_WORKLOAD}
+	 * does. After every <em>sampleEvery</em> iterations, the memory report is
+	 * taken (after asking the JVM to collect garbage). The first sample, after
+	 * the warm-up of the first <em>sampleEvery</em> iterations, is the
+	 * baseline. The run fails as soon as a later sample shows an item grown
+	 * past its baseline by more than <em>tolerance</em> (a fraction of the
+	 * baseline) plus a small fixed allowance for jitter: a megabyte for items
+	 * in bytes, and 64 for counts.
+	 *<p>
+	 * Each sample is printed to standard output as it is taken. The reason for
+	 * a failure is passed to <em>reporter</em>, in the manner of
+	 * {@link #stateMachine stateMachine}, so the result can be combined with
+	 * others in a test script:
+	 *<pre>
+	 * succeeding &amp;= soak("soak", null, c, 1_000_000, 50_000, 0.10,
+	 *   SOAK_WORKLOAD);
+	 *</pre>
+	 * @param name A name for this run, used in the report of a failure
+	 * @param reporter a Consumer to accept a diagnostic string on failure,
+	 * defaulting if null to System.err::println
+	 * @param c the connection, whose one backend runs the whole workload
+	 * @param iterations how many times to run the workload
+	 * @param sampleEvery how many iterations between samples
+	 * @param tolerance growth allowed over the baseline, as a fraction of it
+	 * @param workload the statements to execute in each iteration
+	 * @return true if no item grew beyond the allowance and no statement
+	 * failed
+	 */
+	public static boolean soak(
+		String name, Consumer<String> reporter, Connection c,
+		long iterations, long sampleEvery, double tolerance,
+		List<String> workload)
+	throws Exception
+	{
+		if ( null == reporter )
+			reporter = System.err::println;
+
+		Map<String,Double> baseline = null;
+
+		try (
+			Statement s = c.createStatement();
+			PreparedStatement report = c.prepareStatement(
+				"SELECT item, value, unit FROM sqlj.memory_report(gc => true)")
+		)
+		{
+			for ( long i = 1 ; i <= iterations ; ++ i )
+			{
+				for ( String sql : workload )
+				{
+					try
+					{
+						for ( boolean isRS = s.execute(sql) ; ;
+							isRS = s.getMoreResults() )
+						{
+							if ( isRS )
+								try ( ResultSet rs = s.getResultSet() )
+								{
+									while ( rs.next() )
+										;
+								}
+							else if ( -1 == s.getUpdateCount() )
+								break;
+						}
+						s.clearWarnings();
+					}
+					catch ( SQLException e )
+					{
+						reporter.accept(String.format(
+							"soak \"%s\" at iteration %d: %s: %s",
+							name, i, sql, e));
+						return false;
+					}
+				}
+
+				if ( 0 != i % sampleEvery  &&  i != iterations )
+					continue;
+
+				Map<String,Double> sample = new LinkedHashMap<>();
+				Map<String,Double> slack = new HashMap<>();
+				try ( ResultSet rs = report.executeQuery() )
+				{
+					while ( rs.next() )
+					{
+						String item = rs.getString(1);
+						sample.put(item, rs.getDouble(2));
+						slack.put(item, "bytes".equals(rs.getString(3))
+							? SOAK_SLACK_BYTES : SOAK_SLACK_COUNT);
+					}
+				}
+				System.out.printf("soak \"%s\" iteration %d: %s%n",
+					name, i, sample);
+
+				if ( null == baseline )
+				{
+					baseline = sample;
+					continue;
+				}
+
+				for ( Map.Entry<String,Double> e : sample.entrySet() )
+				{
+					Double base = baseline.get(e.getKey());
+					if ( null == base )
+						continue;
+					double limit =
+						base + Math.abs(base) * tolerance +
+						slack.get(e.getKey());
+					if ( e.getValue() <= limit )
+						continue;
+					reporter.accept(String.format(
+						"soak \"%s\" at iteration %d: %s grew from %.0f " +
+						"to %.0f, beyond the allowed %.0f",
+						name, i, e.getKey(), base, e.getValue(), limit));
+					return false;
+				}
+			}
+		}
+		return true;
+	}
+
+	/**
+	 * A query for {@link #timeSetting timeSetting} that calls a simple
+	 * {@code int}-returning function from the examples jar many times, so its
+	 * time is mostly the cost of the calls themselves, as when comparing
+	 * {@code pljava.foreign_upcalls} {@code off} and {@code on}.
+	 */
+	public static final String CALL_BENCHMARK =
+		"SELECT pg_catalog.sum(javatest.java_addOne(g))" +
+		" FROM pg_catalog.generate_series(1, 100000) AS g";
+
+	/**
+	 * Times a query under each of several values of a setting, in one
+	 * session, and returns the median time of a run, in milliseconds, for
+	 * each value.
+	 *<p>
+	 * The values take turns, one run of the query under each in every round,
+	 * so a drift in the machine's speed over the whole time affects them
+	 * alike. A first round is run untimed, as warm-up. The setting is left
+	 * with the last of <em>values</em>.
+	 *<pre>
+	 * timeSetting(c, "pljava.foreign_upcalls", List.of("off", "on"),
+	 *   CALL_BENCHMARK, 20)
+	 *</pre>
+	 * @param c the connection
+	 * @param setting the name of the setting
+	 * @param values the values to compare
+	 * @param sql the query to time; its results are read and discarded
+	 * @param rounds how many timed runs under each value
+	 * @return a map from each value to its median milliseconds per run
+	 */
+	public static Map<String,Double> timeSetting(
+		Connection c, String setting, List<String> values, String sql,
+		int rounds)
+	throws Exception
+	{
+		double[][] millis = new double [ values.size() ] [ rounds ];
+
+		try (
+			Statement s = c.createStatement();
+			PreparedStatement set = c.prepareStatement(
+				"SELECT pg_catalog.set_config(?, ?, false)")
+		)
+		{
+			set.setString(1, setting);
+			for ( int round = -1 ; round < rounds ; ++ round )
+			{
+				for ( int v = 0 ; v < values.size() ; ++ v )
+				{
+					set.setString(2, values.get(v));
+					set.executeQuery().close();
+					long start = System.nanoTime();
+					try ( ResultSet rs = s.executeQuery(sql) )
+					{
+						while ( rs.next() )
+							;
+					}
+					if ( 0 <= round )
+						millis[v][round] = (System.nanoTime() - start) / 1e6;
+				}
+			}
+		}
+
+		Map<String,Double> medians = new LinkedHashMap<>();
+		for ( int v = 0 ; v < values.size() ; ++ v )
+		{
+			double[] m = millis[v];
+			Arrays.sort(m);
+			medians.put(values.get(v), 0 == rounds ? Double.NaN
+				: (m[(rounds - 1) / 2] + m[rounds / 2]) / 2);
+		}
+		return medians;
+	}
+
 	/**
 	 * Casts <em>o</em> to class <em>clazz</em>, testing it also for null.
 	 *<p>
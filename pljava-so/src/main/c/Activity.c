@@ -0,0 +1,318 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+#include <postgres.h>
+#include <miscadmin.h>
+#include <pgstat.h>
+#include <storage/proc.h>
+#if PG_VERSION_NUM >= 140000
+#include <catalog/pg_authid.h>
+#include <utils/acl.h>
+#include <utils/backend_progress.h>
+#include <utils/backend_status.h>
+#endif
+
+#include "org_postgresql_pljava_internal_Activity.h"
+#include "pljava/Activity.h"
+#include "pljava/Exception.h"
+#include "pljava/Function.h"
+#include "pljava/PgObject.h"
+
+#if PG_VERSION_NUM >= 140000
+/*
+ * The command PL/Java reports progress as. It is none of PostgreSQL's own
+ * ProgressCommandType values, so the pg_stat_progress_* views pass over it,
+ * and only sqlj.pljava_stat_get_progress() shows it. The target is the oid of
+ * the reporting function, and the first two parameters are the work done and
+ * the total.
+ */
+#define PLJAVA_PROGRESS_COMMAND ((ProgressCommandType)0x504A)
+
+/*
+ * The invocation that began the progress now shown, or NULL.
+ */
+static Invocation *s_progressInvocation;
+#endif
+
+#if PG_VERSION_NUM >= 170000
+static const char * const s_waitEventNames[PLJAVA_WAIT_EVENTS] =
+{
+	"PLJavaJVMStartup",
+	"PLJavaClassLoad",
+	"PLJavaThreadLock",
+	"PLJavaDualStateCleanup"
+};
+
+/*
+ * The ids PostgreSQL assigned to the names, by
+ * pljava_Activity_registerWaitEvents; zero until then.
+ */
+static uint32 s_waitEvents[PLJAVA_WAIT_EVENTS];
+#endif
+
+void pljava_Activity_registerWaitEvents(void)
+{
+#if PG_VERSION_NUM >= 170000
+	int i;
+
+	for ( i = 0 ; i < PLJAVA_WAIT_EVENTS ; ++ i )
+		if ( 0 == s_waitEvents[i] )
+			s_waitEvents[i] = WaitEventExtensionNew(s_waitEventNames[i]);
+#endif
+}
+
+void pljava_Activity_initialize(void)
+{
+	JNINativeMethod methods[] =
+	{
+		{
+		"_waitStart",
+		"(I)I",
+		Java_org_postgresql_pljava_internal_Activity__1waitStart
+		},
+		{
+		"_waitEnd",
+		"(I)V",
+		Java_org_postgresql_pljava_internal_Activity__1waitEnd
+		},
+		{
+		"_reportProgress",
+		"(JJ)V",
+		Java_org_postgresql_pljava_internal_Activity__1reportProgress
+		},
+		{
+		"_progress",
+		"()[J",
+		Java_org_postgresql_pljava_internal_Activity__1progress
+		},
+		{ 0, 0, 0 }
+	};
+	jclass cls;
+
+	StaticAssertStmt(org_postgresql_pljava_internal_Activity_WAIT_JVM_STARTUP
+		== PLJAVA_WAIT_JVM_STARTUP, "Activity.java wait events mismatch");
+	StaticAssertStmt(org_postgresql_pljava_internal_Activity_WAIT_CLASS_LOAD
+		== PLJAVA_WAIT_CLASS_LOAD, "Activity.java wait events mismatch");
+	StaticAssertStmt(org_postgresql_pljava_internal_Activity_WAIT_THREAD_LOCK
+		== PLJAVA_WAIT_THREAD_LOCK, "Activity.java wait events mismatch");
+	StaticAssertStmt(
+		org_postgresql_pljava_internal_Activity_WAIT_DUALSTATE_CLEANUP
+		== PLJAVA_WAIT_DUALSTATE_CLEANUP, "Activity.java wait events mismatch");
+
+	cls = PgObject_getJavaClass("org/postgresql/pljava/internal/Activity");
+	PgObject_registerNatives2(cls, methods);
+	JNI_deleteLocalRef(cls);
+}
+
+#if PG_VERSION_NUM >= 100000
+static inline uint32 currentWaitEvent(void)
+{
+#if PG_VERSION_NUM >= 140000
+	return *my_wait_event_info;
+#else
+	return NULL == MyProc ? 0 : MyProc->wait_event_info;
+#endif
+}
+#endif
+
+uint32 pljava_Activity_waitStart(PLJavaWaitEvent event)
+{
+#if PG_VERSION_NUM >= 100000
+	uint32 prior = currentWaitEvent();
+#if PG_VERSION_NUM >= 170000
+	pgstat_report_wait_start(0 != s_waitEvents[event]
+		? s_waitEvents[event] : PG_WAIT_EXTENSION);
+#else
+	pgstat_report_wait_start(PG_WAIT_EXTENSION);
+#endif
+	return prior;
+#else
+	return 0;
+#endif
+}
+
+void pljava_Activity_waitEnd(uint32 prior)
+{
+#if PG_VERSION_NUM >= 100000
+	if ( 0 == prior )
+		pgstat_report_wait_end();
+	else
+		pgstat_report_wait_start(prior);
+#endif
+}
+
+#if PG_VERSION_NUM >= 140000
+static void reportProgress(int64 done, int64 total)
+{
+	Invocation *ctx = currentInvocation;
+	const int index[] = { 0, 1 };
+	int64 values[2];
+
+	if ( NULL == MyBEEntry  ||  NULL == ctx  ||  0 == ctx->function )
+		return;
+
+	if ( NULL != s_progressInvocation  &&  ctx != s_progressInvocation )
+		return; /* a function nested in the one whose progress is shown */
+
+	if ( PLJAVA_PROGRESS_COMMAND != MyBEEntry->st_progress_command )
+	{
+		if ( PROGRESS_COMMAND_INVALID != MyBEEntry->st_progress_command )
+			return; /* progress of some command is already shown */
+		pgstat_progress_start_command(PLJAVA_PROGRESS_COMMAND,
+			pljava_Function_oid(ctx->function));
+		s_progressInvocation = ctx;
+	}
+
+	values[0] = done;
+	values[1] = total;
+	pgstat_progress_update_multi_param(2, index, values);
+}
+#endif
+
+void pljava_Activity_invocationExit(Invocation *ctx)
+{
+#if PG_VERSION_NUM >= 140000
+	if ( ctx != s_progressInvocation )
+		return;
+	s_progressInvocation = NULL;
+	if ( NULL != MyBEEntry
+		&&  PLJAVA_PROGRESS_COMMAND == MyBEEntry->st_progress_command )
+		pgstat_progress_end_command();
+#endif
+}
+
+/*
+ * Class:     org_postgresql_pljava_internal_Activity
+ * Method:    _waitStart
+ * Signature: (I)I
+ */
+JNIEXPORT jint JNICALL
+Java_org_postgresql_pljava_internal_Activity__1waitStart(
+	JNIEnv *env, jclass cls, jint event)
+{
+	jint result = 0;
+
+	if ( 0 > event  ||  PLJAVA_WAIT_EVENTS <= event )
+		return 0;
+
+	BEGIN_NATIVE_NO_ERRCHECK
+	result = (jint)pljava_Activity_waitStart((PLJavaWaitEvent)event);
+	END_NATIVE
+
+	return result;
+}
+
+/*
+ * Class:     org_postgresql_pljava_internal_Activity
+ * Method:    _waitEnd
+ * Signature: (I)V
+ */
+JNIEXPORT void JNICALL
+Java_org_postgresql_pljava_internal_Activity__1waitEnd(
+	JNIEnv *env, jclass cls, jint prior)
+{
+	BEGIN_NATIVE_NO_ERRCHECK
+	pljava_Activity_waitEnd((uint32)prior);
+	END_NATIVE
+}
+
+/*
+ * Class:     org_postgresql_pljava_internal_Activity
+ * Method:    _reportProgress
+ * Signature: (JJ)V
+ *
+ * Show the progress of the innermost PL/Java function, unless the progress of
+ * some other command is being shown, or of a PL/Java function that called
+ * this one.
+ */
+JNIEXPORT void JNICALL
+Java_org_postgresql_pljava_internal_Activity__1reportProgress(
+	JNIEnv *env, jclass cls, jlong done, jlong total)
+{
+#if PG_VERSION_NUM >= 140000
+	BEGIN_NATIVE
+	PG_TRY();
+	{
+		reportProgress(done, total);
+	}
+	PG_CATCH();
+	{
+		Exception_throw_ERROR("pljava_Activity_reportProgress");
+	}
+	PG_END_TRY();
+	END_NATIVE
+#endif
+}
+
+/*
+ * Class:     org_postgresql_pljava_internal_Activity
+ * Method:    _progress
+ * Signature: ()[J
+ *
+ * For each backend showing progress of a PL/Java function that the current
+ * role may see, the process id, database oid, function oid, work done, and
+ * total; NULL before PostgreSQL 14.
+ */
+JNIEXPORT jlongArray JNICALL
+Java_org_postgresql_pljava_internal_Activity__1progress(JNIEnv *env, jclass cls)
+{
+	jlongArray result = NULL;
+
+#if PG_VERSION_NUM >= 140000
+	BEGIN_NATIVE
+	PG_TRY();
+	{
+		int n = pgstat_fetch_stat_numbackends();
+		jlong *buf = palloc((n + 1) * 5 * sizeof (jlong));
+		jsize len = 0;
+		int i;
+
+		for ( i = 1 ; i <= n ; ++ i )
+		{
+			PgBackendStatus *be;
+			/*
+			 * pgstat_get_local_beentry_by_index appeared in 16.1, not 16.0.
+			 */
+			LocalPgBackendStatus *local =
+#if PG_VERSION_NUM >= 160001
+				pgstat_get_local_beentry_by_index(i);
+#else
+				pgstat_fetch_stat_local_beentry(i);
+#endif
+			if ( NULL == local )
+				continue;
+			be = &local->backendStatus;
+			if ( PLJAVA_PROGRESS_COMMAND != be->st_progress_command )
+				continue;
+			if ( ! has_privs_of_role(GetUserId(), be->st_userid)
+				&&  ! has_privs_of_role(GetUserId(), ROLE_PG_READ_ALL_STATS) )
+				continue;
+			buf[len++] = be->st_procpid;
+			buf[len++] = be->st_databaseid;
+			buf[len++] = be->st_progress_command_target;
+			buf[len++] = be->st_progress_param[0];
+			buf[len++] = be->st_progress_param[1];
+		}
+
+		result = JNI_newLongArray(len);
+		JNI_setLongArrayRegion(result, 0, len, buf);
+		pfree(buf);
+	}
+	PG_CATCH();
+	{
+		Exception_throw_ERROR("pljava_Activity_progress");
+	}
+	PG_END_TRY();
+	END_NATIVE
+#endif
+
+	return result;
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2022 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -22,6 +22,8 @@
 #include <utils/guc.h>
 #include <fmgr.h>
 #include <access/heapam.h>
+#include <access/reloptions.h>
+#include <access/xact.h>
 #include <utils/syscache.h>
 #include <catalog/catalog.h>
 #include <catalog/pg_proc.h>
@@ -39,6 +41,7 @@
  #include <dynloader.h>
 #endif
 
+#include <portability/instr_time.h>
 #include <storage/ipc.h>
 #include <storage/proc.h>
 #include <stdio.h>
@@ -50,13 +53,22 @@
 #include "pljava/DualState.h"
 #include "pljava/Invocation.h"
 #include "pljava/InstallHelper.h"
+#include "pljava/LogicalDecoding.h"
 #include "pljava/Function.h"
 #include "pljava/HashMap.h"
 #include "pljava/Exception.h"
+#include "pljava/ForeignDowncalls.h"
+#include "pljava/ForeignScan.h"
+#include "pljava/GiST.h"
+#include "pljava/Stats.h"
+#include "pljava/Activity.h"
+#include "pljava/OrderedSet.h"
 #include "pljava/Backend.h"
 #include "pljava/Session.h"
 #include "pljava/SPI.h"
+#include "pljava/Worker.h"
 #include "pljava/type/String.h"
+#include "pljava/type/Type.h"
 
 #if PG_VERSION_NUM >= 90300
 #include "utils/timeout.h"
@@ -119,9 +131,16 @@ static char* modulepath;
 static char* implementors;
 static char* policy_urls;
 static int   statementCacheSize;
+static int   computePoolSize;
 static bool  pljavaDebug;
 static bool  pljavaReleaseLingeringSavepoints;
 static bool  pljavaEnabled;
+bool         pljavaLazyRowConversion; /* declared in Backend.h */
+bool         pljavaForeignUpcalls; /* declared in Backend.h */
+bool         pljavaForeignDowncalls; /* declared in Backend.h */
+int          pljavaStringCacheSize; /* declared in Backend.h */
+int          pljavaCpuBudget; /* declared in Backend.h */
+int          pljavaAllocationBudget; /* declared in Backend.h */
 
 static int   java_thread_pg_entry;
 
@@ -201,6 +220,48 @@ enum initstage
 };
 
 static enum initstage initstage = IS_FORMLESS_VOID;
+
+/*
+ * Elapsed (monotonic) time spent completing each stage of the initsequencer,
+ * indexed by the stage being left. A stage may be visited more than once (a
+ * deferred or failed initialization resumed later), so times accumulate.
+ * Reported at DEBUG1 on completion, and to Java by Backend._startupTimings.
+ */
+static instr_time s_initStageMark;
+static double s_initStageMillis[IS_COMPLETE];
+static char const * const s_initStageNames[IS_COMPLETE] =
+{
+	"registering GUCs",
+	"checking pljava.libjvm_location",
+	"checking pljava.policy_urls",
+	"checking pljava.enable",
+	"loading libjvm",
+	"finding JNI_CreateJavaVM",
+	"one-time native setup",
+	"building JVM options and module path",
+	"creating the JVM",
+	"installing signal handlers",
+	"loading PL/Java classes and natives",
+	"PL/Java greeting (properties, policy)",
+	"installing sqlj schema (groundwork)"
+};
+
+static inline void advanceInitStage(enum initstage next)
+{
+	instr_time now;
+
+	INSTR_TIME_SET_CURRENT(now);
+	if ( initstage < IS_COMPLETE )
+	{
+		instr_time elapsed = now;
+		INSTR_TIME_SUBTRACT(elapsed, s_initStageMark);
+		s_initStageMillis[initstage] += INSTR_TIME_GET_MILLISEC(elapsed);
+	}
+	s_initStageMark = now;
+	initstage = next;
+}
+
+static double reportInitStageTimes(void);
 static void *libjvm_handle;
 static bool jvmStartedAtLeastOnce = false;
 static bool alteredSettingsWereNeeded = false;
@@ -546,12 +607,15 @@ static void initsequencer(enum initstage is, bool tolerant)
 	Invocation ctx;
 	jint JNIresult;
 	char *greeting;
+	uint32 priorWait;
+
+	INSTR_TIME_SET_CURRENT(s_initStageMark);
 
 	switch (is)
 	{
 	case IS_FORMLESS_VOID:
 		registerGUCOptions();
-		initstage = IS_GUCS_REGISTERED;
+		advanceInitStage(IS_GUCS_REGISTERED);
 		if ( deferInit )
 			return;
 		warnJEP411 = false;
@@ -567,7 +631,7 @@ static void initsequencer(enum initstage is, bool tolerant)
 						"path to the jvm library (libjvm.so or jvm.dll, etc.)")));
 			goto check_tolerant;
 		}
-		initstage = IS_CAND_JVMLOCATION;
+		advanceInitStage(IS_CAND_JVMLOCATION);
 		/*FALLTHROUGH*/
 
 	case IS_CAND_JVMLOCATION:
@@ -580,7 +644,7 @@ static void initsequencer(enum initstage is, bool tolerant)
 						"files PL/Java is to use.")));
 			goto check_tolerant;
 		}
-		initstage = IS_CAND_POLICYURLS;
+		advanceInitStage(IS_CAND_POLICYURLS);
 		/*FALLTHROUGH*/
 
 	case IS_CAND_POLICYURLS:
@@ -595,7 +659,7 @@ static void initsequencer(enum initstage is, bool tolerant)
 					"\"on\" to proceed.")));
 			goto check_tolerant;
 		}
-		initstage = IS_PLJAVA_ENABLED;
+		advanceInitStage(IS_PLJAVA_ENABLED);
 		/*FALLTHROUGH*/
 
 	case IS_PLJAVA_ENABLED:
@@ -609,7 +673,7 @@ static void initsequencer(enum initstage is, bool tolerant)
 						"path to the jvm library (libjvm.so or jvm.dll, etc.)")));
 			goto check_tolerant;
 		}
-		initstage = IS_CAND_JVMOPENED;
+		advanceInitStage(IS_CAND_JVMOPENED);
 		/*FALLTHROUGH*/
 
 	case IS_CAND_JVMOPENED:
@@ -633,7 +697,7 @@ static void initsequencer(enum initstage is, bool tolerant)
 						"the right one?")));
 			goto check_tolerant;
 		}
-		initstage = IS_CREATEVM_SYM_FOUND;
+		advanceInitStage(IS_CREATEVM_SYM_FOUND);
 		/*FALLTHROUGH*/
 
 	case IS_CREATEVM_SYM_FOUND:
@@ -647,7 +711,7 @@ static void initsequencer(enum initstage is, bool tolerant)
 		 */
 		pljavaDebug = 1;
 #endif
-		initstage = IS_MISC_ONCE_DONE;
+		advanceInitStage(IS_MISC_ONCE_DONE);
 		/*FALLTHROUGH*/
 
 	case IS_MISC_ONCE_DONE:
@@ -669,17 +733,20 @@ static void initsequencer(enum initstage is, bool tolerant)
 		{
 			JVMOptList_add(&optList, effectiveModulePath, 0, true);
 		}
-		initstage = IS_JAVAVM_OPTLIST;
+		advanceInitStage(IS_JAVAVM_OPTLIST);
 		/*FALLTHROUGH*/
 
 	case IS_JAVAVM_OPTLIST:
+		pljava_Activity_registerWaitEvents();
 		/* Register an on_proc_exit handler that destroys the VM if it has
 		 * been started. It will also log a last-ditch message if the VM happens
 		 * to rudely call exit() rather than returning a non-OK result.
 		 */
 		on_proc_exit(_destroyJavaVM, 0);
 		s_startingVM = true;
+		priorWait = pljava_Activity_waitStart(PLJAVA_WAIT_JVM_STARTUP);
 		JNIresult = initializeJavaVM(&optList); /* frees the optList */
+		pljava_Activity_waitEnd(priorWait);
 		s_startingVM = false;
 		if( JNI_OK != JNIresult )
 		{
@@ -700,7 +767,7 @@ static void initsequencer(enum initstage is, bool tolerant)
 		}
 		jvmStartedAtLeastOnce = true;
 		elog(DEBUG2, "successfully created Java virtual machine");
-		initstage = IS_JAVAVM_STARTED;
+		advanceInitStage(IS_JAVAVM_STARTED);
 		/*FALLTHROUGH*/
 
 	case IS_JAVAVM_STARTED:
@@ -709,17 +776,18 @@ static void initsequencer(enum initstage is, bool tolerant)
 		pqsignal(SIGTERM, pljavaDieHandler);
 		pqsignal(SIGQUIT, pljavaQuickDieHandler);
 #endif
-		initstage = IS_SIGHANDLERS;
+		advanceInitStage(IS_SIGHANDLERS);
 		/*FALLTHROUGH*/
 
 	case IS_SIGHANDLERS:
+		priorWait = pljava_Activity_waitStart(PLJAVA_WAIT_JVM_STARTUP);
 		Invocation_pushBootContext(&ctx);
 		PG_TRY();
 		{
 			initPLJavaClasses();
 			initJavaSession();
 			Invocation_popBootContext();
-			initstage = IS_PLJAVA_FOUND;
+			advanceInitStage(IS_PLJAVA_FOUND);
 		}
 		PG_CATCH();
 		{
@@ -744,6 +812,7 @@ static void initsequencer(enum initstage is, bool tolerant)
 			}
 		}
 		PG_END_TRY();
+		pljava_Activity_waitEnd(priorWait);
 		if ( IS_PLJAVA_FOUND != initstage )
 		{
 			/* JVM initialization failed for some reason. Destroy
@@ -769,7 +838,7 @@ static void initsequencer(enum initstage is, bool tolerant)
 				errmsg("PL/Java loaded"),
 				errdetail("versions:\n%s", greeting)));
 		pfree(greeting);
-		initstage = IS_PLJAVA_INSTALLING;
+		advanceInitStage(IS_PLJAVA_INSTALLING);
 		/*FALLTHROUGH*/
 
 	case IS_PLJAVA_INSTALLING:
@@ -778,7 +847,8 @@ static void initsequencer(enum initstage is, bool tolerant)
 			warnJEP411 = javaGT11;
 			InstallHelper_groundwork(); /* sqlj schema, language handlers, ...*/
 		}
-		initstage = IS_COMPLETE;
+		advanceInitStage(IS_COMPLETE);
+		pljava_Stats_jvmStarted(reportInitStageTimes());
 		/*FALLTHROUGH*/
 
 	case IS_COMPLETE:
@@ -980,13 +1050,46 @@ void _PG_init()
 			"PL/Java cannot determine the path separator this platform uses");
 	s_path_var_sep = *sep;
 
-	if ( InstallHelper_shouldDeferInit() )
+	/*
+	 * Loaded by shared_preload_libraries, in the postmaster: reserve the shared
+	 * statistics area if that must be done now, and start no JVM here; each
+	 * backend will start its own when first needed.
+	 */
+	if ( process_shared_preload_libraries_in_progress )
+	{
+		pljava_Stats_preload();
+		deferInit = true;
+	}
+	else if ( InstallHelper_shouldDeferInit() )
 		deferInit = true;
 	else
 		pljavaCheckExtension( NULL);
 	initsequencer( initstage, true);
 }
 
+/*
+ * One DEBUG1 line with the time taken by each initsequencer stage, so a slow
+ * first call can be attributed to libjvm loading, JVM creation, class loading,
+ * policy setup, and so on. Returns the total.
+ */
+static double reportInitStageTimes(void)
+{
+	StringInfoData buf;
+	double total = 0.;
+	int i;
+
+	initStringInfo(&buf);
+	for ( i = 0 ; i < IS_COMPLETE ; ++ i )
+	{
+		total += s_initStageMillis[i];
+		appendStringInfo(&buf, "%s%s: %.3f ms",
+			0 == i ? "" : "; ", s_initStageNames[i], s_initStageMillis[i]);
+	}
+	elog(DEBUG1, "PL/Java startup took %.3f ms: %s", total, buf.data);
+	pfree(buf.data);
+	return total;
+}
+
 static void initPLJavaClasses(void)
 {
 	jfieldID fID;
@@ -1014,6 +1117,16 @@ static void initPLJavaClasses(void)
 		Java_org_postgresql_pljava_internal_Backend__1getStatementCacheSize
 		},
 		{
+		"_getComputePoolSize",
+		"()I",
+		Java_org_postgresql_pljava_internal_Backend__1getComputePoolSize
+		},
+		{
+		"isInterruptPending",
+		"()Z",
+		Java_org_postgresql_pljava_internal_Backend_isInterruptPending
+		},
+		{
 		"_log",
 		"(ILjava/lang/String;)V",
 		Java_org_postgresql_pljava_internal_Backend__1log
@@ -1024,11 +1137,36 @@ static void initPLJavaClasses(void)
 		Java_org_postgresql_pljava_internal_Backend__1clearFunctionCache
 		},
 		{
+		"_clearFunctionCacheFor",
+		"([Ljava/lang/ClassLoader;)V",
+		Java_org_postgresql_pljava_internal_Backend__1clearFunctionCacheFor
+		},
+		{
+		"_invalidateLoaders",
+		"()V",
+		Java_org_postgresql_pljava_internal_Backend__1invalidateLoaders
+		},
+		{
 		"_isCreatingExtension",
 		"()Z",
 		Java_org_postgresql_pljava_internal_Backend__1isCreatingExtension
 		},
 		{
+		"_getWorkerCount",
+		"()I",
+		Java_org_postgresql_pljava_internal_Backend__1getWorkerCount
+		},
+		{
+		"_launchWorkers",
+		"(Ljava/lang/String;I)I",
+		Java_org_postgresql_pljava_internal_Backend__1launchWorkers
+		},
+		{
+		"_isCurrentTransaction",
+		"(J)Z",
+		Java_org_postgresql_pljava_internal_Backend__1isCurrentTransaction
+		},
+		{
 		"_myLibraryPath",
 		"()Ljava/lang/String;",
 		Java_org_postgresql_pljava_internal_Backend__1myLibraryPath
@@ -1038,6 +1176,21 @@ static void initPLJavaClasses(void)
 		"(Ljava/lang/Class;Ljava/lang/Object;)V",
 		Java_org_postgresql_pljava_internal_Backend__1pokeJEP411
 		},
+		{
+		"_startupStageNames",
+		"()[Ljava/lang/String;",
+		Java_org_postgresql_pljava_internal_Backend__1startupStageNames
+		},
+		{
+		"_startupTimings",
+		"()[D",
+		Java_org_postgresql_pljava_internal_Backend__1startupTimings
+		},
+		{
+		"_memoryReport",
+		"()[D",
+		Java_org_postgresql_pljava_internal_Backend__1memoryReport
+		},
 		{ 0, 0, 0 }
 	};
 
@@ -1097,6 +1250,13 @@ static void initPLJavaClasses(void)
 	SQLInputFromChunk_initialize();
 	SQLOutputToChunk_initialize();
 	SQLOutputToTuple_initialize();
+	pljava_ForeignScan_initialize();
+	pljava_ForeignDowncalls_initialize();
+	pljava_LogicalDecoding_initialize();
+	pljava_OrderedSet_initialize();
+	pljava_GiST_initialize();
+	pljava_Stats_initialize();
+	pljava_Activity_initialize();
 
 	InstallHelper_initialize();
 }
@@ -1814,6 +1974,135 @@ static void registerGUCOptions(void)
 		NULL, /* check hook */
 		NULL, NULL); /* assign hook, show hook */
 
+	INT_GUC(
+		"pljava.string_cache_size",
+		"Number of short values whose Java Strings are remembered for reuse",
+		"When nonzero, a value of up to 32 bytes converted to a Java String "
+		"is remembered, and the same String is returned when the same value "
+		"is seen again, until this many values have been remembered. The "
+		"values are forgotten when each batch of rows is fetched and when "
+		"the outermost PL/Java function returns. Useful when reading columns "
+		"with few distinct values. Zero (the default) disables it.",
+		&pljavaStringCacheSize,
+		0,    /* boot value */
+		0, 65536, /* min, max values */
+		PGC_USERSET,
+		0,    /* flags */
+		NULL, /* check hook */
+		NULL, NULL); /* assign hook, show hook */
+
+	INT_GUC(
+		"pljava.compute_pool_size",
+		"Number of worker threads in the per-backend PL/Java compute pool",
+		"The pool is created on first use, and its size is fixed from then "
+		"on in the session. If zero, tasks submitted to the pool run on the "
+		"submitting thread.",
+		&computePoolSize,
+		0,    /* boot value */
+		0, 256,   /* min, max values */
+		PGC_SUSET,
+		0,    /* flags */
+		NULL, /* check hook */
+		NULL, NULL); /* assign hook, show hook */
+
+	INT_GUC(
+		"pljava.cpu_budget",
+		"CPU time one call of a PL/Java function may use",
+		"A call that uses more fails with SQLSTATE 57014. Set per role or "
+		"per function (with ALTER ROLE or ALTER FUNCTION ... SET) to limit "
+		"particular code. Zero (the default) sets no limit.",
+		&pljavaCpuBudget,
+		0,    /* boot value */
+		0, INT_MAX,   /* min, max values */
+		PGC_SUSET,
+		GUC_UNIT_MS,    /* flags */
+		NULL, /* check hook */
+		NULL, NULL); /* assign hook, show hook */
+
+	INT_GUC(
+		"pljava.allocation_budget",
+		"Java heap memory one call of a PL/Java function may allocate",
+		"Counts all bytes the call allocates, whether or not they remain "
+		"in use. A call that allocates more fails with SQLSTATE 54000. Set "
+		"per role or per function (with ALTER ROLE or ALTER FUNCTION ... "
+		"SET) to limit particular code. Zero (the default) sets no limit.",
+		&pljavaAllocationBudget,
+		0,    /* boot value */
+		0, INT_MAX,   /* min, max values */
+		PGC_SUSET,
+		GUC_UNIT_KB,    /* flags */
+		NULL, /* check hook */
+		NULL, NULL); /* assign hook, show hook */
+
+	INT_GUC(
+		"pljava.worker_count",
+		"Number of PL/Java background workers per database to run jobs "
+		"submitted with sqlj.submit",
+		"Workers are started in a database, up to this number, when a job "
+		"is submitted there. A worker exits if it finds this many older "
+		"workers in its database. If zero, jobs cannot be submitted.",
+		&pljava_workerCount,
+		0,    /* boot value */
+		0, 64,    /* min, max values */
+		PGC_SIGHUP,
+		0,    /* flags */
+		NULL, /* check hook */
+		NULL, NULL); /* assign hook, show hook */
+
+	INT_GUC(
+		"pljava.worker_naptime",
+		"How long an idle PL/Java background worker waits before checking "
+		"again for submitted jobs",
+		NULL, /* extended description */
+		&pljava_workerNaptime,
+		1000, /* boot value */
+		10, 3600000,  /* min, max values */
+		PGC_SIGHUP,
+		GUC_UNIT_MS,    /* flags */
+		NULL, /* check hook */
+		NULL, NULL); /* assign hook, show hook */
+
+	BOOL_GUC(
+		"pljava.lazy_row_conversion",
+		"If true, rows fetched from an SPI cursor are converted for Java "
+		"one at a time, as they are reached",
+		"If false, each batch of rows fetched from the cursor is converted "
+		"to Java objects all at once.",
+		&pljavaLazyRowConversion,
+		false, /* boot value */
+		PGC_USERSET,
+		0,    /* flags */
+		NULL, /* check hook */
+		NULL, NULL); /* assign hook, show hook */
+
+	BOOL_GUC(
+		"pljava.foreign_downcalls",
+		"If true, a few trivial native accessors are called from Java "
+		"through foreign-function downcall handles instead of JNI",
+		"Requires Java 22 or later; with an older Java, a warning is logged "
+		"once and JNI is used. The setting is checked on each call.",
+		&pljavaForeignDowncalls,
+		false, /* boot value */
+		PGC_USERSET,
+		0,    /* flags */
+		NULL, /* check hook */
+		NULL, NULL); /* assign hook, show hook */
+
+	BOOL_GUC(
+		"pljava.foreign_upcalls",
+		"If true, PL/Java functions returning a primitive type or void are "
+		"called through foreign-function upcall stubs instead of JNI",
+		"Requires Java 22 or later; with an older Java, a warning is logged "
+		"once and JNI is used. The Java option "
+		"--enable-native-access=org.postgresql.pljava.internal in "
+		"pljava.vmoptions avoids a warning from Java about the stubs.",
+		&pljavaForeignUpcalls,
+		false, /* boot value */
+		PGC_USERSET,
+		0,    /* flags */
+		NULL, /* check hook */
+		NULL, NULL); /* assign hook, show hook */
+
 	BOOL_GUC(
 		"pljava.release_lingering_savepoints",
 		"If true, lingering savepoints will be released on function exit. "
@@ -1915,6 +2204,7 @@ internalCallHandler(bool trusted, PG_FUNCTION_ARGS)
 	Datum retval = 0;
 	Oid funcoid = fcinfo->flinfo->fn_oid;
 	bool forTrigger = CALLED_AS_TRIGGER(fcinfo);
+	instr_time start;
 
 	/*
 	 * Just in case it could be helpful in offering diagnostics later, hang
@@ -1929,12 +2219,14 @@ internalCallHandler(bool trusted, PG_FUNCTION_ARGS)
 		initsequencer( initstage, false);
 	}
 
+	INSTR_TIME_SET_CURRENT(start);
 	Invocation_pushInvocation(&ctx);
 	PG_TRY();
 	{
 		retval = Function_invoke(
 			funcoid, trusted, forTrigger, false, true, fcinfo);
 		Invocation_popInvocation(false);
+		pljava_Stats_functionCall(funcoid, &start);
 	}
 	PG_CATCH();
 	{
@@ -2039,6 +2331,66 @@ static Datum internalValidator(bool trusted, PG_FUNCTION_ARGS)
 	PG_RETURN_VOID();
 }
 
+extern PLJAVADLLEXPORT Datum java_fdw_handler(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(java_fdw_handler);
+
+/*
+ * Handler for foreign data wrappers implemented in Java. The routine it returns
+ * will call into Java, so the JVM is started here if it has not been already.
+ */
+Datum java_fdw_handler(PG_FUNCTION_ARGS)
+{
+	if ( IS_COMPLETE != initstage )
+	{
+		deferInit = false;
+		initsequencer( initstage, false);
+	}
+	PG_RETURN_POINTER(pljava_ForeignScan_routine());
+}
+
+extern PLJAVADLLEXPORT Datum java_fdw_validator(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(java_fdw_validator);
+
+/*
+ * Validator for the options of a Java foreign data wrapper and its servers,
+ * user mappings, and tables. It needs no JVM.
+ */
+Datum java_fdw_validator(PG_FUNCTION_ARGS)
+{
+	pljava_ForeignScan_validate(
+		untransformRelOptions(PG_GETARG_DATUM(0)), PG_GETARG_OID(1));
+	PG_RETURN_VOID();
+}
+
+extern PLJAVADLLEXPORT Datum java_ordered_set_transition(PG_FUNCTION_ARGS);
+PG_FUNCTION_INFO_V1(java_ordered_set_transition);
+
+/*
+ * Transition function for ordered-set and hypothetical-set aggregates whose
+ * finishers are in Java; it only sorts, and needs no JVM.
+ */
+Datum java_ordered_set_transition(PG_FUNCTION_ARGS)
+{
+	return pljava_OrderedSet_transition(fcinfo);
+}
+
+extern PLJAVADLLEXPORT void _PG_output_plugin_init(OutputPluginCallbacks *cb);
+
+/*
+ * Makes this library usable as a logical decoding output plugin. Java is
+ * started here if there is a transaction to do it in, as when changes are read
+ * through the SQL functions; the startup callback will complain otherwise.
+ */
+void _PG_output_plugin_init(OutputPluginCallbacks *cb)
+{
+	if ( IS_COMPLETE != initstage  &&  pljavaViableXact() )
+	{
+		deferInit = false;
+		initsequencer( initstage, false);
+	}
+	pljava_LogicalDecoding_callbacks(cb);
+}
+
 /*
  * Called at the ends of committing transactions to emit a warning about future
  * JEP 411 impacts, at most once per session, if any PL/Java functions were
@@ -2136,6 +2488,81 @@ Java_org_postgresql_pljava_internal_Backend__1getStatementCacheSize(JNIEnv* env,
 	return statementCacheSize;
 }
 
+/*
+ * Class:     org_postgresql_pljava_internal_Backend
+ * Method:    _getComputePoolSize
+ * Signature: ()I
+ */
+JNIEXPORT jint JNICALL
+Java_org_postgresql_pljava_internal_Backend__1getComputePoolSize(JNIEnv* env, jclass cls)
+{
+	return computePoolSize;
+}
+
+/*
+ * Class:     org_postgresql_pljava_internal_Backend
+ * Method:    _getWorkerCount
+ * Signature: ()I
+ */
+JNIEXPORT jint JNICALL
+Java_org_postgresql_pljava_internal_Backend__1getWorkerCount(JNIEnv* env, jclass cls)
+{
+	return pljava_workerCount;
+}
+
+/*
+ * Class:     org_postgresql_pljava_internal_Backend
+ * Method:    _launchWorkers
+ * Signature: (Ljava/lang/String;I)I
+ */
+JNIEXPORT jint JNICALL
+Java_org_postgresql_pljava_internal_Backend__1launchWorkers(JNIEnv* env, jclass cls, jstring libraryPath, jint count)
+{
+	jint result = 0;
+
+	BEGIN_NATIVE
+	PG_TRY();
+	{
+		char *path = String_createNTS(libraryPath);
+		result = pljava_Worker_launch(path, count);
+		pfree(path);
+	}
+	PG_CATCH();
+	{
+		Exception_throw_ERROR("pljava_Worker_launch");
+	}
+	PG_END_TRY();
+	END_NATIVE
+
+	return result;
+}
+
+/*
+ * Class:     org_postgresql_pljava_internal_Backend
+ * Method:    _isCurrentTransaction
+ * Signature: (J)Z
+ */
+JNIEXPORT jboolean JNICALL
+Java_org_postgresql_pljava_internal_Backend__1isCurrentTransaction(JNIEnv* env, jclass cls, jlong xid)
+{
+	return TransactionIdIsCurrentTransactionId((TransactionId)xid)
+		? JNI_TRUE : JNI_FALSE;
+}
+
+/*
+ * Class:     org_postgresql_pljava_internal_Backend
+ * Method:    isInterruptPending
+ * Signature: ()Z
+ *
+ * Only reads the flags set by the signal handlers, so it is safe to call from
+ * any thread without entering PG.
+ */
+JNIEXPORT jboolean JNICALL
+Java_org_postgresql_pljava_internal_Backend_isInterruptPending(JNIEnv* env, jclass cls)
+{
+	return ( QueryCancelPending || ProcDiePending ) ? JNI_TRUE : JNI_FALSE;
+}
+
 /*
  * Class:     org_postgresql_pljava_internal_Backend
  * Method:    _log
@@ -2197,6 +2624,40 @@ Java_org_postgresql_pljava_internal_Backend__1clearFunctionCache(JNIEnv* env, jc
 	END_NATIVE
 }
 
+/*
+ * Class:     org_postgresql_pljava_internal_Backend
+ * Method:    _clearFunctionCacheFor
+ * Signature: ([Ljava/lang/ClassLoader;)V
+ */
+JNIEXPORT void JNICALL
+Java_org_postgresql_pljava_internal_Backend__1clearFunctionCacheFor(JNIEnv* env, jclass cls, jobjectArray loaders)
+{
+	BEGIN_NATIVE_NO_ERRCHECK
+	Function_clearFunctionCacheFor(loaders);
+	END_NATIVE
+}
+
+/*
+ * Class:     org_postgresql_pljava_internal_Backend
+ * Method:    _invalidateLoaders
+ * Signature: ()V
+ */
+JNIEXPORT void JNICALL
+Java_org_postgresql_pljava_internal_Backend__1invalidateLoaders(JNIEnv* env, jclass cls)
+{
+	BEGIN_NATIVE
+	PG_TRY();
+	{
+		Function_invalidateLoaders();
+	}
+	PG_CATCH();
+	{
+		Exception_throw_ERROR("CacheInvalidateRelcacheByRelid");
+	}
+	PG_END_TRY();
+	END_NATIVE
+}
+
 /*
  * Class:     org_postgresql_pljava_internal_Backend
  * Method:    _isCreatingExtension
@@ -2245,6 +2706,100 @@ Java_org_postgresql_pljava_internal_Backend__1myLibraryPath(JNIEnv *env, jclass
 	return result;
 }
 
+/*
+ * Class:     org_postgresql_pljava_internal_Backend
+ * Method:    _startupStageNames
+ * Signature: ()[Ljava/lang/String;
+ *
+ * Names of the initsequencer stages, in the order of the values returned by
+ * _startupTimings, followed by one for Function resolution.
+ */
+JNIEXPORT jobjectArray JNICALL
+Java_org_postgresql_pljava_internal_Backend__1startupStageNames(JNIEnv *env, jclass cls)
+{
+	jobjectArray result = NULL;
+	jstring name;
+	int i;
+
+	BEGIN_NATIVE
+	result = JNI_newObjectArray(IS_COMPLETE + 1, s_String_class, NULL);
+	for ( i = 0 ; i < IS_COMPLETE ; ++ i )
+	{
+		name = String_createJavaStringFromNTS(s_initStageNames[i]);
+		JNI_setObjectArrayElement(result, i, name);
+		JNI_deleteLocalRef(name);
+	}
+	name = String_createJavaStringFromNTS("resolving PL/Java functions");
+	JNI_setObjectArrayElement(result, IS_COMPLETE, name);
+	JNI_deleteLocalRef(name);
+	END_NATIVE
+
+	return result;
+}
+
+/*
+ * Class:     org_postgresql_pljava_internal_Backend
+ * Method:    _startupTimings
+ * Signature: ()[D
+ *
+ * Milliseconds spent in each initsequencer stage, then the cumulative time
+ * spent resolving PL/Java functions so far, then the number of such
+ * resolutions.
+ */
+JNIEXPORT jdoubleArray JNICALL
+Java_org_postgresql_pljava_internal_Backend__1startupTimings(JNIEnv *env, jclass cls)
+{
+	jdoubleArray result = NULL;
+	jdouble values[IS_COMPLETE + 2];
+	uint64 count;
+	int i;
+
+	BEGIN_NATIVE
+	for ( i = 0 ; i < IS_COMPLETE ; ++ i )
+		values[i] = s_initStageMillis[i];
+	values[IS_COMPLETE] = pljava_Function_resolutionMillis(&count);
+	values[IS_COMPLETE + 1] = (jdouble)count;
+	result = JNI_newDoubleArray(IS_COMPLETE + 2);
+	JNI_setDoubleArrayRegion(result, 0, IS_COMPLETE + 2, values);
+	END_NATIVE
+
+	return result;
+}
+
+/*
+ * Class:     org_postgresql_pljava_internal_Backend
+ * Method:    _memoryReport
+ * Signature: ()[D
+ *
+ * Bytes allocated in TopMemoryContext and in JavaMemoryContext (each counting
+ * its children), the number of live JNI global references, and the numbers of
+ * cached Function and Type objects. The byte counts are -1 before PG 13, which
+ * has no cheap way to get them.
+ */
+JNIEXPORT jdoubleArray JNICALL
+Java_org_postgresql_pljava_internal_Backend__1memoryReport(JNIEnv *env, jclass cls)
+{
+	jdoubleArray result = NULL;
+	jdouble values[5];
+
+	BEGIN_NATIVE
+#if PG_VERSION_NUM >= 130000
+	values[0] = (jdouble)MemoryContextMemAllocated(TopMemoryContext, true);
+	values[1] = (jdouble)MemoryContextMemAllocated(JavaMemoryContext, true);
+#else
+	values[0] = -1;
+	values[1] = -1;
+#endif
+	values[2] = (jdouble)JNI_globalRefCount();
+	values[3] = (jdouble)pljava_Function_cacheSize();
+	values[4] = (jdouble)Type_cacheSize();
+	result = JNI_newDoubleArray(5);
+	JNI_setDoubleArrayRegion(result, 0, 5, values);
+	END_NATIVE
+
+	return result;
+}
+
 /*
  * Class:     org_postgresql_pljava_internal_Backend
  * Method:    _pokeJEP411
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2019 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2018-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -18,8 +18,10 @@
 #include "org_postgresql_pljava_internal_DualState_SingleFreeErrorData.h"
 #include "org_postgresql_pljava_internal_DualState_SingleSPIfreeplan.h"
 #include "org_postgresql_pljava_internal_DualState_SingleSPIcursorClose.h"
+#include "org_postgresql_pljava_internal_DualState_SingleSPIfreetuptable.h"
 #include "pljava/DualState.h"
 
+#include "pljava/Activity.h"
 #include "pljava/Backend.h"
 #include "pljava/Exception.h"
 #include "pljava/Invocation.h"
@@ -75,8 +77,10 @@ jobject pljava_DualState_key(void)
  */
 void pljava_DualState_cleanEnqueuedInstances(void)
 {
+	uint32 priorWait = pljava_Activity_waitStart(PLJAVA_WAIT_DUALSTATE_CLEANUP);
 	JNI_callStaticVoidMethodLocked(s_DualState_class,
 								   s_DualState_cleanEnqueuedInstances);
+	pljava_Activity_waitEnd(priorWait);
 }
 
 /*
@@ -183,6 +187,16 @@ void pljava_DualState_initialize(void)
 		{ 0, 0, 0 }
 	};
 
+	JNINativeMethod singleSPIfreetuptableMethods[] =
+	{
+		{
+		"_spiFreeTupTable",
+		"(JJ)V",
+		Java_org_postgresql_pljava_internal_DualState_00024SingleSPIfreetuptable__1spiFreeTupTable
+		},
+		{ 0, 0, 0 }
+	};
+
 	s_DualState_class = (jclass)JNI_newGlobalRef(PgObject_getJavaClass(
 		"org/postgresql/pljava/internal/DualState"));
 	s_DualState_resourceOwnerRelease = PgObject_getStaticJavaMethod(
@@ -231,6 +245,11 @@ void pljava_DualState_initialize(void)
 	PgObject_registerNatives2(clazz, singleSPIcursorCloseMethods);
 	JNI_deleteLocalRef(clazz);
 
+	clazz = (jclass)PgObject_getJavaClass(
+		"org/postgresql/pljava/internal/DualState$SingleSPIfreetuptable");
+	PgObject_registerNatives2(clazz, singleSPIfreetuptableMethods);
+	JNI_deleteLocalRef(clazz);
+
 	RegisterResourceReleaseCallback(resourceReleaseCB, NULL);
 
 	/*
@@ -426,3 +445,40 @@ Java_org_postgresql_pljava_internal_DualState_00024SingleSPIcursorClose__1spiCur
 	PG_END_TRY();
 	END_NATIVE
 }
+
+
+
+/*
+ * Class:     org_postgresql_pljava_internal_DualState_SingleSPIfreetuptable
+ * Method:    _spiFreeTupTable
+ * Signature: (JJ)V
+ *
+ * The tuptable is on the tuptables list of the SPI connection of the invocation
+ * that made it, and SPI_freetuptable looks for it only on the list of the
+ * current connection, warning if it is not there. In any other invocation
+ * (a nested one polling the reference queue, say) it is left alone for the
+ * SPI_finish of its own.
+ */
+JNIEXPORT void JNICALL
+Java_org_postgresql_pljava_internal_DualState_00024SingleSPIfreetuptable__1spiFreeTupTable(
+	JNIEnv* env, jobject _this, jlong pointer, jlong invocation)
+{
+	BEGIN_NATIVE_NO_ERRCHECK
+	Ptr2Long p2l;
+	Ptr2Long p2lro;
+	p2l.longVal = pointer;
+	p2lro.longVal = invocation;
+	if ( p2lro.ptrVal == currentInvocation )
+	{
+		PG_TRY();
+		{
+			SPI_freetuptable(p2l.ptrVal);
+		}
+		PG_CATCH();
+		{
+			Exception_throw_ERROR("SPI_freetuptable");
+		}
+		PG_END_TRY();
+	}
+	END_NATIVE
+}
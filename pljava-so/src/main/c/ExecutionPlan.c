@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2019 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -17,14 +17,17 @@
 #include <utils/guc.h>
 
 #include "org_postgresql_pljava_internal_ExecutionPlan.h"
+#include "pljava/Backend.h"
 #include "pljava/DualState.h"
 #include "pljava/Invocation.h"
 #include "pljava/Exception.h"
 #include "pljava/Function.h"
 #include "pljava/SPI.h"
+#include "pljava/Stats.h"
 #include "pljava/type/Oid.h"
 #include "pljava/type/Portal.h"
 #include "pljava/type/String.h"
+#include "pljava/type/TupleTable.h"
 
 #if defined(NEED_MISCADMIN_FOR_STACK_BASE)
 #include <miscadmin.h>
@@ -66,8 +69,13 @@ void pljava_ExecutionPlan_initialize(void)
 		Java_org_postgresql_pljava_internal_ExecutionPlan__1execute
 		},
 		{
+		"_executeTable",
+		"(J[Ljava/lang/Object;SILorg/postgresql/pljava/internal/TupleDesc;)Lorg/postgresql/pljava/internal/TupleTable;",
+		Java_org_postgresql_pljava_internal_ExecutionPlan__1executeTable
+		},
+		{
 		"_prepare",
-		"(Ljava/lang/Object;Ljava/lang/String;[Lorg/postgresql/pljava/internal/Oid;)Lorg/postgresql/pljava/internal/ExecutionPlan;",
+		"(Ljava/lang/Object;Ljava/lang/String;[Lorg/postgresql/pljava/internal/Oid;Z)Lorg/postgresql/pljava/internal/ExecutionPlan;",
 		Java_org_postgresql_pljava_internal_ExecutionPlan__1prepare
 		},
 		{ 0, 0, 0 }
@@ -166,6 +174,7 @@ Java_org_postgresql_pljava_internal_ExecutionPlan__1cursorOpen(JNIEnv* env, jobj
 					read_only = Function_isCurrentReadOnly();
 				else
 					read_only = (SPI_READONLY_FORCED == readonly_spec);
+				pljava_Stats_spiStatement();
 				portal = SPI_cursor_open(
 					name, p2l.ptrVal, values, nulls, read_only);
 				if(name != 0)
@@ -247,6 +256,7 @@ Java_org_postgresql_pljava_internal_ExecutionPlan__1execute(JNIEnv* env, jclass
 					read_only = Function_isCurrentReadOnly();
 				else
 					read_only = (SPI_READONLY_FORCED == readonly_spec);
+				pljava_Stats_spiStatement();
 				result = (jint)SPI_execute_plan(
 					p2l.ptrVal, values, nulls, read_only, (int)count);
 				if(result < 0)
@@ -269,13 +279,88 @@ Java_org_postgresql_pljava_internal_ExecutionPlan__1execute(JNIEnv* env, jclass
 	return result;
 }
 
+/*
+ * Class:     org_postgresql_pljava_internal_ExecutionPlan
+ * Method:    _executeTable
+ * Signature: (J[Ljava/lang/Object;SILorg/postgresql/pljava/internal/TupleDesc;)Lorg/postgresql/pljava/internal/TupleTable;
+ *
+ * Runs the plan to completion with SPI_execute_plan, rather than through a
+ * cursor, so that a plan prepared with CURSOR_OPT_PARALLEL_OK can actually use
+ * parallel workers (the executor will not start them for a portal that may be
+ * fetched from in pieces). The rows are returned in one TupleTable, lazy if
+ * pljava.lazy_row_conversion is on, as in Portal._fetchTable. The table is
+ * returned even when empty, so the caller has the TupleDesc.
+ */
+JNIEXPORT jobject JNICALL
+Java_org_postgresql_pljava_internal_ExecutionPlan__1executeTable(JNIEnv* env, jclass clazz, jlong _this, jobjectArray jvalues, jshort readonly_spec, jint count, jobject knownTD)
+{
+	jobject result = 0;
+	if(_this != 0)
+	{
+		BEGIN_NATIVE
+		STACK_BASE_VARS
+		STACK_BASE_PUSH(env)
+		PG_TRY();
+		{
+			Ptr2Long p2l;
+			Datum* values = 0;
+			char*  nulls  = 0;
+			p2l.longVal = _this;
+			if(coerceObjects(p2l.ptrVal, jvalues, &values, &nulls))
+			{
+				bool read_only;
+				int spi_ret;
+				Invocation_assertConnect();
+				if ( SPI_READONLY_DEFAULT == readonly_spec )
+					read_only = Function_isCurrentReadOnly();
+				else
+					read_only = (SPI_READONLY_FORCED == readonly_spec);
+				pljava_Stats_spiStatement();
+				spi_ret = SPI_execute_plan(
+					p2l.ptrVal, values, nulls, read_only, (long)count);
+				if(spi_ret < 0)
+					Exception_throwSPI("execute_plan", spi_ret);
+				else if ( NULL != SPI_tuptable )
+				{
+					if ( pljavaLazyRowConversion )
+						result = TupleTable_createLazy(SPI_tuptable, knownTD);
+					else
+					{
+						result = TupleTable_create(SPI_tuptable, knownTD);
+						SPI_freetuptable(SPI_tuptable);
+					}
+					SPI_tuptable = 0;
+				}
+
+				if(values != 0)
+					pfree(values);
+				if(nulls != 0)
+					pfree(nulls);
+			}
+		}
+		PG_CATCH();
+		{
+			Exception_throw_ERROR("SPI_execute_plan");
+		}
+		PG_END_TRY();
+		STACK_BASE_POP()
+		END_NATIVE
+	}
+	return result;
+}
+
 /*
  * Class:     org_postgresql_pljava_internal_ExecutionPlan
  * Method:    _prepare
- * Signature: (Ljava/lang/Object;Ljava/lang/String;[Lorg/postgresql/pljava/internal/Oid;)Lorg/postgresql/pljava/internal/ExecutionPlan;
+ * Signature: (Ljava/lang/Object;Ljava/lang/String;[Lorg/postgresql/pljava/internal/Oid;Z)Lorg/postgresql/pljava/internal/ExecutionPlan;
+ *
+ * When parallel is true, the plan is made with CURSOR_OPT_PARALLEL_OK, which
+ * SPI_prepare never passes, so the planner is free to choose a parallel plan.
+ * Such a plan should be run with _executeTable; a cursor opened on it will
+ * still work, but without workers.
  */
 JNIEXPORT jobject JNICALL
-Java_org_postgresql_pljava_internal_ExecutionPlan__1prepare(JNIEnv* env, jclass clazz, jobject key, jstring jcmd, jobjectArray paramTypes)
+Java_org_postgresql_pljava_internal_ExecutionPlan__1prepare(JNIEnv* env, jclass clazz, jobject key, jstring jcmd, jobjectArray paramTypes, jboolean parallel)
 {
 	jobject result = 0;
 #if PG_VERSION_NUM >= 90200
@@ -309,6 +394,12 @@ Java_org_postgresql_pljava_internal_ExecutionPlan__1prepare(JNIEnv* env, jclass
 
 		cmd   = String_createNTS(jcmd);
 		Invocation_assertConnect();
+#if PG_VERSION_NUM >= 90600
+		if ( JNI_TRUE == parallel )
+			ePlan = SPI_prepare_cursor(
+				cmd, paramCount, paramOids, CURSOR_OPT_PARALLEL_OK);
+		else
+#endif
 		ePlan = SPI_prepare(cmd, paramCount, paramOids);
 		pfree(cmd);
 
@@ -0,0 +1,149 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+#include <postgres.h>
+#include <executor/spi.h>
+#include <lib/stringinfo.h>
+#include <utils/portal.h>
+
+#include "org_postgresql_pljava_internal_ForeignDowncalls.h"
+#include "pljava/Backend.h"
+#include "pljava/ForeignDowncalls.h"
+#include "pljava/PgObject.h"
+
+/*
+ * The functions are kept here together, rather than beside the JNI natives
+ * they stand in for, so the rule that none of them may raise an error can be
+ * checked in one place. Their order in s_downcalls must match the order of
+ * the handles in ForeignDowncalls.java.
+ */
+
+static int64 portalPos(Portal portal)
+{
+	return (int64)portal->portalPos;
+}
+
+static bool portalAtStart(Portal portal)
+{
+	return portal->atStart;
+}
+
+static bool portalAtEnd(Portal portal)
+{
+	return portal->atEnd;
+}
+
+static int64 spiProcessed(void)
+{
+	return (int64)SPI_processed;
+}
+
+static int32 spiResult(void)
+{
+	return (int32)SPI_result;
+}
+
+/*
+ * Set the length of the StringInfo str to pos, and NUL-terminate it, if there
+ * is room for needed more bytes without enlarging it; return false otherwise,
+ * leaving str untouched, so the caller can use the JNI _ensureCapacity, which
+ * may enlarge it (and so raise an error).
+ */
+static bool stringInfoTrySetLength(StringInfo str, int32 pos, int32 needed)
+{
+	if ( pos + needed >= str->maxlen )
+		return false;
+	str->len = pos;
+	str->data[pos] = '\0';
+	return true;
+}
+
+static void *s_downcalls[] =
+{
+	portalPos,
+	portalAtStart,
+	portalAtEnd,
+	spiProcessed,
+	spiResult,
+	stringInfoTrySetLength
+};
+
+void pljava_ForeignDowncalls_initialize(void)
+{
+	JNINativeMethod methods[] =
+	{
+		{
+		"_addresses",
+		"()[J",
+		Java_org_postgresql_pljava_internal_ForeignDowncalls__1addresses
+		},
+		{
+		"_setting",
+		"()Ljava/nio/ByteBuffer;",
+		Java_org_postgresql_pljava_internal_ForeignDowncalls__1setting
+		},
+		{ 0, 0, 0 }
+	};
+
+	PgObject_registerNatives(
+		"org/postgresql/pljava/internal/ForeignDowncalls", methods);
+}
+
+/*
+ * Class:     org_postgresql_pljava_internal_ForeignDowncalls
+ * Method:    _addresses
+ * Signature: ()[J
+ */
+JNIEXPORT jlongArray JNICALL
+Java_org_postgresql_pljava_internal_ForeignDowncalls__1addresses(
+	JNIEnv *env, jclass cls)
+{
+	jlongArray result = NULL;
+	jlong addrs [ lengthof(s_downcalls) ];
+	int i;
+
+	for ( i = 0 ; i < lengthof(s_downcalls) ; ++ i )
+	{
+		Ptr2Long p2l;
+		p2l.longVal = 0L; /* ensure that the rest is zeroed out */
+		p2l.ptrVal = s_downcalls[i];
+		addrs[i] = p2l.longVal;
+	}
+
+	BEGIN_NATIVE
+	result = JNI_newLongArray(lengthof(s_downcalls));
+	if ( NULL != result )
+		JNI_setLongArrayRegion(result, 0, lengthof(s_downcalls), addrs);
+	END_NATIVE
+	return result;
+}
+
+/*
+ * Class:     org_postgresql_pljava_internal_ForeignDowncalls
+ * Method:    _setting
+ * Signature: ()Ljava/nio/ByteBuffer;
+ *
+ * A direct buffer over the variable behind pljava.foreign_downcalls, so Java
+ * can check the current setting before each call without a JNI call of its
+ * own.
+ */
+JNIEXPORT jobject JNICALL
+Java_org_postgresql_pljava_internal_ForeignDowncalls__1setting(
+	JNIEnv *env, jclass cls)
+{
+	jobject result = NULL;
+
+	BEGIN_NATIVE
+	result = JNI_newDirectByteBuffer(
+		&pljavaForeignDowncalls, sizeof pljavaForeignDowncalls);
+	END_NATIVE
+	return result;
+}
@@ -0,0 +1,687 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+#include <postgres.h>
+#include <access/sysattr.h>
+#include <catalog/pg_foreign_data_wrapper.h>
+#include <commands/defrem.h>
+#include <commands/explain.h>
+#include <executor/executor.h>
+#include <foreign/foreign.h>
+#include <nodes/pg_list.h>
+#include <optimizer/cost.h>
+#include <optimizer/pathnode.h>
+#include <optimizer/planmain.h>
+#include <optimizer/restrictinfo.h>
+#if PG_VERSION_NUM >= 120000
+#include <optimizer/optimizer.h>
+#else
+#include <optimizer/var.h>
+#endif
+#include <utils/lsyscache.h>
+#include <utils/memutils.h>
+#include <utils/rel.h>
+
+#include "pljava/ForeignScan.h"
+#include "pljava/Invocation.h"
+#include "pljava/PgObject.h"
+#include "pljava/type/String.h"
+#include "pljava/type/Type.h"
+
+#if PG_VERSION_NUM >= 110000
+#define ATTNAME(relid, attno) get_attname((relid), (attno), false)
+#else
+#define ATTNAME(relid, attno) get_attname((relid), (attno))
+#endif
+
+#define DEFAULT_BATCH_SIZE 100
+#define MAX_BATCH_SIZE 1000000
+
+/*
+ * Cost of starting a scan, which includes constructing the Java wrapper.
+ */
+#define STARTUP_COST 10.0
+
+static jclass    s_ForeignScan_class;
+static jmethodID s_ForeignScan_estimateRows;
+static jmethodID s_ForeignScan_begin;
+static jmethodID s_ForeignScan_batch;
+static jmethodID s_ForeignScan_next;
+static jmethodID s_ForeignScan_rescan;
+static jmethodID s_ForeignScan_close;
+
+/*
+ * Options of the wrapper, server, and table, with the ones PL/Java uses itself
+ * picked out, and the rest kept to be passed to the Java class.
+ */
+typedef struct
+{
+	char const *className;
+	char const *schema;
+	int         batchSize;
+	List       *others;
+} Options;
+
+/*
+ * Planner state, kept in baserel->fdw_private.
+ */
+typedef struct
+{
+	Options options;
+	List   *columns;    /* attribute numbers the query uses */
+	List   *qualAttnos; /* for each pushed-down qual, the column, */
+	List   *qualOps;    /* the operator name (as a String node), */
+	List   *qualConsts; /* and the Const compared to */
+} PlanInfo;
+
+/*
+ * Executor state, kept in node->fdw_state.
+ */
+typedef struct
+{
+	char const  *className;
+	int          ncolumns;
+	AttrNumber  *attnos;
+	Type        *types;
+	jobject      scan;  /* global ref to the Java ForeignScan */
+	jobjectArray batch; /* global ref to its batch array */
+	int          count; /* rows in the current batch */
+	int          next;  /* index in the batch of the next row to return */
+	bool         done;
+	MemoryContextCallback releaseCB;
+} ScanInfo;
+
+static void getForeignRelSize(
+	PlannerInfo *root, RelOptInfo *baserel, Oid foreigntableid);
+static void getForeignPaths(
+	PlannerInfo *root, RelOptInfo *baserel, Oid foreigntableid);
+static ForeignScan *getForeignPlan(
+	PlannerInfo *root, RelOptInfo *baserel, Oid foreigntableid,
+	ForeignPath *best_path, List *tlist, List *scan_clauses, Plan *outer_plan);
+static void beginForeignScan(ForeignScanState *node, int eflags);
+static TupleTableSlot *iterateForeignScan(ForeignScanState *node);
+static void reScanForeignScan(ForeignScanState *node);
+static void endForeignScan(ForeignScanState *node);
+static void explainForeignScan(ForeignScanState *node, ExplainState *es);
+
+static void getOptions(Oid foreigntableid, Options *o);
+static int batchSize(DefElem *def);
+static void extractQuals(RelOptInfo *baserel, PlanInfo *info);
+static void optionArrays(
+	List *defs, jobjectArray *names, jobjectArray *values);
+static void qualArrays(
+	Oid relid, List *attnos, List *ops, List *consts,
+	jobjectArray *columns, jobjectArray *operators, jobjectArray *values);
+static void releaseRefs(void *arg);
+
+void pljava_ForeignScan_initialize(void)
+{
+	s_ForeignScan_class = (jclass)JNI_newGlobalRef(PgObject_getJavaClass(
+		"org/postgresql/pljava/internal/ForeignScan"));
+	s_ForeignScan_estimateRows = PgObject_getStaticJavaMethod(
+		s_ForeignScan_class, "estimateRows",
+		"(Ljava/lang/String;Ljava/lang/String;"
+		"[Ljava/lang/String;[Ljava/lang/String;"
+		"[Ljava/lang/String;[Ljava/lang/String;[Ljava/lang/Object;)D");
+	s_ForeignScan_begin = PgObject_getStaticJavaMethod(
+		s_ForeignScan_class, "begin",
+		"(Ljava/lang/String;Ljava/lang/String;"
+		"[Ljava/lang/String;[Ljava/lang/String;[Ljava/lang/String;"
+		"[Ljava/lang/String;[Ljava/lang/String;[Ljava/lang/Object;I)"
+		"Lorg/postgresql/pljava/internal/ForeignScan;");
+	s_ForeignScan_batch = PgObject_getJavaMethod(
+		s_ForeignScan_class, "batch", "()[[Ljava/lang/Object;");
+	s_ForeignScan_next = PgObject_getJavaMethod(
+		s_ForeignScan_class, "next", "()I");
+	s_ForeignScan_rescan = PgObject_getJavaMethod(
+		s_ForeignScan_class, "rescan", "()V");
+	s_ForeignScan_close = PgObject_getJavaMethod(
+		s_ForeignScan_class, "close", "()V");
+}
+
+FdwRoutine *pljava_ForeignScan_routine(void)
+{
+	FdwRoutine *routine = makeNode(FdwRoutine);
+
+	routine->GetForeignRelSize = getForeignRelSize;
+	routine->GetForeignPaths = getForeignPaths;
+	routine->GetForeignPlan = getForeignPlan;
+	routine->BeginForeignScan = beginForeignScan;
+	routine->IterateForeignScan = iterateForeignScan;
+	routine->ReScanForeignScan = reScanForeignScan;
+	routine->EndForeignScan = endForeignScan;
+	routine->ExplainForeignScan = explainForeignScan;
+
+	return routine;
+}
+
+void pljava_ForeignScan_validate(List *options, Oid catalog)
+{
+	ListCell *lc;
+
+	foreach(lc, options)
+	{
+		DefElem *def = (DefElem *)lfirst(lc);
+
+		if ( 0 == strcmp(def->defname, "class")
+			|| 0 == strcmp(def->defname, "schema") )
+		{
+			/*
+			 * Only a superuser can create or alter a foreign data wrapper,
+			 * so only a superuser decides what Java code a wrapper runs.
+			 */
+			if ( ForeignDataWrapperRelationId != catalog )
+				ereport(ERROR, (
+					errcode(ERRCODE_FDW_INVALID_OPTION_NAME),
+					errmsg("option \"%s\" may only be given for the "
+						"foreign data wrapper", def->defname)));
+		}
+		else if ( 0 == strcmp(def->defname, "batch_size") )
+			batchSize(def);
+	}
+}
+
+static void getForeignRelSize(
+	PlannerInfo *root, RelOptInfo *baserel, Oid foreigntableid)
+{
+	PlanInfo *info = (PlanInfo *)palloc0(sizeof *info);
+	Bitmapset *attrs = NULL;
+	bool wholeRow;
+	AttrNumber attno;
+	ListCell *lc;
+	Invocation ctx;
+
+	getOptions(foreigntableid, &info->options);
+	extractQuals(baserel, info);
+
+	/*
+	 * The columns the query uses are those in the target list and in the
+	 * restriction clauses, which PostgreSQL will still check.
+	 */
+#if PG_VERSION_NUM >= 90600
+	pull_varattnos(
+		(Node *)baserel->reltarget->exprs, baserel->relid, &attrs);
+#else
+	pull_varattnos((Node *)baserel->reltargetlist, baserel->relid, &attrs);
+#endif
+	foreach(lc, baserel->baserestrictinfo)
+		pull_varattnos((Node *)((RestrictInfo *)lfirst(lc))->clause,
+			baserel->relid, &attrs);
+
+	wholeRow = bms_is_member(0 - FirstLowInvalidHeapAttributeNumber, attrs);
+	for ( attno = 1 ; attno <= baserel->max_attr ; ++ attno )
+	{
+		if ( InvalidOid == get_atttype(foreigntableid, attno) )
+			continue; /* dropped */
+		if ( wholeRow  ||  bms_is_member(
+				attno - FirstLowInvalidHeapAttributeNumber, attrs) )
+			info->columns = lappend_int(info->columns, attno);
+	}
+
+	Invocation_pushInvocation(&ctx);
+	PG_TRY();
+	{
+		jobjectArray names;
+		jobjectArray values;
+		jobjectArray qualColumns;
+		jobjectArray qualOperators;
+		jobjectArray qualValues;
+
+		optionArrays(info->options.others, &names, &values);
+		qualArrays(foreigntableid,
+			info->qualAttnos, info->qualOps, info->qualConsts,
+			&qualColumns, &qualOperators, &qualValues);
+		baserel->rows = clamp_row_est(JNI_callStaticDoubleMethod(
+			s_ForeignScan_class, s_ForeignScan_estimateRows,
+			String_createJavaStringFromNTS(info->options.schema),
+			String_createJavaStringFromNTS(info->options.className),
+			names, values, qualColumns, qualOperators, qualValues));
+		Invocation_popInvocation(false);
+	}
+	PG_CATCH();
+	{
+		Invocation_popInvocation(true);
+		PG_RE_THROW();
+	}
+	PG_END_TRY();
+
+	baserel->fdw_private = info;
+}
+
+static void getForeignPaths(
+	PlannerInfo *root, RelOptInfo *baserel, Oid foreigntableid)
+{
+	Cost total = STARTUP_COST + baserel->rows * cpu_tuple_cost;
+
+	add_path(baserel, (Path *)create_foreignscan_path(root, baserel,
+#if PG_VERSION_NUM >= 90600
+		NULL, /* default pathtarget */
+#endif
+		baserel->rows, STARTUP_COST, total,
+		NIL,  /* no pathkeys */
+		NULL, /* no outer rel either */
+		NULL, /* no extra plan */
+		NIL)); /* no fdw_private */
+}
+
+static ForeignScan *getForeignPlan(
+	PlannerInfo *root, RelOptInfo *baserel, Oid foreigntableid,
+	ForeignPath *best_path, List *tlist, List *scan_clauses, Plan *outer_plan)
+{
+	PlanInfo *info = (PlanInfo *)baserel->fdw_private;
+
+	/*
+	 * Every clause stays in the plan's qual to be checked locally; the ones
+	 * passed to Java are only hints.
+	 */
+	scan_clauses = extract_actual_clauses(scan_clauses, false);
+
+	return make_foreignscan(tlist, scan_clauses, baserel->relid,
+		NIL, /* no expressions to evaluate */
+		list_make4(info->columns,
+			info->qualAttnos, info->qualOps, info->qualConsts),
+		NIL, /* scan tuples have the table's row type */
+		NIL, /* no remote quals to recheck */
+		outer_plan);
+}
+
+static void beginForeignScan(ForeignScanState *node, int eflags)
+{
+	ForeignScan *plan = (ForeignScan *)node->ss.ps.plan;
+	Oid relid = RelationGetRelid(node->ss.ss_currentRelation);
+	List *columns = (List *)linitial(plan->fdw_private);
+	ScanInfo *info = (ScanInfo *)palloc0(sizeof *info);
+	Options options;
+	ListCell *lc;
+	Invocation ctx;
+	int i;
+
+	getOptions(relid, &options);
+	info->className = options.className;
+	node->fdw_state = info;
+
+	if ( eflags & EXEC_FLAG_EXPLAIN_ONLY )
+		return;
+
+	info->ncolumns = list_length(columns);
+	info->attnos = (AttrNumber *)palloc(
+		(1 + info->ncolumns) * sizeof *info->attnos);
+	info->types = (Type *)palloc((1 + info->ncolumns) * sizeof *info->types);
+
+	/*
+	 * The global references are released when the query's memory context
+	 * goes away, even if the scan is not ended normally.
+	 */
+	info->releaseCB.func = releaseRefs;
+	info->releaseCB.arg = info;
+	MemoryContextRegisterResetCallback(CurrentMemoryContext, &info->releaseCB);
+
+	Invocation_pushInvocation(&ctx);
+	PG_TRY();
+	{
+		jobjectArray names;
+		jobjectArray values;
+		jobjectArray jcolumns;
+		jobjectArray qualColumns;
+		jobjectArray qualOperators;
+		jobjectArray qualValues;
+		jobject scan;
+
+		jcolumns = JNI_newObjectArray(info->ncolumns, s_String_class, NULL);
+		i = 0;
+		foreach(lc, columns)
+		{
+			AttrNumber attno = (AttrNumber)lfirst_int(lc);
+			info->attnos[i] = attno;
+			info->types[i] =
+				Type_objectTypeFromOid(get_atttype(relid, attno), NULL);
+			JNI_setObjectArrayElement(jcolumns, i,
+				String_createJavaStringFromNTS(ATTNAME(relid, attno)));
+			++ i;
+		}
+
+		optionArrays(options.others, &names, &values);
+		qualArrays(relid, (List *)lsecond(plan->fdw_private),
+			(List *)lthird(plan->fdw_private),
+			(List *)lfourth(plan->fdw_private),
+			&qualColumns, &qualOperators, &qualValues);
+
+		scan = JNI_callStaticObjectMethod(
+			s_ForeignScan_class, s_ForeignScan_begin,
+			String_createJavaStringFromNTS(options.schema),
+			String_createJavaStringFromNTS(options.className),
+			names, values, jcolumns, qualColumns, qualOperators, qualValues,
+			(jint)options.batchSize);
+		info->scan = JNI_newGlobalRef(scan);
+		info->batch = (jobjectArray)JNI_newGlobalRef(
+			JNI_callObjectMethod(scan, s_ForeignScan_batch));
+		Invocation_popInvocation(false);
+	}
+	PG_CATCH();
+	{
+		Invocation_popInvocation(true);
+		PG_RE_THROW();
+	}
+	PG_END_TRY();
+}
+
+/*
+ * Return the next row from the current batch, asking Java for another batch
+ * when the current one is used up.
+ */
+static TupleTableSlot *iterateForeignScan(ForeignScanState *node)
+{
+	ScanInfo *info = (ScanInfo *)node->fdw_state;
+	TupleTableSlot *slot = node->ss.ss_ScanTupleSlot;
+	int natts = slot->tts_tupleDescriptor->natts;
+	Invocation ctx;
+
+	ExecClearTuple(slot);
+	if ( info->done )
+		return slot;
+
+	Invocation_pushInvocation(&ctx);
+	PG_TRY();
+	{
+		jobjectArray row;
+		jobject value;
+		int i;
+
+		if ( info->next == info->count )
+		{
+			info->count = JNI_callIntMethod(info->scan, s_ForeignScan_next);
+			info->next = 0;
+			info->done = 0 == info->count;
+		}
+
+		if ( ! info->done )
+		{
+			row = (jobjectArray)
+				JNI_getObjectArrayElement(info->batch, info->next ++);
+			if ( NULL == row  ||  JNI_getArrayLength(row) < info->ncolumns )
+				ereport(ERROR, (
+					errcode(ERRCODE_FDW_ERROR),
+					errmsg("foreign table scan by %s supplied a row with "
+						"fewer than %d values",
+						info->className, info->ncolumns)));
+
+			memset(slot->tts_isnull, true, natts * sizeof(bool));
+			for ( i = 0 ; i < info->ncolumns ; ++ i )
+			{
+				value = JNI_getObjectArrayElement(row, i);
+				if ( NULL == value )
+					continue;
+				slot->tts_values[info->attnos[i] - 1] =
+					Type_coerceObjectBridged(info->types[i], value);
+				slot->tts_isnull[info->attnos[i] - 1] = false;
+				JNI_deleteLocalRef(value);
+			}
+			JNI_deleteLocalRef(row);
+			ExecStoreVirtualTuple(slot);
+		}
+		Invocation_popInvocation(false);
+	}
+	PG_CATCH();
+	{
+		Invocation_popInvocation(true);
+		PG_RE_THROW();
+	}
+	PG_END_TRY();
+
+	return slot;
+}
+
+static void reScanForeignScan(ForeignScanState *node)
+{
+	ScanInfo *info = (ScanInfo *)node->fdw_state;
+	Invocation ctx;
+
+	Invocation_pushInvocation(&ctx);
+	PG_TRY();
+	{
+		JNI_callVoidMethod(info->scan, s_ForeignScan_rescan);
+		Invocation_popInvocation(false);
+	}
+	PG_CATCH();
+	{
+		Invocation_popInvocation(true);
+		PG_RE_THROW();
+	}
+	PG_END_TRY();
+
+	info->count = 0;
+	info->next = 0;
+	info->done = false;
+}
+
+static void endForeignScan(ForeignScanState *node)
+{
+	ScanInfo *info = (ScanInfo *)node->fdw_state;
+	Invocation ctx;
+
+	if ( NULL == info  ||  NULL == info->scan )
+		return; /* EXPLAIN only */
+
+	Invocation_pushInvocation(&ctx);
+	PG_TRY();
+	{
+		JNI_callVoidMethod(info->scan, s_ForeignScan_close);
+		Invocation_popInvocation(false);
+	}
+	PG_CATCH();
+	{
+		Invocation_popInvocation(true);
+		PG_RE_THROW();
+	}
+	PG_END_TRY();
+
+	releaseRefs(info);
+}
+
+static void explainForeignScan(ForeignScanState *node, ExplainState *es)
+{
+	ScanInfo *info = (ScanInfo *)node->fdw_state;
+
+	ExplainPropertyText("Java Class", info->className, es);
+}
+
+static void releaseRefs(void *arg)
+{
+	ScanInfo *info = (ScanInfo *)arg;
+
+	if ( NULL != info->batch )
+	{
+		JNI_deleteGlobalRef(info->batch);
+		info->batch = NULL;
+	}
+	if ( NULL != info->scan )
+	{
+		JNI_deleteGlobalRef(info->scan);
+		info->scan = NULL;
+	}
+}
+
+static void getOptions(Oid foreigntableid, Options *o)
+{
+	ForeignTable *table = GetForeignTable(foreigntableid);
+	ForeignServer *server = GetForeignServer(table->serverid);
+	ForeignDataWrapper *wrapper = GetForeignDataWrapper(server->fdwid);
+	List *all = NIL;
+	ListCell *lc;
+
+	all = list_concat(all, list_copy(wrapper->options));
+	all = list_concat(all, list_copy(server->options));
+	all = list_concat(all, list_copy(table->options));
+
+	o->className = NULL;
+	o->schema = NULL;
+	o->batchSize = DEFAULT_BATCH_SIZE;
+	o->others = NIL;
+
+	foreach(lc, all)
+	{
+		DefElem *def = (DefElem *)lfirst(lc);
+		bool isClass = 0 == strcmp(def->defname, "class");
+
+		/*
+		 * The validator refuses these anywhere but on the wrapper, but the
+		 * wrapper's validator can be changed or removed after options are
+		 * given, so what Java code runs is taken only from the wrapper's own.
+		 */
+		if ( isClass  ||  0 == strcmp(def->defname, "schema") )
+		{
+			if ( ! list_member_ptr(wrapper->options, def) )
+				ereport(ERROR, (
+					errcode(ERRCODE_FDW_INVALID_OPTION_NAME),
+					errmsg("option \"%s\" may only be given for the "
+						"foreign data wrapper", def->defname),
+					errdetail("Foreign table \"%s\" or its server \"%s\" "
+						"has the option.",
+						get_rel_name(foreigntableid), server->servername)));
+			if ( isClass )
+				o->className = defGetString(def);
+			else
+				o->schema = defGetString(def);
+		}
+		else if ( 0 == strcmp(def->defname, "batch_size") )
+			o->batchSize = batchSize(def);
+		else
+			o->others = lappend(o->others, def);
+	}
+
+	if ( NULL == o->className )
+		ereport(ERROR, (
+			errcode(ERRCODE_FDW_OPTION_NAME_NOT_FOUND),
+			errmsg("foreign data wrapper \"%s\" has no \"class\" option",
+				wrapper->fdwname)));
+}
+
+static int batchSize(DefElem *def)
+{
+	char *value = defGetString(def);
+	char *end;
+	long n;
+
+	errno = 0;
+	n = strtol(value, &end, 10);
+	if ( end == value  ||  '\0' != *end  ||  0 != errno
+		|| n < 1  ||  n > MAX_BATCH_SIZE )
+		ereport(ERROR, (
+			errcode(ERRCODE_FDW_INVALID_ATTRIBUTE_VALUE),
+			errmsg("invalid value for option \"batch_size\": \"%s\"", value),
+			errhint("The value must be an integer from 1 to %d.",
+				MAX_BATCH_SIZE)));
+	return (int)n;
+}
+
+/*
+ * Find the restriction clauses of the form column operator constant (or
+ * constant operator column, if the operator has a commutator), to be passed
+ * to Java.
+ */
+static void extractQuals(RelOptInfo *baserel, PlanInfo *info)
+{
+	ListCell *lc;
+
+	foreach(lc, baserel->baserestrictinfo)
+	{
+		Expr *clause = ((RestrictInfo *)lfirst(lc))->clause;
+		OpExpr *op;
+		Node *left;
+		Node *right;
+		Var *var;
+		Oid opno;
+
+		if ( ! IsA(clause, OpExpr) )
+			continue;
+		op = (OpExpr *)clause;
+		if ( 2 != list_length(op->args) )
+			continue;
+
+		left = (Node *)linitial(op->args);
+		right = (Node *)lsecond(op->args);
+		opno = op->opno;
+
+		if ( IsA(left, Const)  &&  IsA(right, Var) )
+		{
+			Node *t = left;
+			left = right;
+			right = t;
+			opno = get_commutator(opno);
+			if ( InvalidOid == opno )
+				continue;
+		}
+
+		if ( ! IsA(left, Var)  ||  ! IsA(right, Const) )
+			continue;
+		var = (Var *)left;
+		if ( var->varno != baserel->relid  ||  0 != var->varlevelsup
+			|| var->varattno <= 0 )
+			continue;
+		if ( ((Const *)right)->constisnull )
+			continue;
+
+		info->qualAttnos = lappend_int(info->qualAttnos, var->varattno);
+		info->qualOps = lappend(info->qualOps, makeString(get_opname(opno)));
+		info->qualConsts = lappend(info->qualConsts, right);
+	}
+}
+
+static void optionArrays(
+	List *defs, jobjectArray *names, jobjectArray *values)
+{
+	int n = list_length(defs);
+	int i = 0;
+	ListCell *lc;
+
+	*names = JNI_newObjectArray(n, s_String_class, NULL);
+	*values = JNI_newObjectArray(n, s_String_class, NULL);
+
+	foreach(lc, defs)
+	{
+		DefElem *def = (DefElem *)lfirst(lc);
+		JNI_setObjectArrayElement(*names, i,
+			String_createJavaStringFromNTS(def->defname));
+		JNI_setObjectArrayElement(*values, i,
+			String_createJavaStringFromNTS(defGetString(def)));
+		++ i;
+	}
+}
+
+static void qualArrays(
+	Oid relid, List *attnos, List *ops, List *consts,
+	jobjectArray *columns, jobjectArray *operators, jobjectArray *values)
+{
+	int n = list_length(attnos);
+	int i = 0;
+	ListCell *la;
+	ListCell *lo;
+	ListCell *lc;
+
+	*columns = JNI_newObjectArray(n, s_String_class, NULL);
+	*operators = JNI_newObjectArray(n, s_String_class, NULL);
+	*values = JNI_newObjectArray(n, s_Object_class, NULL);
+
+	forthree(la, attnos, lo, ops, lc, consts)
+	{
+		Const *c = (Const *)lfirst(lc);
+		Type type = Type_objectTypeFromOid(c->consttype, NULL);
+
+		JNI_setObjectArrayElement(*columns, i,
+			String_createJavaStringFromNTS(
+				ATTNAME(relid, (AttrNumber)lfirst_int(la))));
+		JNI_setObjectArrayElement(*operators, i,
+			String_createJavaStringFromNTS(strVal(lfirst(lo))));
+		JNI_setObjectArrayElement(*values, i,
+			Type_coerceDatum(type, c->constvalue).l);
+		++ i;
+	}
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2022 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -13,13 +13,16 @@
 #include "org_postgresql_pljava_internal_Function.h"
 #include "org_postgresql_pljava_internal_Function_EarlyNatives.h"
 #include "pljava/PgObject_priv.h"
+#include "pljava/Backend.h"
 #include "pljava/Exception.h"
 #include "pljava/InstallHelper.h"
 #include "pljava/Invocation.h"
 #include "pljava/Function.h"
+#include "pljava/GiST.h"
 #include "pljava/HashMap.h"
 #include "pljava/Iterator.h"
 #include "pljava/JNICalls.h"
+#include "pljava/OrderedSet.h"
 #include "pljava/type/Composite.h"
 #include "pljava/type/Oid.h"
 #include "pljava/type/String.h"
@@ -29,7 +32,12 @@
 #include <catalog/pg_proc.h>
 #include <catalog/pg_language.h>
 #include <catalog/pg_namespace.h>
+#include <catalog/pg_type.h>
+#include <catalog/namespace.h>
 #include <utils/builtins.h>
+#include <utils/inval.h>
+#include <utils/lsyscache.h>
+#include <portability/instr_time.h>
 #include <ctype.h>
 #include <funcapi.h>
 #include <utils/typcache.h>
@@ -57,6 +65,8 @@ jobject pljava_Function_NO_LOADER;
 static jclass s_Function_class;
 static jclass s_ParameterFrame_class;
 static jclass s_EntryPoints_class;
+static jclass s_Loader_class;
+static jclass s_ForeignUpcalls_class;
 static jmethodID s_Function_create;
 static jmethodID s_Function_getClassIfUDT;
 static jmethodID s_Function_udtReadHandle;
@@ -66,26 +76,82 @@ static jmethodID s_Function_udtToStringHandle;
 static jmethodID s_ParameterFrame_push;
 static jmethodID s_ParameterFrame_pop;
 static jmethodID s_EntryPoints_invoke;
+static jmethodID s_EntryPoints_invokeBudgeted;
 static jmethodID s_EntryPoints_udtWriteInvoke;
 static jmethodID s_EntryPoints_udtToStringInvoke;
 static jmethodID s_EntryPoints_udtReadInvoke;
 static jmethodID s_EntryPoints_udtParseInvoke;
+static jmethodID s_Loader_dropStaleSchemaLoaders;
+static jmethodID s_ForeignUpcalls_stubs;
+static jmethodID s_ForeignUpcalls_register;
+static jmethodID s_ForeignUpcalls_release;
+static jmethodID s_ForeignUpcalls_rethrow;
 static PgObjectClass s_FunctionClass;
 static Type s_pgproc_Type;
 
 static inline Datum invokeTrigger(Function self, PG_FUNCTION_ARGS);
 
 static jobjectArray s_referenceParameters;
-static jvalue s_primitiveParameters [ 1 + 255 ];
+/*
+ * After the 255 jvalue slots come the jshort of parameter counts (in the
+ * 256th slot) and then a bitmap with a bit for each primitive slot, set when
+ * the parameter passed there is a null for a boxed primitive type. The last
+ * slot holds the flag set by ForeignUpcalls when an upcall caught an exception.
+ */
+static jvalue s_primitiveParameters [ 1 + 255 + 4 + 1 ];
+
+/*
+ * Upcall stubs, one for each return type, in the order of the return types in
+ * ForeignUpcalls.java. They are obtained when pljava.foreign_upcalls is first
+ * found on; s_upcallsAvailable is then 1, or -1 if the Java runtime could not
+ * supply them.
+ */
+enum
+{
+	UPCALL_VOID,
+	UPCALL_BOOLEAN,
+	UPCALL_BYTE,
+	UPCALL_SHORT,
+	UPCALL_CHAR,
+	UPCALL_INT,
+	UPCALL_LONG,
+	UPCALL_FLOAT,
+	UPCALL_DOUBLE,
+	UPCALL_COUNT
+};
+
+static JNI_upcall s_upcalls [ UPCALL_COUNT ];
+static int s_upcallsAvailable;
+
+/*
+ * Cumulative count and time of Function_create calls (cache misses resolving
+ * a PL/Java function, which is where user classes get loaded), for the startup
+ * report.
+ */
+static uint64 s_resolutionCount;
+static double s_resolutionMillis;
 
 static jshort * const s_countCheck =
 	(jshort *)(((char *)s_primitiveParameters) +
 		org_postgresql_pljava_internal_Function_s_offset_paramCounts);
 
+static bits8 * const s_paramNulls =
+	(bits8 *)(((char *)s_primitiveParameters) +
+		org_postgresql_pljava_internal_Function_s_offset_paramNulls);
+
+static jboolean * const s_upcallThrew =
+	(jboolean *)(((char *)s_primitiveParameters) +
+		org_postgresql_pljava_internal_Function_s_offset_upcallThrew);
+
 struct Function_
 {
 	struct PgObject_ PgObject_extension;
 
+	/**
+	 * The oid of the function's pg_proc entry.
+	 */
+	Oid    funcOid;
+
 	/**
 	 * True if the function is not a volatile function (i.e. STABLE or
 	 * IMMUTABLE). This means that the function is not allowed to have
@@ -110,6 +176,20 @@ struct Function_
 	 */
 	jobject schemaLoader;
 
+	/**
+	 * Context for temporaries made while coercing the arguments of a call,
+	 * created on first use and reset when the outermost invocation using it
+	 * exits (see pljava_Function_endScratch).
+	 */
+	MemoryContext scratch;
+
+	/**
+	 * The number of active invocations that have used the scratch context;
+	 * it is reset only when this returns to zero, so a recursive call cannot
+	 * free what an outer call of the same function still refers to.
+	 */
+	uint32 scratchDepth;
+
 	union
 	{
 		struct
@@ -130,6 +210,12 @@ struct Function_
 		 */
 		uint16     numPrimParams;
 	
+		/*
+		 * True if any parameter is of type internal, whose arguments need
+		 * preparing before they can be wrapped for Java.
+		 */
+		bool      hasInternalParams;
+
 		/*
 		 * Array containing one type for eeach parameter.
 		 */
@@ -154,6 +240,12 @@ struct Function_
 		 * the function.
 		 */
 		jobject invocable;
+
+		/*
+		 * The number by which ForeignUpcalls knows the invocable, or zero if
+		 * it has not been registered there.
+		 */
+		jint upcallId;
 		} nonudt;
 		
 		struct
@@ -181,13 +273,33 @@ Function Function_INIT_WRITER = &s_initWriter;
 
 static HashMap s_funcMap = 0;
 
+/*
+ * The oid of sqlj.jar_repository, looked up when needed and kept (with
+ * s_jarRepositoryKnown, so a missing relation is not looked for on every call)
+ * until a relcache invalidation may have changed it. An invalidation of that
+ * relation (sent by replace_jar, or a cache reset) also sets s_loadersInvalid,
+ * and the next function lookup has the Java Loader drop any schema loaders
+ * whose class path has changed.
+ */
+static Oid s_jarRepositoryOid = InvalidOid;
+static bool s_jarRepositoryKnown = false;
+static bool s_loadersInvalid = false;
+
+static void loaderInvalCallback(Datum arg, Oid relid);
+static Oid jarRepositoryOid(void);
+
 static void _Function_finalize(PgObject func)
 {
 	Function self = (Function)func;
 	JNI_deleteGlobalRef(self->clazz);
 	JNI_deleteGlobalRef(self->schemaLoader);
+	if(self->scratch != 0)
+		MemoryContextDelete(self->scratch);
 	if(!self->isUDT)
 	{
+		if ( 0 != self->func.nonudt.upcallId )
+			JNI_callStaticVoidMethod(s_ForeignUpcalls_class,
+				s_ForeignUpcalls_release, self->func.nonudt.upcallId);
 		JNI_deleteGlobalRef(self->func.nonudt.invocable);
 		if(self->func.nonudt.typeMap != 0)
 			JNI_deleteGlobalRef(self->func.nonudt.typeMap);
@@ -235,6 +347,13 @@ void Function_initialize(void)
 
 	StaticAssertStmt(org_postgresql_pljava_internal_Function_s_sizeof_jvalue
 		== sizeof (jvalue), "Function.java has wrong size for Java JNI jvalue");
+	StaticAssertStmt(org_postgresql_pljava_internal_Function_s_offset_paramNulls
+		+ (255 + 7) / 8 <= sizeof s_primitiveParameters,
+		"Function.java has parameter null bitmap beyond the parameter area");
+	StaticAssertStmt(
+		org_postgresql_pljava_internal_Function_s_offset_upcallThrew
+		+ sizeof (jboolean) <= sizeof s_primitiveParameters,
+		"Function.java has upcall exception flag beyond the parameter area");
 
 	s_funcMap = HashMap_create(59, TopMemoryContext);
 
@@ -260,6 +379,13 @@ void Function_initialize(void)
 		"(Ljava/sql/ResultSet;Ljava/lang/String;)"
 		"Ljava/lang/Class;");
 
+	s_Loader_class = JNI_newGlobalRef(PgObject_getJavaClass(
+		"org/postgresql/pljava/sqlj/Loader"));
+	s_Loader_dropStaleSchemaLoaders = PgObject_getStaticJavaMethod(
+		s_Loader_class, "dropStaleSchemaLoaders", "()V");
+
+	CacheRegisterRelcacheCallback(loaderInvalCallback, (Datum)0);
+
 	s_EntryPoints_class = JNI_newGlobalRef(PgObject_getJavaClass(
 		"org/postgresql/pljava/internal/EntryPoints"));
 	s_EntryPoints_invoke = PgObject_getStaticJavaMethod(
@@ -268,6 +394,12 @@ void Function_initialize(void)
 		"(Lorg/postgresql/pljava/internal/EntryPoints$Invocable;)"
 		"Ljava/lang/Object;");
 
+	s_EntryPoints_invokeBudgeted = PgObject_getStaticJavaMethod(
+		s_EntryPoints_class,
+		"invokeBudgeted",
+		"(Lorg/postgresql/pljava/internal/EntryPoints$Invocable;IJJ)"
+		"Ljava/lang/Object;");
+
 	s_EntryPoints_udtWriteInvoke = PgObject_getStaticJavaMethod(
 		s_EntryPoints_class,
 		"udtWriteInvoke",
@@ -306,6 +438,18 @@ void Function_initialize(void)
 		"udtToStringHandle", "(Ljava/lang/Class;Ljava/lang/String;Z)"
 		"Lorg/postgresql/pljava/internal/EntryPoints$Invocable;");
 
+	s_ForeignUpcalls_class = JNI_newGlobalRef(PgObject_getJavaClass(
+		"org/postgresql/pljava/internal/ForeignUpcalls"));
+	s_ForeignUpcalls_stubs = PgObject_getStaticJavaMethod(
+		s_ForeignUpcalls_class, "stubs", "()[J");
+	s_ForeignUpcalls_register = PgObject_getStaticJavaMethod(
+		s_ForeignUpcalls_class, "register",
+		"(Lorg/postgresql/pljava/internal/EntryPoints$Invocable;)I");
+	s_ForeignUpcalls_release = PgObject_getStaticJavaMethod(
+		s_ForeignUpcalls_class, "release", "(I)V");
+	s_ForeignUpcalls_rethrow = PgObject_getStaticJavaMethod(
+		s_ForeignUpcalls_class, "rethrow", "()V");
+
 	PgObject_registerNatives2(s_Function_class, functionMethods);
 
 	cls = PgObject_getJavaClass("org/postgresql/pljava/sqlj/Loader");
@@ -320,71 +464,193 @@ void Function_initialize(void)
 	s_pgproc_Type = Composite_obtain(ProcedureRelation_Rowtype_Id);
 }
 
-jobject pljava_Function_refInvoke(Function self)
+/*
+ * Call an invocable of self through JNI, by way of EntryPoints.invokeBudgeted
+ * if pljava.cpu_budget or pljava.allocation_budget is set.
+ */
+static inline jobject generalInvoke(Function self, jobject invocable)
 {
+	if ( 0 == pljavaCpuBudget  &&  0 == pljavaAllocationBudget )
+		return JNI_callStaticObjectMethod(s_EntryPoints_class,
+			s_EntryPoints_invoke, invocable);
 	return JNI_callStaticObjectMethod(s_EntryPoints_class,
-		s_EntryPoints_invoke, self->func.nonudt.invocable);
+		s_EntryPoints_invokeBudgeted, invocable, (jint)self->funcOid,
+		(jlong)pljavaCpuBudget * 1000000, (jlong)pljavaAllocationBudget * 1024);
+}
+
+/*
+ * Whether to call self through an upcall stub: pljava.foreign_upcalls is on,
+ * no budget is set (budgets are enforced only on the JNI path), the stubs are
+ * available, and self's invocable is registered with ForeignUpcalls (which is
+ * done here the first time).
+ */
+static bool useUpcall(Function self)
+{
+	if ( ! pljavaForeignUpcalls )
+		return false;
+	if ( 0 != pljavaCpuBudget  ||  0 != pljavaAllocationBudget )
+		return false;
+	if ( 0 != self->func.nonudt.upcallId )
+		return true;
+
+	if ( 0 == s_upcallsAvailable )
+	{
+		jlongArray stubs = JNI_callStaticObjectMethod(
+			s_ForeignUpcalls_class, s_ForeignUpcalls_stubs);
+		s_upcallsAvailable = -1;
+		if ( NULL != stubs )
+		{
+			jlong addrs [ UPCALL_COUNT ];
+			int i;
+			JNI_getLongArrayRegion(stubs, 0, UPCALL_COUNT, addrs);
+			JNI_deleteLocalRef(stubs);
+			for ( i = 0 ; i < UPCALL_COUNT ; ++ i )
+			{
+				Ptr2Long p2l;
+				p2l.longVal = addrs[i];
+				s_upcalls[i] = (JNI_upcall)p2l.ptrVal;
+			}
+			s_upcallsAvailable = 1;
+		}
+	}
+	if ( 0 > s_upcallsAvailable )
+		return false;
+
+	self->func.nonudt.upcallId = JNI_callStaticIntMethod(
+		s_ForeignUpcalls_class, s_ForeignUpcalls_register,
+		self->func.nonudt.invocable);
+	return true;
+}
+
+/*
+ * After an upcall, rethrow in the usual JNI way any exception it caught.
+ */
+static inline void checkUpcall(void)
+{
+	if ( JNI_FALSE == *s_upcallThrew )
+		return;
+	*s_upcallThrew = JNI_FALSE;
+	JNI_callStaticVoidMethod(s_ForeignUpcalls_class, s_ForeignUpcalls_rethrow);
+}
+
+jobject pljava_Function_refInvoke(Function self)
+{
+	return generalInvoke(self, self->func.nonudt.invocable);
 }
 
 void pljava_Function_voidInvoke(Function self)
 {
-	JNI_callStaticObjectMethod(s_EntryPoints_class,
-		s_EntryPoints_invoke, self->func.nonudt.invocable);
+	if ( useUpcall(self) )
+	{
+		JNI_callVoidUpcall(
+			s_upcalls[UPCALL_VOID], self->func.nonudt.upcallId);
+		checkUpcall();
+		return;
+	}
+	generalInvoke(self, self->func.nonudt.invocable);
 }
 
 jboolean pljava_Function_booleanInvoke(Function self)
 {
-	JNI_callStaticObjectMethod(s_EntryPoints_class,
-		s_EntryPoints_invoke, self->func.nonudt.invocable);
+	if ( useUpcall(self) )
+	{
+		jboolean result = JNI_callBooleanUpcall(
+			s_upcalls[UPCALL_BOOLEAN], self->func.nonudt.upcallId);
+		checkUpcall();
+		return result;
+	}
+	generalInvoke(self, self->func.nonudt.invocable);
 	return s_primitiveParameters[0].z;
 }
 
 jbyte pljava_Function_byteInvoke(Function self)
 {
-	JNI_callStaticObjectMethod(s_EntryPoints_class,
-		s_EntryPoints_invoke, self->func.nonudt.invocable);
+	if ( useUpcall(self) )
+	{
+		jbyte result = JNI_callByteUpcall(
+			s_upcalls[UPCALL_BYTE], self->func.nonudt.upcallId);
+		checkUpcall();
+		return result;
+	}
+	generalInvoke(self, self->func.nonudt.invocable);
 	return s_primitiveParameters[0].b;
 }
 
 jshort pljava_Function_shortInvoke(Function self)
 {
-	JNI_callStaticObjectMethod(s_EntryPoints_class,
-		s_EntryPoints_invoke, self->func.nonudt.invocable);
+	if ( useUpcall(self) )
+	{
+		jshort result = JNI_callShortUpcall(
+			s_upcalls[UPCALL_SHORT], self->func.nonudt.upcallId);
+		checkUpcall();
+		return result;
+	}
+	generalInvoke(self, self->func.nonudt.invocable);
 	return s_primitiveParameters[0].s;
 }
 
 jchar pljava_Function_charInvoke(Function self)
 {
-	JNI_callStaticObjectMethod(s_EntryPoints_class,
-		s_EntryPoints_invoke, self->func.nonudt.invocable);
+	if ( useUpcall(self) )
+	{
+		jchar result = JNI_callCharUpcall(
+			s_upcalls[UPCALL_CHAR], self->func.nonudt.upcallId);
+		checkUpcall();
+		return result;
+	}
+	generalInvoke(self, self->func.nonudt.invocable);
 	return s_primitiveParameters[0].c;
 }
 
 jint pljava_Function_intInvoke(Function self)
 {
-	JNI_callStaticObjectMethod(s_EntryPoints_class,
-		s_EntryPoints_invoke, self->func.nonudt.invocable);
+	if ( useUpcall(self) )
+	{
+		jint result = JNI_callIntUpcall(
+			s_upcalls[UPCALL_INT], self->func.nonudt.upcallId);
+		checkUpcall();
+		return result;
+	}
+	generalInvoke(self, self->func.nonudt.invocable);
 	return s_primitiveParameters[0].i;
 }
 
 jfloat pljava_Function_floatInvoke(Function self)
 {
-	JNI_callStaticObjectMethod(s_EntryPoints_class,
-		s_EntryPoints_invoke, self->func.nonudt.invocable);
+	if ( useUpcall(self) )
+	{
+		jfloat result = JNI_callFloatUpcall(
+			s_upcalls[UPCALL_FLOAT], self->func.nonudt.upcallId);
+		checkUpcall();
+		return result;
+	}
+	generalInvoke(self, self->func.nonudt.invocable);
 	return s_primitiveParameters[0].f;
 }
 
 jlong pljava_Function_longInvoke(Function self)
 {
-	JNI_callStaticObjectMethod(s_EntryPoints_class,
-		s_EntryPoints_invoke, self->func.nonudt.invocable);
+	if ( useUpcall(self) )
+	{
+		jlong result = JNI_callLongUpcall(
+			s_upcalls[UPCALL_LONG], self->func.nonudt.upcallId);
+		checkUpcall();
+		return result;
+	}
+	generalInvoke(self, self->func.nonudt.invocable);
 	return s_primitiveParameters[0].j;
 }
 
 jdouble pljava_Function_doubleInvoke(Function self)
 {
-	JNI_callStaticObjectMethod(s_EntryPoints_class,
-		s_EntryPoints_invoke, self->func.nonudt.invocable);
+	if ( useUpcall(self) )
+	{
+		jdouble result = JNI_callDoubleUpcall(
+			s_upcalls[UPCALL_DOUBLE], self->func.nonudt.upcallId);
+		checkUpcall();
+		return result;
+	}
+	generalInvoke(self, self->func.nonudt.invocable);
 	return s_primitiveParameters[0].d;
 }
 
@@ -499,8 +765,7 @@ jboolean pljava_Function_vpcInvoke(
 	JNI_setObjectArrayElement(s_referenceParameters, 0, rowcollect);
 	s_primitiveParameters[0].j = call_cntr;
 	s_primitiveParameters[1].z = close;
-	*result = JNI_callStaticObjectMethod(s_EntryPoints_class,
-		s_EntryPoints_invoke, invocable);
+	*result = generalInvoke(self, invocable);
 	return s_primitiveParameters[0].z;
 }
 
@@ -729,6 +994,7 @@ static Function Function_create(
 
 	self = /* will rely on the fact that allocInstance zeroes memory */
 		(Function)PgObjectClass_allocInstance(s_FunctionClass,TopMemoryContext);
+	self->funcOid = funcOid;
 	p2l.longVal = 0;
 	p2l.ptrVal = (void *)self;
 
@@ -822,13 +1088,34 @@ getFunction(
 	Oid funcOid, bool trusted, bool forTrigger,
 	bool forValidator, bool checkBody)
 {
-	Function func =
+	Function func;
+
+	if ( ! s_jarRepositoryKnown )
+		jarRepositoryOid(); /* so the callback can recognize it */
+
+	if ( s_loadersInvalid )
+	{
+		s_loadersInvalid = false;
+		JNI_callStaticVoidMethod(
+			s_Loader_class, s_Loader_dropStaleSchemaLoaders);
+	}
+
+	func =
 		forValidator ? NULL : (Function)HashMap_getByOid(s_funcMap, funcOid);
 
 	if ( NULL == func )
 	{
+		instr_time start;
+		instr_time elapsed;
+
+		INSTR_TIME_SET_CURRENT(start);
 		func = Function_create(
 			funcOid, trusted, forTrigger, forValidator, checkBody);
+		INSTR_TIME_SET_CURRENT(elapsed);
+		INSTR_TIME_SUBTRACT(elapsed, start);
+		++ s_resolutionCount;
+		s_resolutionMillis += INSTR_TIME_GET_MILLISEC(elapsed);
+
 		if ( NULL != func )
 			HashMap_putByOid(s_funcMap, funcOid, func);
 	}
@@ -837,6 +1124,45 @@ getFunction(
 	return func;
 }
 
+/*
+ * Return this Function's scratch context, creating it if need be, and note in
+ * currentInvocation that it is in use, so it will be reset by
+ * pljava_Function_endScratch when the invocation exits.
+ */
+static inline MemoryContext
+beginScratch(Function self)
+{
+	if ( 0 == self->scratch )
+		self->scratch = AllocSetContextCreate(TopMemoryContext,
+			"PL/Java function scratch", ALLOCSET_SMALL_SIZES);
+	++ self->scratchDepth;
+	currentInvocation->usedScratch = true;
+	return self->scratch;
+}
+
+void pljava_Function_endScratch(Function self)
+{
+	if ( 0 < self->scratchDepth  &&  0 == -- self->scratchDepth )
+		MemoryContextReset(self->scratch);
+}
+
+double pljava_Function_resolutionMillis(uint64 *count)
+{
+	if ( NULL != count )
+		*count = s_resolutionCount;
+	return s_resolutionMillis;
+}
+
+uint32 pljava_Function_cacheSize(void)
+{
+	return HashMap_size(s_funcMap);
+}
+
+Oid pljava_Function_oid(Function self)
+{
+	return self->funcOid;
+}
+
 jobject Function_getTypeMap(Function self)
 {
 	return self->func.nonudt.typeMap;
@@ -854,7 +1180,30 @@ static bool Function_inUse(Function func)
 	return false;
 }
 
-void Function_clearFunctionCache(void)
+/*
+ * True if loaders is null, or func's schema loader is one of its elements.
+ */
+static bool usesLoader(Function func, jobjectArray loaders)
+{
+	jsize i;
+	jsize n;
+
+	if ( 0 == loaders )
+		return true;
+
+	n = JNI_getArrayLength(loaders);
+	for ( i = 0; i < n; ++ i )
+	{
+		jobject loader = JNI_getObjectArrayElement(loaders, i);
+		bool same = JNI_isSameObject(func->schemaLoader, loader);
+		JNI_deleteLocalRef(loader);
+		if ( same )
+			return true;
+	}
+	return false;
+}
+
+static void clearFunctionCache(jobjectArray loaders)
 {
 	Entry entry;
 
@@ -867,10 +1216,10 @@ void Function_clearFunctionCache(void)
 		Function func = (Function)Entry_getValue(entry);
 		if(func != 0)
 		{
-			if(Function_inUse(func))
+			if(Function_inUse(func) || !usesLoader(func, loaders))
 			{
-				/* This is the replace_jar function or similar. Just
-				 * move it to the new map.
+				/* This is the replace_jar function or similar, or one not
+				 * affected. Just move it to the new map.
 				 */
 				HashMap_put(s_funcMap, Entry_getKey(entry), func);
 			}
@@ -885,7 +1234,60 @@ void Function_clearFunctionCache(void)
 	PgObject_free((PgObject)oldMap);
 }
 
+void Function_clearFunctionCache(void)
+{
+	clearFunctionCache(0);
+}
+
+void Function_clearFunctionCacheFor(jobjectArray loaders)
+{
+	clearFunctionCache(loaders);
+}
+
+static Oid jarRepositoryOid(void)
+{
+	Oid nsp;
+
+	if ( ! s_jarRepositoryKnown )
+	{
+		nsp = get_namespace_oid("sqlj", true);
+		s_jarRepositoryOid = InvalidOid == nsp ? InvalidOid
+			: get_relname_relid("jar_repository", nsp);
+		s_jarRepositoryKnown = true;
+	}
+	return s_jarRepositoryOid;
+}
+
+/*
+ * Only sets flags; no catalog access is allowed here. The oid is forgotten so
+ * it is looked up again, in case the relation has been dropped; while it is
+ * not known to exist, any relation invalidated might be its creation.
+ */
+static void loaderInvalCallback(Datum arg, Oid relid)
+{
+	if ( InvalidOid == relid  ||  s_jarRepositoryOid == relid )
+	{
+		s_loadersInvalid = true;
+		s_jarRepositoryOid = InvalidOid;
+		s_jarRepositoryKnown = false;
+	}
+	else if ( InvalidOid == s_jarRepositoryOid )
+		s_jarRepositoryKnown = false;
+}
+
+void Function_invalidateLoaders(void)
+{
+	Oid relid = jarRepositoryOid();
+	if ( InvalidOid != relid )
+		CacheInvalidateRelcacheByRelid(relid);
+}
+
 /*
+ * A boxed primitive type (Integer, for example) is also passed in the
+ * primitive area, as its primitive value with a bit in s_paramNulls telling
+ * whether it is null, and is boxed in Java by the invocation handle, where
+ * valueOf caching and escape analysis can spare the allocation.
+ *
  * Type_isPrimitive() by itself returns true for both, say, int and int[].
  * That is sometimes relied on, as in the code that would accept Integer[]
  * as a replacement for int[].
@@ -898,7 +1300,8 @@ void Function_clearFunctionCache(void)
 static inline bool
 passAsPrimitive(Type t)
 {
-	return Type_isPrimitive(t) && (NULL == Type_getElementType(t));
+	return ( Type_isPrimitive(t) && (NULL == Type_getElementType(t)) )
+		|| Type_isBoxedPrimitive(t);
 }
 
 Datum
@@ -963,6 +1366,21 @@ Function_invoke(
 
 	installContextLoader(self);
 
+	/*
+	 * An argument of type internal is a pointer that needs more context than
+	 * its Type has before it can be wrapped: the sorted input of an ordered-set
+	 * aggregate is sorted, with any hypothetical row, and the arguments of a
+	 * GiST support function are resolved against the index's operator class.
+	 */
+	if ( passedArgCount > 0  &&  ! skipParameterConversion
+		&& self->func.nonudt.hasInternalParams )
+	{
+		if ( pljava_OrderedSet_isSortedInput(self->func.nonudt.paramTypes[0]) )
+			pljava_OrderedSet_prepareFinal(fcinfo);
+		pljava_GiST_prepare(
+			self->func.nonudt.paramTypes, passedArgCount, fcinfo);
+	}
+
 	invokerType = self->func.nonudt.returnType;
 
 	if ( passedArgCount > 0  &&  ! skipParameterConversion )
@@ -972,11 +1390,23 @@ Function_invoke(
 		int32 primIdx = 0;
 		Type* types = self->func.nonudt.paramTypes;
 		jvalue coerced;
+		MemoryContext oldContext;
 
 		if(Type_isDynamic(invokerType))
 			invokerType = Type_getRealType(invokerType,
 				get_fn_expr_rettype(fcinfo->flinfo), self->func.nonudt.typeMap);
 
+		/*
+		 * Whatever the coercions allocate (detoasted copies, output-function
+		 * strings, and the like) is only needed until the Java objects have
+		 * been made, so it goes in the scratch context, reset in bulk when
+		 * this invocation exits, rather than in the executor's context.
+		 */
+		oldContext = MemoryContextSwitchTo(beginScratch(self));
+
+		if ( 0 < self->func.nonudt.numPrimParams )
+			memset(s_paramNulls, 0, (self->func.nonudt.numPrimParams + 7) / 8);
+
 		for(idx = 0; idx < passedArgCount; ++idx)
 		{
 			Type paramType = types[idx];
@@ -985,10 +1415,14 @@ Function_invoke(
 			if(PG_ARGISNULL(idx))
 			{
 				/*
-				 * Set this argument to zero (or null in case of object)
+				 * Set this argument to zero (or null in case of object), and
+				 * flag it null, which matters only for a boxed primitive.
 				 */
 				if ( passPrimitive )
+				{
+					s_paramNulls[primIdx / 8] |= 1 << (primIdx % 8);
 					s_primitiveParameters[primIdx++].j = 0L;
+				}
 				else
 					++ refIdx; /* array element is already initially null */
 			}
@@ -998,7 +1432,11 @@ Function_invoke(
 					paramType = Type_getRealType(paramType,
 						get_fn_expr_argtype(fcinfo->flinfo, idx),
 						self->func.nonudt.typeMap);
-				coerced = Type_coerceDatum(paramType, PG_GETARG_DATUM(idx));
+				if ( passPrimitive  &&  ! Type_isPrimitive(paramType) )
+					coerced = Type_coerceDatumUnboxed(
+						paramType, PG_GETARG_DATUM(idx));
+				else
+					coerced = Type_coerceDatum(paramType, PG_GETARG_DATUM(idx));
 				if ( passPrimitive )
 					s_primitiveParameters[primIdx++] = coerced;
 				else
@@ -1006,6 +1444,8 @@ Function_invoke(
 						s_referenceParameters, refIdx++, coerced.l);
 			}
 		}
+
+		MemoryContextSwitchTo(oldContext);
 	}
 
 	retVal = self->func.nonudt.isMultiCall
@@ -1175,6 +1615,7 @@ JNIEXPORT jboolean JNICALL
 		self->schemaLoader = JNI_newGlobalRef(schemaLoader);
 		self->clazz = JNI_newGlobalRef(clazz);
 		self->func.nonudt.isMultiCall = (JNI_TRUE == isMultiCall);
+		self->func.nonudt.hasInternalParams = false;
 		self->func.nonudt.typeMap =
 			(NULL == typeMap) ? NULL : JNI_newGlobalRef(typeMap);
 
@@ -1223,6 +1664,9 @@ JNIEXPORT jboolean JNICALL
 					++ primParams;
 				else
 					++ refParams;
+				if ( INTERNALOID ==
+						Type_getOid(self->func.nonudt.paramTypes[i]) )
+					self->func.nonudt.hasInternalParams = true;
 			}
 		}
 
@@ -1397,9 +1841,14 @@ JNIEXPORT void JNICALL
 		else
 		{
 			self->func.nonudt.paramTypes[index] = replType;
+			/*
+			 * Move the parameter between the counts by the same test that
+			 * built them; a boxed type, or a CoerceIn of one, is passed as a
+			 * primitive though Type_isPrimitive is false for it.
+			 */
 			if ( passAsPrimitive(origType) != passAsPrimitive(replType) )
 			{
-				if ( Type_isPrimitive(replType) )
+				if ( passAsPrimitive(replType) )
 				{
 					-- self->func.nonudt.numRefParams;
 					++ self->func.nonudt.numPrimParams;
@@ -0,0 +1,731 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+#include <postgres.h>
+#include <access/genam.h>
+#include <access/gist.h>
+#include <access/htup_details.h>
+#include <catalog/pg_am.h>
+#include <catalog/pg_amproc.h>
+#include <catalog/pg_opclass.h>
+#include <catalog/pg_type.h>
+#include <utils/builtins.h>
+#include <utils/fmgroids.h>
+#include <utils/rel.h>
+#if PG_VERSION_NUM >= 120000
+#include <access/table.h>
+#else
+#include <access/heapam.h>
+#define table_open(r, l) heap_open(r, l)
+#define table_close(r, l) heap_close(r, l)
+#endif
+
+#include "org_postgresql_pljava_internal_GiSTSupport.h"
+#include "pljava/DualState.h"
+#include "pljava/Exception.h"
+#include "pljava/GiST.h"
+#include "pljava/Invocation.h"
+#include "pljava/PgObject.h"
+#include "pljava/type/Type_priv.h"
+
+#if PG_VERSION_NUM >= 120000
+#define SET_ARG(fcinfo, i, v) \
+	((fcinfo)->args[i].value = (v), (fcinfo)->args[i].isnull = false)
+#else
+#define SET_ARG(fcinfo, i, v) \
+	((fcinfo)->arg[i] = (v), (fcinfo)->argnull[i] = false)
+#endif
+
+/*
+ * The kinds of internal argument in the GiST support-function protocol, each
+ * with its nested interface of org.postgresql.pljava.GiST and its class nested
+ * in org.postgresql.pljava.internal.GiSTSupport.
+ */
+typedef enum
+{
+	GIST_ENTRY,
+	GIST_ENTRY_VECTOR,
+	GIST_SPLIT,
+	GIST_RECHECK,
+	GIST_PENALTY,
+	GIST_SAME,
+	GIST_UNION_SIZE,
+	GIST_NKINDS
+} GiSTKind;
+
+static const struct
+{
+	const char *typeClassName;
+	const char *javaTypeName;
+	const char *JNISignature;
+	const char *implClass;
+} s_kinds[GIST_NKINDS] =
+{
+	{ "type.GiST.Entry", "org.postgresql.pljava.GiST.Entry",
+		"Lorg/postgresql/pljava/GiST$Entry;",
+		"org/postgresql/pljava/internal/GiSTSupport$Entry" },
+	{ "type.GiST.EntryVector", "org.postgresql.pljava.GiST.EntryVector",
+		"Lorg/postgresql/pljava/GiST$EntryVector;",
+		"org/postgresql/pljava/internal/GiSTSupport$EntryVector" },
+	{ "type.GiST.Split", "org.postgresql.pljava.GiST.Split",
+		"Lorg/postgresql/pljava/GiST$Split;",
+		"org/postgresql/pljava/internal/GiSTSupport$Split" },
+	{ "type.GiST.Recheck", "org.postgresql.pljava.GiST.Recheck",
+		"Lorg/postgresql/pljava/GiST$Recheck;",
+		"org/postgresql/pljava/internal/GiSTSupport$Recheck" },
+	{ "type.GiST.Penalty", "org.postgresql.pljava.GiST.Penalty",
+		"Lorg/postgresql/pljava/GiST$Penalty;",
+		"org/postgresql/pljava/internal/GiSTSupport$Penalty" },
+	{ "type.GiST.Same", "org.postgresql.pljava.GiST.Same",
+		"Lorg/postgresql/pljava/GiST$Same;",
+		"org/postgresql/pljava/internal/GiSTSupport$Same" },
+	{ "type.GiST.UnionSize", "org.postgresql.pljava.GiST.UnionSize",
+		"Lorg/postgresql/pljava/GiST$UnionSize;",
+		"org/postgresql/pljava/internal/GiSTSupport$UnionSize" }
+};
+
+static Type      s_types[GIST_NKINDS];
+static jclass    s_classes[GIST_NKINDS];
+static jmethodID s_inits[GIST_NKINDS];
+static jmethodID s_GiSTSupport_pointer;
+
+/*
+ * What pljava_GiST_prepare puts in place of an internal argument: the pointer
+ * itself, and what its wrapper needs to know to convert keys and number
+ * entries. For a split, first and size are those of the entry vector being
+ * split.
+ */
+typedef struct GiSTArg
+{
+	void *pointer;
+	bool  leaf;
+	int32 first;
+	int32 size;
+	Oid   keyType;    /* of a key passed in */
+	Oid   resultType; /* of a key to be passed back */
+} GiSTArg;
+
+/*
+ * What resolve finds for a support function, kept in the caller's fn_extra so
+ * that the catalogs are searched only on the first call.
+ */
+typedef struct GiSTResolved
+{
+	uint16 procnum;
+	Oid    indexedType;
+	Oid    storageType;
+} GiSTResolved;
+
+static int kindOf(Type t);
+static uint16 resolve(FmgrInfo *flinfo, Oid *indexedType, Oid *storageType);
+static bool gistKeyType(Oid family, Oid inType, Oid *keyType);
+static jobject newWrapper(GiSTKind kind, void *pointer, bool leaf,
+	int32 first, int32 size, Oid keyType, Oid resultType);
+static jobject keyToJava(Datum key, Oid type);
+static Datum keyFromJava(jobject key, Oid type);
+static jvalue _GiST_coerceDatum(Type self, Datum arg);
+static Datum _GiST_coerceObject(Type self, jobject obj);
+
+void pljava_GiST_initialize(void)
+{
+	TypeClass cls;
+	jclass supportClass;
+	int kind;
+	JNINativeMethod methods[] =
+	{
+		{
+		"_key",
+		"(JI)Ljava/lang/Object;",
+		Java_org_postgresql_pljava_internal_GiSTSupport__1key
+		},
+		{
+		"_withKey",
+		"(JLjava/lang/Object;I)"
+		"Lorg/postgresql/pljava/internal/GiSTSupport$Entry;",
+		Java_org_postgresql_pljava_internal_GiSTSupport__1withKey
+		},
+		{
+		"_entry",
+		"(JII)Lorg/postgresql/pljava/internal/GiSTSupport$Entry;",
+		Java_org_postgresql_pljava_internal_GiSTSupport__1entry
+		},
+		{
+		"_keys",
+		"(JI[Ljava/lang/Object;I)V",
+		Java_org_postgresql_pljava_internal_GiSTSupport__1keys
+		},
+		{
+		"_split",
+		"(JI[ILjava/lang/Object;[ILjava/lang/Object;I)V",
+		Java_org_postgresql_pljava_internal_GiSTSupport__1split
+		},
+		{
+		"_setBoolean",
+		"(JZ)V",
+		Java_org_postgresql_pljava_internal_GiSTSupport__1setBoolean
+		},
+		{
+		"_setFloat",
+		"(JF)V",
+		Java_org_postgresql_pljava_internal_GiSTSupport__1setFloat
+		},
+		{
+		"_setInt",
+		"(JI)V",
+		Java_org_postgresql_pljava_internal_GiSTSupport__1setInt
+		},
+		{ 0, 0, 0 }
+	};
+
+	supportClass = PgObject_getJavaClass(
+		"org/postgresql/pljava/internal/GiSTSupport");
+	PgObject_registerNatives2(supportClass, methods);
+	s_GiSTSupport_pointer =
+		PgObject_getJavaMethod(supportClass, "pointer", "()J");
+	JNI_deleteLocalRef(supportClass);
+
+	/*
+	 * SortedInput, registered earlier, remains the mapping for internal by
+	 * oid; these are found by the Java names in a function's AS string.
+	 */
+	for ( kind = 0 ; kind < GIST_NKINDS ; ++ kind )
+	{
+		s_classes[kind] = JNI_newGlobalRef(
+			PgObject_getJavaClass(s_kinds[kind].implClass));
+		s_inits[kind] = PgObject_getJavaMethod(s_classes[kind], "<init>",
+			"(Lorg/postgresql/pljava/internal/DualState$Key;JJZIIII)V");
+
+		cls = TypeClass_alloc(s_kinds[kind].typeClassName);
+		cls->JNISignature = s_kinds[kind].JNISignature;
+		cls->javaTypeName = s_kinds[kind].javaTypeName;
+		cls->coerceDatum  = _GiST_coerceDatum;
+		cls->coerceObject = _GiST_coerceObject;
+		s_types[kind] = TypeClass_allocInstance(cls, INTERNALOID);
+		Type_registerType(s_kinds[kind].javaTypeName, s_types[kind]);
+	}
+}
+
+static int kindOf(Type t)
+{
+	int kind;
+
+	for ( kind = 0 ; kind < GIST_NKINDS ; ++ kind )
+		if ( s_types[kind] == t )
+			return kind;
+	return -1;
+}
+
+void pljava_GiST_prepare(Type *types, int nargs, PG_FUNCTION_ARGS)
+{
+	GiSTArg *vector = NULL;
+	GiSTArg *ga;
+	GISTENTRY *entry;
+	GistEntryVector *entryvec;
+	Oid indexedType;
+	Oid storageType;
+	uint16 procnum;
+	int kind;
+	int i;
+
+	for ( i = 0 ; i < nargs ; ++ i )
+	{
+		kind = kindOf(types[i]);
+		if ( -1 == kind  ||  PG_ARGISNULL(i) )
+			continue;
+
+		ga = (GiSTArg *)palloc0(sizeof *ga);
+		ga->pointer = PG_GETARG_POINTER(i);
+
+		switch ( kind )
+		{
+		case GIST_ENTRY:
+			/*
+			 * A leaf key being compressed is of the indexed type, and a key
+			 * returned by fetch is too; any other key is of the storage type.
+			 */
+			entry = (GISTENTRY *)ga->pointer;
+			procnum = resolve(fcinfo->flinfo, &indexedType, &storageType);
+			ga->leaf = entry->leafkey;
+			ga->keyType = GIST_COMPRESS_PROC == procnum && entry->leafkey
+				? indexedType : storageType;
+			ga->resultType = GIST_FETCH_PROC == procnum
+				? indexedType : storageType;
+			break;
+
+		case GIST_ENTRY_VECTOR:
+			/*
+			 * The entries being split start at FirstOffsetNumber; the entries
+			 * of a union start at zero.
+			 */
+			entryvec = (GistEntryVector *)ga->pointer;
+			procnum = resolve(fcinfo->flinfo, &indexedType, &storageType);
+			ga->first = GIST_PICKSPLIT_PROC == procnum ? FirstOffsetNumber : 0;
+			ga->size = entryvec->n - ga->first;
+			ga->keyType = ga->resultType = storageType;
+			vector = ga;
+			break;
+
+		case GIST_SPLIT:
+			if ( NULL == vector )
+				ereport(ERROR, (
+					errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+					errmsg("a GiST.Split parameter must follow a "
+						"GiST.EntryVector parameter")));
+			ga->first = vector->first;
+			ga->size = vector->size;
+			ga->keyType = ga->resultType = vector->keyType;
+			break;
+
+		default:
+			break; /* a pointer to a result, needing nothing more */
+		}
+
+		SET_ARG(fcinfo, i, PointerGetDatum(ga));
+	}
+}
+
+/*
+ * Find which GiST support function the function called through flinfo is,
+ * returning the support function number and storing the indexed and storage
+ * types of the operator class it serves.
+ *
+ * The relation in a GISTENTRY can't be what the function is found by, as GiST
+ * leaves it NULL in the entries it passes to union and decompress when making
+ * a union, as at a page split. Instead pg_amproc is searched for the function
+ * in a GiST operator family, and pg_opclass for the operator class in that
+ * family for the input type the function is registered for. The function can
+ * be found in more than one operator class only if they all use it for the
+ * same purpose on the same types, or the call would be ambiguous, as nothing in
+ * the arguments says which one it is for. The answer is cached in the fn_extra
+ * of flinfo, which GiST keeps for as long as it uses the index.
+ */
+static uint16 resolve(FmgrInfo *flinfo, Oid *indexedType, Oid *storageType)
+{
+	GiSTResolved *r = (GiSTResolved *)flinfo->fn_extra;
+	GiSTResolved found;
+	Relation amproc;
+	SysScanDesc scan;
+	ScanKeyData key;
+	HeapTuple tuple;
+	Form_pg_amproc proc;
+	Oid keyType;
+
+	if ( NULL != r )
+	{
+		*indexedType = r->indexedType;
+		*storageType = r->storageType;
+		return r->procnum;
+	}
+
+	found.procnum = 0;
+	amproc = table_open(AccessMethodProcedureRelationId, AccessShareLock);
+	ScanKeyInit(&key, Anum_pg_amproc_amproc,
+		BTEqualStrategyNumber, F_OIDEQ, ObjectIdGetDatum(flinfo->fn_oid));
+	scan = systable_beginscan(amproc, InvalidOid, false, NULL, 1, &key);
+
+	while ( HeapTupleIsValid(tuple = systable_getnext(scan)) )
+	{
+		proc = (Form_pg_amproc)GETSTRUCT(tuple);
+		if ( ! gistKeyType(
+			proc->amprocfamily, proc->amproclefttype, &keyType) )
+			continue;
+		if ( 0 == found.procnum )
+		{
+			found.procnum = (uint16)proc->amprocnum;
+			found.indexedType = proc->amproclefttype;
+			found.storageType = keyType;
+		}
+		else if ( proc->amprocnum != found.procnum
+			||  proc->amproclefttype != found.indexedType
+			||  keyType != found.storageType )
+			ereport(ERROR, (
+				errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				errmsg("function %u serves more than one GiST operator class "
+					"differently", flinfo->fn_oid),
+				errhint("Declare a separate SQL function for each "
+					"operator class.")));
+	}
+
+	systable_endscan(scan);
+	table_close(amproc, AccessShareLock);
+
+	if ( 0 == found.procnum )
+		ereport(ERROR, (
+			errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			errmsg("function %u is not a support function of a GiST "
+				"operator class", flinfo->fn_oid)));
+
+	r = MemoryContextAlloc(flinfo->fn_mcxt, sizeof *r);
+	*r = found;
+	flinfo->fn_extra = r;
+	*indexedType = found.indexedType;
+	*storageType = found.storageType;
+	return found.procnum;
+}
+
+/*
+ * Find the GiST operator class in family for the input type inType, storing
+ * its storage type, which is the input type if it declares none. False if
+ * there is no such class.
+ */
+static bool gistKeyType(Oid family, Oid inType, Oid *keyType)
+{
+	Relation opclass;
+	SysScanDesc scan;
+	ScanKeyData keys[3];
+	HeapTuple tuple;
+	Form_pg_opclass opc;
+	bool found = false;
+
+	opclass = table_open(OperatorClassRelationId, AccessShareLock);
+	ScanKeyInit(&keys[0], Anum_pg_opclass_opcmethod,
+		BTEqualStrategyNumber, F_OIDEQ, ObjectIdGetDatum(GIST_AM_OID));
+	ScanKeyInit(&keys[1], Anum_pg_opclass_opcfamily,
+		BTEqualStrategyNumber, F_OIDEQ, ObjectIdGetDatum(family));
+	ScanKeyInit(&keys[2], Anum_pg_opclass_opcintype,
+		BTEqualStrategyNumber, F_OIDEQ, ObjectIdGetDatum(inType));
+	scan = systable_beginscan(opclass, InvalidOid, false, NULL, 3, keys);
+
+	if ( HeapTupleIsValid(tuple = systable_getnext(scan)) )
+	{
+		opc = (Form_pg_opclass)GETSTRUCT(tuple);
+		*keyType = OidIsValid(opc->opckeytype) ? opc->opckeytype : inType;
+		found = true;
+	}
+
+	systable_endscan(scan);
+	table_close(opclass, AccessShareLock);
+	return found;
+}
+
+/*
+ * The Java objects are scoped to the current Invocation, as the pointers they
+ * wrap are good only until the support function returns.
+ */
+static jobject newWrapper(GiSTKind kind, void *pointer, bool leaf,
+	int32 first, int32 size, Oid keyType, Oid resultType)
+{
+	Ptr2Long p2l;
+	Ptr2Long p2lro;
+
+	p2l.longVal = 0L;
+	p2l.ptrVal = pointer;
+	p2lro.longVal = 0L;
+	p2lro.ptrVal = currentInvocation;
+
+	return JNI_newObjectLocked(s_classes[kind], s_inits[kind],
+		pljava_DualState_key(), p2lro.longVal, p2l.longVal,
+		leaf ? JNI_TRUE : JNI_FALSE, (jint)first, (jint)size,
+		(jint)keyType, (jint)resultType);
+}
+
+static jvalue _GiST_coerceDatum(Type self, Datum arg)
+{
+	jvalue result;
+	GiSTArg *ga = (GiSTArg *)DatumGetPointer(arg);
+
+	result.l = newWrapper(kindOf(self), ga->pointer, ga->leaf,
+		ga->first, ga->size, ga->keyType, ga->resultType);
+	return result;
+}
+
+/*
+ * A wrapper returned from Java (the entry from compress, say, or the penalty
+ * from penalty) returns the pointer it wraps.
+ */
+static Datum _GiST_coerceObject(Type self, jobject obj)
+{
+	Ptr2Long p2l;
+
+	p2l.longVal = JNI_callLongMethod(obj, s_GiSTSupport_pointer);
+	return PointerGetDatum(p2l.ptrVal);
+}
+
+/*
+ * A key is passed to Java as an object, boxed where that matters, as
+ * ResultSet.getObject would return it.
+ */
+static jobject keyToJava(Datum key, Oid type)
+{
+	return Type_coerceDatum(
+		Type_objectTypeFromOid(type, Invocation_getTypeMap()), key).l;
+}
+
+/*
+ * A key passed back may be boxed or not (a Double[] or a double[] for float8[],
+ * say), as long as it is of a class the type maps to. The caller has switched
+ * to the upper context, as the key is part of the support function's result.
+ */
+static Datum keyFromJava(jobject key, Oid type)
+{
+	jobject typeMap = Invocation_getTypeMap();
+	Type t = Type_objectTypeFromOid(type, typeMap);
+	const char *sig;
+
+	if ( NULL == key )
+		ereport(ERROR, (
+			errcode(ERRCODE_NULL_VALUE_NOT_ALLOWED),
+			errmsg("a GiST key passed back from Java cannot be null")));
+
+	if ( ! JNI_isInstanceOf(key, Type_getJavaClass(t)) )
+	{
+		t = Type_fromOid(type, typeMap);
+		sig = Type_getJNISignature(t);
+		if ( ( 'L' != *sig  &&  '[' != *sig )
+			|| ! JNI_isInstanceOf(key, Type_getJavaClass(t)) )
+			ereport(ERROR, (
+				errcode(ERRCODE_DATATYPE_MISMATCH),
+				errmsg("a GiST key passed back from Java is not of a class "
+					"that type %s maps to", format_type_be(type))));
+	}
+	return Type_coerceObject(t, key);
+}
+
+/****************************************
+ * JNI methods
+ ****************************************/
+
+/*
+ * Class:     org_postgresql_pljava_internal_GiSTSupport
+ * Method:    _key
+ * Signature: (JI)Ljava/lang/Object;
+ */
+JNIEXPORT jobject JNICALL
+Java_org_postgresql_pljava_internal_GiSTSupport__1key(
+	JNIEnv *env, jclass cls, jlong pointer, jint keyType)
+{
+	jobject result = NULL;
+	Ptr2Long p2l;
+	p2l.longVal = pointer;
+
+	BEGIN_NATIVE
+	PG_TRY();
+	{
+		result = keyToJava(((GISTENTRY *)p2l.ptrVal)->key, (Oid)keyType);
+	}
+	PG_CATCH();
+	{
+		Exception_throw_ERROR("Type_coerceDatum");
+	}
+	PG_END_TRY();
+	END_NATIVE
+	return result;
+}
+
+/*
+ * Class:     org_postgresql_pljava_internal_GiSTSupport
+ * Method:    _withKey
+ * Signature: (JLjava/lang/Object;I)Lorg/postgresql/pljava/internal/GiSTSupport$Entry;
+ */
+JNIEXPORT jobject JNICALL
+Java_org_postgresql_pljava_internal_GiSTSupport__1withKey(
+	JNIEnv *env, jclass cls, jlong pointer, jobject key, jint resultType)
+{
+	jobject result = NULL;
+	MemoryContext currCtx = CurrentMemoryContext;
+	Ptr2Long p2l;
+	p2l.longVal = pointer;
+
+	BEGIN_NATIVE
+	PG_TRY();
+	{
+		GISTENTRY *old = (GISTENTRY *)p2l.ptrVal;
+		GISTENTRY *entry;
+
+		Invocation_switchToUpperContext();
+		entry = (GISTENTRY *)palloc(sizeof *entry);
+		gistentryinit(*entry, keyFromJava(key, (Oid)resultType),
+			old->rel, old->page, old->offset, old->leafkey);
+		MemoryContextSwitchTo(currCtx);
+
+		result = newWrapper(GIST_ENTRY, entry, entry->leafkey, 0, 0,
+			(Oid)resultType, (Oid)resultType);
+	}
+	PG_CATCH();
+	{
+		MemoryContextSwitchTo(currCtx);
+		Exception_throw_ERROR("Type_coerceObject");
+	}
+	PG_END_TRY();
+	END_NATIVE
+	return result;
+}
+
+/*
+ * Class:     org_postgresql_pljava_internal_GiSTSupport
+ * Method:    _entry
+ * Signature: (JII)Lorg/postgresql/pljava/internal/GiSTSupport$Entry;
+ */
+JNIEXPORT jobject JNICALL
+Java_org_postgresql_pljava_internal_GiSTSupport__1entry(
+	JNIEnv *env, jclass cls, jlong pointer, jint offset, jint keyType)
+{
+	jobject result = NULL;
+	Ptr2Long p2l;
+	p2l.longVal = pointer;
+
+	BEGIN_NATIVE
+	PG_TRY();
+	{
+		GISTENTRY *entry =
+			&((GistEntryVector *)p2l.ptrVal)->vector[offset];
+
+		result = newWrapper(GIST_ENTRY, entry, entry->leafkey, 0, 0,
+			(Oid)keyType, (Oid)keyType);
+	}
+	PG_CATCH();
+	{
+		Exception_throw_ERROR("GiST entry");
+	}
+	PG_END_TRY();
+	END_NATIVE
+	return result;
+}
+
+/*
+ * Class:     org_postgresql_pljava_internal_GiSTSupport
+ * Method:    _keys
+ * Signature: (JI[Ljava/lang/Object;I)V
+ */
+JNIEXPORT void JNICALL
+Java_org_postgresql_pljava_internal_GiSTSupport__1keys(
+	JNIEnv *env, jclass cls, jlong pointer, jint first, jobjectArray into,
+	jint keyType)
+{
+	Ptr2Long p2l;
+	p2l.longVal = pointer;
+
+	BEGIN_NATIVE
+	PG_TRY();
+	{
+		GistEntryVector *entryvec = (GistEntryVector *)p2l.ptrVal;
+		jsize count = JNI_getArrayLength(into);
+		Type type =
+			Type_objectTypeFromOid((Oid)keyType, Invocation_getTypeMap());
+		jobject key;
+		jsize i;
+
+		for ( i = 0 ; i < count ; ++ i )
+		{
+			key = Type_coerceDatum(type, entryvec->vector[first + i].key).l;
+			JNI_setObjectArrayElement(into, i, key);
+			JNI_deleteLocalRef(key);
+		}
+	}
+	PG_CATCH();
+	{
+		Exception_throw_ERROR("Type_coerceDatum");
+	}
+	PG_END_TRY();
+	END_NATIVE
+}
+
+/*
+ * Class:     org_postgresql_pljava_internal_GiSTSupport
+ * Method:    _split
+ * Signature: (JI[ILjava/lang/Object;[ILjava/lang/Object;I)V
+ *
+ * The Java caller has checked that the indices are in range and that each
+ * entry is on one side.
+ */
+JNIEXPORT void JNICALL
+Java_org_postgresql_pljava_internal_GiSTSupport__1split(
+	JNIEnv *env, jclass cls, jlong pointer, jint first,
+	jintArray left, jobject leftUnion, jintArray right, jobject rightUnion,
+	jint storageType)
+{
+	MemoryContext currCtx = CurrentMemoryContext;
+	Ptr2Long p2l;
+	p2l.longVal = pointer;
+
+	BEGIN_NATIVE
+	PG_TRY();
+	{
+		GIST_SPLITVEC *v = (GIST_SPLITVEC *)p2l.ptrVal;
+		jsize nleft = JNI_getArrayLength(left);
+		jsize nright = JNI_getArrayLength(right);
+		jint *indices;
+		jsize i;
+
+		Invocation_switchToUpperContext();
+
+		indices = (jint *)palloc((Max(nleft, nright) + 1) * sizeof (jint));
+
+		v->spl_left =
+			(OffsetNumber *)palloc((nleft + 1) * sizeof (OffsetNumber));
+		JNI_getIntArrayRegion(left, 0, nleft, indices);
+		for ( i = 0 ; i < nleft ; ++ i )
+			v->spl_left[i] = (OffsetNumber)(indices[i] + first);
+		v->spl_nleft = nleft;
+
+		v->spl_right =
+			(OffsetNumber *)palloc((nright + 1) * sizeof (OffsetNumber));
+		JNI_getIntArrayRegion(right, 0, nright, indices);
+		for ( i = 0 ; i < nright ; ++ i )
+			v->spl_right[i] = (OffsetNumber)(indices[i] + first);
+		v->spl_nright = nright;
+
+		v->spl_ldatum = keyFromJava(leftUnion, (Oid)storageType);
+		v->spl_rdatum = keyFromJava(rightUnion, (Oid)storageType);
+
+		pfree(indices);
+		MemoryContextSwitchTo(currCtx);
+	}
+	PG_CATCH();
+	{
+		MemoryContextSwitchTo(currCtx);
+		Exception_throw_ERROR("Type_coerceObject");
+	}
+	PG_END_TRY();
+	END_NATIVE
+}
+
+/*
+ * Class:     org_postgresql_pljava_internal_GiSTSupport
+ * Method:    _setBoolean
+ * Signature: (JZ)V
+ */
+JNIEXPORT void JNICALL
+Java_org_postgresql_pljava_internal_GiSTSupport__1setBoolean(
+	JNIEnv *env, jclass cls, jlong pointer, jboolean value)
+{
+	Ptr2Long p2l;
+	p2l.longVal = pointer;
+	*(bool *)p2l.ptrVal = (JNI_TRUE == value);
+}
+
+/*
+ * Class:     org_postgresql_pljava_internal_GiSTSupport
+ * Method:    _setFloat
+ * Signature: (JF)V
+ */
+JNIEXPORT void JNICALL
+Java_org_postgresql_pljava_internal_GiSTSupport__1setFloat(
+	JNIEnv *env, jclass cls, jlong pointer, jfloat value)
+{
+	Ptr2Long p2l;
+	p2l.longVal = pointer;
+	*(float *)p2l.ptrVal = value;
+}
+
+/*
+ * Class:     org_postgresql_pljava_internal_GiSTSupport
+ * Method:    _setInt
+ * Signature: (JI)V
+ */
+JNIEXPORT void JNICALL
+Java_org_postgresql_pljava_internal_GiSTSupport__1setInt(
+	JNIEnv *env, jclass cls, jlong pointer, jint value)
+{
+	Ptr2Long p2l;
+	p2l.longVal = pointer;
+	*(int *)p2l.ptrVal = value;
+}
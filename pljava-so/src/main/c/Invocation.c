@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2021 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -15,12 +15,14 @@
 
 #include "org_postgresql_pljava_jdbc_Invocation.h"
 #include "pljava/Invocation.h"
+#include "pljava/Activity.h"
 #include "pljava/Function.h"
 #include "pljava/PgObject.h"
 #include "pljava/JNICalls.h"
 #include "pljava/Backend.h"
 #include "pljava/DualState.h"
 #include "pljava/Exception.h"
+#include "pljava/type/String.h"
 
 #define LOCAL_FRAME_SIZE 128
 
@@ -149,6 +151,7 @@ void Invocation_pushBootContext(Invocation* ctx)
 	ctx->primSlot0.j     = 0L;
 	ctx->savedLoader     = 0;
 	ctx->hasConnected    = false;
+	ctx->usedScratch     = false;
 	ctx->upperContext    = CurrentMemoryContext;
 	ctx->errorOccurred   = false;
 	ctx->inExprContextCB = false;
@@ -182,6 +185,7 @@ void Invocation_pushInvocation(Invocation* ctx)
 	ctx->primSlot0       = *s_primSlot0;
 	ctx->savedLoader     = pljava_Function_NO_LOADER;
 	ctx->hasConnected    = false;
+	ctx->usedScratch     = false;
 	ctx->upperContext    = CurrentMemoryContext;
 	ctx->errorOccurred   = false;
 	ctx->inExprContextCB = false;
@@ -231,14 +235,32 @@ void Invocation_popInvocation(bool wasException)
 	 */
 	pljava_DualState_nativeRelease(currentInvocation);
 
+	/*
+	 * Nothing scoped to this invocation can still refer to the temporaries
+	 * from coercing its arguments, so the scratch context can be reset.
+	 */
+	if(currentInvocation->usedScratch)
+		pljava_Function_endScratch(currentInvocation->function);
+
 	/*
 	 * Check for any DualState objects that became unreachable and can be freed.
 	 */
 	pljava_DualState_cleanEnqueuedInstances();
 
+	/*
+	 * End any progress this invocation reported.
+	 */
+	pljava_Activity_invocationExit(currentInvocation);
+
 	if(currentInvocation->hasConnected)
 		SPI_finish();
 
+	/*
+	 * Leaving PL/Java altogether, forget any Strings remembered for reuse.
+	 */
+	if(ctx == 0)
+		String_clearCache();
+
 	JNI_popLocalFrame(0);
 
 	if(ctx != 0)
@@ -300,6 +322,7 @@ Java_org_postgresql_pljava_jdbc_Invocation__1register(JNIEnv* env, jobject _this
 	if ( NULL == currentInvocation->invocation )
 	{
 		currentInvocation->invocation = (*env)->NewGlobalRef(env, _this);
+		JNI_noteNewGlobalRef();
 		return;
 	}
 	if ( (*env)->IsSameObject(env, currentInvocation->invocation, _this) )
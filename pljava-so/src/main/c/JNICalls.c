@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2021 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -16,6 +16,7 @@
 #include <string.h> /* for _MSC_VER *_min_messages hack */
 
 #include "pljava/JNICalls.h"
+#include "pljava/Activity.h"
 #include "pljava/Backend.h"
 #include "pljava/Invocation.h"
 #include "pljava/Exception.h"
@@ -31,6 +32,14 @@ static JNIEnv* primordialJNIEnv;
 
 static jobject s_threadLock;
 
+/*
+ * Global references made by JNI_newGlobalRef (or counted with
+ * JNI_noteNewGlobalRef) and not yet deleted by JNI_deleteGlobalRef. JNI offers
+ * no way to count them; this count is reported by sqlj.memory_report() so
+ * that a slow leak of them can be seen.
+ */
+static int64 s_globalRefCount;
+
 static bool s_refuseOtherThreads = false;
 static bool s_doMonitorOps = true;
 
@@ -230,8 +239,17 @@ static void endCall(JNIEnv* env)
 	if(exh != 0)
 		(*env)->ExceptionClear(env);
 
-	if(s_doMonitorOps && ((*env)->MonitorEnter(env, s_threadLock) < 0))
-		elog(ERROR, "Java enter monitor failure");
+	if(s_doMonitorOps)
+	{
+		/*
+		 * Another Java thread may be holding the lock, in PostgreSQL.
+		 */
+		uint32 priorWait = pljava_Activity_waitStart(PLJAVA_WAIT_THREAD_LOCK);
+		jint entered = (*env)->MonitorEnter(env, s_threadLock);
+		pljava_Activity_waitEnd(priorWait);
+		if(entered < 0)
+			elog(ERROR, "Java enter monitor failure");
+	}
 
 	jniEnv = env;
 	if(exh != 0)
@@ -830,6 +848,89 @@ void JNI_callStaticVoidMethodV(jclass clazz, jmethodID methodID, va_list args)
 	END_CALL
 }
 
+/*
+ * The upcalls. fn is a stub of the matching C type, cast to JNI_upcall for
+ * storage.
+ */
+void JNI_callVoidUpcall(JNI_upcall fn, jint arg)
+{
+	BEGIN_CALL
+	((void (*)(jint))fn)(arg);
+	END_CALL
+}
+
+jboolean JNI_callBooleanUpcall(JNI_upcall fn, jint arg)
+{
+	jboolean result;
+	BEGIN_CALL
+	result = ((jboolean (*)(jint))fn)(arg);
+	END_CALL
+	return result;
+}
+
+jbyte JNI_callByteUpcall(JNI_upcall fn, jint arg)
+{
+	jbyte result;
+	BEGIN_CALL
+	result = ((jbyte (*)(jint))fn)(arg);
+	END_CALL
+	return result;
+}
+
+jshort JNI_callShortUpcall(JNI_upcall fn, jint arg)
+{
+	jshort result;
+	BEGIN_CALL
+	result = ((jshort (*)(jint))fn)(arg);
+	END_CALL
+	return result;
+}
+
+jchar JNI_callCharUpcall(JNI_upcall fn, jint arg)
+{
+	jchar result;
+	BEGIN_CALL
+	result = ((jchar (*)(jint))fn)(arg);
+	END_CALL
+	return result;
+}
+
+jint JNI_callIntUpcall(JNI_upcall fn, jint arg)
+{
+	jint result;
+	BEGIN_CALL
+	result = ((jint (*)(jint))fn)(arg);
+	END_CALL
+	return result;
+}
+
+jlong JNI_callLongUpcall(JNI_upcall fn, jint arg)
+{
+	jlong result;
+	BEGIN_CALL
+	result = ((jlong (*)(jint))fn)(arg);
+	END_CALL
+	return result;
+}
+
+jfloat JNI_callFloatUpcall(JNI_upcall fn, jint arg)
+{
+	jfloat result;
+	BEGIN_CALL
+	result = ((jfloat (*)(jint))fn)(arg);
+	END_CALL
+	return result;
+}
+
+jdouble JNI_callDoubleUpcall(JNI_upcall fn, jint arg)
+{
+	jdouble result;
+	BEGIN_CALL
+	result = ((jdouble (*)(jint))fn)(arg);
+	END_CALL
+	return result;
+}
+
 void JNI_callStaticVoidMethodLocked(jclass clazz, jmethodID methodID, ...)
 {
 	va_list args;
@@ -893,6 +994,8 @@ void JNI_deleteGlobalRef(jobject object)
 	BEGIN_JAVA
 	(*env)->DeleteGlobalRef(env, object);
 	END_JAVA
+	if ( NULL != object )
+		-- s_globalRefCount;
 }
 
 void JNI_deleteLocalRef(jobject object)
@@ -1357,9 +1460,26 @@ jobject JNI_newGlobalRef(jobject object)
 	BEGIN_JAVA
 	result = (*env)->NewGlobalRef(env, object);
 	END_JAVA
+	if ( NULL != result )
+		++ s_globalRefCount;
 	return result;
 }
 
+/*
+ * For a global reference made directly with NewGlobalRef, in a native method
+ * where JNI_newGlobalRef cannot be used, that will later be deleted with
+ * JNI_deleteGlobalRef.
+ */
+void JNI_noteNewGlobalRef(void)
+{
+	++ s_globalRefCount;
+}
+
+int64 JNI_globalRefCount(void)
+{
+	return s_globalRefCount;
+}
+
 jintArray JNI_newIntArray(jsize length)
 {
 	jintArray result;
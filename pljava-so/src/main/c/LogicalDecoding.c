@@ -0,0 +1,539 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+#include <postgres.h>
+#if PG_VERSION_NUM < 130000
+#include <access/tuptoaster.h>
+#define detoast_external_attr heap_tuple_fetch_attr
+#else
+#include <access/detoast.h>
+#endif
+#include <commands/defrem.h>
+#include <replication/logical.h>
+#include <replication/reorderbuffer.h>
+#include <utils/lsyscache.h>
+#include <utils/memutils.h>
+#include <utils/rel.h>
+
+#include "pljava/LogicalDecoding.h"
+#include "pljava/Invocation.h"
+#include "pljava/PgObject.h"
+#include "pljava/type/String.h"
+#include "pljava/type/Tuple.h"
+#include "pljava/type/TupleDesc.h"
+
+#define DEFAULT_BATCH_SIZE 100
+#define MAX_BATCH_SIZE 100000
+
+/*
+ * Before PG 17, the reorder buffer keeps each tuple in a ReorderBufferTupleBuf.
+ */
+#if PG_VERSION_NUM >= 170000
+#define CHANGE_TUPLE(t) (t)
+#else
+#define CHANGE_TUPLE(t) (NULL == (t) ? NULL : &(t)->tuple)
+#endif
+
+/*
+ * Values of the Java enum LogicalDecoder.Kind, by ordinal.
+ */
+#define KIND_INSERT 0
+#define KIND_UPDATE 1
+#define KIND_DELETE 2
+
+static jclass    s_LogicalDecoding_class;
+static jmethodID s_LogicalDecoding_start;
+static jmethodID s_LogicalDecoding_begin;
+static jmethodID s_LogicalDecoding_changes;
+static jmethodID s_LogicalDecoding_commit;
+static jmethodID s_LogicalDecoding_close;
+static jclass    s_TupleDesc_class;
+static jclass    s_Tuple_class;
+
+/*
+ * A change waiting to be passed to Java. When changes are batched, the tuples
+ * and descriptor are copies in the batch context, as the reorder buffer may
+ * free its own before the batch is delivered (when a large transaction has
+ * been spilled to disk, for example). The values of toasted columns the
+ * reorder buffer has reassembled, reached by indirect toast pointers that it
+ * frees after each change, are copied into the tuples. With a batch size of
+ * one, each change is delivered from within its own callback, and nothing is
+ * copied.
+ */
+typedef struct
+{
+	jbyte       kind;
+	char       *schema;
+	char       *table;
+	TupleDesc   source; /* the relation's descriptor, to recognize reuse */
+	TupleDesc   desc;
+	HeapTuple   oldTuple;
+	HeapTuple   newTuple;
+} Change;
+
+typedef struct
+{
+	jobject       decoder; /* global ref to the Java LogicalDecoding */
+	int           batchSize;
+	int           count;
+	Change       *changes;
+	MemoryContext batchCxt;
+	MemoryContextCallback releaseCB;
+} DecodingState;
+
+static void decodeStartup(
+	LogicalDecodingContext *ctx, OutputPluginOptions *opt, bool is_init);
+static void decodeBegin(LogicalDecodingContext *ctx, ReorderBufferTXN *txn);
+static void decodeChange(LogicalDecodingContext *ctx, ReorderBufferTXN *txn,
+	Relation relation, ReorderBufferChange *rbc);
+static void decodeCommit(LogicalDecodingContext *ctx, ReorderBufferTXN *txn,
+	XLogRecPtr commit_lsn);
+static void decodeShutdown(LogicalDecodingContext *ctx);
+
+static HeapTuple copyTuple(HeapTuple tuple, TupleDesc desc);
+static void flush(LogicalDecodingContext *ctx, ReorderBufferTXN *txn);
+static void writeOutput(LogicalDecodingContext *ctx, jobjectArray output);
+static void releaseRef(void *arg);
+
+void pljava_LogicalDecoding_initialize(void)
+{
+	s_LogicalDecoding_class = (jclass)JNI_newGlobalRef(PgObject_getJavaClass(
+		"org/postgresql/pljava/internal/LogicalDecoding"));
+	s_LogicalDecoding_start = PgObject_getStaticJavaMethod(
+		s_LogicalDecoding_class, "start",
+		"(Ljava/lang/String;Ljava/lang/String;"
+		"[Ljava/lang/String;[Ljava/lang/String;)"
+		"Lorg/postgresql/pljava/internal/LogicalDecoding;");
+	s_LogicalDecoding_begin = PgObject_getJavaMethod(
+		s_LogicalDecoding_class, "begin", "(J)[Ljava/lang/String;");
+	s_LogicalDecoding_changes = PgObject_getJavaMethod(
+		s_LogicalDecoding_class, "changes",
+		"(J[B[Ljava/lang/String;[Ljava/lang/String;"
+		"[Lorg/postgresql/pljava/internal/TupleDesc;"
+		"[Lorg/postgresql/pljava/internal/Tuple;"
+		"[Lorg/postgresql/pljava/internal/Tuple;)[Ljava/lang/String;");
+	s_LogicalDecoding_commit = PgObject_getJavaMethod(
+		s_LogicalDecoding_class, "commit", "(JJ)[Ljava/lang/String;");
+	s_LogicalDecoding_close = PgObject_getJavaMethod(
+		s_LogicalDecoding_class, "close", "()V");
+
+	s_TupleDesc_class = (jclass)JNI_newGlobalRef(PgObject_getJavaClass(
+		"org/postgresql/pljava/internal/TupleDesc"));
+	s_Tuple_class = (jclass)JNI_newGlobalRef(PgObject_getJavaClass(
+		"org/postgresql/pljava/internal/Tuple"));
+}
+
+void pljava_LogicalDecoding_callbacks(OutputPluginCallbacks *cb)
+{
+	cb->startup_cb = decodeStartup;
+	cb->begin_cb = decodeBegin;
+	cb->change_cb = decodeChange;
+	cb->commit_cb = decodeCommit;
+	cb->shutdown_cb = decodeShutdown;
+}
+
+static void decodeStartup(
+	LogicalDecodingContext *ctx, OutputPluginOptions *opt, bool is_init)
+{
+	DecodingState *state;
+	char const *className = NULL;
+	char const *schema = NULL;
+	List *others = NIL;
+	ListCell *lc;
+	Invocation icx;
+
+	opt->output_type = OUTPUT_PLUGIN_TEXTUAL_OUTPUT;
+	if ( is_init )
+		return; /* only creating the slot; no options, nothing to decode */
+
+	if ( NULL == s_LogicalDecoding_class )
+		ereport(ERROR, (
+			errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			errmsg("PL/Java logical decoding could not start Java here"),
+			errhint("Read the changes with a SQL function such as "
+				"pg_logical_slot_get_changes.")));
+
+	state = (DecodingState *)
+		MemoryContextAllocZero(ctx->context, sizeof *state);
+	state->batchSize = DEFAULT_BATCH_SIZE;
+
+	foreach(lc, ctx->output_plugin_options)
+	{
+		DefElem *def = (DefElem *)lfirst(lc);
+
+		if ( 0 == strcmp(def->defname, "class") )
+			className = defGetString(def);
+		else if ( 0 == strcmp(def->defname, "schema") )
+			schema = defGetString(def);
+		else if ( 0 == strcmp(def->defname, "batch_size") )
+		{
+			int64 n = defGetInt64(def);
+			if ( n < 1  ||  n > MAX_BATCH_SIZE )
+				ereport(ERROR, (
+					errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+					errmsg("option \"batch_size\" must be from 1 to %d",
+						MAX_BATCH_SIZE)));
+			state->batchSize = (int)n;
+		}
+		else
+			others = lappend(others, def);
+	}
+
+	if ( NULL == className )
+		ereport(ERROR, (
+			errcode(ERRCODE_INVALID_PARAMETER_VALUE),
+			errmsg("PL/Java logical decoding requires a \"class\" option")));
+
+	state->changes = (Change *)MemoryContextAlloc(
+		ctx->context, state->batchSize * sizeof *state->changes);
+	state->batchCxt = AllocSetContextCreate(ctx->context,
+		"PL/Java logical decoding batch", ALLOCSET_DEFAULT_SIZES);
+
+	/*
+	 * The decoder's global reference is released with the decoding context,
+	 * whether decoding ends normally or not.
+	 */
+	state->releaseCB.func = releaseRef;
+	state->releaseCB.arg = state;
+	MemoryContextRegisterResetCallback(ctx->context, &state->releaseCB);
+	ctx->output_plugin_private = state;
+
+	Invocation_pushInvocation(&icx);
+	PG_TRY();
+	{
+		int n = list_length(others);
+		int i = 0;
+		jobjectArray names = JNI_newObjectArray(n, s_String_class, NULL);
+		jobjectArray values = JNI_newObjectArray(n, s_String_class, NULL);
+		jobject decoder;
+
+		foreach(lc, others)
+		{
+			DefElem *def = (DefElem *)lfirst(lc);
+			JNI_setObjectArrayElement(names, i,
+				String_createJavaStringFromNTS(def->defname));
+			JNI_setObjectArrayElement(values, i,
+				NULL == def->arg ? NULL
+				: String_createJavaStringFromNTS(defGetString(def)));
+			++ i;
+		}
+
+		decoder = JNI_callStaticObjectMethod(
+			s_LogicalDecoding_class, s_LogicalDecoding_start,
+			String_createJavaStringFromNTS(schema),
+			String_createJavaStringFromNTS(className), names, values);
+		state->decoder = JNI_newGlobalRef(decoder);
+		Invocation_popInvocation(false);
+	}
+	PG_CATCH();
+	{
+		Invocation_popInvocation(true);
+		PG_RE_THROW();
+	}
+	PG_END_TRY();
+}
+
+static void decodeBegin(LogicalDecodingContext *ctx, ReorderBufferTXN *txn)
+{
+	DecodingState *state = (DecodingState *)ctx->output_plugin_private;
+	Invocation icx;
+
+	Invocation_pushInvocation(&icx);
+	PG_TRY();
+	{
+		writeOutput(ctx, JNI_callObjectMethod(state->decoder,
+			s_LogicalDecoding_begin, (jlong)txn->xid));
+		Invocation_popInvocation(false);
+	}
+	PG_CATCH();
+	{
+		Invocation_popInvocation(true);
+		PG_RE_THROW();
+	}
+	PG_END_TRY();
+}
+
+static void decodeChange(LogicalDecodingContext *ctx, ReorderBufferTXN *txn,
+	Relation relation, ReorderBufferChange *rbc)
+{
+	DecodingState *state = (DecodingState *)ctx->output_plugin_private;
+	TupleDesc source = RelationGetDescr(relation);
+	bool copy = 1 < state->batchSize;
+	MemoryContext prev;
+	HeapTuple oldTuple = CHANGE_TUPLE(rbc->data.tp.oldtuple);
+	HeapTuple newTuple = CHANGE_TUPLE(rbc->data.tp.newtuple);
+	Change *c;
+	int i;
+
+	switch ( rbc->action )
+	{
+	case REORDER_BUFFER_CHANGE_INSERT:
+	case REORDER_BUFFER_CHANGE_UPDATE:
+	case REORDER_BUFFER_CHANGE_DELETE:
+		break;
+	default:
+		return;
+	}
+
+	prev = MemoryContextSwitchTo(state->batchCxt);
+	c = &state->changes[state->count];
+	c->kind =
+		REORDER_BUFFER_CHANGE_INSERT == rbc->action ? KIND_INSERT :
+		REORDER_BUFFER_CHANGE_UPDATE == rbc->action ? KIND_UPDATE :
+		KIND_DELETE;
+	c->schema = get_namespace_name(RelationGetNamespace(relation));
+	c->table = pstrdup(RelationGetRelationName(relation));
+	c->source = source;
+	c->desc = source;
+	if ( copy )
+	{
+		c->desc = NULL;
+		for ( i = state->count - 1 ; i >= 0 ; -- i )
+			if ( state->changes[i].source == source )
+			{
+				c->desc = state->changes[i].desc;
+				break;
+			}
+		if ( NULL == c->desc )
+			c->desc = CreateTupleDescCopy(source);
+	}
+	c->oldTuple = NULL == oldTuple ? NULL
+		: copy ? copyTuple(oldTuple, source) : oldTuple;
+	c->newTuple = NULL == newTuple ? NULL
+		: copy ? copyTuple(newTuple, source) : newTuple;
+	MemoryContextSwitchTo(prev);
+
+	if ( ++ state->count == state->batchSize )
+		flush(ctx, txn);
+}
+
+/*
+ * Copy a tuple to be delivered in a later batch, replacing any indirect (or
+ * expanded) toast pointer with the value it points to. A pointer to a value
+ * stored on disk is kept, as in an unbatched change; the reorder buffer passes
+ * those only for columns an update left unchanged, whose values it does not
+ * have, and they cannot be fetched while decoding.
+ */
+static HeapTuple copyTuple(HeapTuple tuple, TupleDesc desc)
+{
+	int natts = desc->natts;
+	Datum *values;
+	bool *nulls;
+	bool replaced = false;
+	HeapTuple result;
+	int i;
+
+	if ( ! HeapTupleHasExternal(tuple) )
+		return heap_copytuple(tuple);
+
+	values = (Datum *)palloc(natts * sizeof (Datum));
+	nulls = (bool *)palloc(natts * sizeof (bool));
+	heap_deform_tuple(tuple, desc, values, nulls);
+
+	for ( i = 0 ; i < natts ; ++ i )
+	{
+		Form_pg_attribute att = TupleDescAttr(desc, i);
+		struct varlena *v;
+
+		if ( nulls[i]  ||  att->attisdropped  ||  -1 != att->attlen )
+			continue;
+		v = (struct varlena *)DatumGetPointer(values[i]);
+		if ( VARATT_IS_EXTERNAL_INDIRECT(v)
+			||  VARATT_IS_EXTERNAL_EXPANDED(v) )
+		{
+			values[i] = PointerGetDatum(detoast_external_attr(v));
+			replaced = true;
+		}
+	}
+
+	if ( replaced )
+	{
+		result = heap_form_tuple(desc, values, nulls);
+		result->t_self = tuple->t_self;
+		result->t_tableOid = tuple->t_tableOid;
+	}
+	else
+		result = heap_copytuple(tuple);
+
+	pfree(values);
+	pfree(nulls);
+	return result;
+}
+
+static void decodeCommit(LogicalDecodingContext *ctx, ReorderBufferTXN *txn,
+	XLogRecPtr commit_lsn)
+{
+	DecodingState *state = (DecodingState *)ctx->output_plugin_private;
+	Invocation icx;
+
+	flush(ctx, txn);
+
+	Invocation_pushInvocation(&icx);
+	PG_TRY();
+	{
+		writeOutput(ctx, JNI_callObjectMethod(state->decoder,
+			s_LogicalDecoding_commit, (jlong)txn->xid, (jlong)commit_lsn));
+		Invocation_popInvocation(false);
+	}
+	PG_CATCH();
+	{
+		Invocation_popInvocation(true);
+		PG_RE_THROW();
+	}
+	PG_END_TRY();
+}
+
+static void decodeShutdown(LogicalDecodingContext *ctx)
+{
+	DecodingState *state = (DecodingState *)ctx->output_plugin_private;
+	Invocation icx;
+
+	if ( NULL == state  ||  NULL == state->decoder )
+		return;
+
+	Invocation_pushInvocation(&icx);
+	PG_TRY();
+	{
+		JNI_callVoidMethod(state->decoder, s_LogicalDecoding_close);
+		Invocation_popInvocation(false);
+	}
+	PG_CATCH();
+	{
+		Invocation_popInvocation(true);
+		PG_RE_THROW();
+	}
+	PG_END_TRY();
+
+	releaseRef(state);
+}
+
+/*
+ * Pass the pending changes to Java in one call. The Tuple objects borrow the
+ * pending tuples, and go stale when the Invocation is popped, after which the
+ * batch context can be reset.
+ */
+static void flush(LogicalDecodingContext *ctx, ReorderBufferTXN *txn)
+{
+	DecodingState *state = (DecodingState *)ctx->output_plugin_private;
+	int n = state->count;
+	Invocation icx;
+
+	if ( 0 == n )
+		return;
+
+	Invocation_pushInvocation(&icx);
+	PG_TRY();
+	{
+		jbyteArray kinds = JNI_newByteArray(n);
+		jobjectArray schemas = JNI_newObjectArray(n, s_String_class, NULL);
+		jobjectArray tables = JNI_newObjectArray(n, s_String_class, NULL);
+		jobjectArray descs = JNI_newObjectArray(n, s_TupleDesc_class, NULL);
+		jobjectArray olds = JNI_newObjectArray(n, s_Tuple_class, NULL);
+		jobjectArray news = JNI_newObjectArray(n, s_Tuple_class, NULL);
+		jobject desc = NULL;
+		TupleDesc lastDesc = NULL;
+		int i;
+
+		for ( i = 0 ; i < n ; ++ i )
+		{
+			Change *c = &state->changes[i];
+			jobject o;
+
+			JNI_setByteArrayRegion(kinds, i, 1, &c->kind);
+
+			o = String_createJavaStringFromNTS(c->schema);
+			JNI_setObjectArrayElement(schemas, i, o);
+			JNI_deleteLocalRef(o);
+			o = String_createJavaStringFromNTS(c->table);
+			JNI_setObjectArrayElement(tables, i, o);
+			JNI_deleteLocalRef(o);
+
+			/*
+			 * Consecutive changes to one table share one Java TupleDesc.
+			 */
+			if ( c->desc != lastDesc )
+			{
+				if ( NULL != desc )
+					JNI_deleteLocalRef(desc);
+				desc = pljava_TupleDesc_create(c->desc);
+				lastDesc = c->desc;
+			}
+			JNI_setObjectArrayElement(descs, i, desc);
+
+			if ( NULL != c->oldTuple )
+			{
+				o = pljava_Tuple_createBorrowed(c->oldTuple);
+				JNI_setObjectArrayElement(olds, i, o);
+				JNI_deleteLocalRef(o);
+			}
+			if ( NULL != c->newTuple )
+			{
+				o = pljava_Tuple_createBorrowed(c->newTuple);
+				JNI_setObjectArrayElement(news, i, o);
+				JNI_deleteLocalRef(o);
+			}
+		}
+
+		writeOutput(ctx, JNI_callObjectMethod(state->decoder,
+			s_LogicalDecoding_changes, (jlong)txn->xid,
+			kinds, schemas, tables, descs, olds, news));
+		Invocation_popInvocation(false);
+	}
+	PG_CATCH();
+	{
+		Invocation_popInvocation(true);
+		PG_RE_THROW();
+	}
+	PG_END_TRY();
+
+	state->count = 0;
+	MemoryContextReset(state->batchCxt);
+}
+
+/*
+ * Write each string of output (which may be null, for none) as one unit of
+ * plugin output.
+ */
+static void writeOutput(LogicalDecodingContext *ctx, jobjectArray output)
+{
+	int n;
+	int i;
+
+	if ( NULL == output )
+		return;
+
+	n = JNI_getArrayLength(output);
+	for ( i = 0 ; i < n ; ++ i )
+	{
+		jstring s = (jstring)JNI_getObjectArrayElement(output, i);
+		char *text = String_createNTS(s);
+
+		OutputPluginPrepareWrite(ctx, i == n - 1);
+		if ( NULL != text )
+		{
+			appendStringInfoString(ctx->out, text);
+			pfree(text);
+		}
+		OutputPluginWrite(ctx, i == n - 1);
+		JNI_deleteLocalRef(s);
+	}
+}
+
+static void releaseRef(void *arg)
+{
+	DecodingState *state = (DecodingState *)arg;
+
+	if ( NULL != state->decoder )
+	{
+		JNI_deleteGlobalRef(state->decoder);
+		state->decoder = NULL;
+	}
+}
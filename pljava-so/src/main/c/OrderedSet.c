@@ -0,0 +1,740 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+#include <postgres.h>
+#include <catalog/pg_aggregate.h>
+#include <catalog/pg_type.h>
+#include <executor/executor.h>
+#include <miscadmin.h>
+#include <nodes/makefuncs.h>
+#include <nodes/nodeFuncs.h>
+#if PG_VERSION_NUM >= 120000
+#include <optimizer/optimizer.h>
+#else
+#include <optimizer/tlist.h>
+#endif
+#include <utils/builtins.h>
+#if PG_VERSION_NUM >= 120000
+#include <utils/float.h>
+#endif
+#include <utils/lsyscache.h>
+#include <utils/memutils.h>
+#include <utils/tuplesort.h>
+#include <utils/typcache.h>
+
+#include "org_postgresql_pljava_internal_OrderedSet.h"
+#include "pljava/DualState.h"
+#include "pljava/Exception.h"
+#include "pljava/Invocation.h"
+#include "pljava/OrderedSet.h"
+#include "pljava/PgObject.h"
+#include "pljava/type/Type_priv.h"
+
+/*
+ * Signatures of the tuplesort functions, which have changed over the versions.
+ */
+#if PG_VERSION_NUM >= 150000
+#define SORT_OPTIONS , NULL, TUPLESORT_NONE
+#define GETDATUM(s, v, n) tuplesort_getdatum((s), true, true, (v), (n), NULL)
+#define GETSLOT(s, sl) tuplesort_gettupleslot((s), true, true, (sl), NULL)
+#elif PG_VERSION_NUM >= 110000
+#define SORT_OPTIONS , NULL, false
+#define GETDATUM(s, v, n) tuplesort_getdatum((s), true, (v), (n), NULL)
+#define GETSLOT(s, sl) tuplesort_gettupleslot((s), true, true, (sl), NULL)
+#elif PG_VERSION_NUM >= 100000
+#define SORT_OPTIONS , false
+#define GETDATUM(s, v, n) tuplesort_getdatum((s), true, (v), (n), NULL)
+#define GETSLOT(s, sl) tuplesort_gettupleslot((s), true, true, (sl), NULL)
+#elif PG_VERSION_NUM >= 90600
+#define SORT_OPTIONS , false
+#define GETDATUM(s, v, n) tuplesort_getdatum((s), true, (v), (n), NULL)
+#define GETSLOT(s, sl) tuplesort_gettupleslot((s), true, (sl), NULL)
+#else
+#define SORT_OPTIONS , false
+#define GETDATUM(s, v, n) tuplesort_getdatum((s), true, (v), (n))
+#define GETSLOT(s, sl) tuplesort_gettupleslot((s), true, (sl))
+#endif
+
+#if PG_VERSION_NUM >= 120000
+#define TYPE_FROM_TL(tl) ExecTypeFromTL(tl)
+#define MAKE_SLOT(td) MakeSingleTupleTableSlot((td), &TTSOpsMinimalTuple)
+#else
+#define TYPE_FROM_TL(tl) ExecTypeFromTL((tl), false)
+#define MAKE_SLOT(td) MakeSingleTupleTableSlot(td)
+#endif
+
+#ifndef TupleDescAttr
+#define TupleDescAttr(tupdesc, i) ((tupdesc)->attrs[(i)])
+#endif
+
+#if PG_VERSION_NUM >= 120000
+#define SET_ARG(fcinfo, i, v) \
+	((fcinfo)->args[i].value = (v), (fcinfo)->args[i].isnull = false)
+#else
+#define SET_ARG(fcinfo, i, v) \
+	((fcinfo)->arg[i] = (v), (fcinfo)->argnull[i] = false)
+#endif
+
+/*
+ * Identifies a state made here, so that a Java function with an internal
+ * parameter named as the finisher of some other aggregate is refused rather
+ * than handed a pointer to something else.
+ */
+#define ORDERED_SET_MAGIC 0x504A4F53
+
+static jclass    s_OrderedSet_class;
+static jmethodID s_OrderedSet_init;
+static jclass    s_Object_class;
+static Type      s_SortedInput;
+
+/*
+ * The state of one group, allocated in the aggregate's context for the group.
+ *
+ * An ordered-set aggregate with one aggregated argument is sorted as datums,
+ * leaving out nulls as PostgreSQL's percentile and mode aggregates do. Any
+ * other is sorted as tuples, all rows kept; for a hypothetical-set aggregate,
+ * with a last int4 column, 0 for an aggregated row and -1 for the hypothetical
+ * one, as a last sort key so that the hypothetical row sorts before its peers.
+ */
+typedef struct OrderedSetState
+{
+	uint32          magic;
+	bool            hypothetical;
+	bool            datumSort;
+	bool            sorted;
+	int             ncolumns;     /* aggregated, not counting the flag */
+	Oid             datumType;    /* only when datumSort */
+	Tuplesortstate *sort;
+	TupleDesc       tupdesc;      /* these two only when not datumSort */
+	TupleTableSlot *slot;
+	MemoryContext   fetchContext; /* reset for each batch fetched */
+	int64           count;        /* rows sorted, not counting hypothetical */
+	int64           fetched;      /* rows fetched, counting hypothetical */
+	int64           hypotheticalPosition; /* -1 until it has been fetched */
+} OrderedSetState;
+
+static OrderedSetState *startup(PG_FUNCTION_ARGS);
+static void shutdown(Datum arg);
+static bool fetch(OrderedSetState *state, Datum *value, bool *isnull);
+static double toDouble(Oid type, Datum value);
+static int64 toLong(Oid type, Datum value);
+static jvalue _OrderedSet_coerceDatum(Type self, Datum arg);
+
+void pljava_OrderedSet_initialize(void)
+{
+	TypeClass cls;
+	JNINativeMethod methods[] =
+	{
+		{
+		"_fetchDoubles",
+		"(J[D)I",
+		Java_org_postgresql_pljava_internal_OrderedSet__1fetchDoubles
+		},
+		{
+		"_fetchLongs",
+		"(J[J)I",
+		Java_org_postgresql_pljava_internal_OrderedSet__1fetchLongs
+		},
+		{
+		"_fetchObjects",
+		"(J[Ljava/lang/Object;)I",
+		Java_org_postgresql_pljava_internal_OrderedSet__1fetchObjects
+		},
+		{
+		"_skip",
+		"(JJ)J",
+		Java_org_postgresql_pljava_internal_OrderedSet__1skip
+		},
+		{
+		"_hypotheticalPosition",
+		"(J)J",
+		Java_org_postgresql_pljava_internal_OrderedSet__1hypotheticalPosition
+		},
+		{ 0, 0, 0 }
+	};
+
+	s_OrderedSet_class = JNI_newGlobalRef(PgObject_getJavaClass(
+		"org/postgresql/pljava/internal/OrderedSet"));
+	PgObject_registerNatives2(s_OrderedSet_class, methods);
+	s_OrderedSet_init = PgObject_getJavaMethod(s_OrderedSet_class, "<init>",
+		"(Lorg/postgresql/pljava/internal/DualState$Key;JJJZ)V");
+	s_Object_class = JNI_newGlobalRef(PgObject_getJavaClass(
+		"java/lang/Object"));
+
+	/*
+	 * Registered first, this is also the mapping for internal by oid; other
+	 * Java types of internal (those in GiST.c) are found only by Java name.
+	 */
+	cls = TypeClass_alloc("type.SortedInput");
+	cls->JNISignature = "Lorg/postgresql/pljava/SortedInput;";
+	cls->javaTypeName = "org.postgresql.pljava.SortedInput";
+	cls->coerceDatum  = _OrderedSet_coerceDatum;
+	s_SortedInput = TypeClass_allocInstance(cls, INTERNALOID);
+	Type_registerType("org.postgresql.pljava.SortedInput", s_SortedInput);
+}
+
+bool pljava_OrderedSet_isSortedInput(Type t)
+{
+	return s_SortedInput == t;
+}
+
+/*
+ * The Java object is scoped to the current Invocation, the finisher's, so it
+ * goes stale when the finisher returns.
+ */
+static jvalue _OrderedSet_coerceDatum(Type self, Datum arg)
+{
+	jvalue result;
+	OrderedSetState *state = (OrderedSetState *)DatumGetPointer(arg);
+	Ptr2Long p2l;
+	Ptr2Long p2lro;
+
+	p2l.longVal = 0L;
+	p2l.ptrVal = state;
+	p2lro.longVal = 0L;
+	p2lro.ptrVal = currentInvocation;
+
+	result.l = JNI_newObjectLocked(s_OrderedSet_class, s_OrderedSet_init,
+		pljava_DualState_key(), p2lro.longVal, p2l.longVal,
+		(jlong)(state->count + (state->hypothetical ? 1 : 0)),
+		state->hypothetical ? JNI_TRUE : JNI_FALSE);
+	return result;
+}
+
+/*
+ * Make the state for a group, from the Aggref of the aggregate being
+ * evaluated, much as PostgreSQL's ordered_set_startup does.
+ */
+static OrderedSetState *startup(PG_FUNCTION_ARGS)
+{
+	MemoryContext aggcontext;
+	MemoryContext oldcontext;
+	Aggref *aggref;
+	OrderedSetState *state;
+	List *tlist;
+	ListCell *lc;
+	int nkeys;
+	int i;
+	AttrNumber *attNums;
+	Oid *sortOperators;
+	Oid *collations;
+	bool *nullsFirst;
+
+	if ( AGG_CONTEXT_AGGREGATE != AggCheckCallContext(fcinfo, &aggcontext) )
+		ereport(ERROR, (
+			errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			errmsg("PL/Java ordered-set support called in non-aggregate "
+				"context")));
+
+	aggref = AggGetAggref(fcinfo);
+	if ( NULL == aggref  ||  ! AGGKIND_IS_ORDERED_SET(aggref->aggkind) )
+		ereport(ERROR, (
+			errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			errmsg("PL/Java ordered-set support called for an aggregate "
+				"that is not an ordered-set aggregate")));
+
+	oldcontext = MemoryContextSwitchTo(aggcontext);
+
+	state = (OrderedSetState *)palloc0(sizeof *state);
+	state->magic = ORDERED_SET_MAGIC;
+	state->hypothetical = AGGKIND_HYPOTHETICAL == aggref->aggkind;
+	state->ncolumns = list_length(aggref->args);
+	state->datumSort = ! state->hypothetical  &&  1 == state->ncolumns;
+	state->hypotheticalPosition = -1;
+	state->fetchContext = AllocSetContextCreate(aggcontext,
+		"PL/Java ordered-set fetch", ALLOCSET_SMALL_SIZES);
+
+	if ( state->datumSort )
+	{
+		SortGroupClause *sgc = linitial(aggref->aggorder);
+		TargetEntry *tle = get_sortgroupclause_tle(sgc, aggref->args);
+
+		state->datumType = exprType((Node *)tle->expr);
+		state->sort = tuplesort_begin_datum(state->datumType, sgc->sortop,
+			exprCollation((Node *)tle->expr), sgc->nulls_first, work_mem
+			SORT_OPTIONS);
+	}
+	else
+	{
+		tlist = aggref->args;
+		nkeys = list_length(aggref->aggorder);
+		if ( state->hypothetical )
+		{
+			tlist = list_copy(tlist);
+			tlist = lappend(tlist, makeTargetEntry(
+				(Expr *)makeConst(INT4OID, -1, InvalidOid, sizeof (int32),
+					Int32GetDatum(0), false, true),
+				state->ncolumns + 1, pstrdup("flag"), true));
+			++ nkeys;
+		}
+
+		state->tupdesc = TYPE_FROM_TL(tlist);
+		state->slot = MAKE_SLOT(state->tupdesc);
+
+		attNums = (AttrNumber *)palloc(nkeys * sizeof (AttrNumber));
+		sortOperators = (Oid *)palloc(nkeys * sizeof (Oid));
+		collations = (Oid *)palloc(nkeys * sizeof (Oid));
+		nullsFirst = (bool *)palloc(nkeys * sizeof (bool));
+
+		i = 0;
+		foreach(lc, aggref->aggorder)
+		{
+			SortGroupClause *sgc = (SortGroupClause *)lfirst(lc);
+			TargetEntry *tle = get_sortgroupclause_tle(sgc, aggref->args);
+
+			attNums[i] = tle->resno;
+			sortOperators[i] = sgc->sortop;
+			collations[i] = exprCollation((Node *)tle->expr);
+			nullsFirst[i] = sgc->nulls_first;
+			++ i;
+		}
+		if ( state->hypothetical )
+		{
+			attNums[i] = state->ncolumns + 1;
+			sortOperators[i] =
+				lookup_type_cache(INT4OID, TYPECACHE_LT_OPR)->lt_opr;
+			collations[i] = InvalidOid;
+			nullsFirst[i] = false;
+		}
+
+		state->sort = tuplesort_begin_heap(state->tupdesc, nkeys, attNums,
+			sortOperators, collations, nullsFirst, work_mem SORT_OPTIONS);
+	}
+
+#if PG_VERSION_NUM >= 90500
+	AggRegisterCallback(fcinfo, shutdown, PointerGetDatum(state));
+#endif
+
+	MemoryContextSwitchTo(oldcontext);
+	return state;
+}
+
+/*
+ * Release the sort (and any temporary files it has) when the group's context
+ * is reset or the aggregate is shut down.
+ */
+static void shutdown(Datum arg)
+{
+	OrderedSetState *state = (OrderedSetState *)DatumGetPointer(arg);
+
+	if ( NULL != state->sort )
+		tuplesort_end(state->sort);
+	state->sort = NULL;
+	if ( NULL != state->slot )
+		ExecDropSingleTupleTableSlot(state->slot);
+	state->slot = NULL;
+}
+
+Datum pljava_OrderedSet_transition(PG_FUNCTION_ARGS)
+{
+	OrderedSetState *state = PG_ARGISNULL(0)
+		? startup(fcinfo)
+		: (OrderedSetState *)PG_GETARG_POINTER(0);
+	TupleTableSlot *slot;
+	int nargs = PG_NARGS() - 1;
+	int i;
+
+	if ( state->datumSort )
+	{
+		if ( ! PG_ARGISNULL(1) )
+		{
+			tuplesort_putdatum(state->sort, PG_GETARG_DATUM(1), false);
+			++ state->count;
+		}
+		PG_RETURN_POINTER(state);
+	}
+
+	if ( nargs != state->ncolumns )
+		elog(ERROR, "PL/Java ordered-set transition passed %d arguments "
+			"for %d columns", nargs, state->ncolumns);
+
+	slot = state->slot;
+	ExecClearTuple(slot);
+	for ( i = 0 ; i < nargs ; ++ i )
+	{
+		slot->tts_values[i] = PG_GETARG_DATUM(i + 1);
+		slot->tts_isnull[i] = PG_ARGISNULL(i + 1);
+	}
+	if ( state->hypothetical )
+	{
+		slot->tts_values[nargs] = Int32GetDatum(0);
+		slot->tts_isnull[nargs] = false;
+	}
+	ExecStoreVirtualTuple(slot);
+	tuplesort_puttupleslot(state->sort, slot);
+	++ state->count;
+
+	PG_RETURN_POINTER(state);
+}
+
+void pljava_OrderedSet_prepareFinal(PG_FUNCTION_ARGS)
+{
+	OrderedSetState *state;
+	TupleTableSlot *slot;
+	int first;
+	int i;
+
+	if ( PG_ARGISNULL(0) )
+	{
+		/* No rows were aggregated; the finisher still gets an empty input. */
+		state = startup(fcinfo);
+		SET_ARG(fcinfo, 0, PointerGetDatum(state));
+	}
+	else
+	{
+		state = (OrderedSetState *)PG_GETARG_POINTER(0);
+		if ( ORDERED_SET_MAGIC != state->magic )
+			ereport(ERROR, (
+				errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+				errmsg("a PL/Java function with a parameter of type internal "
+					"can only be the finisher of an ordered-set aggregate "
+					"using sqlj.java_ordered_set_transition")));
+	}
+
+	if ( state->sorted )
+		ereport(ERROR, (
+			errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+			errmsg("the sorted input of a PL/Java ordered-set aggregate can "
+				"be finished only once"),
+			errhint("Declare the aggregate's finishEffect READ_WRITE, or "
+				"leave it to default.")));
+
+	if ( state->hypothetical )
+	{
+		/*
+		 * The hypothetical row is the last ncolumns direct arguments, which
+		 * follow the state; any arguments after them are the ones added for
+		 * a polymorphic finisher.
+		 */
+		first = 1 + list_length(AggGetAggref(fcinfo)->aggdirectargs)
+			- state->ncolumns;
+		slot = state->slot;
+		ExecClearTuple(slot);
+		for ( i = 0 ; i < state->ncolumns ; ++ i )
+		{
+			slot->tts_values[i] = PG_GETARG_DATUM(first + i);
+			slot->tts_isnull[i] = PG_ARGISNULL(first + i);
+		}
+		slot->tts_values[i] = Int32GetDatum(-1);
+		slot->tts_isnull[i] = false;
+		ExecStoreVirtualTuple(slot);
+		tuplesort_puttupleslot(state->sort, slot);
+	}
+
+	tuplesort_performsort(state->sort);
+	state->sorted = true;
+}
+
+/*
+ * Fetch the next row: for a datum sort, into *value and *isnull; otherwise
+ * into the slot, noting the position if it is the hypothetical row. The caller
+ * has switched to the fetch context.
+ */
+static bool fetch(OrderedSetState *state, Datum *value, bool *isnull)
+{
+	if ( state->datumSort )
+	{
+		if ( ! GETDATUM(state->sort, value, isnull) )
+			return false;
+	}
+	else
+	{
+		if ( ! GETSLOT(state->sort, state->slot) )
+			return false;
+		if ( state->hypothetical  &&  -1 == state->hypotheticalPosition
+			&& 0 != DatumGetInt32(
+				slot_getattr(state->slot, state->ncolumns + 1, isnull)) )
+			state->hypotheticalPosition = state->fetched;
+	}
+	++ state->fetched;
+	return true;
+}
+
+static double toDouble(Oid type, Datum value)
+{
+	switch ( type )
+	{
+	case FLOAT8OID:
+		return DatumGetFloat8(value);
+	case FLOAT4OID:
+		return DatumGetFloat4(value);
+	case INT8OID:
+		return (double)DatumGetInt64(value);
+	case INT4OID:
+		return DatumGetInt32(value);
+	case INT2OID:
+		return DatumGetInt16(value);
+	case NUMERICOID:
+		return DatumGetFloat8(DirectFunctionCall1(numeric_float8, value));
+	}
+	ereport(ERROR, (
+		errcode(ERRCODE_DATATYPE_MISMATCH),
+		errmsg("sorted input of type %s cannot be read as double",
+			format_type_be(type))));
+	return 0; /* not reached */
+}
+
+static int64 toLong(Oid type, Datum value)
+{
+	switch ( type )
+	{
+	case INT8OID:
+		return DatumGetInt64(value);
+	case INT4OID:
+		return DatumGetInt32(value);
+	case INT2OID:
+		return DatumGetInt16(value);
+	}
+	ereport(ERROR, (
+		errcode(ERRCODE_DATATYPE_MISMATCH),
+		errmsg("sorted input of type %s cannot be read as long",
+			format_type_be(type))));
+	return 0; /* not reached */
+}
+
+/*
+ * Check that a primitive read is of a single aggregated column; a
+ * hypothetical-set aggregate is sorted as tuples even then.
+ */
+static Oid singleColumnType(OrderedSetState *state)
+{
+	if ( state->datumSort )
+		return state->datumType;
+	if ( 1 == state->ncolumns )
+		return TupleDescAttr(state->tupdesc, 0)->atttypid;
+	ereport(ERROR, (
+		errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
+		errmsg("sorted input of %d columns cannot be read as primitives",
+			state->ncolumns)));
+	return InvalidOid; /* not reached */
+}
+
+/****************************************
+ * JNI methods
+ ****************************************/
+
+/*
+ * Class:     org_postgresql_pljava_internal_OrderedSet
+ * Method:    _fetchDoubles
+ * Signature: (J[D)I
+ */
+JNIEXPORT jint JNICALL
+Java_org_postgresql_pljava_internal_OrderedSet__1fetchDoubles(
+	JNIEnv *env, jclass cls, jlong _this, jdoubleArray into)
+{
+	jint count = 0;
+	Ptr2Long p2l;
+	p2l.longVal = _this;
+
+	BEGIN_NATIVE
+	PG_TRY();
+	{
+		OrderedSetState *state = (OrderedSetState *)p2l.ptrVal;
+		jsize max = JNI_getArrayLength(into);
+		Oid type = singleColumnType(state);
+		MemoryContext oldcontext;
+		jdouble *buf;
+		Datum value;
+		bool isnull;
+
+		MemoryContextReset(state->fetchContext);
+		oldcontext = MemoryContextSwitchTo(state->fetchContext);
+		buf = (jdouble *)palloc(Max(max, 1) * sizeof (jdouble));
+		while ( count < max  &&  fetch(state, &value, &isnull) )
+		{
+			if ( ! state->datumSort )
+				value = slot_getattr(state->slot, 1, &isnull);
+			buf[count++] = isnull ? get_float8_nan() : toDouble(type, value);
+		}
+		MemoryContextSwitchTo(oldcontext);
+		JNI_setDoubleArrayRegion(into, 0, count, buf);
+	}
+	PG_CATCH();
+	{
+		Exception_throw_ERROR("tuplesort_getdatum");
+	}
+	PG_END_TRY();
+	END_NATIVE
+	return count;
+}
+
+/*
+ * Class:     org_postgresql_pljava_internal_OrderedSet
+ * Method:    _fetchLongs
+ * Signature: (J[J)I
+ */
+JNIEXPORT jint JNICALL
+Java_org_postgresql_pljava_internal_OrderedSet__1fetchLongs(
+	JNIEnv *env, jclass cls, jlong _this, jlongArray into)
+{
+	jint count = 0;
+	Ptr2Long p2l;
+	p2l.longVal = _this;
+
+	BEGIN_NATIVE
+	PG_TRY();
+	{
+		OrderedSetState *state = (OrderedSetState *)p2l.ptrVal;
+		jsize max = JNI_getArrayLength(into);
+		Oid type = singleColumnType(state);
+		MemoryContext oldcontext;
+		jlong *buf;
+		Datum value;
+		bool isnull;
+
+		MemoryContextReset(state->fetchContext);
+		oldcontext = MemoryContextSwitchTo(state->fetchContext);
+		buf = (jlong *)palloc(Max(max, 1) * sizeof (jlong));
+		while ( count < max  &&  fetch(state, &value, &isnull) )
+		{
+			if ( ! state->datumSort )
+				value = slot_getattr(state->slot, 1, &isnull);
+			if ( isnull )
+				ereport(ERROR, (
+					errcode(ERRCODE_NULL_VALUE_NOT_ALLOWED),
+					errmsg("null in sorted input read as long")));
+			buf[count++] = toLong(type, value);
+		}
+		MemoryContextSwitchTo(oldcontext);
+		JNI_setLongArrayRegion(into, 0, count, buf);
+	}
+	PG_CATCH();
+	{
+		Exception_throw_ERROR("tuplesort_getdatum");
+	}
+	PG_END_TRY();
+	END_NATIVE
+	return count;
+}
+
+/*
+ * Class:     org_postgresql_pljava_internal_OrderedSet
+ * Method:    _fetchObjects
+ * Signature: (J[Ljava/lang/Object;)I
+ */
+JNIEXPORT jint JNICALL
+Java_org_postgresql_pljava_internal_OrderedSet__1fetchObjects(
+	JNIEnv *env, jclass cls, jlong _this, jobjectArray into)
+{
+	jint count = 0;
+	Ptr2Long p2l;
+	p2l.longVal = _this;
+
+	BEGIN_NATIVE
+	PG_TRY();
+	{
+		OrderedSetState *state = (OrderedSetState *)p2l.ptrVal;
+		jsize max = JNI_getArrayLength(into);
+		MemoryContext oldcontext;
+		Datum value;
+		bool isnull;
+		jobject obj;
+		jobjectArray row;
+		int i;
+
+		MemoryContextReset(state->fetchContext);
+		oldcontext = MemoryContextSwitchTo(state->fetchContext);
+		while ( count < max  &&  fetch(state, &value, &isnull) )
+		{
+			if ( state->datumSort )
+			{
+				obj = isnull ? NULL : Type_coerceDatum(
+					Type_objectTypeFromOid(state->datumType, NULL), value).l;
+				JNI_setObjectArrayElement(into, count++, obj);
+				JNI_deleteLocalRef(obj);
+				continue;
+			}
+			row = JNI_newObjectArray(state->ncolumns, s_Object_class, NULL);
+			for ( i = 0 ; i < state->ncolumns ; ++ i )
+			{
+				value = slot_getattr(state->slot, i + 1, &isnull);
+				if ( isnull )
+					continue;
+				obj = Type_coerceDatum(Type_objectTypeFromOid(
+					TupleDescAttr(state->tupdesc, i)->atttypid, NULL),
+					value).l;
+				JNI_setObjectArrayElement(row, i, obj);
+				JNI_deleteLocalRef(obj);
+			}
+			JNI_setObjectArrayElement(into, count++, row);
+			JNI_deleteLocalRef(row);
+		}
+		MemoryContextSwitchTo(oldcontext);
+	}
+	PG_CATCH();
+	{
+		Exception_throw_ERROR("tuplesort_getdatum");
+	}
+	PG_END_TRY();
+	END_NATIVE
+	return count;
+}
+
+/*
+ * Class:     org_postgresql_pljava_internal_OrderedSet
+ * Method:    _skip
+ * Signature: (JJ)J
+ */
+JNIEXPORT jlong JNICALL
+Java_org_postgresql_pljava_internal_OrderedSet__1skip(
+	JNIEnv *env, jclass cls, jlong _this, jlong n)
+{
+	jlong skipped = 0;
+	Ptr2Long p2l;
+	p2l.longVal = _this;
+
+	BEGIN_NATIVE
+	PG_TRY();
+	{
+		OrderedSetState *state = (OrderedSetState *)p2l.ptrVal;
+		MemoryContext oldcontext;
+		Datum value;
+		bool isnull;
+
+		if ( ! state->hypothetical )
+		{
+			/* Without a hypothetical row to watch for, skip in one call. */
+			skipped = Min(n, state->count - state->fetched);
+			if ( 0 < skipped )
+				tuplesort_skiptuples(state->sort, skipped, true);
+			state->fetched += skipped;
+		}
+		else
+		{
+			MemoryContextReset(state->fetchContext);
+			oldcontext = MemoryContextSwitchTo(state->fetchContext);
+			while ( skipped < n  &&  fetch(state, &value, &isnull) )
+				++ skipped;
+			MemoryContextSwitchTo(oldcontext);
+		}
+	}
+	PG_CATCH();
+	{
+		Exception_throw_ERROR("tuplesort_skiptuples");
+	}
+	PG_END_TRY();
+	END_NATIVE
+	return skipped;
+}
+
+/*
+ * Class:     org_postgresql_pljava_internal_OrderedSet
+ * Method:    _hypotheticalPosition
+ * Signature: (J)J
+ */
+JNIEXPORT jlong JNICALL
+Java_org_postgresql_pljava_internal_OrderedSet__1hypotheticalPosition(
+	JNIEnv *env, jclass cls, jlong _this)
+{
+	Ptr2Long p2l;
+	p2l.longVal = _this;
+	return ((OrderedSetState *)p2l.ptrVal)->hypotheticalPosition;
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2019 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -14,6 +14,7 @@
 #include "pljava/SPI.h"
 #include "pljava/Invocation.h"
 #include "pljava/Exception.h"
+#include "pljava/Stats.h"
 #include "pljava/type/String.h"
 #include "pljava/type/TupleTable.h"
 
@@ -141,6 +142,7 @@ Java_org_postgresql_pljava_internal_SPI__1exec(JNIEnv* env, jclass cls, jstring
 		PG_TRY();
 		{
 			Invocation_assertConnect();
+			pljava_Stats_spiStatement();
 			result = (jint)SPI_exec(command, (int)count);
 			if(result < 0)
 				Exception_throwSPI("exec", result);
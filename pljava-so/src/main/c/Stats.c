@@ -0,0 +1,558 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+#include <postgres.h>
+#include <miscadmin.h>
+#include <pgstat.h>
+#include <access/xact.h>
+#include <storage/ipc.h>
+#include <storage/lwlock.h>
+#include <storage/shmem.h>
+#include <utils/hsearch.h>
+#include <utils/timestamp.h>
+#if PG_VERSION_NUM >= 170000
+#include <storage/dsm_registry.h>
+#endif
+
+#include "org_postgresql_pljava_internal_Stats.h"
+#include "pljava/Exception.h"
+#include "pljava/Function.h"
+#include "pljava/Invocation.h"
+#include "pljava/PgObject.h"
+#include "pljava/Stats.h"
+
+/*
+ * The counters are numbered by constants in Stats.java.
+ */
+#define COUNTER(c) org_postgresql_pljava_internal_Stats_##c
+#define COUNTERS COUNTER(COUNTERS)
+
+/*
+ * Least time between flushes at transaction end.
+ */
+#define FLUSH_INTERVAL_MS 1000
+
+/*
+ * Slots for functions in the shared area, a power of two. Calls of functions
+ * that find no free slot are added to the UNTRACKED_CALLS counter.
+ */
+#define FUNCTION_SLOTS 1024
+
+typedef struct
+{
+	Oid   dbid;
+	Oid   funcid;    /* InvalidOid in a slot not yet used */
+	int64 calls;
+	int64 micros;
+} SharedFunction;
+
+/*
+ * The shared area, guarded by an LWLock held exclusive to add a backend's
+ * counts or zero them, and shared to copy the totals out. A slot is found by
+ * linear probing from a hash of the database and function oids.
+ *
+ * From PostgreSQL 17, the area is a DSM registry segment that holds its own
+ * lock, in a tranche numbered when the segment is made; before, the lock is
+ * the one of a named tranche requested at preload.
+ */
+typedef struct
+{
+#if PG_VERSION_NUM >= 170000
+	int            trancheId;
+	LWLock         lock;
+#elif PG_VERSION_NUM < 90600
+	LWLock        *lock;
+#endif
+	TimestampTz    resetTime;
+	int64          counters[COUNTERS];
+	SharedFunction functions[FUNCTION_SLOTS];
+} SharedStats;
+
+typedef struct
+{
+	Oid   funcid;    /* hash key */
+	int64 calls;
+	int64 micros;
+} LocalFunction;
+
+#define TRANCHE_NAME "pljava_stats"
+
+static SharedStats *s_shared;
+static LWLock *s_lock;
+static HTAB *s_localFunctions;
+static int64 s_pending[COUNTERS];
+static TimestampTz s_lastFlush;
+
+/*
+ * The JVM's own cumulative counters (classes loaded, collections, and
+ * milliseconds collecting) and PL/Java's count and time of function
+ * resolutions, as of the last flush.
+ */
+static jlong s_lastJVM[3];
+static uint64 s_lastResolutions;
+static double s_lastResolutionMillis;
+
+static jclass s_Stats_class;
+static jmethodID s_Stats_jvmCounters;
+
+static void initShared(void *ptr);
+static void statsXactCB(XactEvent event, void *arg);
+static void statsExit(int code, Datum arg);
+static SharedFunction *findSlot(Oid dbid, Oid funcid);
+static void sampleJVM(void);
+
+#if PG_VERSION_NUM < 170000
+static shmem_startup_hook_type s_prevShmemStartup;
+#if PG_VERSION_NUM >= 150000
+static shmem_request_hook_type s_prevShmemRequest;
+
+static void statsShmemRequest(void)
+{
+	if ( NULL != s_prevShmemRequest )
+		s_prevShmemRequest();
+	RequestAddinShmemSpace(MAXALIGN(sizeof (SharedStats)));
+	RequestNamedLWLockTranche(TRANCHE_NAME, 1);
+}
+#endif
+
+static void statsShmemStartup(void)
+{
+	bool found;
+
+	if ( NULL != s_prevShmemStartup )
+		s_prevShmemStartup();
+
+	LWLockAcquire(AddinShmemInitLock, LW_EXCLUSIVE);
+	s_shared = ShmemInitStruct(TRANCHE_NAME, sizeof (SharedStats), &found);
+	if ( ! found )
+	{
+		initShared(s_shared);
+#if PG_VERSION_NUM < 90600
+		s_shared->lock = LWLockAssign();
+#endif
+	}
+#if PG_VERSION_NUM >= 90600
+	s_lock = &(GetNamedLWLockTranche(TRANCHE_NAME))->lock;
+#else
+	s_lock = s_shared->lock;
+#endif
+	LWLockRelease(AddinShmemInitLock);
+}
+#endif
+
+void pljava_Stats_preload(void)
+{
+#if PG_VERSION_NUM < 170000
+#if PG_VERSION_NUM >= 150000
+	s_prevShmemRequest = shmem_request_hook;
+	shmem_request_hook = statsShmemRequest;
+#else
+	RequestAddinShmemSpace(MAXALIGN(sizeof (SharedStats)));
+#if PG_VERSION_NUM >= 90600
+	RequestNamedLWLockTranche(TRANCHE_NAME, 1);
+#else
+	RequestAddinLWLocks(1);
+#endif
+#endif
+	s_prevShmemStartup = shmem_startup_hook;
+	shmem_startup_hook = statsShmemStartup;
+#endif
+}
+
+void pljava_Stats_initialize(void)
+{
+	HASHCTL ctl;
+	JNINativeMethod methods[] =
+	{
+		{
+		"_functions",
+		"()[J",
+		Java_org_postgresql_pljava_internal_Stats__1functions
+		},
+		{
+		"_counters",
+		"()[J",
+		Java_org_postgresql_pljava_internal_Stats__1counters
+		},
+		{
+		"_reset",
+		"()Z",
+		Java_org_postgresql_pljava_internal_Stats__1reset
+		},
+		{ 0, 0, 0 }
+	};
+
+	s_Stats_class = JNI_newGlobalRef(PgObject_getJavaClass(
+		"org/postgresql/pljava/internal/Stats"));
+	PgObject_registerNatives2(s_Stats_class, methods);
+	s_Stats_jvmCounters = PgObject_getStaticJavaMethod(
+		s_Stats_class, "jvmCounters", "()[J");
+
+	if ( NULL != s_localFunctions )
+		return; /* the JVM has been started again in this session */
+
+	memset(&ctl, 0, sizeof ctl);
+	ctl.keysize = sizeof (Oid);
+	ctl.entrysize = sizeof (LocalFunction);
+	s_localFunctions = hash_create("PL/Java function statistics", 64, &ctl,
+		HASH_ELEM | HASH_BLOBS);
+
+#if PG_VERSION_NUM >= 170000
+	{
+		bool found;
+		s_shared = GetNamedDSMSegment(TRANCHE_NAME, sizeof (SharedStats),
+			initShared, &found);
+		LWLockRegisterTranche(s_shared->trancheId, TRANCHE_NAME);
+		s_lock = &s_shared->lock;
+	}
+#endif
+
+	RegisterXactCallback(statsXactCB, NULL);
+	before_shmem_exit(statsExit, 0);
+}
+
+static void initShared(void *ptr)
+{
+	SharedStats *s = (SharedStats *)ptr;
+
+	memset(s, 0, sizeof (SharedStats));
+#if PG_VERSION_NUM >= 170000
+	s->trancheId = LWLockNewTrancheId();
+	LWLockInitialize(&s->lock, s->trancheId);
+#endif
+	s->resetTime = GetCurrentTimestamp();
+}
+
+/*
+ * Flush at the ends of transactions. The JVM's counters are sampled, if a
+ * flush is due, just before committing, where an error from Java can still
+ * abort the transaction; once committed, and while aborting, no Java is
+ * called, and only the shared area is updated.
+ */
+static void statsXactCB(XactEvent event, void *arg)
+{
+	switch ( event )
+	{
+	case XACT_EVENT_PRE_COMMIT:
+		if ( NULL != s_shared  &&  NULL != s_localFunctions
+			&&  TimestampDifferenceExceeds(s_lastFlush,
+				GetCurrentTimestamp(), FLUSH_INTERVAL_MS) )
+			sampleJVM();
+		break;
+	case XACT_EVENT_COMMIT:
+	case XACT_EVENT_ABORT:
+		pljava_Stats_flush(false, false);
+		break;
+	default:
+		break;
+	}
+}
+
+/*
+ * Flush at backend exit, while the shared area is still attached. The JVM is
+ * not called, as the exit may be for an error in the middle of Java code;
+ * what it counted since the last flush is lost.
+ */
+static void statsExit(int code, Datum arg)
+{
+	pljava_Stats_flush(true, false);
+}
+
+void pljava_Stats_functionCall(Oid funcOid, instr_time *start)
+{
+	instr_time elapsed;
+	LocalFunction *lf;
+	bool found;
+
+	if ( NULL == s_shared  ||  pgstat_track_functions < TRACK_FUNC_PL )
+		return;
+
+	INSTR_TIME_SET_CURRENT(elapsed);
+	INSTR_TIME_SUBTRACT(elapsed, *start);
+
+	lf = (LocalFunction *)
+		hash_search(s_localFunctions, &funcOid, HASH_ENTER, &found);
+	if ( ! found )
+	{
+		lf->calls = 0;
+		lf->micros = 0;
+	}
+	++ lf->calls;
+	lf->micros += INSTR_TIME_GET_MICROSEC(elapsed);
+}
+
+void pljava_Stats_spiStatement(void)
+{
+	++ s_pending[COUNTER(SPI_STATEMENTS)];
+}
+
+void pljava_Stats_jvmStarted(double millis)
+{
+	++ s_pending[COUNTER(JVM_STARTS)];
+	s_pending[COUNTER(JVM_START_MICROS)] += (int64)(millis * 1000.);
+}
+
+/*
+ * Add the growth of the JVM's counters since the last sample. They start
+ * over if the JVM has been started again.
+ */
+static void sampleJVM(void)
+{
+	jlong now[3];
+	jlong delta[3];
+	int i;
+	jlongArray a =
+		JNI_callStaticObjectMethod(s_Stats_class, s_Stats_jvmCounters);
+
+	if ( NULL == a )
+		return;
+	JNI_getLongArrayRegion(a, 0, 3, now);
+	JNI_deleteLocalRef(a);
+
+	for ( i = 0 ; i < 3 ; ++ i )
+	{
+		delta[i] = now[i] >= s_lastJVM[i] ? now[i] - s_lastJVM[i] : now[i];
+		s_lastJVM[i] = now[i];
+	}
+	s_pending[COUNTER(CLASSES_LOADED)] += delta[0];
+	s_pending[COUNTER(GC_COUNT)] += delta[1];
+	s_pending[COUNTER(GC_MICROS)] += delta[2] * 1000;
+}
+
+void pljava_Stats_flush(bool force, bool withJVM)
+{
+	TimestampTz now;
+	HASH_SEQ_STATUS seq;
+	LocalFunction *lf;
+	SharedFunction *sf;
+	uint64 resolutions;
+	double resolutionMillis;
+	int i;
+
+	if ( NULL == s_shared  ||  NULL == s_localFunctions )
+		return; /* no area, or PL/Java not yet initialized in this backend */
+
+	now = GetCurrentTimestamp();
+	if ( ! force  &&
+		! TimestampDifferenceExceeds(s_lastFlush, now, FLUSH_INTERVAL_MS) )
+		return;
+	s_lastFlush = now;
+
+	if ( withJVM )
+		sampleJVM();
+
+	resolutionMillis = pljava_Function_resolutionMillis(&resolutions);
+	s_pending[COUNTER(FUNCTIONS_RESOLVED)] +=
+		(int64)(resolutions - s_lastResolutions);
+	s_pending[COUNTER(RESOLUTION_MICROS)] +=
+		(int64)((resolutionMillis - s_lastResolutionMillis) * 1000.);
+	s_lastResolutions = resolutions;
+	s_lastResolutionMillis = resolutionMillis;
+
+	LWLockAcquire(s_lock, LW_EXCLUSIVE);
+	for ( i = 0 ; i < COUNTERS ; ++ i )
+		s_shared->counters[i] += s_pending[i];
+	hash_seq_init(&seq, s_localFunctions);
+	while ( NULL != (lf = (LocalFunction *)hash_seq_search(&seq)) )
+	{
+		if ( 0 == lf->calls )
+			continue;
+		sf = findSlot(MyDatabaseId, lf->funcid);
+		if ( NULL == sf )
+			s_shared->counters[COUNTER(UNTRACKED_CALLS)] += lf->calls;
+		else
+		{
+			sf->calls += lf->calls;
+			sf->micros += lf->micros;
+		}
+		lf->calls = 0;
+		lf->micros = 0;
+	}
+	LWLockRelease(s_lock);
+
+	memset(s_pending, 0, sizeof s_pending);
+}
+
+/*
+ * The slot for a function, claimed if it has none yet, or NULL if every slot
+ * is taken. Call holding the lock exclusive.
+ */
+static SharedFunction *findSlot(Oid dbid, Oid funcid)
+{
+	uint32 h = ((uint32)funcid * 2654435761U) ^ (uint32)dbid;
+	int n;
+
+	for ( n = 0 ; n < FUNCTION_SLOTS ; ++ n )
+	{
+		SharedFunction *sf =
+			&s_shared->functions[(h + n) & (FUNCTION_SLOTS - 1)];
+		if ( funcid == sf->funcid  &&  dbid == sf->dbid )
+			return sf;
+		if ( InvalidOid == sf->funcid )
+		{
+			sf->dbid = dbid;
+			sf->funcid = funcid;
+			return sf;
+		}
+	}
+	return NULL;
+}
+
+/*
+ * Class:     org_postgresql_pljava_internal_Stats
+ * Method:    _functions
+ * Signature: ()[J
+ *
+ * After flushing this backend's counts, the totals for each function, as the
+ * database oid, function oid, calls, and microseconds; NULL if there is no
+ * shared area.
+ */
+JNIEXPORT jlongArray JNICALL
+Java_org_postgresql_pljava_internal_Stats__1functions(JNIEnv *env, jclass cls)
+{
+	jlongArray result = NULL;
+
+	BEGIN_NATIVE
+	PG_TRY();
+	{
+		if ( NULL != s_shared )
+		{
+			jlong *buf = palloc(FUNCTION_SLOTS * 4 * sizeof (jlong));
+			jsize n = 0;
+			int i;
+
+			pljava_Stats_flush(true, true);
+
+			LWLockAcquire(s_lock, LW_SHARED);
+			for ( i = 0 ; i < FUNCTION_SLOTS ; ++ i )
+			{
+				SharedFunction *sf = &s_shared->functions[i];
+				if ( InvalidOid == sf->funcid )
+					continue;
+				buf[n++] = sf->dbid;
+				buf[n++] = sf->funcid;
+				buf[n++] = sf->calls;
+				buf[n++] = sf->micros;
+			}
+			LWLockRelease(s_lock);
+
+			result = JNI_newLongArray(n);
+			JNI_setLongArrayRegion(result, 0, n, buf);
+			pfree(buf);
+		}
+	}
+	PG_CATCH();
+	{
+		Exception_throw_ERROR("pljava_Stats_functions");
+	}
+	PG_END_TRY();
+	END_NATIVE
+
+	return result;
+}
+
+/*
+ * Class:     org_postgresql_pljava_internal_Stats
+ * Method:    _counters
+ * Signature: ()[J
+ *
+ * After flushing this backend's counts, the totals of the counters numbered in
+ * Stats.java, followed by the time of the last reset in seconds since the Unix
+ * epoch; NULL if there is no shared area.
+ */
+JNIEXPORT jlongArray JNICALL
+Java_org_postgresql_pljava_internal_Stats__1counters(JNIEnv *env, jclass cls)
+{
+	jlongArray result = NULL;
+
+	BEGIN_NATIVE
+	PG_TRY();
+	{
+		if ( NULL != s_shared )
+		{
+			jlong values[COUNTERS + 1];
+			TimestampTz resetTime;
+			int i;
+
+			pljava_Stats_flush(true, true);
+
+			LWLockAcquire(s_lock, LW_SHARED);
+			for ( i = 0 ; i < COUNTERS ; ++ i )
+				values[i] = s_shared->counters[i];
+			resetTime = s_shared->resetTime;
+			LWLockRelease(s_lock);
+
+			values[COUNTERS] = (jlong)timestamptz_to_time_t(resetTime);
+			result = JNI_newLongArray(COUNTERS + 1);
+			JNI_setLongArrayRegion(result, 0, COUNTERS + 1, values);
+		}
+	}
+	PG_CATCH();
+	{
+		Exception_throw_ERROR("pljava_Stats_counters");
+	}
+	PG_END_TRY();
+	END_NATIVE
+
+	return result;
+}
+
+/*
+ * Class:     org_postgresql_pljava_internal_Stats
+ * Method:    _reset
+ * Signature: ()Z
+ *
+ * Zero the shared totals, with this backend's counts so far; false if there is
+ * no shared area.
+ */
+JNIEXPORT jboolean JNICALL
+Java_org_postgresql_pljava_internal_Stats__1reset(JNIEnv *env, jclass cls)
+{
+	jboolean result = JNI_FALSE;
+
+	BEGIN_NATIVE
+	PG_TRY();
+	{
+		if ( NULL != s_shared )
+		{
+			HASH_SEQ_STATUS seq;
+			LocalFunction *lf;
+			TimestampTz now;
+
+			/* brings the JVM and resolution baselines up to date */
+			pljava_Stats_flush(true, true);
+			now = GetCurrentTimestamp();
+
+			LWLockAcquire(s_lock, LW_EXCLUSIVE);
+			memset(s_shared->counters, 0, sizeof s_shared->counters);
+			memset(s_shared->functions, 0, sizeof s_shared->functions);
+			s_shared->resetTime = now;
+			LWLockRelease(s_lock);
+
+			memset(s_pending, 0, sizeof s_pending);
+			hash_seq_init(&seq, s_localFunctions);
+			while ( NULL != (lf = (LocalFunction *)hash_seq_search(&seq)) )
+			{
+				lf->calls = 0;
+				lf->micros = 0;
+			}
+			result = JNI_TRUE;
+		}
+	}
+	PG_CATCH();
+	{
+		Exception_throw_ERROR("pljava_Stats_reset");
+	}
+	PG_END_TRY();
+	END_NATIVE
+
+	return result;
+}
@@ -0,0 +1,446 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+#include <postgres.h>
+#include <miscadmin.h>
+#include <pgstat.h>
+#include <access/xact.h>
+#include <catalog/pg_proc.h>
+#include <catalog/pg_type.h>
+#include <executor/spi.h>
+#include <lib/stringinfo.h>
+#include <postmaster/bgworker.h>
+#include <storage/ipc.h>
+#include <storage/latch.h>
+#include <tcop/tcopprot.h>
+#include <utils/acl.h>
+#include <utils/builtins.h>
+#include <utils/guc.h>
+#include <utils/lsyscache.h>
+#include <utils/memutils.h>
+#include <utils/snapmgr.h>
+#include <utils/syscache.h>
+
+#include "pljava/Worker.h"
+
+int pljava_workerCount;
+int pljava_workerNaptime;
+
+#if PG_VERSION_NUM >= 100000
+#define WAIT_EVENT_ARG , PG_WAIT_EXTENSION
+#elif PG_VERSION_NUM >= 90600
+#define WAIT_EVENT_ARG , 0
+#else
+#define WAIT_EVENT_ARG
+#endif
+
+/*
+ * A claimed job, copied out of the transaction that claimed it.
+ */
+typedef struct
+{
+	int64 id;
+	char *owner;
+	Oid   function;
+	Datum args;
+} Job;
+
+static MemoryContext s_jobContext;
+static volatile sig_atomic_t s_gotSighup = false;
+
+/*
+ * How another worker is known in pg_stat_activity: by the bgw_type it shows
+ * as its backend_type, or, before PostgreSQL 11, by an application_name that
+ * only a backend with no client port (which any client connection has) counts
+ * by, as any client can set its application_name.
+ */
+#if PG_VERSION_NUM >= 110000
+#define SAME_WORKER_TYPE \
+	"  AND a.backend_type OPERATOR(pg_catalog.=) m.backend_type"
+#else
+#define SAME_WORKER_TYPE \
+	"  AND a.client_port IS NULL" \
+	"  AND a.application_name OPERATOR(pg_catalog.=) m.application_name"
+#endif
+
+/*
+ * Whether PL/Java is (still) installed in this database, and how many workers
+ * in this database started before this one.
+ */
+static char const s_pollSQL[] =
+	"SELECT"
+	" pg_catalog.to_regclass('sqlj.worker_job') IS NOT NULL,"
+	" (SELECT pg_catalog.count(*)"
+	"  FROM pg_catalog.pg_stat_activity a, pg_catalog.pg_stat_activity m"
+	"  WHERE m.pid OPERATOR(pg_catalog.=) pg_catalog.pg_backend_pid()"
+	"  AND a.datid OPERATOR(pg_catalog.=) m.datid"
+	SAME_WORKER_TYPE
+	"  AND ( a.backend_start OPERATOR(pg_catalog.<) m.backend_start"
+	"   OR a.backend_start OPERATOR(pg_catalog.=) m.backend_start"
+	"   AND a.pid OPERATOR(pg_catalog.<) m.pid ))";
+
+/*
+ * Jobs left 'running' by a worker that no longer exists will never finish.
+ */
+static char const s_orphanSQL[] =
+	"UPDATE sqlj.worker_job SET"
+	" jobState = 'failed', jobSqlState = 'XX000',"
+	" jobError = 'the PL/Java worker running this job exited before finishing',"
+	" finished = pg_catalog.now()"
+	" WHERE jobState OPERATOR(pg_catalog.=) 'running'"
+	" AND NOT EXISTS ("
+	"  SELECT 1 FROM pg_catalog.pg_stat_activity"
+	"  WHERE pid OPERATOR(pg_catalog.=) jobWorker)";
+
+static char const s_claimSQL[] =
+	"UPDATE sqlj.worker_job SET"
+	" jobState = 'running', jobWorker = pg_catalog.pg_backend_pid()"
+	" WHERE jobId OPERATOR(pg_catalog.=) ("
+	"  SELECT jobId FROM sqlj.worker_job"
+	"  WHERE jobState OPERATOR(pg_catalog.=) 'pending'"
+	"  ORDER BY jobId LIMIT 1 FOR UPDATE SKIP LOCKED)"
+	" RETURNING jobId, jobOwner, CAST(jobFunction AS pg_catalog.oid), jobArgs";
+
+static char const s_doneSQL[] =
+	"UPDATE sqlj.worker_job SET"
+	" jobState = 'done', jobResult = $2, finished = pg_catalog.now()"
+	" WHERE jobId OPERATOR(pg_catalog.=) $1";
+
+static char const s_failedSQL[] =
+	"UPDATE sqlj.worker_job SET"
+	" jobState = 'failed', jobSqlState = $2, jobError = $3,"
+	" finished = pg_catalog.now()"
+	" WHERE jobId OPERATOR(pg_catalog.=) $1";
+
+static void workerSighup(SIGNAL_ARGS);
+static void beginXact(char const *activity);
+static void endXact(void);
+static bool shouldExit(void);
+static void failOrphans(void);
+static bool claimJob(Job *job);
+static void runJob(Job *job);
+static void recordFailure(Job *job, ErrorData *edata);
+static char *callSQL(Oid function);
+
+int pljava_Worker_launch(char const *libraryPath, int count)
+{
+	BackgroundWorker worker;
+	int launched;
+
+	if ( strlen(libraryPath) >= BGW_MAXLEN )
+		ereport(ERROR, (
+			errcode(ERRCODE_NAME_TOO_LONG),
+			errmsg("PL/Java library path \"%s\" is too long to name in a "
+				"background worker", libraryPath)));
+
+	memset(&worker, 0, sizeof worker);
+	worker.bgw_flags =
+		BGWORKER_SHMEM_ACCESS | BGWORKER_BACKEND_DATABASE_CONNECTION;
+	worker.bgw_start_time = BgWorkerStart_RecoveryFinished;
+	worker.bgw_restart_time = 10;
+	strlcpy(worker.bgw_library_name, libraryPath, BGW_MAXLEN);
+	strlcpy(worker.bgw_function_name, "pljava_Worker_main", BGW_MAXLEN);
+	snprintf(worker.bgw_name, BGW_MAXLEN,
+		PLJAVA_WORKER_NAME " for database %u", MyDatabaseId);
+#if PG_VERSION_NUM >= 110000
+	strlcpy(worker.bgw_type, PLJAVA_WORKER_NAME, BGW_MAXLEN);
+#endif
+	worker.bgw_main_arg = ObjectIdGetDatum(MyDatabaseId);
+	worker.bgw_notify_pid = 0;
+
+	for ( launched = 0 ; launched < count ; ++ launched )
+	{
+		if ( RegisterDynamicBackgroundWorker(&worker, NULL) )
+			continue;
+		ereport(WARNING, (
+			errmsg("could start only %d of %d PL/Java workers",
+				launched, count),
+			errhint("Consider increasing max_worker_processes.")));
+		break;
+	}
+	return launched;
+}
+
+void pljava_Worker_main(Datum dbOid)
+{
+	bool orphansChecked = false;
+	Job job;
+	int rc;
+
+	pqsignal(SIGHUP, workerSighup);
+	pqsignal(SIGTERM, die);
+	BackgroundWorkerUnblockSignals();
+
+#if PG_VERSION_NUM >= 110000
+	BackgroundWorkerInitializeConnectionByOid(
+		DatumGetObjectId(dbOid), InvalidOid, 0);
+#else
+	BackgroundWorkerInitializeConnectionByOid(
+		DatumGetObjectId(dbOid), InvalidOid);
+#endif
+	SetConfigOption("application_name", PLJAVA_WORKER_NAME,
+		PGC_USERSET, PGC_S_SESSION);
+
+	s_jobContext = AllocSetContextCreate(TopMemoryContext,
+		"PL/Java worker job", ALLOCSET_DEFAULT_SIZES);
+
+	for ( ;; )
+	{
+		CHECK_FOR_INTERRUPTS();
+
+		if ( s_gotSighup )
+		{
+			s_gotSighup = false;
+			ProcessConfigFile(PGC_SIGHUP);
+		}
+
+		if ( shouldExit() )
+			proc_exit(0); /* exit status zero: not to be restarted */
+
+		if ( ! orphansChecked )
+		{
+			failOrphans();
+			orphansChecked = true;
+		}
+
+		if ( claimJob(&job) )
+		{
+			runJob(&job);
+			MemoryContextReset(s_jobContext);
+			continue;
+		}
+
+		pgstat_report_activity(STATE_IDLE, NULL);
+		rc = WaitLatch(MyLatch,
+			WL_LATCH_SET | WL_TIMEOUT | WL_POSTMASTER_DEATH,
+			pljava_workerNaptime WAIT_EVENT_ARG);
+		ResetLatch(MyLatch);
+		if ( rc & WL_POSTMASTER_DEATH )
+			proc_exit(1);
+	}
+}
+
+static void workerSighup(SIGNAL_ARGS)
+{
+	int save_errno = errno;
+	s_gotSighup = true;
+	SetLatch(MyLatch);
+	errno = save_errno;
+}
+
+static void beginXact(char const *activity)
+{
+	SetCurrentStatementStartTimestamp();
+	StartTransactionCommand();
+	if ( SPI_OK_CONNECT != SPI_connect() )
+		elog(ERROR, "PL/Java worker could not connect to SPI");
+	PushActiveSnapshot(GetTransactionSnapshot());
+	pgstat_report_activity(STATE_RUNNING, activity);
+}
+
+static void endXact(void)
+{
+	SPI_finish();
+	PopActiveSnapshot();
+	CommitTransactionCommand();
+}
+
+/*
+ * True if PL/Java has been removed from this database, or this worker is
+ * surplus to pljava.worker_count (which sqlj.submit can briefly overshoot, or
+ * which may have been reduced since this worker started).
+ */
+static bool shouldExit(void)
+{
+	bool installed;
+	int64 elders;
+	bool isnull;
+
+	beginXact("checking PL/Java worker count");
+	if ( SPI_OK_SELECT != SPI_execute(s_pollSQL, true, 1)
+		|| 1 != SPI_processed )
+		elog(ERROR, "PL/Java worker could not check the worker count");
+	installed = DatumGetBool(SPI_getbinval(SPI_tuptable->vals[0],
+		SPI_tuptable->tupdesc, 1, &isnull));
+	elders = DatumGetInt64(SPI_getbinval(SPI_tuptable->vals[0],
+		SPI_tuptable->tupdesc, 2, &isnull));
+	endXact();
+
+	return ! installed  ||  elders >= pljava_workerCount;
+}
+
+static void failOrphans(void)
+{
+	beginXact("failing orphaned PL/Java jobs");
+	if ( SPI_OK_UPDATE != SPI_execute(s_orphanSQL, false, 0) )
+		elog(ERROR, "PL/Java worker could not fail orphaned jobs");
+	endXact();
+}
+
+/*
+ * Claim the oldest pending job, if any, committing its change to 'running' so
+ * other workers will not also claim it.
+ */
+static bool claimJob(Job *job)
+{
+	MemoryContext cxt;
+	HeapTuple tup;
+	TupleDesc td;
+	bool isnull;
+	bool found;
+
+	beginXact("claiming a PL/Java job");
+	if ( SPI_OK_UPDATE_RETURNING != SPI_execute(s_claimSQL, false, 1) )
+		elog(ERROR, "PL/Java worker could not claim a job");
+
+	found = 1 == SPI_processed;
+	if ( found )
+	{
+		tup = SPI_tuptable->vals[0];
+		td = SPI_tuptable->tupdesc;
+		cxt = MemoryContextSwitchTo(s_jobContext);
+		job->id = DatumGetInt64(SPI_getbinval(tup, td, 1, &isnull));
+		job->owner = SPI_getvalue(tup, td, 2);
+		job->function = DatumGetObjectId(SPI_getbinval(tup, td, 3, &isnull));
+		job->args = PointerGetDatum(PG_DETOAST_DATUM_COPY(
+			SPI_getbinval(tup, td, 4, &isnull)));
+		MemoryContextSwitchTo(cxt);
+	}
+
+	endXact();
+	return found;
+}
+
+/*
+ * Run a claimed job in a transaction of its own, as the role that submitted
+ * it, and record the result; or, if anything fails, roll back and record the
+ * failure in a separate transaction.
+ *
+ * The job runs as a security-restricted operation with a local user ID change,
+ * so it cannot SET ROLE or SET SESSION AUTHORIZATION its way back to the
+ * worker's superuser identity.
+ */
+static void runJob(Job *job)
+{
+	PG_TRY();
+	{
+		Oid argtypes[2];
+		Datum values[2];
+		char nulls[2] = { ' ', ' ' };
+		char *sql;
+		char *result;
+		Oid owner;
+		Oid savedUser;
+		int savedSecContext;
+
+		beginXact("running a PL/Java job");
+		sql = callSQL(job->function);
+		owner = get_role_oid(job->owner, false);
+
+		pgstat_report_activity(STATE_RUNNING, sql);
+		GetUserIdAndSecContext(&savedUser, &savedSecContext);
+		SetUserIdAndSecContext(owner, savedSecContext
+			| SECURITY_LOCAL_USERID_CHANGE | SECURITY_RESTRICTED_OPERATION);
+
+		argtypes[0] = TEXTARRAYOID;
+		if ( SPI_OK_SELECT != SPI_execute_with_args(
+				sql, 1, argtypes, &job->args, NULL, false, 1)
+			|| 1 != SPI_processed )
+			elog(ERROR, "PL/Java job " INT64_FORMAT " produced no result",
+				job->id);
+		result = SPI_getvalue(SPI_tuptable->vals[0],
+			SPI_tuptable->tupdesc, 1);
+
+		SetUserIdAndSecContext(savedUser, savedSecContext);
+
+		argtypes[0] = INT8OID;
+		argtypes[1] = TEXTOID;
+		values[0] = Int64GetDatum(job->id);
+		if ( NULL == result )
+		{
+			values[1] = (Datum)0;
+			nulls[1] = 'n';
+		}
+		else
+			values[1] = CStringGetTextDatum(result);
+		if ( SPI_OK_UPDATE != SPI_execute_with_args(
+				s_doneSQL, 2, argtypes, values, nulls, false, 0) )
+			elog(ERROR, "PL/Java worker could not record a job result");
+
+		endXact();
+	}
+	PG_CATCH();
+	{
+		ErrorData *edata;
+
+		MemoryContextSwitchTo(s_jobContext);
+		edata = CopyErrorData();
+		FlushErrorState();
+		AbortCurrentTransaction(); /* also restores the user ID */
+		recordFailure(job, edata);
+	}
+	PG_END_TRY();
+}
+
+static void recordFailure(Job *job, ErrorData *edata)
+{
+	Oid argtypes[3] = { INT8OID, TEXTOID, TEXTOID };
+	Datum values[3];
+
+	values[0] = Int64GetDatum(job->id);
+	values[1] = CStringGetTextDatum(unpack_sql_state(edata->sqlerrcode));
+	values[2] = CStringGetTextDatum(
+		NULL != edata->message ? edata->message : "unknown error");
+
+	beginXact("recording a failed PL/Java job");
+	if ( SPI_OK_UPDATE != SPI_execute_with_args(
+			s_failedSQL, 3, argtypes, values, NULL, false, 0) )
+		elog(ERROR, "PL/Java worker could not record a job failure");
+	endXact();
+
+	FreeErrorData(edata);
+}
+
+/*
+ * Build a query that calls the function, casting each element of the text
+ * array parameter $1 to the type of the corresponding argument, and casting
+ * the result to text. The name and types are all schema-qualified, so the
+ * call resolves to exactly this function.
+ */
+static char *callSQL(Oid function)
+{
+	StringInfoData buf;
+	HeapTuple tup;
+	Form_pg_proc proc;
+	int i;
+
+	tup = SearchSysCache1(PROCOID, ObjectIdGetDatum(function));
+	if ( ! HeapTupleIsValid(tup) )
+		ereport(ERROR, (
+			errcode(ERRCODE_UNDEFINED_FUNCTION),
+			errmsg("function with OID %u does not exist", function)));
+	proc = (Form_pg_proc) GETSTRUCT(tup);
+
+	initStringInfo(&buf);
+	appendStringInfo(&buf, "SELECT CAST(%s(",
+		quote_qualified_identifier(
+			get_namespace_name(proc->pronamespace), NameStr(proc->proname)));
+	for ( i = 0 ; i < proc->pronargs ; ++ i )
+		appendStringInfo(&buf, "%s%sCAST($1[%d] AS %s)",
+			0 == i ? "" : ", ",
+			InvalidOid != proc->provariadic  &&  i == proc->pronargs - 1
+				? "VARIADIC " : "",
+			1 + i, format_type_be_qualified(proc->proargtypes.values[i]));
+	appendStringInfoString(&buf, ") AS pg_catalog.text)");
+
+	ReleaseSysCache(tup);
+	return buf.data;
+}
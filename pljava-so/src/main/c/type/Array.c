@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2020 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -10,10 +10,81 @@
  *   Tada AB
  *   Chapman Flack
  */
+#include <postgres.h>
+#include <lib/stringinfo.h>
+#include <utils/builtins.h>
+
 #include "pljava/type/Type_priv.h"
 #include "pljava/type/Array.h"
+#include "pljava/type/String.h"
 #include "pljava/Invocation.h"
 
+/*
+ * Arrays whose Java element type is a boxed primitive, LocalDate, or
+ * BigDecimal are converted in bulk: the element values are copied into one
+ * primitive Java array (for numeric, one comma-separated String) with a
+ * boolean mask of the nulls, and one call to a static method of the internal
+ * Java class BulkArrays builds the Java array, or, in the other direction,
+ * takes it apart. That replaces the several JNI calls per element made by the
+ * general _Array_coerceDatum and _Array_coerceObject.
+ *
+ * kind is the JNI signature of the primitive carrier, or 'L' for the String
+ * used for numeric, and size the length of the PostgreSQL element, which
+ * must match for the bulk path to be used.
+ */
+typedef struct
+{
+	const char *elemJavaTypeName;
+	char        kind;
+	int16       size;
+	const char *boxName;
+	const char *boxSig;
+	const char *unboxName;
+	const char *unboxSig;
+	jmethodID   box;
+	jmethodID   unbox;
+} BulkConversion;
+
+static BulkConversion s_bulkConversions[] =
+{
+	{ "java.lang.Boolean", 'Z', 1,
+		"boxBooleans", "([Z[Z)[Ljava/lang/Boolean;",
+		"unboxBooleans", "([Ljava/lang/Boolean;[Z)[Z" },
+	{ "java.lang.Short", 'S', 2,
+		"boxShorts", "([S[Z)[Ljava/lang/Short;",
+		"unboxShorts", "([Ljava/lang/Short;[Z)[S" },
+	{ "java.lang.Integer", 'I', 4,
+		"boxInts", "([I[Z)[Ljava/lang/Integer;",
+		"unboxInts", "([Ljava/lang/Integer;[Z)[I" },
+	{ "java.lang.Long", 'J', 8,
+		"boxLongs", "([J[Z)[Ljava/lang/Long;",
+		"unboxLongs", "([Ljava/lang/Long;[Z)[J" },
+	{ "java.lang.Float", 'F', 4,
+		"boxFloats", "([F[Z)[Ljava/lang/Float;",
+		"unboxFloats", "([Ljava/lang/Float;[Z)[F" },
+	{ "java.lang.Double", 'D', 8,
+		"boxDoubles", "([D[Z)[Ljava/lang/Double;",
+		"unboxDoubles", "([Ljava/lang/Double;[Z)[D" },
+	{ "java.time.LocalDate", 'I', 4,
+		"boxDates", "([I[Z)[Ljava/time/LocalDate;",
+		"unboxDates", "([Ljava/time/LocalDate;[Z)[I" },
+	{ "java.math.BigDecimal", 'L', -1,
+		"boxDecimals", "(Ljava/lang/String;[Z)[Ljava/math/BigDecimal;",
+		"unboxDecimals", "([Ljava/math/BigDecimal;[Z)Ljava/lang/String;" },
+	{ NULL }
+};
+
+static jclass s_BulkArrays_class;
+
+/*
+ * An array Type converted in bulk carries its BulkConversion.
+ */
+typedef struct BulkArray_
+{
+	struct Type_ Type;
+	BulkConversion *bulk;
+} *BulkArray;
+
 void arraySetNull(bits8* bitmap, int offset, bool flag)
 {
 	if(bitmap != 0)
@@ -143,6 +214,251 @@ static Datum _Array_coerceObject(Type self, jobject objArray)
 	PG_RETURN_ARRAYTYPE_P(v);
 }
 
+static jbooleanArray nullMask(bits8* nullBitMap, jsize nElems)
+{
+	jsize idx;
+	jbooleanArray mask = JNI_newBooleanArray(nElems);
+	jboolean* isNull = (jboolean*)palloc(nElems * sizeof(jboolean) + 1);
+
+	for(idx = 0; idx < nElems; ++idx)
+		isNull[idx] = arrayIsNull(nullBitMap, idx) ? JNI_TRUE : JNI_FALSE;
+	JNI_setBooleanArrayRegion(mask, 0, nElems, isNull);
+	pfree(isNull);
+	return mask;
+}
+
+/*
+ * Return a new primitive Java array of the given kind holding the nElems
+ * values in buf.
+ */
+static jarray newPrimitiveArray(char kind, jsize nElems, void* buf)
+{
+	jarray array;
+	switch(kind)
+	{
+	case 'Z':
+		array = JNI_newBooleanArray(nElems);
+		JNI_setBooleanArrayRegion(array, 0, nElems, (jboolean*)buf);
+		break;
+	case 'S':
+		array = JNI_newShortArray(nElems);
+		JNI_setShortArrayRegion(array, 0, nElems, (jshort*)buf);
+		break;
+	case 'I':
+		array = JNI_newIntArray(nElems);
+		JNI_setIntArrayRegion(array, 0, nElems, (jint*)buf);
+		break;
+	case 'J':
+		array = JNI_newLongArray(nElems);
+		JNI_setLongArrayRegion(array, 0, nElems, (jlong*)buf);
+		break;
+	case 'F':
+		array = JNI_newFloatArray(nElems);
+		JNI_setFloatArrayRegion(array, 0, nElems, (jfloat*)buf);
+		break;
+	case 'D':
+		array = JNI_newDoubleArray(nElems);
+		JNI_setDoubleArrayRegion(array, 0, nElems, (jdouble*)buf);
+		break;
+	default:
+		elog(ERROR, "unexpected bulk array kind '%c'", kind);
+		pg_unreachable();
+	}
+	return array;
+}
+
+/*
+ * Copy the nElems values of the primitive Java array of the given kind
+ * into buf.
+ */
+static void getPrimitiveArray(char kind, jarray array, jsize nElems, void* buf)
+{
+	switch(kind)
+	{
+	case 'Z':
+		JNI_getBooleanArrayRegion(array, 0, nElems, (jboolean*)buf);
+		break;
+	case 'S':
+		JNI_getShortArrayRegion(array, 0, nElems, (jshort*)buf);
+		break;
+	case 'I':
+		JNI_getIntArrayRegion(array, 0, nElems, (jint*)buf);
+		break;
+	case 'J':
+		JNI_getLongArrayRegion(array, 0, nElems, (jlong*)buf);
+		break;
+	case 'F':
+		JNI_getFloatArrayRegion(array, 0, nElems, (jfloat*)buf);
+		break;
+	case 'D':
+		JNI_getDoubleArrayRegion(array, 0, nElems, (jdouble*)buf);
+		break;
+	default:
+		elog(ERROR, "unexpected bulk array kind '%c'", kind);
+	}
+}
+
+/*
+ * The text forms of the non-null numeric elements, separated by commas,
+ * as a Java String.
+ */
+static jstring decimalsText(
+	Type elemType, ArrayType* v, jsize nElems, bits8* nullBitMap)
+{
+	jsize idx;
+	jstring result;
+	StringInfoData buf;
+	const char* values = ARR_DATA_PTR(v);
+	char elemAlign = Type_getAlign(elemType);
+
+	initStringInfo(&buf);
+	for(idx = 0; idx < nElems; ++idx)
+	{
+		char* text;
+		if(arrayIsNull(nullBitMap, idx))
+			continue;
+		text = DatumGetCString(
+			DirectFunctionCall1(numeric_out, PointerGetDatum(values)));
+		if(0 < buf.len)
+			appendStringInfoChar(&buf, ',');
+		appendStringInfoString(&buf, text);
+		pfree(text);
+		values = att_addlength_datum(values, -1, PointerGetDatum(values));
+		values = (char*)att_align_nominal(values, elemAlign);
+	}
+	result = String_createJavaStringFromNTS(buf.data);
+	pfree(buf.data);
+	return result;
+}
+
+static jvalue _Array_coerceDatumBulk(Type self, Datum arg)
+{
+	jvalue result;
+	jobject values;
+	jbooleanArray mask = NULL;
+	BulkConversion* bulk = ((BulkArray)self)->bulk;
+	ArrayType* v = DatumGetArrayTypeP(arg);
+	jsize nElems = (jsize)ArrayGetNItems(ARR_NDIM(v), ARR_DIMS(v));
+	bits8* nullBitMap = ARR_NULLBITMAP(v);
+
+	if(nullBitMap != 0 || bulk->kind == 'L')
+		mask = nullMask(nullBitMap, nElems);
+
+	if(bulk->kind == 'L')
+		values = decimalsText(
+			Type_getElementType(self), v, nElems, nullBitMap);
+	else if(nullBitMap == 0)
+		values = newPrimitiveArray(bulk->kind, nElems, ARR_DATA_PTR(v));
+	else
+	{
+		jsize idx;
+		const char* src = ARR_DATA_PTR(v);
+		char* buf = (char*)palloc0(nElems * bulk->size + 1);
+		for(idx = 0; idx < nElems; ++idx)
+		{
+			if(arrayIsNull(nullBitMap, idx))
+				continue;
+			memcpy(buf + idx * bulk->size, src, bulk->size);
+			src += bulk->size;
+		}
+		values = newPrimitiveArray(bulk->kind, nElems, buf);
+		pfree(buf);
+	}
+
+	result.l = JNI_callStaticObjectMethod(
+		s_BulkArrays_class, bulk->box, values, mask);
+	JNI_deleteLocalRef(values);
+	if(mask != 0)
+		JNI_deleteLocalRef(mask);
+	return result;
+}
+
+static Datum _Array_coerceObjectBulk(Type self, jobject objArray)
+{
+	ArrayType* v;
+	jsize idx;
+	jobject values;
+	jboolean* isNull;
+	int   nNulls = 0;
+	Type  elemType = Type_getElementType(self);
+	BulkConversion* bulk = ((BulkArray)self)->bulk;
+	int   nElems = (int)JNI_getArrayLength((jarray)objArray);
+	jbooleanArray mask = JNI_newBooleanArray(nElems);
+
+	values = JNI_callStaticObjectMethod(
+		s_BulkArrays_class, bulk->unbox, objArray, mask);
+	isNull = (jboolean*)palloc(nElems * sizeof(jboolean) + 1);
+	JNI_getBooleanArrayRegion(mask, 0, nElems, isNull);
+	JNI_deleteLocalRef(mask);
+	for(idx = 0; idx < nElems; ++idx)
+		if(isNull[idx])
+			++nNulls;
+
+	if(bulk->kind == 'L')
+	{
+		int    lowerBound = 1;
+		Datum* datums = (Datum*)palloc(nElems * sizeof(Datum) + 1);
+		bool*  nulls  = (bool*)palloc(nElems * sizeof(bool) + 1);
+		char*  text   = String_createNTS(values);
+		char*  next   = text;
+
+		for(idx = 0; idx < nElems; ++idx)
+		{
+			char* comma;
+			nulls[idx] = isNull[idx];
+			datums[idx] = 0;
+			if(nulls[idx])
+				continue;
+			comma = strchr(next, ',');
+			if(comma != 0)
+				*comma = 0;
+			datums[idx] = DirectFunctionCall3(numeric_in,
+				CStringGetDatum(next),
+				ObjectIdGetDatum(InvalidOid), Int32GetDatum(-1));
+			next = (comma == 0) ? next + strlen(next) : comma + 1;
+		}
+
+		v = construct_md_array(datums, nulls, 1, &nElems, &lowerBound,
+			Type_getOid(elemType), Type_getLength(elemType),
+			Type_isByValue(elemType), Type_getAlign(elemType));
+		pfree(text);
+		pfree(datums);
+		pfree(nulls);
+	}
+	else
+	{
+		v = createArrayType(
+			nElems, bulk->size, Type_getOid(elemType), 0 < nNulls);
+		if(nNulls == 0)
+			getPrimitiveArray(bulk->kind, values, nElems, ARR_DATA_PTR(v));
+		else
+		{
+			char* buf = (char*)palloc(nElems * bulk->size + 1);
+			char* dst = ARR_DATA_PTR(v);
+			bits8* nullBitMap = ARR_NULLBITMAP(v);
+			getPrimitiveArray(bulk->kind, values, nElems, buf);
+			for(idx = 0; idx < nElems; ++idx)
+			{
+				if(isNull[idx])
+					continue;
+				memcpy(dst, buf + idx * bulk->size, bulk->size);
+				dst += bulk->size;
+				arraySetNull(nullBitMap, idx, false);
+			}
+			pfree(buf);
+			/*
+			 * createArrayType allowed space for every element; the nulls
+			 * take none.
+			 */
+			SET_VARSIZE(v, ARR_DATA_OFFSET(v) + (nElems - nNulls) * bulk->size);
+		}
+	}
+
+	JNI_deleteLocalRef(values);
+	pfree(isNull);
+	PG_RETURN_ARRAYTYPE_P(v);
+}
+
 /*
  * For an array, canReplaceType can be computed a bit more generously.
  * The primitive types are coded so that a boxed scalar can replace its
@@ -160,12 +476,68 @@ static bool _Array_canReplaceType(Type self, Type other)
 		|| Type_getObjectType(self) == other;
 }
 
+static Type _Array_create(Oid typeId, Type elementType,
+	DatumCoercer coerceDatum, ObjectCoercer coerceObject, Size instanceSize);
+
+/*
+ * Return the BulkConversion for arrays of elementType, or NULL if they are
+ * not converted in bulk.
+ */
+static BulkConversion* bulkConversionFor(Type elementType)
+{
+	BulkConversion* bulk;
+	const char* javaName = Type_getJavaTypeName(elementType);
+	int16 length = Type_getLength(elementType);
+
+	for(bulk = s_bulkConversions; bulk->elemJavaTypeName != 0; ++bulk)
+	{
+		if(strcmp(bulk->elemJavaTypeName, javaName) != 0)
+			continue;
+		if(bulk->kind == 'L'
+			? Type_getOid(elementType) != NUMERICOID : bulk->size != length)
+			return 0;
+		break;
+	}
+	if(bulk->elemJavaTypeName == 0)
+		return 0;
+
+	if(s_BulkArrays_class == 0)
+		s_BulkArrays_class = JNI_newGlobalRef(PgObject_getJavaClass(
+			"org/postgresql/pljava/internal/BulkArrays"));
+	if(bulk->box == 0)
+	{
+		bulk->box = PgObject_getStaticJavaMethod(
+			s_BulkArrays_class, bulk->boxName, bulk->boxSig);
+		bulk->unbox = PgObject_getStaticJavaMethod(
+			s_BulkArrays_class, bulk->unboxName, bulk->unboxSig);
+	}
+	return bulk;
+}
+
 Type Array_fromOid(Oid typeId, Type elementType)
 {
-	return Array_fromOid2(typeId, elementType, _Array_coerceDatum, _Array_coerceObject);
+	BulkArray self;
+	BulkConversion* bulk = bulkConversionFor(elementType);
+
+	if(bulk == 0)
+		return Array_fromOid2(typeId, elementType,
+			_Array_coerceDatum, _Array_coerceObject);
+
+	self = (BulkArray)_Array_create(typeId, elementType,
+		_Array_coerceDatumBulk, _Array_coerceObjectBulk,
+		sizeof(struct BulkArray_));
+	self->bulk = bulk;
+	return (Type)self;
 }
 
 Type Array_fromOid2(Oid typeId, Type elementType, DatumCoercer coerceDatum, ObjectCoercer coerceObject)
+{
+	return _Array_create(typeId, elementType, coerceDatum, coerceObject,
+		sizeof(struct Type_));
+}
+
+static Type _Array_create(Oid typeId, Type elementType,
+	DatumCoercer coerceDatum, ObjectCoercer coerceObject, Size instanceSize)
 {
 	Type self;
 	TypeClass arrayClass;
@@ -177,7 +549,7 @@ Type Array_fromOid2(Oid typeId, Type elementType, DatumCoercer coerceDatum, Obje
 
 	char* tmp = palloc(strlen(elemClassName) + 3);
 	sprintf(tmp, "%s[]", elemClassName);
-	arrayClass = TypeClass_alloc(tmp);
+	arrayClass = TypeClass_alloc2(tmp, sizeof(struct TypeClass_), instanceSize);
 
 	tmp = palloc(strlen(elemJNISignature) + 2);
 	sprintf(tmp, "[%s", elemJNISignature);
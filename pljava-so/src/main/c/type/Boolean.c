@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2020 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -127,6 +127,7 @@ void Boolean_initialize(void)
 	cls->JNISignature = "Ljava/lang/Boolean;";
 	cls->javaTypeName = "java.lang.Boolean";
 	cls->coerceDatum  = _Boolean_coerceDatum;
+	cls->coerceDatumUnboxed = _boolean_coerceDatum;
 	cls->coerceObject = _Boolean_coerceObject;
 	t_Boolean = TypeClass_allocInstance(cls, BOOLOID);
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2020 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -128,6 +128,7 @@ void Byte_initialize(void)
 	cls->JNISignature = "Ljava/lang/Byte;";
 	cls->javaTypeName = "java.lang.Byte";
 	cls->coerceDatum  = _Byte_coerceDatum;
+	cls->coerceDatumUnboxed = _byte_coerceDatum;
 	cls->coerceObject = _Byte_coerceObject;
 	t_Byte = TypeClass_allocInstance(cls, CHAROID);
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2020 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -60,6 +60,13 @@ static jvalue _Coerce_coerceDatum(Type type, Datum arg)
 	return result;
 }
 
+static jvalue _Coerce_coerceDatumUnboxed(Type type, Datum arg)
+{
+	Coerce self = (Coerce)type;
+	return Type_coerceDatumUnboxed(
+		self->innerType, FunctionCall1(&self->coerceFunction, arg));
+}
+
 static Datum _Coerce_coerceObject(Type type, jobject jval)
 {
 	Coerce self = (Coerce)type;
@@ -105,6 +112,7 @@ void Coerce_initialize(void)
 	s_coerceInClass = TypeClass_alloc2("type.CoerceIn", sizeof(struct TypeClass_), sizeof(struct Coerce_));
 	s_coerceInClass->getJNISignature = _Coerce_getJNISignature;
 	s_coerceInClass->coerceDatum = _Coerce_coerceDatum;
+	s_coerceInClass->coerceDatumUnboxed = _Coerce_coerceDatumUnboxed;
 
 	s_coerceOutClass = TypeClass_alloc2("type.CoerceOut", sizeof(struct TypeClass_), sizeof(struct Coerce_));
 	s_coerceOutClass->getJNISignature = _Coerce_getJNISignature;
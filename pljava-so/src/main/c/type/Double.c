@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2020 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -132,6 +132,7 @@ void Double_initialize(void)
 	cls->JNISignature = "Ljava/lang/Double;";
 	cls->javaTypeName = "java.lang.Double";
 	cls->coerceDatum  = _Double_coerceDatum;
+	cls->coerceDatumUnboxed = _double_coerceDatum;
 	cls->coerceObject = _Double_coerceObject;
 	t_Double = TypeClass_allocInstance(cls, FLOAT8OID);
 
@@ -0,0 +1,353 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+#include <postgres.h>
+#if PG_VERSION_NUM >= 90300
+#include <access/htup_details.h>
+#endif
+#include <catalog/pg_enum.h>
+#include <utils/builtins.h>
+#include <utils/catcache.h>
+#include <utils/syscache.h>
+
+#include "pljava/type/Type_priv.h"
+#include "pljava/type/Enum.h"
+#include "pljava/type/String.h"
+
+/*
+ * A table from OIDs to ordinals is kept as a plain array indexed by
+ * (oid - minOid) when the OIDs of the labels are close together, as they are
+ * when all were created by one CREATE TYPE. Labels added later by ALTER TYPE
+ * can have OIDs far away; past this much slack per label, the table holds the
+ * OIDs in sorted order and is searched instead.
+ */
+#define ENUM_DENSE_SLACK 8
+
+static jmethodID s_Class_isEnum;
+static jmethodID s_Class_getEnumConstants;
+static jmethodID s_Enum_name;
+static jmethodID s_Enum_ordinal;
+
+struct Enum_
+{
+	struct Type_ Type;
+
+	/*
+	 * The constants of the Java class, indexed by ordinal.
+	 */
+	jobjectArray constants;
+
+	/*
+	 * For each ordinal, the OID of the label with the constant's name, or
+	 * InvalidOid if the SQL type has no such label.
+	 */
+	Oid *oidByOrdinal;
+	int  nConstants;
+
+	/*
+	 * When dense, ordinalByOid[oid - minOid] is the ordinal for oid, or -1.
+	 * Otherwise, sortedOids holds the nLabels OIDs in order, and
+	 * ordinalByOid the corresponding ordinals.
+	 */
+	bool dense;
+	Oid  minOid;
+	Oid  maxOid;
+	int  nLabels;
+	Oid *sortedOids;
+	int *ordinalByOid;
+};
+
+typedef struct
+{
+	Oid oid;
+	int ordinal;
+} LabelEntry;
+
+extern void Enum_initialize(void);
+
+static int labelComparator(const void *a, const void *b)
+{
+	Oid l = ((const LabelEntry *)a)->oid;
+	Oid r = ((const LabelEntry *)b)->oid;
+	return l < r ? -1 : l > r ? 1 : 0;
+}
+
+/*
+ * Read the labels of the SQL type from pg_enum and fill in both tables,
+ * replacing any built before.
+ */
+static void buildTables(Enum self)
+{
+	CatCList *list;
+	LabelEntry *labels;
+	int i;
+	int j;
+	int nLabels;
+	Oid typeId = self->Type.typeId;
+	const char *javaName = self->Type.typeClass->javaTypeName;
+	MemoryContext currCtx;
+	char **names = palloc(self->nConstants * sizeof (char *));
+
+	for ( j = 0 ; j < self->nConstants ; ++ j )
+	{
+		jobject constant = JNI_getObjectArrayElement(self->constants, j);
+		jstring name = JNI_callObjectMethod(constant, s_Enum_name);
+		names[j] = String_createNTS(name);
+		JNI_deleteLocalRef(name);
+		JNI_deleteLocalRef(constant);
+	}
+
+	list = SearchSysCacheList1(ENUMTYPOIDNAME, ObjectIdGetDatum(typeId));
+	nLabels = list->n_members;
+	labels = palloc((1 + nLabels) * sizeof (LabelEntry));
+
+	for ( i = 0 ; i < nLabels ; ++ i )
+	{
+		HeapTuple tup = &list->members[i]->tuple;
+		Form_pg_enum en = (Form_pg_enum)GETSTRUCT(tup);
+#if PG_VERSION_NUM >= 120000
+		labels[i].oid = en->oid;
+#else
+		labels[i].oid = HeapTupleGetOid(tup);
+#endif
+		labels[i].ordinal = -1;
+		for ( j = 0 ; j < self->nConstants ; ++ j )
+		{
+			if ( 0 == strcmp(names[j], NameStr(en->enumlabel)) )
+			{
+				labels[i].ordinal = j;
+				break;
+			}
+		}
+	}
+	ReleaseSysCacheList(list);
+
+	for ( j = 0 ; j < self->nConstants ; ++ j )
+		pfree(names[j]);
+	pfree(names);
+
+	qsort(labels, nLabels, sizeof (LabelEntry), labelComparator);
+
+	if ( NULL != self->oidByOrdinal )
+		pfree(self->oidByOrdinal);
+	if ( NULL != self->ordinalByOid )
+		pfree(self->ordinalByOid);
+	if ( NULL != self->sortedOids )
+		pfree(self->sortedOids);
+	self->sortedOids = NULL;
+
+	currCtx = MemoryContextSwitchTo(TopMemoryContext);
+
+	self->oidByOrdinal = palloc((1 + self->nConstants) * sizeof (Oid));
+	for ( j = 0 ; j < self->nConstants ; ++ j )
+		self->oidByOrdinal[j] = InvalidOid;
+	for ( i = 0 ; i < nLabels ; ++ i )
+		if ( -1 != labels[i].ordinal )
+			self->oidByOrdinal[labels[i].ordinal] = labels[i].oid;
+
+	self->nLabels = nLabels;
+	self->minOid = 0 < nLabels ? labels[0].oid : InvalidOid;
+	self->maxOid = 0 < nLabels ? labels[nLabels - 1].oid : InvalidOid;
+	self->dense = 0 < nLabels  &&  self->maxOid - self->minOid
+		< (uint64)ENUM_DENSE_SLACK * nLabels;
+
+	if ( self->dense )
+	{
+		uint32 span = self->maxOid - self->minOid + 1;
+		self->ordinalByOid = palloc(span * sizeof (int));
+		for ( i = 0 ; i < (int)span ; ++ i )
+			self->ordinalByOid[i] = -1;
+		for ( i = 0 ; i < nLabels ; ++ i )
+			self->ordinalByOid[labels[i].oid - self->minOid] =
+				labels[i].ordinal;
+	}
+	else
+	{
+		self->sortedOids = palloc((1 + nLabels) * sizeof (Oid));
+		self->ordinalByOid = palloc((1 + nLabels) * sizeof (int));
+		for ( i = 0 ; i < nLabels ; ++ i )
+		{
+			self->sortedOids[i] = labels[i].oid;
+			self->ordinalByOid[i] = labels[i].ordinal;
+		}
+	}
+
+	MemoryContextSwitchTo(currCtx);
+	pfree(labels);
+
+	elog(DEBUG2, "mapped %d labels of enum type %s to Java enum %s (%s)",
+		nLabels, format_type_be(typeId), javaName,
+		self->dense ? "dense" : "sparse");
+}
+
+static int lookupOrdinal(Enum self, Oid oid)
+{
+	int lo;
+	int hi;
+
+	if ( self->dense )
+	{
+		if ( oid < self->minOid  ||  oid > self->maxOid )
+			return -1;
+		return self->ordinalByOid[oid - self->minOid];
+	}
+
+	lo = 0;
+	hi = self->nLabels - 1;
+	while ( lo <= hi )
+	{
+		int mid = lo + (hi - lo) / 2;
+		Oid m = self->sortedOids[mid];
+		if ( m == oid )
+			return self->ordinalByOid[mid];
+		if ( m < oid )
+			lo = mid + 1;
+		else
+			hi = mid - 1;
+	}
+	return -1;
+}
+
+/*
+ * The tables are built once. A value not found in them may be a label added
+ * by ALTER TYPE ... ADD VALUE since, so they are built again once before an
+ * error is reported.
+ */
+static int ordinalOf(Enum self, Oid oid)
+{
+	int ordinal = lookupOrdinal(self, oid);
+	if ( -1 != ordinal )
+		return ordinal;
+
+	buildTables(self);
+	ordinal = lookupOrdinal(self, oid);
+	if ( -1 != ordinal )
+		return ordinal;
+
+	ereport(ERROR, (
+		errcode(ERRCODE_CANNOT_COERCE),
+		errmsg("value of enum type %s has no constant in Java enum %s",
+			format_type_be(self->Type.typeId),
+			self->Type.typeClass->javaTypeName),
+		errdetail("The enum value OID is %u.", oid)));
+	return -1; /* not reached */
+}
+
+static jvalue _Enum_coerceDatum(Type self, Datum arg)
+{
+	jvalue result;
+	Enum e = (Enum)self;
+	result.l = JNI_getObjectArrayElement(
+		e->constants, ordinalOf(e, DatumGetObjectId(arg)));
+	return result;
+}
+
+static Datum _Enum_coerceObject(Type self, jobject value)
+{
+	Enum e = (Enum)self;
+	jint ordinal = JNI_callIntMethod(value, s_Enum_ordinal);
+	Oid oid = e->oidByOrdinal[ordinal];
+
+	if ( InvalidOid == oid )
+	{
+		jstring name = JNI_callObjectMethod(value, s_Enum_name);
+		char *cname = String_createNTS(name);
+		JNI_deleteLocalRef(name);
+		ereport(ERROR, (
+			errcode(ERRCODE_INVALID_TEXT_REPRESENTATION),
+			errmsg("Java enum constant %s.%s has no label in enum type %s",
+				self->typeClass->javaTypeName, cname,
+				format_type_be(self->typeId))));
+	}
+	return ObjectIdGetDatum(oid);
+}
+
+Type Enum_register(jclass clazz, Oid typeId, Form_pg_type pgType)
+{
+	jstring jcn;
+	jobjectArray constants;
+	MemoryContext currCtx;
+	TypeClass enumClass;
+	Enum self;
+	char *className;
+	char *classSignature;
+	char *sp;
+	const char *cp;
+	char c;
+
+	if ( JNI_FALSE == JNI_callBooleanMethod(clazz, s_Class_isEnum) )
+	{
+		jcn = JNI_callObjectMethod(clazz, Class_getName);
+		className = String_createNTS(jcn);
+		JNI_deleteLocalRef(jcn);
+		ereport(ERROR, (
+			errcode(ERRCODE_CANNOT_COERCE),
+			errmsg("class %s mapped to enum type %s is not a Java enum",
+				className, format_type_be(typeId))));
+	}
+
+	/* Create a Java Signature String from the class name
+	 */
+	jcn = JNI_callObjectMethod(clazz, Class_getName);
+	currCtx = MemoryContextSwitchTo(TopMemoryContext);
+	className = String_createNTS(jcn);
+	JNI_deleteLocalRef(jcn);
+
+	classSignature = palloc(strlen(className) + 3);
+	MemoryContextSwitchTo(currCtx);
+
+	sp = classSignature;
+	cp = className;
+	*sp++ = 'L';
+	while ( (c = *cp++) != 0 )
+		*sp++ = ('.' == c) ? '/' : c;
+	*sp++ = ';';
+	*sp = 0;
+
+	enumClass = TypeClass_alloc2(
+		"type.Enum", sizeof(struct TypeClass_), sizeof(struct Enum_));
+
+	enumClass->JNISignature   = classSignature;
+	enumClass->javaTypeName   = className;
+	enumClass->javaClass      = JNI_newGlobalRef(clazz);
+	enumClass->canReplaceType = _Type_canReplaceType;
+	enumClass->coerceDatum    = _Enum_coerceDatum;
+	enumClass->coerceObject   = _Enum_coerceObject;
+
+	self = (Enum)TypeClass_allocInstance2(enumClass, typeId, pgType);
+
+	constants = JNI_callObjectMethod(clazz, s_Class_getEnumConstants);
+	self->constants = JNI_newGlobalRef(constants);
+	self->nConstants = JNI_getArrayLength(constants);
+	JNI_deleteLocalRef(constants);
+
+	self->oidByOrdinal = NULL;
+	self->ordinalByOid = NULL;
+	self->sortedOids = NULL;
+	buildTables(self);
+
+	Type_registerType(className, (Type)self);
+	return (Type)self;
+}
+
+void Enum_initialize(void)
+{
+	jclass cls = PgObject_getJavaClass("java/lang/Class");
+	s_Class_isEnum = PgObject_getJavaMethod(cls, "isEnum", "()Z");
+	s_Class_getEnumConstants = PgObject_getJavaMethod(
+		cls, "getEnumConstants", "()[Ljava/lang/Object;");
+	JNI_deleteLocalRef(cls);
+
+	cls = PgObject_getJavaClass("java/lang/Enum");
+	s_Enum_name = PgObject_getJavaMethod(cls, "name", "()Ljava/lang/String;");
+	s_Enum_ordinal = PgObject_getJavaMethod(cls, "ordinal", "()I");
+	JNI_deleteLocalRef(cls);
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2020 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -134,6 +134,7 @@ void Float_initialize(void)
 	cls->JNISignature = "Ljava/lang/Float;";
 	cls->javaTypeName = "java.lang.Float";
 	cls->coerceDatum  = _Float_coerceDatum;
+	cls->coerceDatumUnboxed = _float_coerceDatum;
 	cls->coerceObject = _Float_coerceObject;
 	t_Float = TypeClass_allocInstance(cls, FLOAT4OID);
 
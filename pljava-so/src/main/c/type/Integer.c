@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2020 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -127,6 +127,7 @@ void Integer_initialize(void)
 	cls->JNISignature = "Ljava/lang/Integer;";
 	cls->javaTypeName = "java.lang.Integer";
 	cls->coerceDatum  = _Integer_coerceDatum;
+	cls->coerceDatumUnboxed = _int_coerceDatum;
 	cls->coerceObject = _Integer_coerceObject;
 	t_Integer = TypeClass_allocInstance(cls, INT4OID);
 
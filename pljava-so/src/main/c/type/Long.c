@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2020 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -134,6 +134,7 @@ void Long_initialize(void)
 	cls->JNISignature = "Ljava/lang/Long;";
 	cls->javaTypeName = "java.lang.Long";
 	cls->coerceDatum  = _Long_coerceDatum;
+	cls->coerceDatumUnboxed = _long_coerceDatum;
 	cls->coerceObject = _Long_coerceObject;
 	t_Long = TypeClass_allocInstance(cls, INT8OID);
 
@@ -24,6 +24,7 @@
 #include "pljava/HashMap.h"
 #include "pljava/type/Type_priv.h"
 #include "pljava/type/TupleDesc.h"
+#include "pljava/type/TupleTable.h"
 #include "pljava/type/Portal.h"
 #include "pljava/type/String.h"
 
@@ -84,6 +85,11 @@ void pljava_Portal_initialize(void)
 	  	Java_org_postgresql_pljava_internal_Portal__1fetch
 		},
 		{
+		"_fetchTable",
+		"(JZJLorg/postgresql/pljava/internal/TupleDesc;)Lorg/postgresql/pljava/internal/TupleTable;",
+	  	Java_org_postgresql_pljava_internal_Portal__1fetchTable
+		},
+		{
 		"_isAtEnd",
 	  	"(J)Z",
 	  	Java_org_postgresql_pljava_internal_Portal__1isAtEnd
@@ -174,6 +180,64 @@ Java_org_postgresql_pljava_internal_Portal__1fetch(JNIEnv* env, jclass clazz, jl
 	return result;
 }
 
+/*
+ * Class:     org_postgresql_pljava_internal_Portal
+ * Method:    _fetchTable
+ * Signature: (JZJLorg/postgresql/pljava/internal/TupleDesc;)Lorg/postgresql/pljava/internal/TupleTable;
+ *
+ * The SPI_cursor_fetch of _fetch, the TupleTable construction of
+ * SPI._getTupTable, and the SPI_freetuptable of SPI._freeTupTable, in one
+ * crossing. Returns null if no rows were fetched. If pljava.lazy_row_conversion
+ * is on, the SPITupleTable is handed over to a lazy TupleTable rather than
+ * being converted and freed here.
+ */
+JNIEXPORT jobject JNICALL
+Java_org_postgresql_pljava_internal_Portal__1fetchTable(JNIEnv* env, jclass clazz, jlong _this, jboolean forward, jlong count, jobject knownTD)
+{
+	jobject result = 0;
+	if(_this != 0)
+	{
+		BEGIN_NATIVE
+		Ptr2Long p2l;
+		STACK_BASE_VARS
+		STACK_BASE_PUSH(env)
+
+		/*
+		 * As in _fetch above, a strategic place to clean enqueued instances.
+		 */
+		pljava_DualState_cleanEnqueuedInstances();
+
+		p2l.longVal = _this;
+		PG_TRY();
+		{
+			Invocation_assertConnect();
+			SPI_cursor_fetch((Portal)p2l.ptrVal, forward == JNI_TRUE,
+				(long)count);
+			if ( 0 < SPI_processed  &&  NULL != SPI_tuptable )
+			{
+				if ( pljavaLazyRowConversion )
+					result = TupleTable_createLazy(SPI_tuptable, knownTD);
+				else
+				{
+					result = TupleTable_create(SPI_tuptable, knownTD);
+					SPI_freetuptable(SPI_tuptable);
+				}
+			}
+			else if ( NULL != SPI_tuptable )
+				SPI_freetuptable(SPI_tuptable);
+			SPI_tuptable = 0;
+		}
+		PG_CATCH();
+		{
+			Exception_throw_ERROR("SPI_cursor_fetch");
+		}
+		PG_END_TRY();
+		STACK_BASE_POP()
+		END_NATIVE
+	}
+	return result;
+}
+
 /*
  * Class:     org_postgresql_pljava_internal_Portal
  * Method:    _getName
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2020 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -126,6 +126,7 @@ void Short_initialize(void)
 	cls->JNISignature = "Ljava/lang/Short;";
 	cls->javaTypeName = "java.lang.Short";
 	cls->coerceDatum  = _Short_coerceDatum;
+	cls->coerceDatumUnboxed = _short_coerceDatum;
 	cls->coerceObject = _Short_coerceObject;
 	t_Short = TypeClass_allocInstance(cls, INT2OID);
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2021 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -10,7 +10,12 @@
  *   Tada AB - Thomas Hallgren
  *   Chapman Flack
  */
+#include <utils/fmgroids.h>
+#include <utils/hsearch.h>
+#include <utils/memutils.h>
+
 #include "pljava/type/String_priv.h"
+#include "pljava/Backend.h"
 #include "pljava/HashMap.h"
 
 static TypeClass s_StringClass;
@@ -34,6 +39,33 @@ static jstring s_the_empty_string;
 
 static int s_server_encoding;
 
+/*
+ * While pljava.string_cache_size is nonzero, the Java Strings made from short
+ * values are remembered (as global references) in a hash table keyed by the
+ * values' bytes, so a value seen again, as in a column with few distinct
+ * values, is not decoded again and yields the same String. The table stops
+ * growing at pljava.string_cache_size entries, and is emptied by
+ * String_clearCache.
+ */
+#define STRING_CACHE_MAX_LENGTH 32
+
+typedef struct
+{
+	int32 length;
+	char  bytes[STRING_CACHE_MAX_LENGTH];
+} StringCacheKey;
+
+typedef struct
+{
+	StringCacheKey key;
+	jstring        string;
+} StringCacheEntry;
+
+static HTAB *s_stringCache;
+static long  s_stringCacheCount;
+
+static jstring cachedString(StringPL self, Datum arg);
+
 /*
  * String_appendJavaString and String_createNTS can be called from
  * elogExceptionMessage in JNICalls.c if something goes off the rails before
@@ -58,7 +90,16 @@ static bool _String_canReplaceType(Type self, Type type)
 jvalue _String_coerceDatum(Type self, Datum arg)
 {
 	jvalue result;
-	char* tmp = DatumGetCString(FunctionCall3(
+	char* tmp;
+
+	if ( 0 < pljavaStringCacheSize )
+	{
+		result.l = cachedString((StringPL)self, arg);
+		if ( 0 != result.l )
+			return result;
+	}
+
+	tmp = DatumGetCString(FunctionCall3(
 					&((StringPL)self)->textOutput,
 					arg,
 					ObjectIdGetDatum(((StringPL)self)->elementType),
@@ -68,6 +109,108 @@ jvalue _String_coerceDatum(Type self, Datum arg)
 	return result;
 }
 
+/*
+ * Return a String for the value from the cache, adding it if there is room, or
+ * return 0 if the value is too long to cache.
+ */
+static jstring cachedString(StringPL self, Datum arg)
+{
+	StringCacheKey key;
+	StringCacheEntry *entry;
+	char *tmp = NULL;
+	char const *bytes;
+	Size length;
+	bool found;
+	jstring result;
+
+	if ( self->rawText )
+	{
+		struct varlena *v = (struct varlena *)DatumGetPointer(arg);
+		if ( VARATT_IS_EXTERNAL(v)  ||  VARATT_IS_COMPRESSED(v) )
+			return 0; /* not going to be short */
+		bytes = VARDATA_ANY(v);
+		length = VARSIZE_ANY_EXHDR(v);
+	}
+	else
+	{
+		tmp = DatumGetCString(FunctionCall3(
+			&self->textOutput,
+			arg,
+			ObjectIdGetDatum(self->elementType),
+			Int32GetDatum(-1)));
+		bytes = tmp;
+		length = strlen(tmp);
+	}
+
+	if ( length > STRING_CACHE_MAX_LENGTH )
+	{
+		result = 0;
+		if ( NULL != tmp )
+		{
+			/* the output is already made; finish the job uncached */
+			result = String_createJavaStringFromNTS(tmp);
+			pfree(tmp);
+		}
+		return result;
+	}
+
+	if ( NULL == s_stringCache )
+	{
+		HASHCTL ctl;
+		memset(&ctl, 0, sizeof ctl);
+		ctl.keysize = sizeof (StringCacheKey);
+		ctl.entrysize = sizeof (StringCacheEntry);
+		ctl.hcxt = TopMemoryContext;
+		s_stringCache = hash_create("PL/Java string cache",
+			Min(pljavaStringCacheSize, 1024), &ctl,
+			HASH_ELEM | HASH_BLOBS | HASH_CONTEXT);
+		s_stringCacheCount = 0;
+	}
+
+	memset(&key, 0, sizeof key);
+	key.length = (int32)length;
+	memcpy(key.bytes, bytes, length);
+
+	entry = (StringCacheEntry *)hash_search(
+		s_stringCache, &key, HASH_FIND, NULL);
+	if ( NULL != entry )
+	{
+		if ( NULL != tmp )
+			pfree(tmp);
+		return (jstring)JNI_newLocalRef(entry->string);
+	}
+
+	if ( NULL == tmp )
+		tmp = pnstrdup(bytes, length);
+	result = String_createJavaStringFromNTS(tmp);
+	pfree(tmp);
+
+	if ( s_stringCacheCount < pljavaStringCacheSize )
+	{
+		entry = (StringCacheEntry *)hash_search(
+			s_stringCache, &key, HASH_ENTER, &found);
+		entry->string = (jstring)JNI_newGlobalRef(result);
+		++ s_stringCacheCount;
+	}
+	return result;
+}
+
+void String_clearCache(void)
+{
+	HASH_SEQ_STATUS status;
+	StringCacheEntry *entry;
+
+	if ( NULL == s_stringCache )
+		return;
+
+	hash_seq_init(&status, s_stringCache);
+	while ( NULL != (entry = (StringCacheEntry *)hash_seq_search(&status)) )
+		JNI_deleteGlobalRef(entry->string);
+	hash_destroy(s_stringCache);
+	s_stringCache = NULL;
+	s_stringCacheCount = 0;
+}
+
 Datum _String_coerceObject(Type self, jobject jstr)
 {
 	char* tmp;
@@ -100,6 +243,9 @@ static StringPL String_create(TypeClass cls, Oid typeId)
 	fmgr_info_cxt(pgType->typoutput, &self->textOutput, ctx);
 	fmgr_info_cxt(pgType->typinput,  &self->textInput,  ctx);
 	self->elementType = 'e' == pgType->typtype ? typeId : pgType->typelem;
+	self->rawText = F_TEXTOUT == pgType->typoutput
+		|| F_VARCHAROUT == pgType->typoutput
+		|| F_BPCHAROUT == pgType->typoutput;
 	ReleaseSysCache(typeTup);
 	return self;
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2019 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -13,6 +13,9 @@
  * @author Thomas Hallgren
  */
 #include <postgres.h>
+#if PG_VERSION_NUM >= 90300
+#include <access/htup_details.h>
+#endif
 #include <executor/spi.h>
 #include <executor/tuptable.h>
 
@@ -20,10 +23,15 @@
 #include "pljava/Backend.h"
 #include "pljava/DualState.h"
 #include "pljava/Exception.h"
+#include "pljava/Invocation.h"
 #include "pljava/type/Type_priv.h"
 #include "pljava/type/Tuple.h"
 #include "pljava/type/TupleDesc.h"
 
+#define CONFIRMCONST(c) \
+StaticAssertStmt((c) == (org_postgresql_pljava_internal_Tuple_##c), \
+	"Java/C value mismatch for " #c)
+
 static jclass    s_Tuple_class;
 static jmethodID s_Tuple_init;
 
@@ -72,10 +80,27 @@ jobject pljava_Tuple_internalCreate(HeapTuple ht, bool mustCopy)
 	 * XXX? this seems like a lot of tuple copying.
 	 */
 	jht = JNI_newObjectLocked(s_Tuple_class, s_Tuple_init,
-		pljava_DualState_key(), (jlong)0, htH.longVal);
+		pljava_DualState_key(), (jlong)0, htH.longVal, JNI_FALSE);
 	return jht;
 }
 
+jobject pljava_Tuple_createBorrowed(HeapTuple ht)
+{
+	Ptr2Long htH;
+	Ptr2Long roH;
+
+	htH.longVal = 0L;
+	htH.ptrVal = ht;
+	roH.longVal = 0L;
+	roH.ptrVal = currentInvocation;
+	/*
+	 * The current Invocation is the resource owner, so the Java object goes
+	 * stale when it is popped, and the tuple is never freed from Java.
+	 */
+	return JNI_newObjectLocked(s_Tuple_class, s_Tuple_init,
+		pljava_DualState_key(), roH.longVal, htH.longVal, JNI_TRUE);
+}
+
 static jvalue _Tuple_coerceDatum(Type self, Datum arg)
 {
 	jvalue result;
@@ -95,12 +120,35 @@ void pljava_Tuple_initialize(void)
 		"(JJILjava/lang/Class;)Ljava/lang/Object;",
 	  	Java_org_postgresql_pljava_internal_Tuple__1getObject
 		},
+		{
+		"_getData",
+		"(J)Ljava/nio/ByteBuffer;",
+		Java_org_postgresql_pljava_internal_Tuple__1getData
+		},
 		{ 0, 0, 0 }};
 
+	/*
+	 * TupleDeformer reads these parts of the HeapTupleHeader itself.
+	 */
+	CONFIRMCONST(HEAP_HASNULL);
+	CONFIRMCONST(HEAP_NATTS_MASK);
+	StaticAssertStmt(offsetof(HeapTupleHeaderData, t_infomask2) ==
+		org_postgresql_pljava_internal_Tuple_OFFSET_T_INFOMASK2,
+		"Java/C value mismatch for OFFSET_T_INFOMASK2");
+	StaticAssertStmt(offsetof(HeapTupleHeaderData, t_infomask) ==
+		org_postgresql_pljava_internal_Tuple_OFFSET_T_INFOMASK,
+		"Java/C value mismatch for OFFSET_T_INFOMASK");
+	StaticAssertStmt(offsetof(HeapTupleHeaderData, t_hoff) ==
+		org_postgresql_pljava_internal_Tuple_OFFSET_T_HOFF,
+		"Java/C value mismatch for OFFSET_T_HOFF");
+	StaticAssertStmt(offsetof(HeapTupleHeaderData, t_bits) ==
+		org_postgresql_pljava_internal_Tuple_OFFSET_T_BITS,
+		"Java/C value mismatch for OFFSET_T_BITS");
+
 	s_Tuple_class = JNI_newGlobalRef(PgObject_getJavaClass("org/postgresql/pljava/internal/Tuple"));
 	PgObject_registerNatives2(s_Tuple_class, methods);
 	s_Tuple_init = PgObject_getJavaMethod(s_Tuple_class, "<init>",
-		"(Lorg/postgresql/pljava/internal/DualState$Key;JJ)V");
+		"(Lorg/postgresql/pljava/internal/DualState$Key;JJZ)V");
 
 	cls = TypeClass_alloc("type.Tuple");
 	cls->JNISignature = "Lorg/postgresql/pljava/internal/Tuple;";
@@ -156,3 +204,23 @@ Java_org_postgresql_pljava_internal_Tuple__1getObject(JNIEnv* env, jclass cls, j
 	END_NATIVE
 	return result;
 }
+
+/*
+ * Class:     org_postgresql_pljava_internal_Tuple
+ * Method:    _getData
+ * Signature: (J)Ljava/nio/ByteBuffer;
+ */
+JNIEXPORT jobject JNICALL
+Java_org_postgresql_pljava_internal_Tuple__1getData(JNIEnv* env, jclass cls, jlong _this)
+{
+	jobject result = 0;
+	HeapTuple self;
+	Ptr2Long p2l;
+	p2l.longVal = _this;
+	self = (HeapTuple)p2l.ptrVal;
+
+	BEGIN_NATIVE
+	result = JNI_newDirectByteBuffer(self->t_data, (jlong)self->t_len);
+	END_NATIVE
+	return result;
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2020 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -25,6 +25,10 @@
 #include "pljava/type/TupleDesc.h"
 #include "pljava/type/Oid.h"
 
+#ifndef TupleDescAttr
+#define TupleDescAttr(tupdesc, i) ((tupdesc)->attrs[(i)])
+#endif
+
 static jclass    s_TupleDesc_class;
 static jmethodID s_TupleDesc_init;
 
@@ -112,7 +116,7 @@ void pljava_TupleDesc_initialize(void)
 		},
 		{
 		"_formTuple",
-		"(J[Ljava/lang/Object;)Lorg/postgresql/pljava/internal/Tuple;",
+		"(J[Ljava/lang/Object;[J[B)Lorg/postgresql/pljava/internal/Tuple;",
 		Java_org_postgresql_pljava_internal_TupleDesc__1formTuple
 		},
 		{
@@ -120,6 +124,11 @@ void pljava_TupleDesc_initialize(void)
 		"(JI)Lorg/postgresql/pljava/internal/Oid;",
 		Java_org_postgresql_pljava_internal_TupleDesc__1getOid
 		},
+		{
+		"_getLayout",
+		"(J)[I",
+		Java_org_postgresql_pljava_internal_TupleDesc__1getLayout
+		},
 		{ 0, 0, 0 }};
 
 	s_TupleDesc_class = JNI_newGlobalRef(PgObject_getJavaClass("org/postgresql/pljava/internal/TupleDesc"));
@@ -211,13 +220,49 @@ Java_org_postgresql_pljava_internal_TupleDesc__1getColumnIndex(JNIEnv* env, jcla
 	return result;
 }
 
+/*
+ * Convert the raw bits of a primitive value stored by Java to a Datum, given
+ * the JNI signature character of its kind (which the Java caller has already
+ * made to agree with the column type).
+ */
+static Datum primitiveToDatum(jbyte kind, jlong bits)
+{
+	union { jint i; jfloat f; } fbits;
+	union { jlong j; jdouble d; } dbits;
+
+	switch ( kind )
+	{
+	case 'Z':
+		return BoolGetDatum(0 != bits);
+	case 'S':
+		return Int16GetDatum((int16)bits);
+	case 'I':
+		return Int32GetDatum((int32)bits);
+	case 'J':
+		return Int64GetDatum((int64)bits);
+	case 'F':
+		fbits.i = (jint)bits;
+		return Float4GetDatum(fbits.f);
+	case 'D':
+		dbits.j = bits;
+		return Float8GetDatum(dbits.d);
+	default:
+		elog(ERROR, "unexpected primitive kind '%c' in formTuple", (char)kind);
+		pg_unreachable();
+	}
+}
+
 /*
  * Class:     org_postgresql_pljava_internal_TupleDesc
  * Method:    _formTuple
- * Signature: (J[Ljava/lang/Object;)Lorg/postgresql/pljava/internal/Tuple;
+ * Signature: (J[Ljava/lang/Object;[J[B)Lorg/postgresql/pljava/internal/Tuple;
+ *
+ * The jprimitives and jkinds arrays may be null. If not, they are copied in
+ * bulk, and any column with a nonzero kind takes its value from jprimitives,
+ * without any per-column JNI call.
  */
 JNIEXPORT jobject JNICALL
-Java_org_postgresql_pljava_internal_TupleDesc__1formTuple(JNIEnv* env, jclass cls, jlong _this, jobjectArray jvalues)
+Java_org_postgresql_pljava_internal_TupleDesc__1formTuple(JNIEnv* env, jclass cls, jlong _this, jobjectArray jvalues, jlongArray jprimitives, jbyteArray jkinds)
 {
 	jobject result = 0;
 
@@ -233,14 +278,33 @@ Java_org_postgresql_pljava_internal_TupleDesc__1formTuple(JNIEnv* env, jclass cl
 		int    count   = self->natts;
 		Datum* values  = (Datum*)palloc(count * sizeof(Datum));
 		bool*  nulls   = palloc(count * sizeof(bool));
+		jlong* prims   = 0;
+		jbyte* kinds   = 0;
 		jobject typeMap = Invocation_getTypeMap(); /* a global ref */
 
 		memset(values, 0,  count * sizeof(Datum));
 		memset(nulls, true, count * sizeof(bool));/*all values null initially*/
-	
+
+		if ( 0 != jkinds  &&  0 != jprimitives )
+		{
+			prims = (jlong*)palloc(count * sizeof(jlong));
+			kinds = (jbyte*)palloc(count * sizeof(jbyte));
+			JNI_getLongArrayRegion(jprimitives, 0, count, prims);
+			JNI_getByteArrayRegion(jkinds, 0, count, kinds);
+		}
+
 		for(idx = 0; idx < count; ++idx)
 		{
-			jobject value = JNI_getObjectArrayElement(jvalues, idx);
+			jobject value;
+
+			if ( 0 != kinds  &&  0 != kinds[idx] )
+			{
+				values[idx] = primitiveToDatum(kinds[idx], prims[idx]);
+				nulls[idx] = false;
+				continue;
+			}
+
+			value = JNI_getObjectArrayElement(jvalues, idx);
 			if(value != 0)
 			{
 				/* Obtain boxed types here too, when that matters. */
@@ -257,6 +321,11 @@ Java_org_postgresql_pljava_internal_TupleDesc__1formTuple(JNIEnv* env, jclass cl
 		MemoryContextSwitchTo(curr);
 		pfree(values);
 		pfree(nulls);
+		if ( 0 != kinds )
+		{
+			pfree(prims);
+			pfree(kinds);
+		}
 	}
 	PG_CATCH();
 	{
@@ -302,3 +371,48 @@ Java_org_postgresql_pljava_internal_TupleDesc__1getOid(JNIEnv* env, jclass cls,
 
 	return result;
 }
+
+/*
+ * Class:     org_postgresql_pljava_internal_TupleDesc
+ * Method:    _getLayout
+ * Signature: (J)[I
+ */
+JNIEXPORT jintArray JNICALL
+Java_org_postgresql_pljava_internal_TupleDesc__1getLayout(JNIEnv* env, jclass cls, jlong _this)
+{
+	jintArray result = 0;
+	TupleDesc td;
+	jint *layout;
+	int i;
+	Ptr2Long p2l;
+	p2l.longVal = _this;
+	td = (TupleDesc)p2l.ptrVal;
+
+	/*
+	 * For each attribute, its length (-1 for varlena, -2 for cstring), the
+	 * alignment of its start in bytes, and its type, or InvalidOid if dropped.
+	 */
+	BEGIN_NATIVE
+	layout = palloc(3 * td->natts * sizeof (jint));
+	for ( i = 0 ; i < td->natts ; ++ i )
+	{
+		Form_pg_attribute att = TupleDescAttr(td, i);
+		jint align;
+		switch ( att->attalign )
+		{
+		case 's': align = ALIGNOF_SHORT; break;
+		case 'i': align = ALIGNOF_INT; break;
+		case 'd': align = ALIGNOF_DOUBLE; break;
+		default:  align = 1; break;
+		}
+		layout[3 * i]     = (jint)att->attlen;
+		layout[3 * i + 1] = align;
+		layout[3 * i + 2] = att->attisdropped ? InvalidOid : att->atttypid;
+	}
+	result = JNI_newIntArray(3 * td->natts);
+	if ( 0 != result )
+		JNI_setIntArrayRegion(result, 0, 3 * td->natts, layout);
+	pfree(layout);
+	END_NATIVE
+	return result;
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2020 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -14,6 +14,11 @@
 #include <executor/spi.h>
 #include <executor/tuptable.h>
 
+#include "org_postgresql_pljava_internal_TupleTable.h"
+#include "pljava/DualState.h"
+#include "pljava/Exception.h"
+#include "pljava/Invocation.h"
+#include "pljava/type/String.h"
 #include "pljava/type/Type_priv.h"
 #include "pljava/type/TupleTable.h"
 #include "pljava/type/Tuple.h"
@@ -25,6 +30,7 @@
 
 static jclass    s_TupleTable_class;
 static jmethodID s_TupleTable_init;
+static jmethodID s_TupleTable_initLazy;
 
 jobject TupleTable_createFromSlot(TupleTableSlot* tts)
 {
@@ -47,14 +53,9 @@ jobject TupleTable_createFromSlot(TupleTableSlot* tts)
 	return JNI_newObject(s_TupleTable_class, s_TupleTable_init, tupdesc, tuples);
 }
 
-jobject TupleTable_create(SPITupleTable* tts, jobject knownTD)
+static jint tupleCount(SPITupleTable* tts)
 {
-	jobjectArray tuples;
 	uint64 tupcount;
-	MemoryContext curr;
-
-	if(tts == 0)
-		return 0;
 
 #if PG_VERSION_NUM < 130000
 	tupcount = tts->alloced - tts->free;
@@ -66,25 +67,118 @@ jobject TupleTable_create(SPITupleTable* tts, jobject knownTD)
 				(errcode(ERRCODE_FEATURE_NOT_SUPPORTED),
 				 errmsg("a PL/Java TupleTable cannot represent more than "
 					"INT32_MAX rows")));
+	return (jint)tupcount;
+}
+
+jobject TupleTable_create(SPITupleTable* tts, jobject knownTD)
+{
+	jobjectArray tuples;
+	jint tupcount;
+	MemoryContext curr;
+
+	if(tts == 0)
+		return 0;
+
+	tupcount = tupleCount(tts);
+	String_clearCache(); /* a new batch */
 
 	curr = MemoryContextSwitchTo(JavaMemoryContext);
 
 	if(knownTD == 0)
 		knownTD = pljava_TupleDesc_internalCreate(tts->tupdesc);
 
-	tuples = pljava_Tuple_createArray(tts->vals, (jint)tupcount, true);
+	tuples = pljava_Tuple_createArray(tts->vals, tupcount, true);
 	MemoryContextSwitchTo(curr);
 
 	return JNI_newObject(s_TupleTable_class, s_TupleTable_init, knownTD, tuples);
 }
 
+jobject TupleTable_createLazy(SPITupleTable* tts, jobject knownTD)
+{
+	jint tupcount;
+	Ptr2Long p2l;
+	Ptr2Long p2lro;
+	MemoryContext curr;
+
+	if(tts == 0)
+		return 0;
+
+	tupcount = tupleCount(tts);
+	String_clearCache(); /* a new batch */
+
+	if(knownTD == 0)
+	{
+		curr = MemoryContextSwitchTo(JavaMemoryContext);
+		knownTD = pljava_TupleDesc_internalCreate(tts->tupdesc);
+		MemoryContextSwitchTo(curr);
+	}
+
+	p2l.longVal = 0L; /* ensure that the rest is zeroed out */
+	p2l.ptrVal = tts;
+	/*
+	 * The SPITupleTable belongs to the current SPI connection, which
+	 * Invocation_popInvocation will finish; scoping the Java state to the
+	 * Invocation ensures it goes stale before that happens.
+	 */
+	p2lro.longVal = 0L;
+	p2lro.ptrVal = currentInvocation;
+
+	return JNI_newObject(s_TupleTable_class, s_TupleTable_initLazy,
+		pljava_DualState_key(), p2lro.longVal, p2l.longVal, knownTD, tupcount);
+}
+
 /* Make this datatype available to the postgres system.
  */
 extern void TupleTable_initialize(void);
 void TupleTable_initialize(void)
 {
+	JNINativeMethod methods[] =
+	{
+		{
+		"_slot",
+		"(JI)Lorg/postgresql/pljava/internal/Tuple;",
+		Java_org_postgresql_pljava_internal_TupleTable__1slot
+		},
+		{ 0, 0, 0 }
+	};
+
 	s_TupleTable_class = JNI_newGlobalRef(PgObject_getJavaClass("org/postgresql/pljava/internal/TupleTable"));
+	PgObject_registerNatives2(s_TupleTable_class, methods);
 	s_TupleTable_init = PgObject_getJavaMethod(
 				s_TupleTable_class, "<init>",
 				"(Lorg/postgresql/pljava/internal/TupleDesc;[Lorg/postgresql/pljava/internal/Tuple;)V");
+	s_TupleTable_initLazy = PgObject_getJavaMethod(
+				s_TupleTable_class, "<init>",
+				"(Lorg/postgresql/pljava/internal/DualState$Key;JJLorg/postgresql/pljava/internal/TupleDesc;I)V");
+}
+
+/*
+ * Class:     org_postgresql_pljava_internal_TupleTable
+ * Method:    _slot
+ * Signature: (JI)Lorg/postgresql/pljava/internal/Tuple;
+ */
+JNIEXPORT jobject JNICALL
+Java_org_postgresql_pljava_internal_TupleTable__1slot(JNIEnv* env, jclass cls, jlong _this, jint position)
+{
+	jobject result = 0;
+	Ptr2Long p2l;
+	MemoryContext curr;
+
+	p2l.longVal = _this;
+	BEGIN_NATIVE
+	curr = MemoryContextSwitchTo(JavaMemoryContext);
+	PG_TRY();
+	{
+		result = pljava_Tuple_internalCreate(
+			((SPITupleTable*)p2l.ptrVal)->vals[position], true);
+		MemoryContextSwitchTo(curr);
+	}
+	PG_CATCH();
+	{
+		MemoryContextSwitchTo(curr);
+		Exception_throw_ERROR("pljava_Tuple_internalCreate");
+	}
+	PG_END_TRY();
+	END_NATIVE
+	return result;
 }
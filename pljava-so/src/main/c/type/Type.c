@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2022 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -22,6 +22,7 @@
 #include "pljava/type/Array.h"
 #include "pljava/type/Coerce.h"
 #include "pljava/type/Composite.h"
+#include "pljava/type/Enum.h"
 #include "pljava/type/TupleDesc.h"
 #include "pljava/type/Oid.h"
 #include "pljava/type/UDT.h"
@@ -338,6 +339,35 @@ jvalue Type_coerceDatumAs(Type self, Datum value, jclass rqcls)
 	return Type_coerceDatum(self, value);
 }
 
+bool Type_isBoxedPrimitive(Type self)
+{
+	static const char* const boxedSignatures[] =
+	{
+		"Ljava/lang/Boolean;", "Ljava/lang/Byte;", "Ljava/lang/Short;",
+		"Ljava/lang/Integer;", "Ljava/lang/Long;", "Ljava/lang/Float;",
+		"Ljava/lang/Double;", NULL
+	};
+	const char* const* sp;
+	const char* sig;
+
+	if ( NULL == self->typeClass->coerceDatumUnboxed )
+		return false;
+
+	sig = Type_getJNISignature(self);
+	for ( sp = boxedSignatures ; NULL != *sp ; ++ sp )
+		if ( 0 == strcmp(*sp, sig) )
+			return true;
+	return false;
+}
+
+jvalue Type_coerceDatumUnboxed(Type self, Datum value)
+{
+	if ( NULL == self->typeClass->coerceDatumUnboxed )
+		elog(ERROR, "PL/Java type %s cannot be passed unboxed",
+			PgObjectClass_getName((PgObjectClass)self->typeClass));
+	return self->typeClass->coerceDatumUnboxed(self, value);
+}
+
 Datum Type_coerceObject(Type self, jobject object)
 {
 	return self->typeClass->coerceObject(self, object);
@@ -665,9 +695,15 @@ Type Type_fromOidCache(Oid typeId)
 	return (Type)HashMap_getByOid(s_typeByOid, typeId);
 }
 
+uint32 Type_cacheSize(void)
+{
+	return HashMap_size(s_typeByOid);
+}
+
 /*
  * Return NULL unless typeId represents a MappedUDT as found in the typeMap,
- * in which case return a freshly-registered UDT Type.
+ * in which case return a freshly-registered UDT Type. An SQL enum type found
+ * in the typeMap is registered as an Enum Type instead.
  *
  * A MappedUDT's supporting functions don't have SQL declarations, from which
  * an ordinary function's PLPrincipal and initiating class loader would be
@@ -710,6 +746,17 @@ checkTypeMappedUDT(Oid typeId, jobject typeMap, Form_pg_type typeStruct)
 	if ( NULL == typeClass )
 		return NULL;
 
+	/*
+	 * An SQL enum type can be mapped to a Java enum class, for which
+	 * Enum_register builds the table relating labels and constants.
+	 */
+	if ( 'e' == typeStruct->typtype )
+	{
+		type = Enum_register(typeClass, typeId, typeStruct);
+		JNI_deleteLocalRef(typeClass);
+		return type;
+	}
+
 	if ( -2 == typeStruct->typlen )
 	{
 		JNI_deleteLocalRef(typeClass);
@@ -1001,6 +1048,8 @@ extern void TupleTable_initialize(void);
 
 extern void Composite_initialize(void);
 
+extern void Enum_initialize(void);
+
 extern void pljava_SQLXMLImpl_initialize(void);
 
 extern void Type_initialize(void);
@@ -1037,6 +1086,7 @@ void Type_initialize(void)
 	TupleTable_initialize();
 
 	Composite_initialize();
+	Enum_initialize();
 	pljava_SQLXMLImpl_initialize();
 
 	s_Map_class = JNI_newGlobalRef(PgObject_getJavaClass("java/util/Map"));
@@ -1083,6 +1133,7 @@ TypeClass TypeClass_alloc2(
 	self->canReplaceType  = _Type_canReplaceType;
 	self->coerceDatum     = (DatumCoercer)_PgObject_pureVirtualCalled;
 	self->coerceObject    = (ObjectCoercer)_PgObject_pureVirtualCalled;
+	self->coerceDatumUnboxed = NULL;
 	self->createArrayType = _Type_createArrayType;
 	self->invoke          = _Type_invoke;
 	self->getSRFCollector = _Type_getSRFCollector;
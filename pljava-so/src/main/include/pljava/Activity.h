@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+#ifndef __pljava_Activity_h
+#define __pljava_Activity_h
+
+#include "pljava/Invocation.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * What PL/Java reports to PostgreSQL's activity monitoring: wait events, seen
+ * in pg_stat_activity while a backend is starting its JVM, fetching class
+ * images from sqlj.jar_entry, waiting for the lock that lets a thread enter
+ * PostgreSQL, or cleaning up native state of Java objects found unreachable by
+ * the garbage collector; and the progress reported by a Java function through
+ * Session.reportProgress, seen in the sqlj.pljava_stat_progress view.
+ *
+ * From PostgreSQL 17, each wait event has its own name, registered by
+ * pljava_Activity_registerWaitEvents before the JVM is started; before 17, all
+ * show as the generic Extension event, and before 10, none are reported.
+ * Progress is reported from PostgreSQL 14.
+ */
+
+/*
+ * The wait events; the numbering is shared with Activity.java.
+ */
+typedef enum
+{
+	PLJAVA_WAIT_JVM_STARTUP,
+	PLJAVA_WAIT_CLASS_LOAD,
+	PLJAVA_WAIT_THREAD_LOCK,
+	PLJAVA_WAIT_DUALSTATE_CLEANUP,
+	PLJAVA_WAIT_EVENTS
+} PLJavaWaitEvent;
+
+extern void pljava_Activity_initialize(void);
+
+/*
+ * Register the names of the wait events, where an error is tolerable: during
+ * PL/Java's initialization, before the JVM is started. Until it is called,
+ * any wait event is reported as the generic Extension event.
+ */
+extern void pljava_Activity_registerWaitEvents(void);
+
+/*
+ * Report the wait event, returning the one that was reported before, to be
+ * passed to pljava_Activity_waitEnd. (PostgreSQL's own wait events do not
+ * nest; PL/Java's can enclose others, for example a wait for the thread lock
+ * on returning from Java during JVM startup, and are restored after them.)
+ */
+extern uint32 pljava_Activity_waitStart(PLJavaWaitEvent event);
+
+extern void pljava_Activity_waitEnd(uint32 prior);
+
+/*
+ * Called as an Invocation exits, to end progress reporting if that invocation
+ * began it.
+ */
+extern void pljava_Activity_invocationExit(Invocation *ctx);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2021 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -38,6 +38,40 @@ extern bool integerDateTimes;
 
 int Backend_setJavaLogLevel(int logLevel);
 
+/*
+ * Value of the pljava.lazy_row_conversion setting: whether rows fetched from
+ * a cursor are left in the SPITupleTable until Java reaches each one.
+ */
+extern bool pljavaLazyRowConversion;
+
+/*
+ * Value of the pljava.foreign_upcalls setting: whether functions returning a
+ * primitive or void are called through foreign-function upcall stubs rather
+ * than JNI, where the Java runtime supports it (see Function.c).
+ */
+extern bool pljavaForeignUpcalls;
+
+/*
+ * Value of the pljava.foreign_downcalls setting: whether a few trivial native
+ * accessors are called from Java through foreign-function downcall handles
+ * rather than JNI, where the Java runtime supports it (see ForeignDowncalls.c).
+ */
+extern bool pljavaForeignDowncalls;
+
+/*
+ * Value of the pljava.string_cache_size setting: how many short values may have
+ * their Java Strings remembered for reuse (see String_clearCache).
+ */
+extern int pljavaStringCacheSize;
+
+/*
+ * Values of the pljava.cpu_budget (milliseconds) and pljava.allocation_budget
+ * (kilobytes) settings; when either is nonzero, functions are invoked through
+ * EntryPoints.invokeBudgeted, which enforces them (see Function.c).
+ */
+extern int pljavaCpuBudget;
+extern int pljavaAllocationBudget;
+
 /*
  * Called at the ends of committing transactions to emit a warning about future
  * JEP 411 impacts, at most once per session, if any PL/Java functions were
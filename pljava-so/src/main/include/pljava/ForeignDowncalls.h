@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+#ifndef __pljava_ForeignDowncalls_h
+#define __pljava_ForeignDowncalls_h
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Plain C functions for the Java class ForeignDowncalls to bind with
+ * java.lang.foreign.Linker, in place of JNI natives, when
+ * pljava.foreign_downcalls is on. Each is called with no JNI environment and
+ * no Java exception bookkeeping, so none may raise a PostgreSQL error or call
+ * into Java.
+ */
+
+extern void pljava_ForeignDowncalls_initialize(void);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
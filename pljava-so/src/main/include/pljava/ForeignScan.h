@@ -0,0 +1,46 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+#ifndef __pljava_ForeignScan_h
+#define __pljava_ForeignScan_h
+
+#include <postgres.h>
+#include <foreign/fdwapi.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Foreign data wrappers implemented in Java. The handler (sqlj.java_fdw_handler
+ * in Backend.c) returns the routine built here, whose scan callbacks dispatch
+ * to an org.postgresql.pljava.ForeignDataWrapper named by the wrapper's class
+ * option, through the internal Java class ForeignScan. Rows come back from Java
+ * in batches, one Java call per batch.
+ */
+
+extern void pljava_ForeignScan_initialize(void);
+
+/*
+ * The FdwRoutine for every Java foreign data wrapper.
+ */
+extern FdwRoutine *pljava_ForeignScan_routine(void);
+
+/*
+ * Validate the options (a List of DefElem) given for the object of the catalog
+ * identified by catalog.
+ */
+extern void pljava_ForeignScan_validate(List *options, Oid catalog);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
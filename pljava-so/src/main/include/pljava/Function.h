@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2021 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -42,6 +42,18 @@ extern "C" {
  */
 extern void Function_clearFunctionCache(void);
 
+/*
+ * Clear only the cached functions whose schema loader is one of the elements
+ * of the Java array loaders.
+ */
+extern void Function_clearFunctionCacheFor(jobjectArray loaders);
+
+/*
+ * Send a shared invalidation, effective at commit, prompting every backend to
+ * check for schema loaders made stale by a change to the jar repository.
+ */
+extern void Function_invalidateLoaders(void);
+
 /*
  * Determine whether the type represented by typeId is declared as a
  * "Java-based scalar" a/k/a BaseUDT and, if so, return a freshly-registered
@@ -142,6 +154,30 @@ extern jobject pljava_Function_udtReadHandle(
  */
 extern jobject Function_getTypeMap(Function self);
 
+/*
+ * Called as an Invocation exits if it used the Function's scratch context for
+ * argument coercion; resets that context when no enclosing invocation of the
+ * same Function is still using it.
+ */
+extern void pljava_Function_endScratch(Function self);
+
+/*
+ * Total milliseconds spent resolving (creating) Function objects on cache
+ * misses in this session; if count is not NULL, the number of such
+ * resolutions is stored there.
+ */
+extern double pljava_Function_resolutionMillis(uint64 *count);
+
+/*
+ * The number of Function objects currently cached by function Oid.
+ */
+extern uint32 pljava_Function_cacheSize(void);
+
+/*
+ * The pg_proc oid of the function.
+ */
+extern Oid pljava_Function_oid(Function self);
+
 /*
  * Returns true if the currently executing function is non volatile, i.e. stable
  * or immutable. Such functions are not allowed to have side effects.
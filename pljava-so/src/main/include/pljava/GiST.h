@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+#ifndef __pljava_GiST_h
+#define __pljava_GiST_h
+
+#include <postgres.h>
+#include <fmgr.h>
+
+#include "pljava/type/Type.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * GiST support functions written in Java. The internal arguments of the GiST
+ * support-function protocol (a GISTENTRY, a GistEntryVector, a GIST_SPLITVEC,
+ * or a pointer to a result) are mapped to the nested interfaces of
+ * org.postgresql.pljava.GiST by Java type name, and wrapped by the internal
+ * Java class GiSTSupport. A key is converted to or from Java using the
+ * indexed or storage type of the index column whose operator class the
+ * function is supporting, found from the entry's index relation.
+ */
+
+extern void pljava_GiST_initialize(void);
+
+/*
+ * Called by Function_invoke before converting the parameters of a Java
+ * function with any parameter of type internal: for each argument whose Type
+ * is one of the GiST wrappers, replace the pointer with a description that
+ * carries the key types and entry numbering its wrapper will need.
+ */
+extern void pljava_GiST_prepare(Type *types, int nargs, PG_FUNCTION_ARGS);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
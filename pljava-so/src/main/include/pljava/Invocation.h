@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2021 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -45,6 +45,13 @@ struct Invocation_
 	 */
 	bool          hasConnected;
 
+	/**
+	 * Set when the function's scratch context was used to coerce arguments.
+	 * Ensures that pljava_Function_endScratch is called when the function
+	 * exits.
+	 */
+	bool          usedScratch;
+
 	/**
 	 * Set to true if the call originates from an ExprContextCallback. When
 	 * it does, we should not close any cursors.
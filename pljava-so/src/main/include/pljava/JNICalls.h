@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2021 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -123,6 +123,25 @@ extern void         JNI_callVoidMethodLockedV(jobject object, jmethodID methodID
 extern jobject      JNI_newObjectLocked(jclass clazz, jmethodID ctor, ...);
 extern jobject      JNI_newObjectLockedV(jclass clazz, jmethodID ctor, va_list args);
 
+/*
+ * Calls to Java through foreign-function upcall stubs (obtained on Java 22 and
+ * later with java.lang.foreign.Linker.upcallStub), each taking one jint. These
+ * get the same handling of the thread lock and of a pending exception as the
+ * JNI calls, but an upcall stub cannot leave an exception pending; the Java
+ * side must catch any and report it some other way.
+ */
+typedef void (*JNI_upcall)(void);
+
+extern void         JNI_callVoidUpcall(JNI_upcall fn, jint arg);
+extern jboolean     JNI_callBooleanUpcall(JNI_upcall fn, jint arg);
+extern jbyte        JNI_callByteUpcall(JNI_upcall fn, jint arg);
+extern jshort       JNI_callShortUpcall(JNI_upcall fn, jint arg);
+extern jchar        JNI_callCharUpcall(JNI_upcall fn, jint arg);
+extern jint         JNI_callIntUpcall(JNI_upcall fn, jint arg);
+extern jlong        JNI_callLongUpcall(JNI_upcall fn, jint arg);
+extern jfloat       JNI_callFloatUpcall(JNI_upcall fn, jint arg);
+extern jdouble      JNI_callDoubleUpcall(JNI_upcall fn, jint arg);
+
 /*
  * Misc JNIEnv mappings. See <jni.h> for more info.
  */
@@ -212,6 +231,7 @@ extern jboolean     JNI_getStaticBooleanField(jclass clazz, jfieldID field);
 extern jint         JNI_getStaticIntField(jclass clazz, jfieldID field);
 extern jobject      JNI_getStaticObjectField(jclass clazz, jfieldID field);
 extern const char*  JNI_getStringUTFChars(jstring string, jboolean* isCopy);
+extern int64        JNI_globalRefCount(void);
 extern jboolean     JNI_hasNullArrayElement(jobjectArray array);
 extern jboolean     JNI_isCallingJava(void);
 extern jboolean     JNI_isInstanceOf(jobject obj, jclass clazz);
@@ -231,6 +251,7 @@ extern jobjectArray JNI_newObjectArray(jsize length, jclass elementClass, jobjec
 extern jshortArray  JNI_newShortArray(jsize length);
 extern jstring      JNI_newStringUTF(const char* bytes);
 extern jobject      JNI_newWeakGlobalRef(jobject object);
+extern void         JNI_noteNewGlobalRef(void);
 extern jint         JNI_pushLocalFrame(jint capacity);
 extern jobject      JNI_popLocalFrame(jobject result);
 extern jint         JNI_registerNatives(jclass clazz, const JNINativeMethod* methods, jint nMethods);
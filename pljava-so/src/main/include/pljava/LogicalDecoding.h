@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+#ifndef __pljava_LogicalDecoding_h
+#define __pljava_LogicalDecoding_h
+
+#include <postgres.h>
+#include <replication/output_plugin.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Logical decoding output plugins implemented in Java. The library's
+ * _PG_output_plugin_init (in Backend.c) fills in the callbacks here, which
+ * dispatch to an org.postgresql.pljava.LogicalDecoder named by the class
+ * option, through the internal Java class LogicalDecoding. The changes of
+ * a transaction are collected and passed to Java in batches.
+ */
+
+extern void pljava_LogicalDecoding_initialize(void);
+
+extern void pljava_LogicalDecoding_callbacks(OutputPluginCallbacks *cb);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
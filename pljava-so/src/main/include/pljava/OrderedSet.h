@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+#ifndef __pljava_OrderedSet_h
+#define __pljava_OrderedSet_h
+
+#include <postgres.h>
+#include <fmgr.h>
+
+#include "pljava/type/Type.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Ordered-set and hypothetical-set aggregates with finishers in Java. The
+ * transition function (sqlj.java_ordered_set_transition in Backend.c) feeds
+ * each group's aggregated rows to a tuplesort kept in the aggregate's memory
+ * context, as PostgreSQL's own ordered_set_transition does. The state is of
+ * SQL type internal, which PL/Java maps to org.postgresql.pljava.SortedInput,
+ * so the finisher can be a Java function taking that as its first parameter;
+ * it reads the sorted rows back in batches, through the internal Java class
+ * OrderedSet.
+ */
+
+extern void pljava_OrderedSet_initialize(void);
+
+/*
+ * Add the current row's aggregated arguments to the sort, starting it (for the
+ * first row of a group) if the state is null.
+ */
+extern Datum pljava_OrderedSet_transition(PG_FUNCTION_ARGS);
+
+/*
+ * True if the Type is the one mapping internal to SortedInput.
+ */
+extern bool pljava_OrderedSet_isSortedInput(Type t);
+
+/*
+ * Called by Function_invoke before converting the parameters of a Java
+ * function whose first parameter is a SortedInput: check that the state is
+ * one made by pljava_OrderedSet_transition (or start an empty one when no rows
+ * were aggregated, replacing the null argument), add the hypothetical row for
+ * a hypothetical-set aggregate, and perform the sort.
+ */
+extern void pljava_OrderedSet_prepareFinal(PG_FUNCTION_ARGS);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,67 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+#ifndef __pljava_Stats_h
+#define __pljava_Stats_h
+
+#include <postgres.h>
+#include <portability/instr_time.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Cluster-wide cumulative statistics for PL/Java. Each backend counts locally,
+ * and adds its counts to an area of shared memory at most once a second, at
+ * the end of a transaction, and when it exits. The totals outlive the backends
+ * that contributed them, until reset, and are read through the internal Java
+ * class Stats by the sqlj.pljava_stat_* views.
+ *
+ * From PostgreSQL 17, the area is a named segment from the DSM registry, made
+ * by whichever backend needs it first. Before 17, it can only be reserved when
+ * PL/Java is in shared_preload_libraries; otherwise, nothing is counted.
+ */
+
+/*
+ * Called from _PG_init when loading in shared_preload_libraries: arrange for
+ * the area to be reserved in the main shared memory, where that is needed.
+ */
+extern void pljava_Stats_preload(void);
+
+extern void pljava_Stats_initialize(void);
+
+/*
+ * Count a completed call of a PL/Java function, begun at start; does nothing
+ * unless track_functions is pl or all.
+ */
+extern void pljava_Stats_functionCall(Oid funcOid, instr_time *start);
+
+/*
+ * Count a statement run through SPI for Java.
+ */
+extern void pljava_Stats_spiStatement(void);
+
+/*
+ * Count a start of the JVM and PL/Java, which took the given milliseconds.
+ */
+extern void pljava_Stats_jvmStarted(double millis);
+
+/*
+ * Add this backend's counts to the shared totals, with the JVM's own counters
+ * if withJVM; unless force, only if a second has passed since the last time.
+ */
+extern void pljava_Stats_flush(bool force, bool withJVM);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,61 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+#ifndef __pljava_Worker_h
+#define __pljava_Worker_h
+
+#include <postgres.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Background workers that run jobs submitted with sqlj.submit, so heavy work
+ * can be done in a few long-lived, warmed JVMs instead of in every backend
+ * that asks for it.
+ *
+ * Workers are started on demand, per database, by sqlj.submit, up to the
+ * number in pljava.worker_count. Each one polls the table sqlj.worker_job for
+ * pending jobs, and runs each job's function as the role that submitted it.
+ * A worker exits when PL/Java is no longer installed in its database, or when
+ * there are already pljava.worker_count older workers in the database.
+ */
+
+/*
+ * Values of the pljava.worker_count and pljava.worker_naptime settings.
+ */
+extern int pljava_workerCount;
+extern int pljava_workerNaptime;
+
+/*
+ * The application_name each worker reports, by which they can be found (and
+ * counted) in pg_stat_activity.
+ */
+#define PLJAVA_WORKER_NAME "PL/Java worker"
+
+/*
+ * Register up to count dynamic background workers for the current database,
+ * using the PL/Java library at libraryPath. Returns the number that could be
+ * registered, which may be fewer (with a WARNING) if max_worker_processes has
+ * been reached.
+ */
+extern int pljava_Worker_launch(char const *libraryPath, int count);
+
+/*
+ * Entry point named in the registration of each worker.
+ */
+extern PGDLLEXPORT void pljava_Worker_main(Datum dbOid);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
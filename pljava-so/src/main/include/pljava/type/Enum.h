@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+#ifndef __pljava_type_Enum_h
+#define __pljava_type_Enum_h
+
+#include "pljava/type/Type.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**************************************************************************
+ * The Enum class extends the Type to map an SQL enum type to a Java enum
+ * class, as declared with sqlj.add_type_mapping. The labels of the SQL type
+ * are matched once to the constants of the same names, so that a value is
+ * converted in either direction by indexing an array.
+ **************************************************************************/
+
+struct Enum_;
+typedef struct Enum_* Enum;
+
+/*
+ * Register the Java enum class clazz as the mapping for the SQL enum type
+ * typeId. Reports an error if clazz is not an enum class.
+ */
+extern Type Enum_register(jclass clazz, Oid typeId, Form_pg_type pgType);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
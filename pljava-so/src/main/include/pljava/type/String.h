@@ -72,6 +72,13 @@ extern void String_appendJavaString(StringInfoData* buf, jstring javaString);
  */
 extern text* String_createText(jstring javaString);
 
+/*
+ * Forget the Strings remembered for reuse while pljava.string_cache_size is
+ * nonzero. Called when each batch of rows is fetched, and when the outermost
+ * Invocation ends.
+ */
+extern void String_clearCache(void);
+
 extern Type String_obtain(Oid typeId);
 
 extern StringPL StringClass_obtain(TypeClass self, Oid typeId);
@@ -43,6 +43,12 @@ struct String_
 	 * Oid of elment type (if any)
 	 */
 	Oid elementType;
+
+	/*
+	 * True if textOutput merely copies the bytes of a varlena (as for text,
+	 * varchar, and bpchar), so they can be used without calling it.
+	 */
+	bool rawText;
 };
 
 extern Datum _String_coerceObject(Type self, jobject jstr);
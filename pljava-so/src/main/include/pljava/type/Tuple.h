@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2019 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -36,6 +36,13 @@ extern jobject pljava_Tuple_internalCreate(HeapTuple tuple, bool mustCopy);
 extern jobjectArray pljava_Tuple_createArray(
 	HeapTuple* tuples, jint size, bool mustCopy);
 
+/*
+ * Create an org.postgresql.pljava.Tuple that refers to the tuple without
+ * copying it, for use only until the current Invocation is popped. The tuple
+ * must remain valid that long, and is not freed from Java.
+ */
+extern jobject pljava_Tuple_createBorrowed(HeapTuple tuple);
+
 /*
  * Return a java object at given index from a HeapTuple (with a best effort to
  * produce an object of class rqcls if it is not null).
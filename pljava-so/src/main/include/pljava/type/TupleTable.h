@@ -30,6 +30,14 @@ extern "C" {
 extern jobject TupleTable_createFromSlot(TupleTableSlot* tupleTableSlot);
 extern jobject TupleTable_create(SPITupleTable* tupleTable, jobject knownTD);
 
+/*
+ * Create a TupleTable that keeps the SPITupleTable and only creates a Java
+ * Tuple for each row when it is asked for. The SPITupleTable then belongs to
+ * the Java object, and must not be freed by the caller.
+ */
+extern jobject TupleTable_createLazy(SPITupleTable* tupleTable,
+	jobject knownTD);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2020 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -68,6 +68,20 @@ extern bool Type_canReplaceType(Type self, Type type);
  */
 extern jvalue Type_coerceDatum(Type self, Datum datum);
 
+/*
+ * Returns true if the Java class of this type is one of the boxed primitive
+ * classes Boolean, Byte, Short, Integer, Long, Float, or Double. A function
+ * parameter of such a type is passed to Java in the primitive parameter area,
+ * with a null flag, and boxed in Java.
+ */
+extern bool Type_isBoxedPrimitive(Type self);
+
+/*
+ * For a type for which Type_isBoxedPrimitive is true, translate a given
+ * non-null Datum into the jvalue of the corresponding primitive.
+ */
+extern jvalue Type_coerceDatumUnboxed(Type self, Datum datum);
+
 /*
  * Translate a given Datum into a jvalue, where the type represented
  * by this instance is derived from the PG type of the datum, and rqcls, if
@@ -245,6 +259,11 @@ typedef Datum (*ObjectCoercer)(Type, jobject);
 extern void Type_registerType(const char* javaTypeName, Type type);
 extern void Type_registerType2(Oid typeId, const char* javaTypeName, TypeObtainer obtainer);
 
+/*
+ * The number of types currently cached by Oid.
+ */
+extern uint32 Type_cacheSize(void);
+
 #include "pljava/Function.h"
 
 /*
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2020 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -86,6 +86,13 @@ struct TypeClass_
 	 */
 	DatumCoercer coerceDatum;
 
+	/*
+	 * For a boxed primitive type (Integer, for example), translate a given
+	 * Datum into the jvalue of the primitive, leaving the boxing to be done in
+	 * Java. NULL for any other type.
+	 */
+	DatumCoercer coerceDatumUnboxed;
+
 	/*
 	 * Translate a given Object into a Datum accorging to the type represented
 	 * by this instance.
@@ -0,0 +1,99 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+package org.postgresql.pljava.internal;
+
+import static org.postgresql.pljava.internal.Backend.doInPG;
+
+import java.sql.SQLException;
+
+/**
+ * Reporting of PL/Java's activity where PostgreSQL's monitoring can see it:
+ * wait events in {@code pg_stat_activity}, and the progress of long-running
+ * functions in the {@code sqlj.pljava_stat_progress} view.
+ *<p>
+ * The native code reports most of the wait events itself; Java code reports
+ * the wait for a class image from {@code sqlj.jar_entry} through
+ * {@link #waitFor waitFor}.
+ */
+public final class Activity
+{
+	private Activity() { } // do not instantiate
+
+	/*
+	 * The wait events, numbered as in the native code.
+	 */
+	public static final int WAIT_JVM_STARTUP       = 0;
+	public static final int WAIT_CLASS_LOAD        = 1;
+	public static final int WAIT_THREAD_LOCK       = 2;
+	public static final int WAIT_DUALSTATE_CLEANUP = 3;
+
+	/**
+	 * A wait event being reported, which the one reported before replaces
+	 * again when closed.
+	 */
+	public static final class Wait implements AutoCloseable
+	{
+		private final int m_prior;
+
+		private Wait(int prior)
+		{
+			m_prior = prior;
+		}
+
+		@Override
+		public void close()
+		{
+			doInPG(() -> _waitEnd(m_prior));
+		}
+	}
+
+	/**
+	 * Report the wait event until the returned {@code Wait} is closed.
+	 */
+	public static Wait waitFor(int event)
+	{
+		return new Wait(doInPG(() -> _waitStart(event)));
+	}
+
+	/**
+	 * Show the progress of the calling function; see
+	 * {@link org.postgresql.pljava.Session#reportProgress
+	 * Session.reportProgress}.
+	 */
+	public static void reportProgress(long done, long total)
+	throws SQLException
+	{
+		if ( 0 > done  ||  0 > total )
+			throw new SQLException(
+				"progress may not be reported as negative", "22023");
+		doInPG(() -> _reportProgress(done, total));
+	}
+
+	/**
+	 * For each backend showing the progress of a PL/Java function, and
+	 * visible to the current role, five elements: process id, database oid,
+	 * function oid, work done, and total. Empty before PostgreSQL 14.
+	 */
+	public static long[] progress()
+	{
+		long[] a = doInPG(Activity::_progress);
+		return null == a ? new long[0] : a;
+	}
+
+	private static native int _waitStart(int event);
+
+	private static native void _waitEnd(int prior);
+
+	private static native void _reportProgress(long done, long total);
+
+	private static native long[] _progress();
+}
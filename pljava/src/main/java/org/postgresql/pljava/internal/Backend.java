@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2022 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -84,10 +84,13 @@ public class Backend
 	throws E
 	{
 		if ( null != THREADLOCK )
+		{
+			assertNotComputeWorker();
 			synchronized(THREADLOCK)
 			{
 				return op.get();
 			}
+		}
 		assertThreadMayEnterPG();
 		return op.get();
 	}
@@ -102,11 +105,14 @@ public class Backend
 	throws E
 	{
 		if ( null != THREADLOCK )
+		{
+			assertNotComputeWorker();
 			synchronized(THREADLOCK)
 			{
 				op.run();
 				return;
 			}
+		}
 		assertThreadMayEnterPG();
 		op.run();
 	}
@@ -123,10 +129,13 @@ public class Backend
 	throws E
 	{
 		if ( null != THREADLOCK )
+		{
+			assertNotComputeWorker();
 			synchronized(THREADLOCK)
 			{
 				return op.getAsBoolean();
 			}
+		}
 		assertThreadMayEnterPG();
 		return op.getAsBoolean();
 	}
@@ -143,10 +152,13 @@ public class Backend
 	throws E
 	{
 		if ( null != THREADLOCK )
+		{
+			assertNotComputeWorker();
 			synchronized(THREADLOCK)
 			{
 				return op.getAsDouble();
 			}
+		}
 		assertThreadMayEnterPG();
 		return op.getAsDouble();
 	}
@@ -162,10 +174,13 @@ public class Backend
 	throws E
 	{
 		if ( null != THREADLOCK )
+		{
+			assertNotComputeWorker();
 			synchronized(THREADLOCK)
 			{
 				return op.getAsInt();
 			}
+		}
 		assertThreadMayEnterPG();
 		return op.getAsInt();
 	}
@@ -181,10 +196,13 @@ public class Backend
 	throws E
 	{
 		if ( null != THREADLOCK )
+		{
+			assertNotComputeWorker();
 			synchronized(THREADLOCK)
 			{
 				return op.getAsLong();
 			}
+		}
 		assertThreadMayEnterPG();
 		return op.getAsLong();
 	}
@@ -229,6 +247,22 @@ public class Backend
 				"Attempt by non-initial thread to enter PostgreSQL from Java");
 	}
 
+	/**
+	 * Throw {@code IllegalStateException} if the current thread is a worker
+	 * in the {@link ComputePoolImpl compute pool}.
+	 *<p>
+	 * Those threads are never allowed into PG, whatever the setting of
+	 * {@code pljava.java_thread_pg_entry}; under the {@code throw} setting,
+	 * {@code assertThreadMayEnterPG} already excludes them, so this is only
+	 * needed where a {@code THREADLOCK} is in use.
+	 */
+	private static void assertNotComputeWorker()
+	{
+		if ( Thread.currentThread() instanceof ComputePoolImpl.Worker )
+			throw new IllegalStateException(
+				"Attempt by PL/Java compute pool thread to enter PostgreSQL");
+	}
+
 	/**
 	 * Returns the configuration option as read from the Global
 	 * Unified Config package (GUC).
@@ -279,11 +313,69 @@ public class Backend
 		doInPG(() -> _log(logLevel, str));
 	}
 
+	/**
+	 * Returns the value of the GUC custom variable
+	 * {@code pljava.compute_pool_size}.
+	 */
+	public static int getComputePoolSize()
+	{
+		return doInPG(Backend::_getComputePoolSize);
+	}
+
+	/**
+	 * Returns the value of the GUC custom variable
+	 * {@code pljava.worker_count}.
+	 */
+	public static int getWorkerCount()
+	{
+		return doInPG(Backend::_getWorkerCount);
+	}
+
+	/**
+	 * Start up to {@code count} PL/Java background workers for the current
+	 * database, loading the PL/Java library at {@code libraryPath}.
+	 * @return the number actually started, which is fewer than requested
+	 * (with a warning) if {@code max_worker_processes} has been reached.
+	 */
+	public static int launchWorkers(String libraryPath, int count)
+	throws SQLException
+	{
+		return doInPG(() -> _launchWorkers(libraryPath, count));
+	}
+
+	/**
+	 * Whether {@code xid} is the transaction ID of the current transaction or
+	 * of one of its subtransactions not yet aborted, as when it is the
+	 * {@code xmin} of a row the current transaction inserted.
+	 */
+	public static boolean isCurrentTransaction(long xid)
+	{
+		return doInPG(() -> _isCurrentTransaction(xid));
+	}
+
 	public static void clearFunctionCache()
 	{
 		doInPG(Backend::_clearFunctionCache);
 	}
 
+	/**
+	 * Clear only the cached functions whose schema loader is one of
+	 * <em>loaders</em>.
+	 */
+	public static void clearFunctionCache(ClassLoader[] loaders)
+	{
+		doInPG(() -> _clearFunctionCacheFor(loaders));
+	}
+
+	/**
+	 * Arrange for every backend, when this transaction commits, to check its
+	 * schema loaders for staleness before its next function lookup.
+	 */
+	public static void invalidateLoaders() throws SQLException
+	{
+		doInPG(Backend::_invalidateLoaders);
+	}
+
 	public static boolean isCreatingExtension()
 	{
 		return doInPG(Backend::_isCreatingExtension);
@@ -303,6 +395,45 @@ public class Backend
 		throw new SQLException("Unable to retrieve PL/Java's library path");
 	}
 
+	/**
+	 * Returns the names of the timed PL/Java startup stages, in the order of
+	 * the values returned by {@link #startupTimings startupTimings}.
+	 *<p>
+	 * The last name is for the cumulative resolution of PL/Java functions,
+	 * which continues after startup as new functions are first called.
+	 */
+	public static String[] startupStageNames()
+	{
+		return doInPG(Backend::_startupStageNames);
+	}
+
+	/**
+	 * Returns the milliseconds spent in each PL/Java startup stage, in the
+	 * order named by {@link #startupStageNames startupStageNames}.
+	 *<p>
+	 * The last two elements are not startup stages: the cumulative
+	 * milliseconds spent resolving PL/Java functions so far (the element for
+	 * the last name), then the count of PL/Java functions resolved, which has
+	 * no name. The array is therefore one element longer than the array of
+	 * names.
+	 */
+	public static double[] startupTimings()
+	{
+		return doInPG(Backend::_startupTimings);
+	}
+
+	/**
+	 * Returns, in order, the bytes allocated in {@code TopMemoryContext} and
+	 * in PL/Java's own memory context (each with its children, and -1 if the
+	 * PostgreSQL version cannot report it), the number of JNI global
+	 * references PL/Java holds, and the numbers of functions and types in
+	 * PL/Java's native caches.
+	 */
+	public static double[] memoryReport()
+	{
+		return doInPG(Backend::_memoryReport);
+	}
+
 	/**
 	 * Attempt (best effort, unexposed JDK internals) to suppress
 	 * the layer-inappropriate JEP 411 warning when {@code InstallHelper}
@@ -327,13 +458,30 @@ public class Backend
 	 */
 	public static native boolean isReleaseLingeringSavepoints();
 
+	/**
+	 * Returns <code>true</code> if a query cancel or backend termination
+	 * request has arrived and not yet been serviced. May be called from any
+	 * thread; it only reads the flags set by the signal handlers.
+	 */
+	public static native boolean isInterruptPending();
+
 	private static native String _getConfigOption(String key);
 
 	private static native int  _getStatementCacheSize();
+	private static native int  _getComputePoolSize();
+	private static native int  _getWorkerCount();
+	private static native int  _launchWorkers(String libraryPath, int count)
+	throws SQLException;
+	private static native boolean _isCurrentTransaction(long xid);
 	private static native void _log(int logLevel, String str);
 	private static native void _clearFunctionCache();
+	private static native void _clearFunctionCacheFor(ClassLoader[] loaders);
+	private static native void _invalidateLoaders() throws SQLException;
 	private static native boolean _isCreatingExtension();
 	private static native String _myLibraryPath();
+	private static native String[] _startupStageNames();
+	private static native double[] _startupTimings();
+	private static native double[] _memoryReport();
 	private static native void _pokeJEP411(Class<?> caller, Object token);
 
 	private static class EarlyNatives
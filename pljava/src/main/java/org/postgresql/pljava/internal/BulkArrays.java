@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+package org.postgresql.pljava.internal;
+
+import java.math.BigDecimal;
+
+import java.time.LocalDate;
+
+/**
+ * Builds and takes apart arrays of boxed or object elements for the native
+ * array conversions in {@code type/Array.c}.
+ *<p>
+ * The native code copies the element values of a PostgreSQL array into a
+ * primitive Java array (or, for {@code numeric}, one comma-separated string),
+ * along with a mask that is {@code true} where an element is null, and makes
+ * one call here to build the Java array. In the other direction, one call
+ * here returns the values and fills in the mask. A {@code null} mask passed
+ * from native code means no element is null.
+ *<p>
+ * Boxing uses the {@code valueOf} methods, so small integral values and the
+ * two {@code Boolean} values are shared rather than allocated.
+ */
+final class BulkArrays
+{
+	private BulkArrays() // do not instantiate
+	{
+	}
+
+	/**
+	 * Days from the Java epoch (1970-01-01) to the PostgreSQL one
+	 * (2000-01-01).
+	 */
+	private static final long EPOCH_DIFF = 10957;
+
+	private static boolean isNull(boolean[] nulls, int i)
+	{
+		return null != nulls  &&  nulls[i];
+	}
+
+	static Boolean[] boxBooleans(boolean[] values, boolean[] nulls)
+	{
+		Boolean[] a = new Boolean [ values.length ];
+		for ( int i = 0 ; i < a.length ; ++ i )
+			if ( ! isNull(nulls, i) )
+				a[i] = Boolean.valueOf(values[i]);
+		return a;
+	}
+
+	static boolean[] unboxBooleans(Boolean[] a, boolean[] nulls)
+	{
+		boolean[] values = new boolean [ a.length ];
+		for ( int i = 0 ; i < a.length ; ++ i )
+		{
+			Boolean v = a[i];
+			if ( null == v )
+				nulls[i] = true;
+			else
+				values[i] = v.booleanValue();
+		}
+		return values;
+	}
+
+	static Short[] boxShorts(short[] values, boolean[] nulls)
+	{
+		Short[] a = new Short [ values.length ];
+		for ( int i = 0 ; i < a.length ; ++ i )
+			if ( ! isNull(nulls, i) )
+				a[i] = Short.valueOf(values[i]);
+		return a;
+	}
+
+	static short[] unboxShorts(Short[] a, boolean[] nulls)
+	{
+		short[] values = new short [ a.length ];
+		for ( int i = 0 ; i < a.length ; ++ i )
+		{
+			Short v = a[i];
+			if ( null == v )
+				nulls[i] = true;
+			else
+				values[i] = v.shortValue();
+		}
+		return values;
+	}
+
+	static Integer[] boxInts(int[] values, boolean[] nulls)
+	{
+		Integer[] a = new Integer [ values.length ];
+		for ( int i = 0 ; i < a.length ; ++ i )
+			if ( ! isNull(nulls, i) )
+				a[i] = Integer.valueOf(values[i]);
+		return a;
+	}
+
+	static int[] unboxInts(Integer[] a, boolean[] nulls)
+	{
+		int[] values = new int [ a.length ];
+		for ( int i = 0 ; i < a.length ; ++ i )
+		{
+			Integer v = a[i];
+			if ( null == v )
+				nulls[i] = true;
+			else
+				values[i] = v.intValue();
+		}
+		return values;
+	}
+
+	static Long[] boxLongs(long[] values, boolean[] nulls)
+	{
+		Long[] a = new Long [ values.length ];
+		for ( int i = 0 ; i < a.length ; ++ i )
+			if ( ! isNull(nulls, i) )
+				a[i] = Long.valueOf(values[i]);
+		return a;
+	}
+
+	static long[] unboxLongs(Long[] a, boolean[] nulls)
+	{
+		long[] values = new long [ a.length ];
+		for ( int i = 0 ; i < a.length ; ++ i )
+		{
+			Long v = a[i];
+			if ( null == v )
+				nulls[i] = true;
+			else
+				values[i] = v.longValue();
+		}
+		return values;
+	}
+
+	static Float[] boxFloats(float[] values, boolean[] nulls)
+	{
+		Float[] a = new Float [ values.length ];
+		for ( int i = 0 ; i < a.length ; ++ i )
+			if ( ! isNull(nulls, i) )
+				a[i] = Float.valueOf(values[i]);
+		return a;
+	}
+
+	static float[] unboxFloats(Float[] a, boolean[] nulls)
+	{
+		float[] values = new float [ a.length ];
+		for ( int i = 0 ; i < a.length ; ++ i )
+		{
+			Float v = a[i];
+			if ( null == v )
+				nulls[i] = true;
+			else
+				values[i] = v.floatValue();
+		}
+		return values;
+	}
+
+	static Double[] boxDoubles(double[] values, boolean[] nulls)
+	{
+		Double[] a = new Double [ values.length ];
+		for ( int i = 0 ; i < a.length ; ++ i )
+			if ( ! isNull(nulls, i) )
+				a[i] = Double.valueOf(values[i]);
+		return a;
+	}
+
+	static double[] unboxDoubles(Double[] a, boolean[] nulls)
+	{
+		double[] values = new double [ a.length ];
+		for ( int i = 0 ; i < a.length ; ++ i )
+		{
+			Double v = a[i];
+			if ( null == v )
+				nulls[i] = true;
+			else
+				values[i] = v.doubleValue();
+		}
+		return values;
+	}
+
+	/**
+	 * Build {@code LocalDate}s from PostgreSQL {@code date} values, which
+	 * count days from 2000-01-01.
+	 */
+	static LocalDate[] boxDates(int[] values, boolean[] nulls)
+	{
+		LocalDate[] a = new LocalDate [ values.length ];
+		for ( int i = 0 ; i < a.length ; ++ i )
+			if ( ! isNull(nulls, i) )
+				a[i] = LocalDate.ofEpochDay(values[i] + EPOCH_DIFF);
+		return a;
+	}
+
+	static int[] unboxDates(LocalDate[] a, boolean[] nulls)
+	{
+		int[] values = new int [ a.length ];
+		for ( int i = 0 ; i < a.length ; ++ i )
+		{
+			LocalDate v = a[i];
+			if ( null == v )
+				nulls[i] = true;
+			else
+				values[i] = (int)(v.toEpochDay() - EPOCH_DIFF);
+		}
+		return values;
+	}
+
+	/**
+	 * Build {@code BigDecimal}s from the text forms of the non-null
+	 * {@code numeric} values, separated by commas.
+	 */
+	static BigDecimal[] boxDecimals(String values, boolean[] nulls)
+	{
+		BigDecimal[] a = new BigDecimal [ nulls.length ];
+		int start = 0;
+		for ( int i = 0 ; i < a.length ; ++ i )
+		{
+			if ( nulls[i] )
+				continue;
+			int end = values.indexOf(',', start);
+			if ( -1 == end )
+				end = values.length();
+			a[i] = new BigDecimal(values.substring(start, end));
+			start = end + 1;
+		}
+		return a;
+	}
+
+	/**
+	 * Return the text forms of the non-null elements, separated by commas.
+	 */
+	static String unboxDecimals(BigDecimal[] a, boolean[] nulls)
+	{
+		StringBuilder sb = new StringBuilder();
+		for ( int i = 0 ; i < a.length ; ++ i )
+		{
+			BigDecimal v = a[i];
+			if ( null == v )
+			{
+				nulls[i] = true;
+				continue;
+			}
+			if ( 0 < sb.length() )
+				sb.append(',');
+			sb.append(v.toString());
+		}
+		return sb.toString();
+	}
+}
@@ -0,0 +1,209 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+package org.postgresql.pljava.internal;
+
+import java.security.AccessControlContext;
+import java.security.AccessController;
+
+import java.sql.SQLException;
+
+import java.util.ArrayList;
+import java.util.Collection;
+import java.util.List;
+
+import java.util.concurrent.Callable;
+import java.util.concurrent.CancellationException;
+import java.util.concurrent.ExecutionException;
+import java.util.concurrent.ExecutorService;
+import java.util.concurrent.Executors;
+import java.util.concurrent.Future;
+import java.util.concurrent.FutureTask;
+import java.util.concurrent.TimeoutException;
+import java.util.concurrent.atomic.AtomicInteger;
+
+import static java.util.concurrent.TimeUnit.MILLISECONDS;
+
+import org.postgresql.pljava.ComputePool;
+
+import org.postgresql.pljava.jdbc.Invocation;
+
+import static org.postgresql.pljava.internal.Backend.doInPG;
+import static org.postgresql.pljava.internal.Privilege.doPrivileged;
+
+/**
+ * Implementation of the backend's {@link ComputePool}.
+ *<p>
+ * The worker threads are instances of {@link Worker Worker}, which
+ * {@code Backend.doInPG} refuses to let into PG. Each submitted task is
+ * registered with the current {@link Invocation} to be cancelled when that
+ * invocation exits, and waiting for results polls
+ * {@link Backend#isInterruptPending} so a query cancel is noticed while the
+ * main thread is blocked in Java.
+ */
+class ComputePoolImpl implements ComputePool
+{
+	/**
+	 * How long to wait for a result between checks for a pending interrupt.
+	 */
+	private static final long POLL_MILLIS = 100;
+
+	private static ComputePoolImpl s_instance;
+
+	private final int m_parallelism;
+	private final ExecutorService m_executor;
+
+	/**
+	 * Type of the worker threads, recognized by {@code Backend} to bar them
+	 * from entering PG.
+	 */
+	static final class Worker extends Thread
+	{
+		Worker(Runnable r, int n)
+		{
+			super(r, "PL/Java compute " + n);
+			setDaemon(true);
+		}
+	}
+
+	/**
+	 * Return the pool, creating it on first use with the size from
+	 * {@code pljava.compute_pool_size}.
+	 */
+	static ComputePoolImpl getInstance()
+	{
+		return doInPG(() ->
+		{
+			if ( null == s_instance )
+				s_instance = new ComputePoolImpl(Backend.getComputePoolSize());
+			return s_instance;
+		});
+	}
+
+	private ComputePoolImpl(int parallelism)
+	{
+		m_parallelism = parallelism;
+		if ( 0 == parallelism )
+		{
+			m_executor = null;
+			return;
+		}
+
+		AtomicInteger serial = new AtomicInteger();
+		m_executor = doPrivileged(() ->
+			Executors.newFixedThreadPool(parallelism,
+				r -> new Worker(r, serial.incrementAndGet())));
+	}
+
+	@Override
+	public int parallelism()
+	{
+		return m_parallelism;
+	}
+
+	@Override
+	public <T> Future<T> submit(Callable<T> task) throws SQLException
+	{
+		if ( ! Backend.threadMayEnterPG() )
+			throw new IllegalStateException(
+				"Compute pool tasks may only be submitted by " +
+				"the thread that may enter PostgreSQL");
+
+		if ( null == m_executor )
+		{
+			FutureTask<T> ft = new FutureTask<>(task);
+			ft.run();
+			return ft;
+		}
+
+		@SuppressWarnings("removal")
+		AccessControlContext acc = AccessController.getContext();
+		ClassLoader loader = Thread.currentThread().getContextClassLoader();
+
+		Future<T> f = m_executor.submit(() ->
+		{
+			Thread t = Thread.currentThread();
+			t.setContextClassLoader(loader);
+			try
+			{
+				return doPrivileged(task::call, acc);
+			}
+			finally
+			{
+				t.setContextClassLoader(null);
+			}
+		});
+
+		Invocation.current().cancelOnExit(f);
+		return f;
+	}
+
+	@Override
+	public <T> T await(Future<T> future) throws SQLException
+	{
+		try
+		{
+			for ( ;; )
+			{
+				try
+				{
+					return future.get(POLL_MILLIS, MILLISECONDS);
+				}
+				catch ( TimeoutException e )
+				{
+					if ( Backend.isInterruptPending() )
+						break;
+				}
+			}
+		}
+		catch ( InterruptedException e )
+		{
+			Thread.currentThread().interrupt();
+		}
+		catch ( CancellationException e )
+		{
+		}
+		catch ( ExecutionException e )
+		{
+			Throwable t = e.getCause();
+			if ( t instanceof SQLException )
+				throw (SQLException)t;
+			throw new SQLException(
+				"PL/Java compute pool task failed: " + t, "XX000", t);
+		}
+
+		future.cancel(true);
+		throw new SQLException(
+			"canceling PL/Java compute pool task", "57014");
+	}
+
+	@Override
+	public <T> List<T> invokeAll(Collection<? extends Callable<T>> tasks)
+	throws SQLException
+	{
+		List<Future<T>> futures = new ArrayList<>(tasks.size());
+		List<T> results = new ArrayList<>(tasks.size());
+		try
+		{
+			for ( Callable<T> task : tasks )
+				futures.add(submit(task));
+			for ( Future<T> f : futures )
+				results.add(await(f));
+			return results;
+		}
+		finally
+		{
+			if ( results.size() < futures.size() )
+				for ( Future<T> f : futures )
+					f.cancel(true);
+		}
+	}
+}
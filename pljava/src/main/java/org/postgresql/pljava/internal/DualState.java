@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2020 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2018-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -605,6 +605,16 @@ public abstract class DualState<T> extends WeakReference<T>
 		catch ( JMException e ) { /* XXX */ }
 	}
 
+	/**
+	 * The number of {@code DualState} instances constructed and not yet
+	 * released, for {@code sqlj.memory_report()}.
+	 */
+	public static long liveCount()
+	{
+		return s_stats.getEnlistedScoped() + s_stats.getEnlistedUnscoped()
+			- s_stats.getDelistedScoped() - s_stats.getDelistedUnscoped();
+	}
+
 	/**
 	 * Pointer value of the {@code ResourceOwner} this instance belongs to,
 	 * if any.
@@ -2202,6 +2212,47 @@ public abstract class DualState<T> extends WeakReference<T>
 		private native void _spiCursorClose(long pointer);
 	}
 
+	/**
+	 * A {@code DualState} subclass whose only native resource releasing action
+	 * needed is {@code SPI_freetuptable} of a single pointer.
+	 */
+	public static abstract class SingleSPIfreetuptable<T>
+	extends SingleGuardedLong<T>
+	{
+		protected SingleSPIfreetuptable(
+			Key cookie, T referent, long resourceOwner, long ftTarget)
+		{
+			super(cookie, referent, resourceOwner, ftTarget);
+		}
+
+		@Override
+		public String formatString()
+		{
+			return "%s SPI_freetuptable(%x)";
+		}
+
+		/**
+		 * When the Java state is released or unreachable, an
+		 * {@code SPI_freetuptable}
+		 * call is made so the native memory is released without having to wait
+		 * for the {@code SPI_finish} at the end of the invocation.
+		 *<p>
+		 * The call is made only if the invocation that owns the table is the
+		 * current one, as only then is the table on the current SPI
+		 * connection's list; otherwise it is left for that invocation's
+		 * {@code SPI_finish}.
+		 */
+		@Override
+		protected void javaStateUnreachable(boolean nativeStateLive)
+		{
+			assert Backend.threadMayEnterPG();
+			if ( nativeStateLive )
+				_spiFreeTupTable(guardedLong(), m_resourceOwner);
+		}
+
+		private native void _spiFreeTupTable(long pointer, long invocation);
+	}
+
 	/**
 	 * Bean exposing some {@code DualState} allocation and lifecycle statistics
 	 * for viewing in a JMX management client.
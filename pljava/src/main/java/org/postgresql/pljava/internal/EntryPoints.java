@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2020-2021 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2020-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -44,7 +44,9 @@ import static org.postgresql.pljava.internal.UncheckedException.unchecked;
  * A class to consolidate entry points from C to PL/Java functions.
  *<p>
  * The *invoke methods in this class can be private, as they are invoked only
- * from C via JNI, not from Java.
+ * from C via JNI, not from Java. The exception is {@code invoke}, which is
+ * also called by {@code ForeignUpcalls} when a function is called through a
+ * foreign-function upcall stub instead of JNI, and by {@code invokeBudgeted}.
  *<p>
  * The primary entry point is {@code invoke}. The supplied {@code Invocable},
  * created by {@code invocable} below for its caller {@code Function.create},
@@ -150,7 +152,7 @@ class EntryPoints
 	 * has void type or returns a primitive (which will have been returned in
 	 * the first static primitive parameter slot).
 	 */
-	private static Object invoke(Invocable<PrivilegedAction<Object>> target)
+	static Object invoke(Invocable<PrivilegedAction<Object>> target)
 	throws Throwable
 	{
 		assert PrivilegedAction.class.isInstance(target.payload);
@@ -158,6 +160,52 @@ class EntryPoints
 		return doPrivilegedAndUnwrap(target.payload, target.acc);
 	}
 
+	/**
+	 * Entry point for a general PL/Java function, used instead of
+	 * {@link #invoke invoke} when {@code pljava.cpu_budget} or
+	 * {@code pljava.allocation_budget} is set.
+	 *<p>
+	 * The invocation is metered by {@link InvocationBudget}, and fails with
+	 * that class's exception if it exceeds either budget, unless it failed
+	 * with an error from PostgreSQL, which is left to propagate.
+	 * @param target as for {@code invoke}
+	 * @param function oid of the function, for the budget report
+	 * @param cpuBudget CPU nanoseconds allowed, or zero for no limit
+	 * @param allocationBudget bytes allowed to be allocated, or zero for no
+	 * limit
+	 */
+	private static Object invokeBudgeted(
+		Invocable<PrivilegedAction<Object>> target, int function,
+		long cpuBudget, long allocationBudget)
+	throws Throwable
+	{
+		InvocationBudget.Meter meter =
+			InvocationBudget.start(function, cpuBudget, allocationBudget);
+		Object result = null;
+		Throwable thrown = null;
+
+		try
+		{
+			result = invoke(target);
+		}
+		catch ( Throwable t )
+		{
+			thrown = t;
+		}
+
+		SQLException over = meter.finish();
+
+		if ( null != over  &&  ! (thrown instanceof ServerException) )
+		{
+			if ( null != thrown )
+				over.addSuppressed(thrown);
+			throw over;
+		}
+		if ( null != thrown )
+			throw thrown;
+		return result;
+	}
+
 	/**
 	 * Entry point for calling the {@code writeSQL} method of a UDT.
 	 *<p>
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2019 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -60,6 +60,13 @@ import java.util.LinkedHashMap;
  * using the plan becomes unreferenced and garbage-collected without
  * {@code close} being called (which would have moved the plan back to the
  * cache).
+ *<p>
+ * A plan can be prepared <em>parallel-capable</em>, allowing the planner to
+ * choose a parallel plan for it. PostgreSQL will start parallel workers only
+ * for a plan that is run to completion in one call, not for one opened as a
+ * cursor and fetched from in pieces, so such a plan is meant to be run with
+ * {@link #executeTable executeTable}. A parallel-capable plan is cached
+ * separately from an ordinary one for the same SQL and parameter types.
  * 
  * @author Thomas Hallgren
  */
@@ -153,11 +160,14 @@ public class ExecutionPlan
 
 		private final Oid[] m_argTypes;
 
-		PlanKey(String stmt, Oid[] argTypes)
+		private final boolean m_parallel;
+
+		PlanKey(String stmt, Oid[] argTypes, boolean parallel)
 		{
 			m_stmt = stmt;
-			m_hashCode = stmt.hashCode() + 1;
+			m_hashCode = stmt.hashCode() + (parallel ? 2 : 1);
 			m_argTypes = argTypes;
+			m_parallel = parallel;
 		}
 
 		public boolean equals(Object o)
@@ -166,6 +176,8 @@ public class ExecutionPlan
 				return false;
 
 			PlanKey pk = (PlanKey)o;
+			if(pk.m_parallel != m_parallel)
+				return false;
 			if(!pk.m_stmt.equals(m_stmt))
 				return false;
 
@@ -207,6 +219,14 @@ public class ExecutionPlan
 		m_state = new State(cookie, this, resourceOwner, spiPlan);
 	}
 
+	/**
+	 * Whether this plan was prepared parallel-capable.
+	 */
+	public boolean isParallelCapable()
+	{
+		return m_key instanceof PlanKey  &&  ((PlanKey)m_key).m_parallel;
+	}
+
 	/**
 	 * Close the plan.
 	 */
@@ -242,6 +262,7 @@ public class ExecutionPlan
 		String cursorName, Object[] parameters, short read_only)
 	throws SQLException
 	{
+		InvocationBudget.check();
 		return doInPG(() ->
 			_cursorOpen(m_state.getExecutionPlanPtr(),
 				cursorName, parameters, read_only));
@@ -278,11 +299,40 @@ public class ExecutionPlan
 	public int execute(Object[] parameters, short read_only, int rowCount)
 	throws SQLException
 	{
+		InvocationBudget.check();
 		return doInPG(() ->
 			_execute(m_state.getExecutionPlanPtr(),
 				parameters, read_only, rowCount));
 	}
 
+	/**
+	 * Execute a plan that returns rows, to completion, and return all of them
+	 * in one {@code TupleTable}.
+	 *<p>
+	 * Unlike {@link #cursorOpen cursorOpen}, this lets a plan prepared
+	 * parallel-capable use parallel workers, at the cost of holding the whole
+	 * result in memory at once (as native tuples, converted for Java as they
+	 * are reached if {@code pljava.lazy_row_conversion} is on).
+	 *
+	 * @param parameters Values for the parameters.
+	 * @param read_only As for {@link #execute execute}.
+	 * @param rowCount The maximum number of rows, or zero for no limit. A limit
+	 *     keeps PostgreSQL from using parallel workers.
+	 * @param knownTD The {@code TupleDesc} of the result if known, or null.
+	 * @return A {@code TupleTable} of the rows, possibly empty, or null if
+	 *     the plan did not produce a result table.
+	 * @throws SQLException If the underlying native structure has gone stale.
+	 */
+	public TupleTable executeTable(Object[] parameters, short read_only,
+		int rowCount, TupleDesc knownTD)
+	throws SQLException
+	{
+		InvocationBudget.check();
+		return doInPG(() ->
+			_executeTable(m_state.getExecutionPlanPtr(),
+				parameters, read_only, rowCount, knownTD));
+	}
+
 	/**
 	 * Create an execution plan for a statement to be executed later using the
 	 * internal <code>SPI_prepare</code> function.
@@ -296,13 +346,35 @@ public class ExecutionPlan
 	public static ExecutionPlan prepare(String statement, Oid[] argTypes)
 	throws SQLException
 	{
-		Object key = (argTypes == null)
+		return prepare(statement, argTypes, false);
+	}
+
+	/**
+	 * Create an execution plan for a statement to be executed later, allowing
+	 * the planner to choose a parallel plan if {@code parallel} is true.
+	 *<p>
+	 * On PostgreSQL versions before 9.6, {@code parallel} makes no difference
+	 * to the plan.
+	 *
+	 * @param statement The command string.
+	 * @param argTypes SQL types of argument types.
+	 * @param parallel Whether to prepare the plan parallel-capable, for use
+	 *     with {@link #executeTable executeTable}.
+	 * @return An execution plan for the prepared statement.
+	 * @throws SQLException
+	 */
+	public static ExecutionPlan prepare(
+		String statement, Oid[] argTypes, boolean parallel)
+	throws SQLException
+	{
+		Object key = (argTypes == null  &&  ! parallel)
 			? (Object)statement
-			: (Object)new PlanKey(statement, argTypes);
+			: (Object)new PlanKey(statement,
+				null == argTypes ? new Oid[0] : argTypes, parallel);
 
 		ExecutionPlan plan = s_planCache.remove(key);
 		if(plan == null)
-			plan = doInPG(() -> _prepare(key, statement, argTypes));
+			plan = doInPG(() -> _prepare(key, statement, argTypes, parallel));
 		return plan;
 	}
 
@@ -320,7 +392,11 @@ public class ExecutionPlan
 	private static native int _execute(long pointer,
 		Object[] parameters, short read_only, int rowCount) throws SQLException;
 
+	private static native TupleTable _executeTable(long pointer,
+		Object[] parameters, short read_only, int rowCount, TupleDesc knownTD)
+		throws SQLException;
+
 	private static native ExecutionPlan _prepare(
-		Object key, String statement, Oid[] argTypes)
+		Object key, String statement, Oid[] argTypes, boolean parallel)
 	throws SQLException;
 }
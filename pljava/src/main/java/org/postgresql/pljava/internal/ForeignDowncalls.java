@@ -0,0 +1,292 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+package org.postgresql.pljava.internal;
+
+import java.lang.invoke.MethodHandle;
+
+import java.lang.reflect.Array;
+import java.lang.reflect.Method;
+
+import java.nio.ByteBuffer;
+
+import java.util.logging.Logger;
+
+import static org.postgresql.pljava.internal.Backend.doInPG;
+
+/**
+ * Calls of a few trivial native accessors through foreign-function downcall
+ * handles, used in place of their JNI natives when
+ * {@code pljava.foreign_downcalls} is on.
+ *<p>
+ * On Java 22 and later, {@code java.lang.foreign.Linker} can bind a plain C
+ * function as a method handle, and with the {@code critical} option, call it
+ * without the transition out of Java that a JNI native needs. That is only
+ * safe for a function that cannot raise a PostgreSQL error, call back into
+ * Java, or block, so the functions bound here (in {@code ForeignDowncalls.c})
+ * only read or set fields. A caller uses the handle when {@link #enabled} is
+ * true, and otherwise the JNI native as before. Callers still hold the
+ * PostgreSQL thread lock, as for the natives.
+ *<p>
+ * The setting is checked on each call, through a direct buffer over the C
+ * variable so that checking it takes no JNI call; the handles are made the
+ * first time it is found on. Pointers are passed as Java {@code long}, so the
+ * handles are only made where a C pointer is 64 bits wide.
+ *<p>
+ * This class is compiled for an older Java release than the one that
+ * finalized {@code java.lang.foreign}, so the handles are made reflectively.
+ */
+public final class ForeignDowncalls
+{
+	private ForeignDowncalls() // do not instantiate
+	{
+	}
+
+	/**
+	 * The C variable behind {@code pljava.foreign_downcalls}, a {@code bool}.
+	 */
+	private static final ByteBuffer s_setting =
+		doInPG(ForeignDowncalls::_setting);
+
+	/**
+	 * Zero until the handles are first wanted, then 1 if they were made, or -1
+	 * if they could not be.
+	 */
+	private static int s_handlesMade;
+
+	private static MethodHandle s_portalPos;
+	private static MethodHandle s_portalAtStart;
+	private static MethodHandle s_portalAtEnd;
+	private static MethodHandle s_spiProcessed;
+	private static MethodHandle s_spiResult;
+	private static MethodHandle s_stringInfoTrySetLength;
+
+	/**
+	 * Whether the downcall handles are to be used now: the setting is on, and
+	 * the handles could be made (which is tried the first time it is found
+	 * on). To be called with the PostgreSQL thread lock held.
+	 */
+	public static boolean enabled()
+	{
+		if ( 0 == s_setting.get(0) )
+			return false;
+		if ( 0 == s_handlesMade )
+		{
+			MethodHandle[] h = handles();
+			s_handlesMade = -1;
+			if ( null != h )
+			{
+				s_portalPos = h[0];
+				s_portalAtStart = h[1];
+				s_portalAtEnd = h[2];
+				s_spiProcessed = h[3];
+				s_spiResult = h[4];
+				s_stringInfoTrySetLength = h[5];
+				s_handlesMade = 1;
+			}
+		}
+		return 0 < s_handlesMade;
+	}
+
+	/**
+	 * Make the handles, in the order of {@code s_downcalls} in
+	 * {@code ForeignDowncalls.c}, or return null (after logging the reason) if
+	 * this Java runtime cannot.
+	 */
+	private static MethodHandle[] handles()
+	{
+		long[] addresses = doInPG(ForeignDowncalls::_addresses);
+
+		Logger logger = Logger.getAnonymousLogger();
+		if ( Backend.JAVA_MAJOR < 22 )
+		{
+			logger.warning("pljava.foreign_downcalls needs Java 22 or " +
+				"later; using JNI for this session");
+			return null;
+		}
+
+		try
+		{
+			Class<?> linkerC = Class.forName("java.lang.foreign.Linker");
+			Class<?> optionC =
+				Class.forName("java.lang.foreign.Linker$Option");
+			Class<?> descC =
+				Class.forName("java.lang.foreign.FunctionDescriptor");
+			Class<?> layoutC = Class.forName("java.lang.foreign.MemoryLayout");
+			Class<?> valueC = Class.forName("java.lang.foreign.ValueLayout");
+			Class<?> segmentC =
+				Class.forName("java.lang.foreign.MemorySegment");
+			Class<?> layoutsC = Array.newInstance(layoutC, 0).getClass();
+
+			Object address = valueC.getField("ADDRESS").get(null);
+			if ( 8L != (Long)layoutC.getMethod("byteSize").invoke(address) )
+			{
+				logger.warning("pljava.foreign_downcalls needs 64-bit " +
+					"pointers; using JNI for this session");
+				return null;
+			}
+
+			Object linker = linkerC.getMethod("nativeLinker").invoke(null);
+			Object options = Array.newInstance(optionC, 1);
+			Array.set(options, 0,
+				optionC.getMethod("critical", boolean.class)
+					.invoke(null, false));
+			Method of = descC.getMethod("of", layoutC, layoutsC);
+			Method ofAddress = segmentC.getMethod("ofAddress", long.class);
+			Method downcallHandle = linkerC.getMethod("downcallHandle",
+				segmentC, descC, options.getClass());
+
+			Object jBoolean = valueC.getField("JAVA_BOOLEAN").get(null);
+			Object jInt = valueC.getField("JAVA_INT").get(null);
+			Object jLong = valueC.getField("JAVA_LONG").get(null);
+
+			Object[][] signatures =
+			{
+				{ jLong, jLong },          // portalPos
+				{ jBoolean, jLong },       // portalAtStart
+				{ jBoolean, jLong },       // portalAtEnd
+				{ jLong },                 // spiProcessed
+				{ jInt },                  // spiResult
+				{ jBoolean, jLong, jInt, jInt } // stringInfoTrySetLength
+			};
+
+			MethodHandle[] handles = new MethodHandle [ signatures.length ];
+			for ( int i = 0 ; i < handles.length ; ++ i )
+			{
+				Object[] sig = signatures[i];
+				Object args = Array.newInstance(layoutC, sig.length - 1);
+				for ( int j = 1 ; j < sig.length ; ++ j )
+					Array.set(args, j - 1, sig[j]);
+				Object desc = of.invoke(null, sig[0], args);
+				Object target = ofAddress.invoke(null, addresses[i]);
+				handles[i] = (MethodHandle)
+					downcallHandle.invoke(linker, target, desc, options);
+			}
+			return handles;
+		}
+		catch ( ReflectiveOperationException | RuntimeException e )
+		{
+			logger.warning("pljava.foreign_downcalls: downcall handles " +
+				"could not be made, using JNI for this session: " + e);
+			return null;
+		}
+	}
+
+	/**
+	 * The handles are called with {@code invokeExact} and the C functions
+	 * throw nothing, so anything caught here is a bug.
+	 */
+	private static Error unexpected(Throwable t)
+	{
+		if ( t instanceof Error )
+			return (Error)t;
+		return new AssertionError("downcall threw", t);
+	}
+
+	/**
+	 * The {@code portalPos} of the {@code Portal} at {@code pointer}.
+	 */
+	public static long portalPos(long pointer)
+	{
+		try
+		{
+			return (long)s_portalPos.invokeExact(pointer);
+		}
+		catch ( Throwable t )
+		{
+			throw unexpected(t);
+		}
+	}
+
+	/**
+	 * The {@code atStart} of the {@code Portal} at {@code pointer}.
+	 */
+	public static boolean portalAtStart(long pointer)
+	{
+		try
+		{
+			return (boolean)s_portalAtStart.invokeExact(pointer);
+		}
+		catch ( Throwable t )
+		{
+			throw unexpected(t);
+		}
+	}
+
+	/**
+	 * The {@code atEnd} of the {@code Portal} at {@code pointer}.
+	 */
+	public static boolean portalAtEnd(long pointer)
+	{
+		try
+		{
+			return (boolean)s_portalAtEnd.invokeExact(pointer);
+		}
+		catch ( Throwable t )
+		{
+			throw unexpected(t);
+		}
+	}
+
+	/**
+	 * The value of {@code SPI_processed}.
+	 */
+	public static long spiProcessed()
+	{
+		try
+		{
+			return (long)s_spiProcessed.invokeExact();
+		}
+		catch ( Throwable t )
+		{
+			throw unexpected(t);
+		}
+	}
+
+	/**
+	 * The value of {@code SPI_result}.
+	 */
+	public static int spiResult()
+	{
+		try
+		{
+			return (int)s_spiResult.invokeExact();
+		}
+		catch ( Throwable t )
+		{
+			throw unexpected(t);
+		}
+	}
+
+	/**
+	 * Set the length of the {@code StringInfo} at {@code pointer} to
+	 * {@code pos} (and terminate it there), if it has room for {@code needed}
+	 * more bytes without being enlarged.
+	 * @return false, leaving the {@code StringInfo} untouched, if it would have
+	 * to be enlarged
+	 */
+	public static boolean stringInfoTrySetLength(
+		long pointer, int pos, int needed)
+	{
+		try
+		{
+			return (boolean)
+				s_stringInfoTrySetLength.invokeExact(pointer, pos, needed);
+		}
+		catch ( Throwable t )
+		{
+			throw unexpected(t);
+		}
+	}
+
+	private static native long[] _addresses();
+	private static native ByteBuffer _setting();
+}
@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+package org.postgresql.pljava.internal;
+
+import java.lang.reflect.Constructor;
+import java.lang.reflect.InvocationTargetException;
+
+import java.security.AccessControlContext;
+import java.security.ProtectionDomain;
+
+import java.sql.SQLException;
+import java.sql.SQLNonTransientException;
+
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.HashMap;
+import java.util.List;
+import java.util.Map;
+import java.util.Set;
+
+import static java.util.Collections.unmodifiableList;
+import static java.util.Collections.unmodifiableMap;
+
+import javax.security.auth.Subject;
+import javax.security.auth.SubjectDomainCombiner;
+
+import org.postgresql.pljava.ForeignDataWrapper;
+import org.postgresql.pljava.PLPrincipal;
+
+import static org.postgresql.pljava.internal.Privilege.doPrivileged;
+import org.postgresql.pljava.sqlgen.Lexicals.Identifier;
+import org.postgresql.pljava.sqlj.Loader;
+
+/**
+ * Adapter between the native foreign-scan callbacks and a user-supplied
+ * {@link ForeignDataWrapper}.
+ *<p>
+ * The methods here are called only from C. The static ones are called once
+ * for each planning or execution of a scan, and {@code next} once for each
+ * batch of rows, which the C code then reads directly out of the array
+ * returned by {@code batch}.
+ *<p>
+ * Only a superuser can name the class of a wrapper, so calls into it are made
+ * as for a function in an untrusted language, with an
+ * {@link PLPrincipal.Unsandboxed Unsandboxed} principal named
+ * {@code java_fdw}, which the policy can refer to.
+ */
+final class ForeignScan
+{
+	private static final AccessControlContext s_acc = doPrivileged(() ->
+		new AccessControlContext(
+			new AccessControlContext(new ProtectionDomain[] {}),
+			new SubjectDomainCombiner(new Subject(true,
+				Set.of(new PLPrincipal.Unsandboxed("java_fdw")),
+				Set.of(), Set.of()))));
+
+	private final ForeignDataWrapper.Scan m_scan;
+	private final Object[][] m_batch;
+
+	private ForeignScan(ForeignDataWrapper.Scan scan, int batchSize)
+	{
+		m_scan = scan;
+		m_batch = new Object[batchSize][];
+	}
+
+	private static double estimateRows(
+		String schema, String className,
+		String[] optionNames, String[] optionValues,
+		String[] qualColumns, String[] qualOperators, Object[] qualValues)
+	throws SQLException
+	{
+		ForeignDataWrapper w =
+			wrapper(schema, className, optionNames, optionValues);
+		List<ForeignDataWrapper.Qual> quals =
+			quals(qualColumns, qualOperators, qualValues);
+		return doPrivileged(() -> w.estimateRows(quals), s_acc);
+	}
+
+	private static ForeignScan begin(
+		String schema, String className,
+		String[] optionNames, String[] optionValues, String[] columns,
+		String[] qualColumns, String[] qualOperators, Object[] qualValues,
+		int batchSize)
+	throws SQLException
+	{
+		ForeignDataWrapper w =
+			wrapper(schema, className, optionNames, optionValues);
+		List<String> cols = unmodifiableList(Arrays.asList(columns));
+		List<ForeignDataWrapper.Qual> quals =
+			quals(qualColumns, qualOperators, qualValues);
+		ForeignDataWrapper.Scan scan =
+			doPrivileged(() -> w.beginScan(cols, quals), s_acc);
+		if ( null == scan )
+			throw new SQLNonTransientException(
+				className + ".beginScan returned null", "HV000");
+		return new ForeignScan(scan, batchSize);
+	}
+
+	private Object[][] batch()
+	{
+		return m_batch;
+	}
+
+	/**
+	 * Ask the wrapper to fill the batch, returning the number of rows.
+	 */
+	private int next() throws SQLException
+	{
+		int n = doPrivileged(() -> m_scan.next(m_batch), s_acc);
+		if ( n < 0  ||  n > m_batch.length )
+			throw new SQLNonTransientException(
+				"foreign table scan returned " + n + " rows for a batch of " +
+				m_batch.length, "HV000");
+		return n;
+	}
+
+	private void rescan() throws SQLException
+	{
+		doPrivileged(m_scan::rescan, s_acc);
+	}
+
+	private void close() throws SQLException
+	{
+		doPrivileged(m_scan::close, s_acc);
+	}
+
+	private static ForeignDataWrapper wrapper(
+		String schema, String className,
+		String[] optionNames, String[] optionValues)
+	throws SQLException
+	{
+		ClassLoader loader = Loader.getSchemaLoader(
+			null == schema ? null : Identifier.Simple.fromCatalog(schema));
+
+		Map<String,String> options = new HashMap<>();
+		for ( int i = 0 ; i < optionNames.length ; ++ i )
+			options.put(optionNames[i], optionValues[i]); // later ones win
+		Map<String,String> opts = unmodifiableMap(options);
+
+		try
+		{
+			Class<? extends ForeignDataWrapper> c =
+				Class.forName(className, false, loader)
+				.asSubclass(ForeignDataWrapper.class);
+			Constructor<? extends ForeignDataWrapper> ctor =
+				c.getConstructor(Map.class);
+			return doPrivileged(() -> ctor.newInstance(opts), s_acc);
+		}
+		catch ( ClassNotFoundException e )
+		{
+			throw new SQLNonTransientException(
+				"No such class: " + className, "46103", e);
+		}
+		catch ( ClassCastException e )
+		{
+			throw new SQLNonTransientException(
+				"Class " + className + " does not implement " +
+				ForeignDataWrapper.class.getName(), "HV000", e);
+		}
+		catch ( InvocationTargetException e )
+		{
+			Throwable t = e.getCause();
+			if ( t instanceof SQLException )
+				throw (SQLException)t;
+			throw new SQLException(
+				"Constructing " + className + " failed: " + t, "HV000", t);
+		}
+		catch ( ReflectiveOperationException e )
+		{
+			throw new SQLNonTransientException(
+				"Class " + className + " has no accessible constructor " +
+				"accepting a Map<String,String>", "HV000", e);
+		}
+	}
+
+	private static List<ForeignDataWrapper.Qual> quals(
+		String[] columns, String[] operators, Object[] values)
+	{
+		List<ForeignDataWrapper.Qual> quals = new ArrayList<>(columns.length);
+		for ( int i = 0 ; i < columns.length ; ++ i )
+			quals.add(new Qual(columns[i], operators[i], values[i]));
+		return unmodifiableList(quals);
+	}
+
+	private static final class Qual implements ForeignDataWrapper.Qual
+	{
+		private final String m_column;
+		private final String m_operator;
+		private final Object m_value;
+
+		Qual(String column, String operator, Object value)
+		{
+			m_column = column;
+			m_operator = operator;
+			m_value = value;
+		}
+
+		@Override
+		public String column()
+		{
+			return m_column;
+		}
+
+		@Override
+		public String operator()
+		{
+			return m_operator;
+		}
+
+		@Override
+		public Object value()
+		{
+			return m_value;
+		}
+
+		@Override
+		public String toString()
+		{
+			return m_column + " " + m_operator + " " + m_value;
+		}
+	}
+}
@@ -0,0 +1,308 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+package org.postgresql.pljava.internal;
+
+import java.lang.invoke.MethodHandle;
+import static java.lang.invoke.MethodHandles.lookup;
+import static java.lang.invoke.MethodType.methodType;
+
+import java.lang.reflect.Array;
+import java.lang.reflect.Method;
+
+import java.nio.ByteBuffer;
+
+import java.security.PrivilegedAction;
+
+import java.util.ArrayDeque;
+import java.util.Arrays;
+import java.util.logging.Logger;
+
+import org.postgresql.pljava.internal.EntryPoints.Invocable;
+
+/**
+ * Calls of PL/Java functions from C through foreign-function upcall stubs,
+ * used in place of JNI for functions returning a primitive type or
+ * {@code void} when {@code pljava.foreign_upcalls} is on.
+ *<p>
+ * On Java 22 and later, {@code java.lang.foreign.Linker} can make a stub that
+ * C calls as a plain function pointer. One stub is made for each return type,
+ * taking an {@code int} that identifies a function's {@code Invocable}
+ * registered here. Parameters are still passed in the static areas of
+ * {@code Function}, and a primitive result is still stored in the first slot
+ * of the primitive parameter area as with JNI; the stub reads it from there
+ * and returns it to C as its return value. What is saved is the JNI method
+ * call on entry.
+ *<p>
+ * An upcall stub must not let an exception escape (the Java runtime would
+ * end the process), so each target here catches any exception, saves it, and
+ * sets a flag in the primitive parameter area. The C code checks the flag
+ * after each upcall, and calls {@link #rethrow rethrow} through JNI to have the
+ * exception handled in the usual way.
+ *<p>
+ * This class is compiled for an older Java release than the one that
+ * finalized {@code java.lang.foreign}, so the stubs are made reflectively.
+ */
+final class ForeignUpcalls
+{
+	private ForeignUpcalls() // do not instantiate
+	{
+	}
+
+	/**
+	 * The return types of the stubs, in the order expected by
+	 * {@code Function.c}.
+	 */
+	private static final Class<?>[] s_returnTypes =
+	{
+		void.class, boolean.class, byte.class, short.class, char.class,
+		int.class, long.class, float.class, double.class
+	};
+
+	/**
+	 * Registered invocables, indexed by id. Id zero is never used, as the C
+	 * code uses it to mean unregistered.
+	 */
+	private static Invocable<?>[] s_targets = new Invocable<?> [ 16 ];
+	private static int s_nextId = 1;
+	private static final ArrayDeque<Integer> s_freeIds = new ArrayDeque<>();
+
+	private static Throwable s_thrown;
+
+	/**
+	 * Make the upcall stubs and return their addresses, or null (after
+	 * logging the reason) if this Java runtime cannot.
+	 *<p>
+	 * The stubs are allocated in the global arena, as they are used for the
+	 * rest of the session.
+	 */
+	private static long[] stubs()
+	{
+		Logger logger = Logger.getAnonymousLogger();
+		if ( Backend.JAVA_MAJOR < 22 )
+		{
+			logger.warning("pljava.foreign_upcalls needs Java 22 or later; " +
+				"using JNI for this session");
+			return null;
+		}
+
+		try
+		{
+			Class<?> linkerC = Class.forName("java.lang.foreign.Linker");
+			Class<?> optionC =
+				Class.forName("java.lang.foreign.Linker$Option");
+			Class<?> descC =
+				Class.forName("java.lang.foreign.FunctionDescriptor");
+			Class<?> layoutC = Class.forName("java.lang.foreign.MemoryLayout");
+			Class<?> valueC = Class.forName("java.lang.foreign.ValueLayout");
+			Class<?> arenaC = Class.forName("java.lang.foreign.Arena");
+			Class<?> segmentC =
+				Class.forName("java.lang.foreign.MemorySegment");
+			Class<?> layoutsC = Array.newInstance(layoutC, 0).getClass();
+
+			Object linker = linkerC.getMethod("nativeLinker").invoke(null);
+			Object arena = arenaC.getMethod("global").invoke(null);
+			Object noOptions = Array.newInstance(optionC, 0);
+			Method of = descC.getMethod("of", layoutC, layoutsC);
+			Method ofVoid = descC.getMethod("ofVoid", layoutsC);
+			Method upcallStub = linkerC.getMethod("upcallStub",
+				MethodHandle.class, descC, arenaC, noOptions.getClass());
+			Method address = segmentC.getMethod("address");
+
+			Object args = Array.newInstance(layoutC, 1);
+			Array.set(args, 0, valueC.getField("JAVA_INT").get(null));
+
+			long[] addresses = new long [ s_returnTypes.length ];
+			for ( int i = 0 ; i < addresses.length ; ++ i )
+			{
+				Class<?> rt = s_returnTypes[i];
+				MethodHandle target = lookup().findStatic(ForeignUpcalls.class,
+					rt.getName() + "Upcall", methodType(rt, int.class));
+				Object desc = void.class == rt
+					? ofVoid.invoke(null, args)
+					: of.invoke(null, valueC.getField(
+						"JAVA_" + rt.getName().toUpperCase()).get(null), args);
+				Object stub =
+					upcallStub.invoke(linker, target, desc, arena, noOptions);
+				addresses[i] = (Long)address.invoke(stub);
+			}
+			return addresses;
+		}
+		catch ( ReflectiveOperationException | RuntimeException e )
+		{
+			logger.warning("pljava.foreign_upcalls: upcall stubs could not " +
+				"be made, using JNI for this session: " + e);
+			return null;
+		}
+	}
+
+	/**
+	 * Register an invocable and return the id to pass to the stubs.
+	 */
+	private static int register(Invocable<?> target)
+	{
+		Integer free = s_freeIds.poll();
+		int id = null != free ? free : s_nextId++;
+		if ( id >= s_targets.length )
+			s_targets = Arrays.copyOf(s_targets, 2 * s_targets.length);
+		s_targets[id] = target;
+		return id;
+	}
+
+	/**
+	 * Forget an invocable, when its function is dropped from the cache.
+	 */
+	private static void release(int id)
+	{
+		s_targets[id] = null;
+		s_freeIds.push(id);
+	}
+
+	/**
+	 * Throw the exception saved by the most recent upcall.
+	 */
+	private static void rethrow() throws Throwable
+	{
+		Throwable t = s_thrown;
+		s_thrown = null;
+		throw t;
+	}
+
+	private static void caught(Throwable t)
+	{
+		s_thrown = t;
+		Function.setUpcallThrew();
+	}
+
+	@SuppressWarnings("unchecked")
+	private static ByteBuffer call(int id) throws Throwable
+	{
+		EntryPoints.invoke(
+			(Invocable<PrivilegedAction<Object>>)s_targets[id]);
+		return Function.primitiveParameters();
+	}
+
+	private static void voidUpcall(int id)
+	{
+		try
+		{
+			call(id);
+		}
+		catch ( Throwable t )
+		{
+			caught(t);
+		}
+	}
+
+	private static boolean booleanUpcall(int id)
+	{
+		try
+		{
+			return 0 != call(id).get(0);
+		}
+		catch ( Throwable t )
+		{
+			caught(t);
+			return false;
+		}
+	}
+
+	private static byte byteUpcall(int id)
+	{
+		try
+		{
+			return call(id).get(0);
+		}
+		catch ( Throwable t )
+		{
+			caught(t);
+			return 0;
+		}
+	}
+
+	private static short shortUpcall(int id)
+	{
+		try
+		{
+			return call(id).getShort(0);
+		}
+		catch ( Throwable t )
+		{
+			caught(t);
+			return 0;
+		}
+	}
+
+	private static char charUpcall(int id)
+	{
+		try
+		{
+			return call(id).getChar(0);
+		}
+		catch ( Throwable t )
+		{
+			caught(t);
+			return 0;
+		}
+	}
+
+	private static int intUpcall(int id)
+	{
+		try
+		{
+			return call(id).getInt(0);
+		}
+		catch ( Throwable t )
+		{
+			caught(t);
+			return 0;
+		}
+	}
+
+	private static long longUpcall(int id)
+	{
+		try
+		{
+			return call(id).getLong(0);
+		}
+		catch ( Throwable t )
+		{
+			caught(t);
+			return 0;
+		}
+	}
+
+	private static float floatUpcall(int id)
+	{
+		try
+		{
+			return call(id).getFloat(0);
+		}
+		catch ( Throwable t )
+		{
+			caught(t);
+			return 0;
+		}
+	}
+
+	private static double doubleUpcall(int id)
+	{
+		try
+		{
+			return call(id).getDouble(0);
+		}
+		catch ( Throwable t )
+		{
+			caught(t);
+			return 0;
+		}
+	}
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2016-2021 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2016-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -453,7 +453,8 @@ public class Function
 		MethodType mt = mh.type();
 		int parameterCount = mt.parameterCount();
 		int primitives = (int)
-			mt.parameterList().stream().filter(Class::isPrimitive).count();
+			mt.parameterList().stream().filter(Function::passedAsPrimitive)
+			.count();
 		int references = parameterCount - primitives;
 		short countCheck = (short)((references << 8) | (primitives & 0xff));
 
@@ -556,6 +557,22 @@ public class Function
 					insertArguments(s_primitiveZeroer, 0, offset));
 				mh = foldArguments(mh, parameterCount, primGetter);
 			}
+			else if ( null != boxedGetter(pt) )
+			{
+				/*
+				 * A boxed primitive type is passed in the primitive area too,
+				 * with its bit in the null bitmap set if it is null. The boxed
+				 * getter reads both and boxes the value with valueOf, here in
+				 * the handle tree where caching and escape analysis can often
+				 * spare the allocation. Otherwise, the same drill as above.
+				 */
+				int offset = (--primitives) * s_sizeof_jvalue;
+				MethodHandle getter =
+					insertArguments(boxedGetter(pt), 0, offset);
+				mh = foldArguments(mh, 0,
+					insertArguments(s_primitiveZeroer, 0, offset));
+				mh = foldArguments(mh, parameterCount, getter);
+			}
 			else
 			{
 				/*
@@ -619,6 +636,94 @@ public class Function
 			insertArguments(s_paramCountsAre, 0, countCheck));
 	}
 
+	/**
+	 * Whether a parameter of type <var>pt</var> is passed in the primitive
+	 * parameter area: those of primitive type, and those of the boxed types
+	 * that have a {@link #boxedGetter boxedGetter}.
+	 */
+	private static boolean passedAsPrimitive(Class<?> pt)
+	{
+		return pt.isPrimitive()  ||  null != boxedGetter(pt);
+	}
+
+	/**
+	 * The getter for a parameter of boxed primitive type <var>pt</var>, taking
+	 * a byte offset and returning the boxed value or null, or null if
+	 * <var>pt</var> is not one of the types so passed.
+	 *<p>
+	 * The native code decides the same thing from the parameter's JNI
+	 * signature, in {@code passAsPrimitive} in {@code Function.c}; the two must
+	 * agree, or the parameter counts will not match.
+	 */
+	private static MethodHandle boxedGetter(Class<?> pt)
+	{
+		switch ( pt.getName() )
+		{
+		case "java.lang.Boolean": return s_boxedBooleanGetter;
+		case "java.lang.Byte":    return s_boxedByteGetter;
+		case "java.lang.Short":   return s_boxedShortGetter;
+		case "java.lang.Integer": return s_boxedIntGetter;
+		case "java.lang.Float":   return s_boxedFloatGetter;
+		case "java.lang.Long":    return s_boxedLongGetter;
+		case "java.lang.Double":  return s_boxedDoubleGetter;
+		default:                  return null;
+		}
+	}
+
+	/**
+	 * Whether the bit in the null bitmap is set for the primitive parameter
+	 * slot at byte offset <var>offset</var>.
+	 */
+	private static boolean paramIsNull(int offset)
+	{
+		int slot = offset / s_sizeof_jvalue;
+		byte bits =
+			s_primitiveParameters.get(s_offset_paramNulls + (slot >>> 3));
+		return 0 != (bits & (1 << (slot & 7)));
+	}
+
+	private static Boolean booleanOrNull(int offset)
+	{
+		return paramIsNull(offset) ? null
+			: Boolean.valueOf(0 != s_primitiveParameters.get(offset));
+	}
+
+	private static Byte byteOrNull(int offset)
+	{
+		return paramIsNull(offset) ? null
+			: Byte.valueOf(s_primitiveParameters.get(offset));
+	}
+
+	private static Short shortOrNull(int offset)
+	{
+		return paramIsNull(offset) ? null
+			: Short.valueOf(s_primitiveParameters.getShort(offset));
+	}
+
+	private static Integer intOrNull(int offset)
+	{
+		return paramIsNull(offset) ? null
+			: Integer.valueOf(s_primitiveParameters.getInt(offset));
+	}
+
+	private static Float floatOrNull(int offset)
+	{
+		return paramIsNull(offset) ? null
+			: Float.valueOf(s_primitiveParameters.getFloat(offset));
+	}
+
+	private static Long longOrNull(int offset)
+	{
+		return paramIsNull(offset) ? null
+			: Long.valueOf(s_primitiveParameters.getLong(offset));
+	}
+
+	private static Double doubleOrNull(int offset)
+	{
+		return paramIsNull(offset) ? null
+			: Double.valueOf(s_primitiveParameters.getDouble(offset));
+	}
+
 	private static final MethodHandle s_booleanReturn;
 	private static final MethodHandle s_byteReturn;
 	private static final MethodHandle s_shortReturn;
@@ -636,6 +741,13 @@ public class Function
 	private static final MethodHandle s_floatGetter;
 	private static final MethodHandle s_longGetter;
 	private static final MethodHandle s_doubleGetter;
+	private static final MethodHandle s_boxedBooleanGetter;
+	private static final MethodHandle s_boxedByteGetter;
+	private static final MethodHandle s_boxedShortGetter;
+	private static final MethodHandle s_boxedIntGetter;
+	private static final MethodHandle s_boxedFloatGetter;
+	private static final MethodHandle s_boxedLongGetter;
+	private static final MethodHandle s_boxedDoubleGetter;
 	private static final MethodHandle s_refGetter;
 	private static final MethodHandle s_referenceNuller;
 	private static final MethodHandle s_primitiveZeroer;
@@ -708,12 +820,40 @@ public class Function
 	 * in the LSB). Each constructed MethodHandle will have the corresponding
 	 * int16 value bound in for comparison, and will throw an exception if
 	 * invoked with the wrong parameter counts.
+	 *
+	 * The next jvalue slot after that holds a bitmap with a bit for each
+	 * primitive parameter slot, set when the parameter there is of a boxed
+	 * type (Integer, for example) and null. Parameters of those types are
+	 * passed in the primitive area and boxed by the constructed MethodHandle.
+	 *
+	 * The jvalue slot after the bitmap holds a flag that ForeignUpcalls sets
+	 * when an upcall has caught an exception for the C code to rethrow.
 	 */
 	private static final Object[] s_referenceParameters = new Object [ 255 ];
 	private static final ByteBuffer s_primitiveParameters =
 		EarlyNatives._parameterArea(s_referenceParameters)
 		.order(ByteOrder.nativeOrder());
 	private static final int s_offset_paramCounts = 255 * s_sizeof_jvalue;
+	private static final int s_offset_paramNulls = 256 * s_sizeof_jvalue;
+	private static final int s_offset_upcallThrew = 260 * s_sizeof_jvalue;
+
+	/**
+	 * For {@code ForeignUpcalls}, which returns the primitive result of a call
+	 * from the first slot.
+	 */
+	static ByteBuffer primitiveParameters()
+	{
+		return s_primitiveParameters;
+	}
+
+	/**
+	 * For {@code ForeignUpcalls}, to tell the C code an upcall caught an
+	 * exception.
+	 */
+	static void setUpcallThrew()
+	{
+		s_primitiveParameters.put(s_offset_upcallThrew, (byte)1);
+	}
 
 	/**
 	 * Class used to stack parameters for an in-construction call if needed for
@@ -732,6 +872,7 @@ public class Function
 		private ParameterFrame m_prev;
 		private Object[] m_refs;
 		private byte[] m_prims;
+		private byte[] m_nulls;
 
 		/**
 		 * Construct a copy of the current in-progress parameter area.
@@ -752,6 +893,9 @@ public class Function
 				m_prims = new byte [ prims * s_sizeof_jvalue ];
 				// Java 13: s_primitiveParameters.get(0, m_prims);
 				s_primitiveParameters.get(m_prims).position(0);
+				m_nulls = new byte [ (prims + 7) / 8 ];
+				s_primitiveParameters.position(s_offset_paramNulls);
+				s_primitiveParameters.get(m_nulls).position(0);
 			}
 
 			m_prev = s_stack;
@@ -793,6 +937,8 @@ public class Function
 				prims = len / s_sizeof_jvalue;
 				// Java 13: s_primitiveParameters.put(0, f.m_prims);
 				s_primitiveParameters.put(f.m_prims).position(0);
+				s_primitiveParameters.position(s_offset_paramNulls);
+				s_primitiveParameters.put(f.m_nulls).position(0);
 			}
 
 			s_primitiveParameters.putShort(s_offset_paramCounts,
@@ -841,6 +987,35 @@ public class Function
 			mh = myL.findStatic(Function.class, "byteNonZero", mt);
 			s_booleanGetter = filterReturnValue(s_byteGetter, mh);
 
+			mt = methodType(Boolean.class, int.class);
+			s_boxedBooleanGetter =
+				myL.findStatic(Function.class, "booleanOrNull", mt)
+				.asType(mt.erase());
+			mt = mt.changeReturnType(Byte.class);
+			s_boxedByteGetter =
+				myL.findStatic(Function.class, "byteOrNull", mt)
+				.asType(mt.erase());
+			mt = mt.changeReturnType(Short.class);
+			s_boxedShortGetter =
+				myL.findStatic(Function.class, "shortOrNull", mt)
+				.asType(mt.erase());
+			mt = mt.changeReturnType(Integer.class);
+			s_boxedIntGetter =
+				myL.findStatic(Function.class, "intOrNull", mt)
+				.asType(mt.erase());
+			mt = mt.changeReturnType(Float.class);
+			s_boxedFloatGetter =
+				myL.findStatic(Function.class, "floatOrNull", mt)
+				.asType(mt.erase());
+			mt = mt.changeReturnType(Long.class);
+			s_boxedLongGetter =
+				myL.findStatic(Function.class, "longOrNull", mt)
+				.asType(mt.erase());
+			mt = mt.changeReturnType(Double.class);
+			s_boxedDoubleGetter =
+				myL.findStatic(Function.class, "doubleOrNull", mt)
+				.asType(mt.erase());
+
 			mt = methodType(void.class, short.class);
 			mh = myL.findStatic(Function.class, "paramCountsAre", mt);
 			s_paramCountsAre = mh;
@@ -1357,7 +1532,7 @@ public class Function
 		String language, boolean trusted)
 	throws SQLException
 	{
-		Map<Oid,Class<? extends SQLData>> typeMap = null;
+		Map<Oid,Class<?>> typeMap = null;
 		String className = info.group("udtcls");
 		boolean isUDT = (null != className);
 
@@ -1592,7 +1767,7 @@ public class Function
 	private static String[] setupFunctionParams(
 		long wrappedPtr, Matcher info, ResultSet procTup,
 		ClassLoader schemaLoader, Class<?> clazz,
-		boolean readOnly, Map<Oid,Class<? extends SQLData>> typeMap,
+		boolean readOnly, Map<Oid,Class<?>> typeMap,
 		boolean[] multi, boolean[] returnTypeIsOP, boolean commute)
 		throws SQLException
 	{
@@ -1756,16 +1931,43 @@ public class Function
 		case  "double": c =  double.class; break;
 		case    "void": c =    void.class; break;
 		default:
-			try
-			{
-				c = withoutInit
-					? Class.forName(className, false, schemaLoader)
-					: loadAndInitWithACC(className, schemaLoader, valACC);
-			}
-			catch ( ClassNotFoundException | LinkageError e )
+			/*
+			 * A nested class appears by its canonical name, as the annotation
+			 * processor writes it; failing to find a class, try again with the
+			 * last remaining dot taken as a $, reporting the first failure if
+			 * none is found.
+			 */
+			String name = className;
+			ClassNotFoundException notFound = null;
+			for ( ;; )
 			{
-				throw new SQLNonTransientException(
-					"Resolving class " + className + ": " + e, "46103", e);
+				try
+				{
+					c = withoutInit
+						? Class.forName(name, false, schemaLoader)
+						: loadAndInitWithACC(name, schemaLoader, valACC);
+					break;
+				}
+				catch ( ClassNotFoundException e )
+				{
+					if ( null == notFound )
+						notFound = e;
+					int dot = name.lastIndexOf('.');
+					if ( -1 != dot )
+					{
+						name = name.substring(0, dot) + '$' +
+							name.substring(dot + 1);
+						continue;
+					}
+					throw new SQLNonTransientException(
+						"Resolving class " + className + ": " + notFound,
+						"46103", notFound);
+				}
+				catch ( LinkageError e )
+				{
+					throw new SQLNonTransientException(
+						"Resolving class " + className + ": " + e, "46103", e);
+				}
 			}
 		}
 
@@ -2029,7 +2231,7 @@ public class Function
 	private static String[] storeToNonUDT(
 		long wrappedPtr, ClassLoader schemaLoader, Class<?> clazz,
 		boolean readOnly, boolean isMultiCall,
-		Map<Oid,Class<? extends SQLData>> typeMap,
+		Map<Oid,Class<?>> typeMap,
 		Oid returnType, String returnJType, Oid[] paramTypes, String[] pJTypes,
 		boolean[] returnTypeIsOutParameter)
 	{
@@ -2065,7 +2267,7 @@ public class Function
 	private static native boolean _storeToNonUDT(
 		long wrappedPtr, ClassLoader schemaLoader, Class<?> clazz,
 		boolean readOnly, boolean isMultiCall,
-		Map<Oid,Class<? extends SQLData>> typeMap,
+		Map<Oid,Class<?>> typeMap,
 		int numParams, int returnType, String returnJType,
 		int[] paramTypes, String[] paramJTypes, String[] outJTypes);
 
@@ -0,0 +1,275 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+package org.postgresql.pljava.internal;
+
+import static org.postgresql.pljava.internal.Backend.doInPG;
+
+import java.sql.SQLException;
+
+import org.postgresql.pljava.GiST;
+
+/**
+ * The implementations of the {@link GiST} types, each wrapping a pointer passed
+ * to a GiST support function.
+ *<p>
+ * Made by native code when the support function is called, and scoped to that
+ * invocation. Every subclass has the same constructor parameters, of which it
+ * keeps the ones it needs.
+ */
+public abstract class GiSTSupport
+{
+	private final State m_state;
+
+	GiSTSupport(DualState.Key cookie, long resourceOwner, long pointer)
+	{
+		m_state = new State(cookie, this, resourceOwner, pointer);
+	}
+
+	private static class State
+	extends DualState.SingleGuardedLong<GiSTSupport>
+	{
+		private State(
+			DualState.Key cookie, GiSTSupport gs, long ro, long ptr)
+		{
+			super(cookie, gs, ro, ptr);
+		}
+
+		/**
+		 * Return the pointer, as {@code Relation} does; it is only used
+		 * within the support function's invocation, which cannot end while
+		 * one of these methods is running.
+		 */
+		private long getPointer() throws SQLException
+		{
+			pin();
+			try
+			{
+				return guardedLong();
+			}
+			finally
+			{
+				unpin();
+			}
+		}
+	}
+
+	/**
+	 * The wrapped pointer; also called by native code when one of these is
+	 * returned from a support function.
+	 */
+	private long pointer() throws SQLException
+	{
+		return m_state.getPointer();
+	}
+
+	public static class Entry extends GiSTSupport implements GiST.Entry
+	{
+		private final boolean m_leaf;
+		private final int m_keyType;
+		private final int m_resultType;
+
+		Entry(DualState.Key cookie, long resourceOwner, long pointer,
+			boolean leaf, int first, int size, int keyType, int resultType)
+		{
+			super(cookie, resourceOwner, pointer);
+			m_leaf = leaf;
+			m_keyType = keyType;
+			m_resultType = resultType;
+		}
+
+		@Override
+		public boolean isLeaf()
+		{
+			return m_leaf;
+		}
+
+		@Override
+		public Object key() throws SQLException
+		{
+			return doInPG(() -> _key(super.pointer(), m_keyType));
+		}
+
+		@Override
+		public GiST.Entry withKey(Object key) throws SQLException
+		{
+			return doInPG(() -> _withKey(super.pointer(), key, m_resultType));
+		}
+	}
+
+	public static class EntryVector
+	extends GiSTSupport implements GiST.EntryVector
+	{
+		private final int m_first;
+		private final int m_size;
+		private final int m_keyType;
+
+		EntryVector(DualState.Key cookie, long resourceOwner, long pointer,
+			boolean leaf, int first, int size, int keyType, int resultType)
+		{
+			super(cookie, resourceOwner, pointer);
+			m_first = first;
+			m_size = size;
+			m_keyType = keyType;
+		}
+
+		@Override
+		public int size()
+		{
+			return m_size;
+		}
+
+		@Override
+		public GiST.Entry get(int index) throws SQLException
+		{
+			if ( index < 0  ||  index >= m_size )
+				throw new IndexOutOfBoundsException(
+					"GiST entry " + index + " of " + m_size);
+			return doInPG(() ->
+				_entry(super.pointer(), m_first + index, m_keyType));
+		}
+
+		@Override
+		public Object[] keys() throws SQLException
+		{
+			Object[] keys = new Object [ m_size ];
+			doInPG(() -> _keys(super.pointer(), m_first, keys, m_keyType));
+			return keys;
+		}
+	}
+
+	public static class Split extends GiSTSupport implements GiST.Split
+	{
+		private final int m_first;
+		private final int m_size;
+		private final int m_storageType;
+
+		Split(DualState.Key cookie, long resourceOwner, long pointer,
+			boolean leaf, int first, int size, int keyType, int resultType)
+		{
+			super(cookie, resourceOwner, pointer);
+			m_first = first;
+			m_size = size;
+			m_storageType = resultType;
+		}
+
+		@Override
+		public void set(
+			int[] left, Object leftUnion, int[] right, Object rightUnion)
+		throws SQLException
+		{
+			boolean[] placed = new boolean [ m_size ];
+			if ( left.length + right.length != m_size )
+				throw new SQLException(
+					"GiST split places " + (left.length + right.length) +
+					" entries of " + m_size, "22023");
+			for ( int[] side : new int[][] { left, right } )
+			{
+				for ( int i : side )
+				{
+					if ( i < 0  ||  i >= m_size  ||  placed [ i ] )
+						throw new SQLException(
+							"GiST split places entry " + i +
+							" out of range or twice", "22023");
+					placed [ i ] = true;
+				}
+			}
+			doInPG(() -> _split(super.pointer(), m_first,
+				left, leftUnion, right, rightUnion, m_storageType));
+		}
+	}
+
+	public static class Recheck extends GiSTSupport implements GiST.Recheck
+	{
+		Recheck(DualState.Key cookie, long resourceOwner, long pointer,
+			boolean leaf, int first, int size, int keyType, int resultType)
+		{
+			super(cookie, resourceOwner, pointer);
+		}
+
+		@Override
+		public void set(boolean recheck) throws SQLException
+		{
+			doInPG(() -> _setBoolean(super.pointer(), recheck));
+		}
+	}
+
+	public static class Penalty extends GiSTSupport implements GiST.Penalty
+	{
+		Penalty(DualState.Key cookie, long resourceOwner, long pointer,
+			boolean leaf, int first, int size, int keyType, int resultType)
+		{
+			super(cookie, resourceOwner, pointer);
+		}
+
+		@Override
+		public void set(float penalty) throws SQLException
+		{
+			doInPG(() -> _setFloat(super.pointer(), penalty));
+		}
+	}
+
+	public static class Same extends GiSTSupport implements GiST.Same
+	{
+		Same(DualState.Key cookie, long resourceOwner, long pointer,
+			boolean leaf, int first, int size, int keyType, int resultType)
+		{
+			super(cookie, resourceOwner, pointer);
+		}
+
+		@Override
+		public void set(boolean same) throws SQLException
+		{
+			doInPG(() -> _setBoolean(super.pointer(), same));
+		}
+	}
+
+	public static class UnionSize
+	extends GiSTSupport implements GiST.UnionSize
+	{
+		UnionSize(DualState.Key cookie, long resourceOwner, long pointer,
+			boolean leaf, int first, int size, int keyType, int resultType)
+		{
+			super(cookie, resourceOwner, pointer);
+		}
+
+		@Override
+		public void set(int size) throws SQLException
+		{
+			doInPG(() -> _setInt(super.pointer(), size));
+		}
+	}
+
+	private static native Object _key(long pointer, int keyType)
+	throws SQLException;
+
+	private static native Entry _withKey(
+		long pointer, Object key, int resultType)
+	throws SQLException;
+
+	private static native Entry _entry(long pointer, int offset, int keyType)
+	throws SQLException;
+
+	private static native void _keys(
+		long pointer, int first, Object[] into, int keyType)
+	throws SQLException;
+
+	private static native void _split(long pointer, int first,
+		int[] left, Object leftUnion, int[] right, Object rightUnion,
+		int storageType)
+	throws SQLException;
+
+	private static native void _setBoolean(long pointer, boolean value);
+
+	private static native void _setFloat(long pointer, float value);
+
+	private static native void _setInt(long pointer, int value);
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2015-2021 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2015-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -564,6 +564,94 @@ public class InstallHelper
 				"sqlj.java_validator(pg_catalog.oid) IS '" +
 				"Function declaration validator for PL/Java''s " +
 				"trusted/sandboxed language.'");
+
+		s.execute(
+			"CREATE OR REPLACE FUNCTION sqlj.java_fdw_handler()" +
+			" RETURNS pg_catalog.fdw_handler" +
+			" AS " + eQuote(module_path) +
+			" LANGUAGE C");
+		s.execute("REVOKE ALL PRIVILEGES" +
+			" ON FUNCTION sqlj.java_fdw_handler() FROM public");
+		rs = s.executeQuery(
+			"SELECT pg_catalog.obj_description(CAST(" +
+			"'sqlj.java_fdw_handler()' AS pg_catalog.regprocedure), " +
+			"'pg_proc')");
+		rs.next();
+		rs.getString(1);
+		noComment = rs.wasNull();
+		rs.close();
+		if ( noComment )
+			s.execute(
+				"COMMENT ON FUNCTION sqlj.java_fdw_handler() IS '" +
+				"Handler for foreign data wrappers implemented in Java.'");
+
+		s.execute(
+			"CREATE OR REPLACE FUNCTION sqlj.java_fdw_validator(" +
+			"pg_catalog.text[], pg_catalog.oid)" +
+			" RETURNS pg_catalog.void" +
+			" AS " + eQuote(module_path) +
+			" LANGUAGE C");
+		s.execute("REVOKE ALL PRIVILEGES" +
+			" ON FUNCTION sqlj.java_fdw_validator(" +
+			"pg_catalog.text[], pg_catalog.oid) FROM public");
+		rs = s.executeQuery(
+			"SELECT pg_catalog.obj_description(CAST(" +
+			"'sqlj.java_fdw_validator(pg_catalog.text[], pg_catalog.oid)' " +
+			"AS pg_catalog.regprocedure), " +
+			"'pg_proc')");
+		rs.next();
+		rs.getString(1);
+		noComment = rs.wasNull();
+		rs.close();
+		if ( noComment )
+			s.execute(
+				"COMMENT ON FUNCTION sqlj.java_fdw_validator(" +
+				"pg_catalog.text[], pg_catalog.oid) IS '" +
+				"Option validator for foreign data wrappers implemented in " +
+				"Java.'");
+
+		/*
+		 * An aggregate's transition function must match its aggregated
+		 * arguments in number, unless they are VARIADIC "any", so there is
+		 * one for each number of arguments up to four, and one variadic.
+		 */
+		String anys = "";
+		for ( int i = 0 ; i <= 4 ; ++ i )
+		{
+			String name = "sqlj.java_ordered_set_transition";
+			String args;
+			if ( 4 == i )
+			{
+				name += "_multi";
+				args = "pg_catalog.internal, VARIADIC pg_catalog.\"any\"";
+			}
+			else
+			{
+				anys += ", pg_catalog.\"any\"";
+				args = "pg_catalog.internal" + anys;
+			}
+			s.execute(
+				"CREATE OR REPLACE FUNCTION " + name + "(" + args + ")" +
+				" RETURNS pg_catalog.internal" +
+				" AS " + eQuote(module_path) +
+				", 'java_ordered_set_transition'" +
+				" LANGUAGE C");
+			rs = s.executeQuery(
+				"SELECT pg_catalog.obj_description(CAST(" +
+				eQuote(name + "(" + args.replace("VARIADIC ", "") + ")") +
+				" AS pg_catalog.regprocedure), " +
+				"'pg_proc')");
+			rs.next();
+			rs.getString(1);
+			noComment = rs.wasNull();
+			rs.close();
+			if ( noComment )
+				s.execute(
+					"COMMENT ON FUNCTION " + name + "(" + args + ") IS '" +
+					"Transition function for ordered-set aggregates with " +
+					"finishers in Java, sorting the aggregated rows for " +
+					"org.postgresql.pljava.SortedInput.'");
+		}
 	}
 
 	/**
@@ -723,9 +811,46 @@ public class InstallHelper
 	throws SQLException
 	{
 		DatabaseMetaData md = c.getMetaData();
-		ResultSet rs = md.getProcedures( null, "sqlj", "alias_java_language");
+		ResultSet rs =
+			md.getProcedures( null, "sqlj", "pljava_stat_get_progress");
 		boolean seen = rs.next();
 		rs.close();
+		if ( seen )
+			return SchemaVariant.UNREL20261018f;
+
+		rs = md.getProcedures( null, "sqlj", "pljava_stat_reset");
+		seen = rs.next();
+		rs.close();
+		if ( seen )
+			return SchemaVariant.UNREL20261018e;
+
+		rs = md.getProcedures( null, "sqlj", "budget_report");
+		seen = rs.next();
+		rs.close();
+		if ( seen )
+			return SchemaVariant.UNREL20261018d;
+
+		rs = md.getProcedures( null, "sqlj", "memory_report");
+		seen = rs.next();
+		rs.close();
+		if ( seen )
+			return SchemaVariant.UNREL20261018c;
+
+		rs = md.getProcedures( null, "sqlj", "submit");
+		seen = rs.next();
+		rs.close();
+		if ( seen )
+			return SchemaVariant.UNREL20261018b;
+
+		rs = md.getProcedures( null, "sqlj", "startup_report");
+		seen = rs.next();
+		rs.close();
+		if ( seen )
+			return SchemaVariant.UNREL20261018a;
+
+		rs = md.getProcedures( null, "sqlj", "alias_java_language");
+		seen = rs.next();
+		rs.close();
 		if ( seen )
 			return SchemaVariant.REL_1_6_0;
 
@@ -824,10 +949,82 @@ public class InstallHelper
 	 * up to date.
 	 */
 	private static final SchemaVariant currentSchema =
-		SchemaVariant.REL_1_6_0;
+		SchemaVariant.UNREL20261018f;
 
 	private enum SchemaVariant
 	{
+		UNREL20261018f (null)
+		{
+			@Override
+			void migrateFrom( SchemaVariant sv, Connection c, Statement s)
+			throws SQLException
+			{
+				if ( UNREL20261018e != sv )
+					UNREL20261018e.migrateFrom( sv, c, s);
+
+				deployViaDescriptor( c, s, "pljava_progress");
+			}
+		},
+		UNREL20261018e (null)
+		{
+			@Override
+			void migrateFrom( SchemaVariant sv, Connection c, Statement s)
+			throws SQLException
+			{
+				if ( UNREL20261018d != sv )
+					UNREL20261018d.migrateFrom( sv, c, s);
+
+				deployViaDescriptor( c, s, "pljava_stat");
+			}
+		},
+		UNREL20261018d (null)
+		{
+			@Override
+			void migrateFrom( SchemaVariant sv, Connection c, Statement s)
+			throws SQLException
+			{
+				if ( UNREL20261018c != sv )
+					UNREL20261018c.migrateFrom( sv, c, s);
+
+				deployViaDescriptor( c, s, "budget_report");
+			}
+		},
+		UNREL20261018c (null)
+		{
+			@Override
+			void migrateFrom( SchemaVariant sv, Connection c, Statement s)
+			throws SQLException
+			{
+				if ( UNREL20261018b != sv )
+					UNREL20261018b.migrateFrom( sv, c, s);
+
+				deployViaDescriptor( c, s, "memory_report");
+			}
+		},
+		UNREL20261018b (null)
+		{
+			@Override
+			void migrateFrom( SchemaVariant sv, Connection c, Statement s)
+			throws SQLException
+			{
+				if ( UNREL20261018a != sv )
+					UNREL20261018a.migrateFrom( sv, c, s);
+
+				deployViaDescriptor( c, s, "worker_pool");
+			}
+		},
+		UNREL20261018a (null)
+		{
+			@Override
+			void migrateFrom( SchemaVariant sv, Connection c, Statement s)
+			throws SQLException
+			{
+				if ( REL_1_6_0 != sv )
+					REL_1_6_0.migrateFrom( sv, c, s);
+
+				deployViaDescriptor( c, s, "startup_report");
+			}
+		},
 		REL_1_6_0 ("5565a3c9c4b8d6dd0b0f7fff4090d4e8120dc10a")
 		{
 			@Override
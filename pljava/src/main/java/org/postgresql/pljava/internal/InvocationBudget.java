@@ -0,0 +1,411 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+package org.postgresql.pljava.internal;
+
+import java.lang.invoke.MethodHandle;
+import static java.lang.invoke.MethodHandles.publicLookup;
+import static java.lang.invoke.MethodType.methodType;
+
+import java.lang.management.ManagementFactory;
+import java.lang.management.ThreadMXBean;
+
+import java.sql.SQLException;
+import java.sql.SQLNonTransientException;
+
+import java.util.ArrayList;
+import java.util.List;
+import java.util.Map;
+import java.util.TreeMap;
+
+import static java.util.concurrent.TimeUnit.NANOSECONDS;
+
+import java.util.logging.Logger;
+
+import static org.postgresql.pljava.internal.Privilege.doPrivileged;
+
+/**
+ * Enforcement of the {@code pljava.cpu_budget} and
+ * {@code pljava.allocation_budget} settings around one invocation of a
+ * PL/Java function, and the per-function totals reported by
+ * {@code sqlj.budget_report()}.
+ *<p>
+ * The native code calls {@code EntryPoints.invokeBudgeted} instead of
+ * {@code invoke} only when one of the settings is nonzero, and a
+ * {@link Meter Meter} is started for that invocation from the thread's CPU time
+ * and allocated-bytes counters. A watchdog thread samples the counters of
+ * every running meter, and marks one that has exceeded a budget. It does not
+ * interrupt the invoking thread, which may be in PostgreSQL or in PL/Java's
+ * own code, where an interrupt is not expected; instead, {@link #check check}
+ * is called before each query is executed or rows fetched on the thread, and
+ * fails then if a meter running there is marked. Java offers no way to stop
+ * code that does not reach such a point, so the budget is checked again when
+ * the function returns, and the invocation fails then if it was exceeded,
+ * whatever the function returned.
+ *<p>
+ * The allocated-bytes counter is specific to the HotSpot-derived
+ * {@code com.sun.management.ThreadMXBean}, looked up reflectively; if the Java
+ * runtime lacks it, or lacks thread CPU time, the corresponding budget is not
+ * enforced, and a warning is logged once. A runtime that can measure thread
+ * CPU time but has it turned off has it turned on, for every thread, when this
+ * class is first used, that is, on the session's first budgeted invocation.
+ */
+public final class InvocationBudget
+{
+	private InvocationBudget() { } // do not instantiate
+
+	/**
+	 * How often the watchdog samples the running meters.
+	 */
+	private static final long TICK_MILLIS = 10;
+
+	private static final ThreadMXBean s_threads =
+		ManagementFactory.getThreadMXBean();
+
+	/**
+	 * Handle on {@code getThreadAllocatedBytes(long)} bound to the bean, or
+	 * null if the runtime does not offer it.
+	 */
+	private static final MethodHandle s_allocatedBytes;
+
+	private static final boolean s_cpuTimeSupported;
+
+	private static boolean s_warnedCpu;
+	private static boolean s_warnedAllocation;
+
+	static
+	{
+		MethodHandle mh = null;
+		try
+		{
+			Class<?> c = Class.forName("com.sun.management.ThreadMXBean");
+			if ( c.isInstance(s_threads) )
+			{
+				mh = publicLookup().findVirtual(c, "getThreadAllocatedBytes",
+					methodType(long.class, long.class)).bindTo(s_threads);
+				if ( ! (boolean)publicLookup().findVirtual(c,
+					"isThreadAllocatedMemorySupported",
+					methodType(boolean.class)).invoke(s_threads) )
+					mh = null;
+			}
+		}
+		catch ( Throwable t )
+		{
+			mh = null;
+		}
+		s_allocatedBytes = mh;
+
+		boolean cpu = s_threads.isThreadCpuTimeSupported();
+		if ( cpu && ! s_threads.isThreadCpuTimeEnabled() )
+		{
+			try
+			{
+				s_threads.setThreadCpuTimeEnabled(true);
+				cpu = s_threads.isThreadCpuTimeEnabled();
+			}
+			catch ( SecurityException | UnsupportedOperationException e )
+			{
+				cpu = false;
+			}
+		}
+		s_cpuTimeSupported = cpu;
+	}
+
+	/**
+	 * The meters of invocations now running, nested ones after those they are
+	 * nested in; guarded by its own monitor, which the watchdog waits on.
+	 */
+	private static final List<Meter> s_running = new ArrayList<>();
+
+	/**
+	 * Whether any meter in {@code s_running} is over budget, so that
+	 * {@link #check check} can return at once in the usual case.
+	 */
+	private static volatile boolean s_anyOverBudget;
+
+	private static Thread s_watchdog;
+
+	/**
+	 * Totals by function oid, reported by {@code sqlj.budget_report()}; only
+	 * touched while holding the lock to enter PG.
+	 */
+	private static final Map<Integer,Usage> s_usage = new TreeMap<>();
+
+	/**
+	 * The resources used, and budgets exceeded, by the budgeted invocations
+	 * of one function in this session.
+	 */
+	private static final class Usage
+	{
+		long calls;
+		long cpuNanos;
+		long maxCpuNanos;
+		long allocatedBytes;
+		long maxAllocatedBytes;
+		long exceeded;
+	}
+
+	/**
+	 * Begin metering an invocation of the function with oid {@code function}.
+	 * @param cpuBudget CPU time allowed, in nanoseconds, or zero for no limit
+	 * @param allocationBudget bytes the invocation may allocate, or zero for
+	 * no limit
+	 */
+	static Meter start(int function, long cpuBudget, long allocationBudget)
+	{
+		if ( 0 != cpuBudget  &&  ! s_cpuTimeSupported )
+		{
+			cpuBudget = 0;
+			if ( ! s_warnedCpu )
+			{
+				s_warnedCpu = true;
+				Logger.getAnonymousLogger().warning(
+					"pljava.cpu_budget is not enforced: this Java runtime " +
+					"does not measure thread CPU time");
+			}
+		}
+
+		if ( 0 != allocationBudget  &&  null == s_allocatedBytes )
+		{
+			allocationBudget = 0;
+			if ( ! s_warnedAllocation )
+			{
+				s_warnedAllocation = true;
+				Logger.getAnonymousLogger().warning(
+					"pljava.allocation_budget is not enforced: this Java " +
+					"runtime does not count bytes allocated by a thread");
+			}
+		}
+
+		Meter m = new Meter(function, cpuBudget, allocationBudget);
+
+		if ( 0 == cpuBudget  &&  0 == allocationBudget )
+			return m;
+
+		synchronized ( s_running )
+		{
+			if ( null == s_watchdog )
+			{
+				s_watchdog = doPrivileged(() ->
+				{
+					Thread t = new Thread(
+						InvocationBudget::watch, "PL/Java budget watchdog");
+					t.setDaemon(true);
+					t.setContextClassLoader(null);
+					t.start();
+					return t;
+				});
+			}
+			s_running.add(m);
+			s_running.notify();
+		}
+		return m;
+	}
+
+	/**
+	 * Throw the exception for an exceeded budget if any invocation running on
+	 * the current thread has been found over one; called before starting work
+	 * in PostgreSQL for that thread.
+	 */
+	static void check() throws SQLException
+	{
+		if ( ! s_anyOverBudget )
+			return;
+		SQLException e = null;
+		Thread t = Thread.currentThread();
+		synchronized ( s_running )
+		{
+			for ( Meter m : s_running )
+			{
+				if ( t != m.m_thread  ||  ! m.m_overBudget )
+					continue;
+				e = m.exceeded();
+				break;
+			}
+		}
+		if ( null != e )
+			throw e;
+	}
+
+	/**
+	 * Body of the watchdog thread: while any meter is running, sample each
+	 * one every {@code TICK_MILLIS}, marking any found over budget.
+	 */
+	private static void watch()
+	{
+		synchronized ( s_running )
+		{
+			for ( ;; )
+			{
+				try
+				{
+					if ( s_running.isEmpty() )
+						s_running.wait();
+					else
+						s_running.wait(TICK_MILLIS);
+				}
+				catch ( InterruptedException e )
+				{
+					return;
+				}
+
+				for ( Meter m : s_running )
+				{
+					if ( m.m_overBudget )
+						continue;
+					m.sample();
+					if ( m.m_overBudget )
+						s_anyOverBudget = true;
+				}
+			}
+		}
+	}
+
+	/**
+	 * The counters and budgets for one invocation.
+	 */
+	static final class Meter
+	{
+		private final int m_function;
+		private final Thread m_thread;
+		private final long m_cpuBudget;
+		private final long m_allocationBudget;
+		private final long m_cpuStart;
+		private final long m_allocatedStart;
+
+		private long m_cpuUsed;
+		private long m_allocated;
+
+		/*
+		 * Written by the watchdog while holding s_running, read by the
+		 * invoking thread holding the same, or after it has removed this
+		 * meter holding the same.
+		 */
+		private boolean m_overBudget;
+
+		private Meter(int function, long cpuBudget, long allocationBudget)
+		{
+			m_function = function;
+			m_thread = Thread.currentThread();
+			m_cpuBudget = cpuBudget;
+			m_allocationBudget = allocationBudget;
+			m_cpuStart = cpuTime();
+			m_allocatedStart = allocated();
+		}
+
+		private long cpuTime()
+		{
+			if ( ! s_cpuTimeSupported )
+				return 0;
+			long t = s_threads.getThreadCpuTime(m_thread.getId());
+			return -1 == t ? 0 : t;
+		}
+
+		private long allocated()
+		{
+			if ( null == s_allocatedBytes )
+				return 0;
+			try
+			{
+				long b = (long)s_allocatedBytes.invokeExact(m_thread.getId());
+				return -1 == b ? 0 : b;
+			}
+			catch ( Throwable t )
+			{
+				return 0;
+			}
+		}
+
+		/**
+		 * Update the amounts used, and note whether either is over budget.
+		 */
+		private void sample()
+		{
+			m_cpuUsed = Math.max(0, cpuTime() - m_cpuStart);
+			m_allocated = Math.max(0, allocated() - m_allocatedStart);
+			if ( 0 != m_cpuBudget  &&  m_cpuUsed > m_cpuBudget
+				||  0 != m_allocationBudget
+					&&  m_allocated > m_allocationBudget )
+				m_overBudget = true;
+		}
+
+		/**
+		 * Stop metering, add this invocation to its function's totals, and
+		 * return the exception to fail it with if it went over budget, or
+		 * null.
+		 */
+		SQLException finish()
+		{
+			synchronized ( s_running )
+			{
+				s_running.remove(this);
+				boolean any = false;
+				for ( Meter m : s_running )
+					any |= m.m_overBudget;
+				s_anyOverBudget = any;
+			}
+
+			sample();
+
+			Usage u = s_usage.computeIfAbsent(m_function, k -> new Usage());
+			++ u.calls;
+			u.cpuNanos += m_cpuUsed;
+			u.maxCpuNanos = Math.max(u.maxCpuNanos, m_cpuUsed);
+			u.allocatedBytes += m_allocated;
+			u.maxAllocatedBytes = Math.max(u.maxAllocatedBytes, m_allocated);
+
+			SQLException e = exceeded();
+			if ( null != e )
+				++ u.exceeded;
+			return e;
+		}
+
+		/**
+		 * The exception for the budget found exceeded when last sampled, or
+		 * null.
+		 */
+		private SQLException exceeded()
+		{
+			if ( 0 != m_cpuBudget  &&  m_cpuUsed > m_cpuBudget )
+				return new SQLNonTransientException(String.format(
+					"PL/Java function used %d ms of CPU time, over its budget" +
+					" of %d ms (pljava.cpu_budget)",
+					NANOSECONDS.toMillis(m_cpuUsed),
+					NANOSECONDS.toMillis(m_cpuBudget)), "57014");
+
+			if ( 0 != m_allocationBudget  &&  m_allocated > m_allocationBudget )
+				return new SQLNonTransientException(String.format(
+					"PL/Java function allocated %d kB, over its budget" +
+					" of %d kB (pljava.allocation_budget)",
+					m_allocated >> 10, m_allocationBudget >> 10), "54000");
+
+			return null;
+		}
+	}
+
+	/**
+	 * The totals for each function that has had a budgeted invocation in this
+	 * session, in order of function oid: each row holds the oid, the number
+	 * of calls, the total and greatest CPU nanoseconds, the total and greatest
+	 * bytes allocated, and the number of calls that exceeded a budget.
+	 */
+	public static List<long[]> report()
+	{
+		return Backend.doInPG(() ->
+		{
+			List<long[]> rows = new ArrayList<>(s_usage.size());
+			s_usage.forEach((oid, u) -> rows.add(new long[] {
+				Integer.toUnsignedLong(oid), u.calls, u.cpuNanos, u.maxCpuNanos,
+				u.allocatedBytes, u.maxAllocatedBytes, u.exceeded }));
+			return rows;
+		});
+	}
+}
@@ -0,0 +1,232 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+package org.postgresql.pljava.internal;
+
+import java.lang.reflect.Constructor;
+import java.lang.reflect.InvocationTargetException;
+
+import java.security.AccessControlContext;
+import java.security.ProtectionDomain;
+
+import java.sql.ResultSet;
+import java.sql.SQLException;
+import java.sql.SQLNonTransientException;
+
+import java.util.ArrayList;
+import java.util.HashMap;
+import java.util.List;
+import java.util.Map;
+import java.util.Set;
+
+import static java.util.Collections.unmodifiableList;
+import static java.util.Collections.unmodifiableMap;
+
+import javax.security.auth.Subject;
+import javax.security.auth.SubjectDomainCombiner;
+
+import org.postgresql.pljava.LogicalDecoder;
+import org.postgresql.pljava.PLPrincipal;
+
+import static org.postgresql.pljava.internal.Privilege.doPrivileged;
+import org.postgresql.pljava.jdbc.TriggerResultSet;
+import org.postgresql.pljava.sqlgen.Lexicals.Identifier;
+import org.postgresql.pljava.sqlj.Loader;
+
+/**
+ * Adapter between the native logical decoding output plugin callbacks and
+ * a user-supplied {@link LogicalDecoder}.
+ *<p>
+ * The methods here are called only from C. Each of the instance methods
+ * returns what the decoder wrote, or null if it wrote nothing, for the C code
+ * to pass along as output. The changes of a batch arrive as parallel arrays,
+ * one element for each change, with the tuples borrowed from the reorder
+ * buffer for the duration of the call.
+ */
+final class LogicalDecoding
+{
+	private static final AccessControlContext s_acc = doPrivileged(() ->
+		new AccessControlContext(
+			new AccessControlContext(new ProtectionDomain[] {}),
+			new SubjectDomainCombiner(new Subject(true,
+				Set.of(new PLPrincipal.Sandboxed("java_decoding")),
+				Set.of(), Set.of()))));
+
+	private static final LogicalDecoder.Kind[] s_kinds =
+		LogicalDecoder.Kind.values();
+
+	private final LogicalDecoder m_decoder;
+	private final String m_className;
+	private final List<String> m_output = new ArrayList<>();
+	private final LogicalDecoder.Output m_out =
+		data -> m_output.add(data.toString());
+
+	private LogicalDecoding(LogicalDecoder decoder, String className)
+	{
+		m_decoder = decoder;
+		m_className = className;
+	}
+
+	private static LogicalDecoding start(
+		String schema, String className,
+		String[] optionNames, String[] optionValues)
+	throws SQLException
+	{
+		ClassLoader loader = Loader.getSchemaLoader(
+			null == schema ? null : Identifier.Simple.fromCatalog(schema));
+
+		Map<String,String> options = new HashMap<>();
+		for ( int i = 0 ; i < optionNames.length ; ++ i )
+			options.put(optionNames[i], optionValues[i]);
+		Map<String,String> opts = unmodifiableMap(options);
+
+		try
+		{
+			Class<? extends LogicalDecoder> c =
+				Class.forName(className, false, loader)
+				.asSubclass(LogicalDecoder.class);
+			Constructor<? extends LogicalDecoder> ctor =
+				c.getConstructor(Map.class);
+			return new LogicalDecoding(
+				doPrivileged(() -> ctor.newInstance(opts), s_acc), className);
+		}
+		catch ( ClassNotFoundException e )
+		{
+			throw new SQLNonTransientException(
+				"No such class: " + className, "46103", e);
+		}
+		catch ( ClassCastException e )
+		{
+			throw new SQLNonTransientException(
+				"Class " + className + " does not implement " +
+				LogicalDecoder.class.getName(), "42883", e);
+		}
+		catch ( InvocationTargetException e )
+		{
+			Throwable t = e.getCause();
+			if ( t instanceof SQLException )
+				throw (SQLException)t;
+			throw new SQLException(
+				"Constructing " + className + " failed: " + t, "XX000", t);
+		}
+		catch ( ReflectiveOperationException e )
+		{
+			throw new SQLNonTransientException(
+				"Class " + className + " has no accessible constructor " +
+				"accepting a Map<String,String>", "42883", e);
+		}
+	}
+
+	private String[] begin(long xid) throws SQLException
+	{
+		doPrivileged(() -> m_decoder.begin(xid, m_out), s_acc);
+		return output();
+	}
+
+	private String[] changes(long xid, byte[] kinds,
+		String[] schemas, String[] tables, TupleDesc[] descs,
+		Tuple[] oldTuples, Tuple[] newTuples)
+	throws SQLException
+	{
+		List<LogicalDecoder.Change> changes = new ArrayList<>(kinds.length);
+		for ( int i = 0 ; i < kinds.length ; ++ i )
+			changes.add(new Change(s_kinds[kinds[i]], schemas[i], tables[i],
+				descs[i], oldTuples[i], newTuples[i]));
+		List<LogicalDecoder.Change> batch = unmodifiableList(changes);
+		doPrivileged(() -> m_decoder.changes(xid, batch, m_out), s_acc);
+		return output();
+	}
+
+	private String[] commit(long xid, long commitLSN) throws SQLException
+	{
+		doPrivileged(() -> m_decoder.commit(xid, commitLSN, m_out), s_acc);
+		return output();
+	}
+
+	private void close() throws SQLException
+	{
+		doPrivileged(m_decoder::close, s_acc);
+	}
+
+	private String[] output()
+	{
+		if ( m_output.isEmpty() )
+			return null;
+		String[] result = m_output.toArray(new String[m_output.size()]);
+		m_output.clear();
+		return result;
+	}
+
+	@Override
+	public String toString()
+	{
+		return "LogicalDecoding(" + m_className + ")";
+	}
+
+	private static final class Change implements LogicalDecoder.Change
+	{
+		private final LogicalDecoder.Kind m_kind;
+		private final String m_schema;
+		private final String m_table;
+		private final TupleDesc m_desc;
+		private final Tuple m_old;
+		private final Tuple m_new;
+
+		Change(LogicalDecoder.Kind kind, String schema, String table,
+			TupleDesc desc, Tuple oldTuple, Tuple newTuple)
+		{
+			m_kind = kind;
+			m_schema = schema;
+			m_table = table;
+			m_desc = desc;
+			m_old = oldTuple;
+			m_new = newTuple;
+		}
+
+		@Override
+		public LogicalDecoder.Kind kind()
+		{
+			return m_kind;
+		}
+
+		@Override
+		public String schema()
+		{
+			return m_schema;
+		}
+
+		@Override
+		public String table()
+		{
+			return m_table;
+		}
+
+		@Override
+		public ResultSet oldRow() throws SQLException
+		{
+			return null == m_old ? null
+				: new TriggerResultSet(m_desc, m_old, true);
+		}
+
+		@Override
+		public ResultSet newRow() throws SQLException
+		{
+			return null == m_new ? null
+				: new TriggerResultSet(m_desc, m_new, true);
+		}
+
+		@Override
+		public String toString()
+		{
+			return m_kind + " " + m_schema + "." + m_table;
+		}
+	}
+}
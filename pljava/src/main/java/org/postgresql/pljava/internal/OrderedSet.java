@@ -0,0 +1,241 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+package org.postgresql.pljava.internal;
+
+import static org.postgresql.pljava.internal.Backend.doInPG;
+
+import java.sql.SQLException;
+
+import java.util.Iterator;
+import java.util.NoSuchElementException;
+import java.util.PrimitiveIterator;
+
+import org.postgresql.pljava.SortedInput;
+
+/**
+ * The sorted input of an ordered-set aggregate group, kept by native code in
+ * a {@code tuplesort} and read from it in batches.
+ *<p>
+ * Made by native code when the finisher is called, and scoped to that
+ * invocation.
+ */
+public class OrderedSet implements SortedInput
+{
+	/**
+	 * Rows the iterators read per native call.
+	 */
+	private static final int BATCH_SIZE = 1024;
+
+	private final State m_state;
+	private final long m_size;
+	private final boolean m_hypothetical;
+
+	OrderedSet(DualState.Key cookie, long resourceOwner, long pointer,
+		long size, boolean hypothetical)
+	{
+		m_state = new State(cookie, this, resourceOwner, pointer);
+		m_size = size;
+		m_hypothetical = hypothetical;
+	}
+
+	private static class State
+	extends DualState.SingleGuardedLong<OrderedSet>
+	{
+		private State(
+			DualState.Key cookie, OrderedSet os, long ro, long ptr)
+		{
+			super(cookie, os, ro, ptr);
+		}
+
+		/**
+		 * Return the state pointer, as {@code Relation} does; it is only used
+		 * within the methods of the {@code OrderedSet}, whose invocation
+		 * cannot end while one is running.
+		 */
+		private long getPointer() throws SQLException
+		{
+			pin();
+			try
+			{
+				return guardedLong();
+			}
+			finally
+			{
+				unpin();
+			}
+		}
+	}
+
+	@Override
+	public long size()
+	{
+		return m_size;
+	}
+
+	@Override
+	public long skip(long n) throws SQLException
+	{
+		if ( n <= 0 )
+			return 0;
+		return doInPG(() -> _skip(m_state.getPointer(), n));
+	}
+
+	@Override
+	public int read(double[] into) throws SQLException
+	{
+		return doInPG(() -> _fetchDoubles(m_state.getPointer(), into));
+	}
+
+	@Override
+	public int read(long[] into) throws SQLException
+	{
+		return doInPG(() -> _fetchLongs(m_state.getPointer(), into));
+	}
+
+	@Override
+	public int read(Object[] into) throws SQLException
+	{
+		return doInPG(() -> _fetchObjects(m_state.getPointer(), into));
+	}
+
+	@Override
+	public long hypotheticalPosition() throws SQLException
+	{
+		if ( ! m_hypothetical )
+			return -1;
+		return doInPG(() -> _hypotheticalPosition(m_state.getPointer()));
+	}
+
+	@Override
+	public PrimitiveIterator.OfDouble doubles()
+	{
+		return new PrimitiveIterator.OfDouble()
+		{
+			private final double[] m_batch = new double [ BATCH_SIZE ];
+			private int m_count;
+			private int m_next;
+
+			@Override
+			public boolean hasNext()
+			{
+				if ( m_next < m_count )
+					return true;
+				m_next = 0;
+				try
+				{
+					m_count = read(m_batch);
+				}
+				catch ( SQLException e )
+				{
+					throw new IllegalStateException(e);
+				}
+				return 0 < m_count;
+			}
+
+			@Override
+			public double nextDouble()
+			{
+				if ( ! hasNext() )
+					throw new NoSuchElementException();
+				return m_batch [ m_next ++ ];
+			}
+		};
+	}
+
+	@Override
+	public PrimitiveIterator.OfLong longs()
+	{
+		return new PrimitiveIterator.OfLong()
+		{
+			private final long[] m_batch = new long [ BATCH_SIZE ];
+			private int m_count;
+			private int m_next;
+
+			@Override
+			public boolean hasNext()
+			{
+				if ( m_next < m_count )
+					return true;
+				m_next = 0;
+				try
+				{
+					m_count = read(m_batch);
+				}
+				catch ( SQLException e )
+				{
+					throw new IllegalStateException(e);
+				}
+				return 0 < m_count;
+			}
+
+			@Override
+			public long nextLong()
+			{
+				if ( ! hasNext() )
+					throw new NoSuchElementException();
+				return m_batch [ m_next ++ ];
+			}
+		};
+	}
+
+	@Override
+	public Iterator<Object> objects()
+	{
+		return new Iterator<Object>()
+		{
+			private final Object[] m_batch = new Object [ BATCH_SIZE ];
+			private int m_count;
+			private int m_next;
+
+			@Override
+			public boolean hasNext()
+			{
+				if ( m_next < m_count )
+					return true;
+				m_next = 0;
+				try
+				{
+					m_count = read(m_batch);
+				}
+				catch ( SQLException e )
+				{
+					throw new IllegalStateException(e);
+				}
+				return 0 < m_count;
+			}
+
+			@Override
+			public Object next()
+			{
+				if ( ! hasNext() )
+					throw new NoSuchElementException();
+				Object o = m_batch [ m_next ];
+				m_batch [ m_next ++ ] = null;
+				return o;
+			}
+		};
+	}
+
+	private static native int _fetchDoubles(long pointer, double[] into)
+	throws SQLException;
+
+	private static native int _fetchLongs(long pointer, long[] into)
+	throws SQLException;
+
+	private static native int _fetchObjects(long pointer, Object[] into)
+	throws SQLException;
+
+	private static native long _skip(long pointer, long n)
+	throws SQLException;
+
+	private static native long _hypotheticalPosition(long pointer);
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2019 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -108,7 +108,13 @@ public class Portal
 	public long getPortalPos()
 	throws SQLException
 	{
-		long pos = doInPG(() -> _getPortalPos(m_state.getPortalPtr()));
+		long pos = doInPG(() ->
+		{
+			long pointer = m_state.getPortalPtr();
+			return ForeignDowncalls.enabled()  &&  0 != pointer
+				? ForeignDowncalls.portalPos(pointer)
+				: _getPortalPos(pointer);
+		});
 		if ( pos < 0 )
 			throw new ArithmeticException(
 				"portal position too large to report " +
@@ -143,6 +149,7 @@ public class Portal
 	public long fetch(boolean forward, long count)
 	throws SQLException
 	{
+		InvocationBudget.check();
 		long fetched =
 			doInPG(() -> _fetch(m_state.getPortalPtr(), forward, count));
 		if ( fetched < 0 )
@@ -151,6 +158,31 @@ public class Portal
 		return fetched;
 	}
 
+	/**
+	 * Performs an <code>SPI_cursor_fetch</code> and returns the fetched rows
+	 * as a {@link TupleTable}, in a single call into PostgreSQL.
+	 *<p>
+	 * This combines {@link #fetch fetch}, {@link SPI#getTupTable
+	 * SPI.getTupTable}, and {@link SPI#freeTupTable SPI.freeTupTable}. If the
+	 * setting {@code pljava.lazy_row_conversion} is on, the returned table
+	 * holds on to the native rows and creates each {@link Tuple} only when it
+	 * is asked for; it should then be {@link TupleTable#close close}d when no
+	 * longer needed, or it will hold the native rows until the invocation
+	 * returns.
+	 * @param forward Set to <code>true</code> for forward, <code>false</code> for backward.
+	 * @param count Maximum number of rows to fetch.
+	 * @param known The TupleDesc of this Portal, if already known, or null.
+	 * @return The fetched rows, or null if no rows were fetched.
+	 * @throws SQLException if the handle to the native structure is stale.
+	 */
+	public TupleTable fetchTable(boolean forward, long count, TupleDesc known)
+	throws SQLException
+	{
+		InvocationBudget.check();
+		return doInPG(() ->
+			_fetchTable(m_state.getPortalPtr(), forward, count, known));
+	}
+
 	/**
 	 * Returns the value of the <code>atEnd</code> attribute.
 	 * @throws SQLException if the handle to the native structure is stale.
@@ -158,7 +190,13 @@ public class Portal
 	public boolean isAtEnd()
 	throws SQLException
 	{
-		return doInPG(() -> _isAtEnd(m_state.getPortalPtr()));
+		return doInPG(() ->
+		{
+			long pointer = m_state.getPortalPtr();
+			return ForeignDowncalls.enabled()  &&  0 != pointer
+				? ForeignDowncalls.portalAtEnd(pointer)
+				: _isAtEnd(pointer);
+		});
 	}
 
 	/**
@@ -168,7 +206,13 @@ public class Portal
 	public boolean isAtStart()
 	throws SQLException
 	{
-		return doInPG(() -> _isAtStart(m_state.getPortalPtr()));
+		return doInPG(() ->
+		{
+			long pointer = m_state.getPortalPtr();
+			return ForeignDowncalls.enabled()  &&  0 != pointer
+				? ForeignDowncalls.portalAtStart(pointer)
+				: _isAtStart(pointer);
+		});
 	}
 
 	/**
@@ -201,6 +245,10 @@ public class Portal
 	private static native long _fetch(long pointer, boolean forward, long count)
 	throws SQLException;
 
+	private static native TupleTable _fetchTable(long pointer,
+		boolean forward, long count, TupleDesc known)
+	throws SQLException;
+
 	private static native void _close(long pointer);
 
 	private static native boolean _isAtEnd(long pointer)
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2019 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -92,7 +92,8 @@ public class SPI
 	 */
 	public static long getProcessed()
 	{
-		long count = doInPG(SPI::_getProcessed);
+		long count = doInPG(() -> ForeignDowncalls.enabled()
+			? ForeignDowncalls.spiProcessed() : _getProcessed());
 		if ( count < 0 )
 			throw new ArithmeticException(
 				"too many rows processed to count in a Java signed long");
@@ -104,7 +105,8 @@ public class SPI
 	 */
 	public static int getResult()
 	{
-		return doInPG(SPI::_getResult);
+		return doInPG(() -> ForeignDowncalls.enabled()
+			? ForeignDowncalls.spiResult() : _getResult());
 	}
 
 	/**
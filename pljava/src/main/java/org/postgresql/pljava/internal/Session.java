@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2022 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -20,6 +20,7 @@ import java.sql.SQLException;
 import java.sql.Statement;
 import java.util.HashMap;
 
+import org.postgresql.pljava.ComputePool;
 import org.postgresql.pljava.ObjectPool;
 import org.postgresql.pljava.PooledObject;
 import org.postgresql.pljava.SavepointListener;
@@ -126,6 +127,12 @@ public class Session implements org.postgresql.pljava.Session
 		return ObjectPoolImpl.getObjectPool(cls);
 	}
 
+	@Override
+	public ComputePool getComputePool()
+	{
+		return ComputePoolImpl.getInstance();
+	}
+
 	@Override
 	public String getUserName()
 	{
@@ -190,6 +197,12 @@ public class Session implements org.postgresql.pljava.Session
 		XactListener.removeListener(listener);
 	}
 
+	@Override
+	public void reportProgress(long done, long total) throws SQLException
+	{
+		Activity.reportProgress(done, total);
+	}
+
 	/**
 	 * Removes the specified listener from the list of listeners that will
 	 * receive savepoint events.
@@ -0,0 +1,128 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+package org.postgresql.pljava.internal;
+
+import static org.postgresql.pljava.internal.Backend.doInPG;
+
+import java.lang.management.GarbageCollectorMXBean;
+import java.lang.management.ManagementFactory;
+
+import java.sql.SQLException;
+
+/**
+ * Access to the cluster-wide cumulative statistics PL/Java keeps in shared
+ * memory, read by the {@code sqlj.pljava_stat_*} views.
+ *<p>
+ * Each backend counts locally and adds its counts to the shared totals at
+ * most once a second, at the end of a transaction, and when it exits; reading
+ * the totals first adds the reading backend's own. The totals survive the
+ * backends that contributed them, until reset. Before PostgreSQL 17, the
+ * shared area exists only when PL/Java is loaded by
+ * {@code shared_preload_libraries}.
+ */
+public final class Stats
+{
+	private Stats() { } // do not instantiate
+
+	/*
+	 * Indices of the counters in the array returned by counters(), also used
+	 * by the native code.
+	 */
+	public static final int JVM_STARTS         = 0;
+	public static final int JVM_START_MICROS   = 1;
+	public static final int FUNCTIONS_RESOLVED = 2;
+	public static final int RESOLUTION_MICROS  = 3;
+	public static final int CLASSES_LOADED     = 4;
+	public static final int SPI_STATEMENTS     = 5;
+	public static final int GC_COUNT           = 6;
+	public static final int GC_MICROS          = 7;
+	public static final int UNTRACKED_CALLS    = 8;
+	public static final int COUNTERS           = 9;
+
+	/**
+	 * The JVM's cumulative count of classes loaded, count of collections, and
+	 * milliseconds spent collecting, sampled by the native code when it
+	 * flushes; null if they cannot be had. Must not throw.
+	 */
+	private static long[] jvmCounters()
+	{
+		try
+		{
+			long count = 0;
+			long millis = 0;
+			for ( GarbageCollectorMXBean gc :
+				ManagementFactory.getGarbageCollectorMXBeans() )
+			{
+				long c = gc.getCollectionCount();
+				long t = gc.getCollectionTime();
+				if ( -1 != c )
+					count += c;
+				if ( -1 != t )
+					millis += t;
+			}
+			return new long[] {
+				ManagementFactory.getClassLoadingMXBean()
+					.getTotalLoadedClassCount(),
+				count, millis
+			};
+		}
+		catch ( Throwable t )
+		{
+			return null;
+		}
+	}
+
+	/**
+	 * The totals for each function that has been counted, four elements each:
+	 * database oid, function oid, calls, and microseconds in the function.
+	 * Function calls are counted only when {@code track_functions} is
+	 * {@code pl} or {@code all}.
+	 */
+	public static long[] functions() throws SQLException
+	{
+		return available(doInPG(Stats::_functions));
+	}
+
+	/**
+	 * The totals of the counters at the indices given by the constants of
+	 * this class, followed by the time of the last reset, in seconds since
+	 * the Unix epoch.
+	 */
+	public static long[] counters() throws SQLException
+	{
+		return available(doInPG(Stats::_counters));
+	}
+
+	/**
+	 * Zero all the totals.
+	 */
+	public static void reset() throws SQLException
+	{
+		if ( ! doInPG(Stats::_reset) )
+			available(null);
+	}
+
+	private static long[] available(long[] a) throws SQLException
+	{
+		if ( null == a )
+			throw new SQLException(
+				"PL/Java statistics are unavailable; before PostgreSQL 17, " +
+				"PL/Java must be in shared_preload_libraries", "55000");
+		return a;
+	}
+
+	private static native long[] _functions();
+
+	private static native long[] _counters();
+
+	private static native boolean _reset();
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2019 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -14,6 +14,9 @@ package org.postgresql.pljava.internal;
 
 import static org.postgresql.pljava.internal.Backend.doInPG;
 
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+
 import java.sql.SQLException;
 
 /**
@@ -24,20 +27,53 @@ import java.sql.SQLException;
  */
 public class Tuple
 {
+	/*
+	 * Parts of the HeapTupleHeader that TupleDeformer reads, confirmed in
+	 * Tuple.c.
+	 */
+	static final int OFFSET_T_INFOMASK2 = 18;
+	static final int OFFSET_T_INFOMASK  = 20;
+	static final int OFFSET_T_HOFF      = 22;
+	static final int OFFSET_T_BITS      = 23;
+	static final int HEAP_HASNULL       = 0x0001;
+	static final int HEAP_NATTS_MASK    = 0x07FF;
+
 	private final State m_state;
 
-	Tuple(DualState.Key cookie, long resourceOwner, long pointer)
+	/**
+	 * A read-only view of the native tuple's header and data, obtained the
+	 * first time a value is read in Java.
+	 */
+	private ByteBuffer m_data;
+
+	/**
+	 * Construct an instance; when {@code borrowed} is true, the native tuple
+	 * belongs to someone else, and is not freed when this becomes unreachable.
+	 * A borrowed tuple should have a {@code resourceOwner} whose release will
+	 * come before the tuple's owner frees it.
+	 */
+	Tuple(DualState.Key cookie, long resourceOwner, long pointer,
+		boolean borrowed)
 	{
-		m_state = new State(cookie, this, resourceOwner, pointer);
+		m_state = new State(cookie, this, resourceOwner, pointer, borrowed);
 	}
 
 	private static class State
 	extends DualState.SingleHeapFreeTuple<Tuple>
 	{
+		private final boolean m_borrowed;
+
 		private State(
-			DualState.Key cookie, Tuple t, long ro, long ht)
+			DualState.Key cookie, Tuple t, long ro, long ht, boolean borrowed)
 		{
 			super(cookie, t, ro, ht);
+			m_borrowed = borrowed;
+		}
+
+		@Override
+		protected void javaStateUnreachable(boolean nativeStateLive)
+		{
+			super.javaStateUnreachable(nativeStateLive && ! m_borrowed);
 		}
 
 		/**
@@ -85,6 +121,9 @@ public class Tuple
 	 * Conversion to a JDBC 4.1 specified class is best effort, if the native
 	 * type system knows how to do so; otherwise, the return value can be
 	 * whatever would have been returned in the legacy case. Caller beware!
+	 *<p>
+	 * Values of a few fixed-width types are read from the tuple's bytes in
+	 * Java by a {@link TupleDeformer}; others are converted in native code.
 	 * @param tupleDesc The Tuple descriptor for this instance.
 	 * @param index Index of value in the structure (one based).
 	 * @param type Desired Java class of the result, if the JDBC 4.1 version
@@ -96,11 +135,26 @@ public class Tuple
 	throws SQLException
 	{
 		return doInPG(() ->
-			_getObject(this.getNativePointer(),
-				tupleDesc.getNativePointer(), index, type));
+		{
+			long pointer = this.getNativePointer();
+			TupleDeformer deformer = tupleDesc.getDeformer();
+			if ( deformer.canRead(index, type) )
+			{
+				if ( null == m_data )
+					m_data = _getData(pointer).asReadOnlyBuffer()
+						.order(ByteOrder.nativeOrder());
+				Object o = deformer.getObject(m_data, index);
+				if ( TupleDeformer.UNHANDLED != o )
+					return o;
+			}
+			return _getObject(pointer,
+				tupleDesc.getNativePointer(), index, type);
+		});
 	}
 
 	private static native Object _getObject(
 		long pointer, long tupleDescPointer, int index, Class<?> type)
 	throws SQLException;
+
+	private static native ByteBuffer _getData(long pointer);
 }
@@ -0,0 +1,248 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+package org.postgresql.pljava.internal;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+
+import java.time.LocalDate;
+
+import static org.postgresql.pljava.internal.Tuple.HEAP_HASNULL;
+import static org.postgresql.pljava.internal.Tuple.HEAP_NATTS_MASK;
+import static org.postgresql.pljava.internal.Tuple.OFFSET_T_BITS;
+import static org.postgresql.pljava.internal.Tuple.OFFSET_T_HOFF;
+import static org.postgresql.pljava.internal.Tuple.OFFSET_T_INFOMASK;
+import static org.postgresql.pljava.internal.Tuple.OFFSET_T_INFOMASK2;
+
+import static org.postgresql.pljava.jdbc.TypeOid.BOOLOID;
+import static org.postgresql.pljava.jdbc.TypeOid.DATEOID;
+import static org.postgresql.pljava.jdbc.TypeOid.FLOAT4OID;
+import static org.postgresql.pljava.jdbc.TypeOid.FLOAT8OID;
+import static org.postgresql.pljava.jdbc.TypeOid.INT2OID;
+import static org.postgresql.pljava.jdbc.TypeOid.INT4OID;
+import static org.postgresql.pljava.jdbc.TypeOid.INT8OID;
+import static org.postgresql.pljava.jdbc.TypeOid.OIDOID;
+
+/**
+ * Reads values of a few fixed-width types straight from the bytes of a
+ * native {@code HeapTuple}, as {@code heap_deform_tuple} would, without a
+ * native call per value.
+ *<p>
+ * One instance is made per {@link TupleDesc}, from the length, alignment, and
+ * type of each attribute. The offset of each attribute that follows only
+ * fixed-width ones is computed once, and used for any tuple without nulls;
+ * otherwise the offset is found by walking the attributes before it, reading
+ * the lengths of any varlena ones along the way.
+ *<p>
+ * The types read here are {@code bool}, {@code int2}, {@code int4},
+ * {@code int8}, {@code float4}, {@code float8}, {@code oid}, and {@code date}
+ * when a {@code LocalDate} is asked for. Each gives the same result as the
+ * native conversion when no class, or the one it naturally produces, is
+ * requested. Anything else, including a value whose offset would depend on a
+ * {@code cstring} or an out-of-line varlena, or an attribute missing from the
+ * tuple because it was added to the table later, is left to native code.
+ */
+final class TupleDeformer
+{
+	/**
+	 * Returned by {@link #getObject getObject} when the value has to be read
+	 * by native code.
+	 */
+	static final Object UNHANDLED = new Object();
+
+	/**
+	 * Days from the Java epoch (1970-01-01) to the PostgreSQL one
+	 * (2000-01-01).
+	 */
+	private static final long EPOCH_DIFF = 10957;
+
+	private static final boolean BIG_ENDIAN =
+		ByteOrder.BIG_ENDIAN == ByteOrder.nativeOrder();
+
+	private final int[] m_attlen;
+	private final int[] m_align;
+	private final int[] m_typeId;
+
+	/**
+	 * Offset of each attribute when no attribute is null, or -1 if it follows
+	 * one that is not fixed-width.
+	 */
+	private final int[] m_cachedOff;
+
+	/**
+	 * @param layout From {@code TupleDesc._getLayout}: for each attribute,
+	 * its length, its alignment in bytes, and its type (zero if dropped).
+	 */
+	TupleDeformer(int[] layout)
+	{
+		int natts = layout.length / 3;
+		m_attlen = new int [ natts ];
+		m_align = new int [ natts ];
+		m_typeId = new int [ natts ];
+		m_cachedOff = new int [ natts ];
+
+		int off = 0;
+		for ( int i = 0 ; i < natts ; ++ i )
+		{
+			m_attlen[i] = layout[3 * i];
+			m_align[i] = layout[3 * i + 1];
+			m_typeId[i] = layout[3 * i + 2];
+			if ( -1 == off )
+			{
+				m_cachedOff[i] = -1;
+				continue;
+			}
+			off = align(off, m_align[i]);
+			m_cachedOff[i] = off;
+			off = 0 < m_attlen[i] ? off + m_attlen[i] : -1;
+		}
+	}
+
+	private static int align(int off, int alignment)
+	{
+		return (off + alignment - 1) & -alignment;
+	}
+
+	/**
+	 * Whether the attribute at (one-based) {@code index} has a type read
+	 * here, and {@code type} (null for the legacy conversions) is the class
+	 * read for it.
+	 */
+	boolean canRead(int index, Class<?> type)
+	{
+		if ( index < 1  ||  index > m_typeId.length )
+			return false; // native code reports the bad index
+		switch ( m_typeId[index - 1] )
+		{
+		case BOOLOID:
+			return null == type  ||  Boolean.class == type;
+		case INT2OID:
+			return null == type  ||  Short.class == type;
+		case INT4OID:
+			return null == type  ||  Integer.class == type;
+		case INT8OID:
+			return null == type  ||  Long.class == type;
+		case FLOAT4OID:
+			return null == type  ||  Float.class == type;
+		case FLOAT8OID:
+			return null == type  ||  Double.class == type;
+		case OIDOID:
+			return null == type  ||  Oid.class == type;
+		case DATEOID:
+			return LocalDate.class == type;
+		default:
+			return false;
+		}
+	}
+
+	/**
+	 * Read the value at (one-based) {@code index}, for which
+	 * {@link #canRead canRead} was true, from {@code data}, a view of the
+	 * tuple's {@code HeapTupleHeader} in native byte order.
+	 * @return the value, null if it is null, or {@link #UNHANDLED} if it
+	 * must be read by native code
+	 */
+	Object getObject(ByteBuffer data, int index)
+	{
+		int i = index - 1;
+		if ( i >= (data.getShort(OFFSET_T_INFOMASK2) & HEAP_NATTS_MASK) )
+			return UNHANDLED; // missing, may have a default from ALTER TABLE
+
+		boolean hasNulls =
+			0 != (data.getShort(OFFSET_T_INFOMASK) & HEAP_HASNULL);
+		if ( hasNulls  &&  isNull(data, i) )
+			return null;
+
+		int hoff = data.get(OFFSET_T_HOFF) & 0xff;
+		int off = hasNulls ? -1 : m_cachedOff[i];
+
+		if ( -1 == off )
+		{
+			off = 0;
+			for ( int j = 0 ; j < i ; ++ j )
+			{
+				if ( hasNulls  &&  isNull(data, j) )
+					continue;
+				int len = m_attlen[j];
+				if ( 0 < len )
+					off = align(off, m_align[j]) + len;
+				else if ( -1 == len )
+				{
+					if ( 0 == data.get(hoff + off) ) // pad byte, not a header
+						off = align(off, m_align[j]);
+					len = varsize(data, hoff + off);
+					if ( -1 == len )
+						return UNHANDLED;
+					off += len;
+				}
+				else
+					return UNHANDLED;
+			}
+			off = align(off, m_align[i]);
+		}
+
+		int at = hoff + off;
+		switch ( m_typeId[i] )
+		{
+		case BOOLOID:
+			return 0 != data.get(at);
+		case INT2OID:
+			return data.getShort(at);
+		case INT4OID:
+			return data.getInt(at);
+		case INT8OID:
+			return data.getLong(at);
+		case FLOAT4OID:
+			return data.getFloat(at);
+		case FLOAT8OID:
+			return data.getDouble(at);
+		case OIDOID:
+			int oid = data.getInt(at);
+			return 0 == oid ? null : new Oid(oid);
+		case DATEOID:
+			return LocalDate.ofEpochDay(data.getInt(at) + EPOCH_DIFF);
+		default:
+			return UNHANDLED;
+		}
+	}
+
+	/**
+	 * As {@code att_isnull}: the bit for each attribute is set when it is
+	 * <em>not</em> null.
+	 */
+	private static boolean isNull(ByteBuffer data, int i)
+	{
+		return 0 == (data.get(OFFSET_T_BITS + (i >>> 3)) & (1 << (i & 7)));
+	}
+
+	/**
+	 * As {@code VARSIZE_ANY} for a varlena stored inline with a one- or
+	 * four-byte header, or -1 for one stored out of line (a TOAST pointer).
+	 */
+	private static int varsize(ByteBuffer data, int at)
+	{
+		int b = data.get(at) & 0xff;
+		if ( BIG_ENDIAN )
+		{
+			if ( 0x80 == b )
+				return -1;
+			if ( 0 != (b & 0x80) )
+				return b & 0x7f;
+			return data.getInt(at) & 0x3fffffff;
+		}
+		if ( 0x01 == b )
+			return -1;
+		if ( 0 != (b & 0x01) )
+			return b >>> 1;
+		return data.getInt(at) >>> 2;
+	}
+}
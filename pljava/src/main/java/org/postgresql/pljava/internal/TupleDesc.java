@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2019 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -27,6 +27,7 @@ public class TupleDesc
 	private final State m_state;
 	private final int m_size;
 	private Class[] m_columnClasses;
+	private TupleDeformer m_deformer;
 
 	TupleDesc(DualState.Key cookie, long resourceOwner, long pointer, int size)
 	throws SQLException
@@ -120,7 +121,29 @@ public class TupleDesc
 	public Tuple formTuple(Object[] values)
 	throws SQLException
 	{
-		return doInPG(() -> _formTuple(this.getNativePointer(), values));
+		return doInPG(() ->
+			_formTuple(this.getNativePointer(), values, null, null));
+	}
+
+	/**
+	 * Creates a <code>Tuple</code> that is described by this descriptor and
+	 * initialized with the supplied <code>values</code>, except that any
+	 * column <em>i</em> for which <code>kinds[i]</code> is nonzero takes its
+	 * value from the raw bits in <code>primitives[i]</code> instead.
+	 *<p>
+	 * The kind is the JNI signature character of the primitive type whose bits
+	 * are stored (<code>Z S I J F D</code>, a <code>float</code> stored as the
+	 * result of {@link Float#floatToRawIntBits floatToRawIntBits}, a
+	 * <code>double</code> as {@link Double#doubleToRawLongBits
+	 * doubleToRawLongBits}), and must be the kind of the column's own type.
+	 * The two arrays are copied to native code in bulk, with no per-column
+	 * unboxing.
+	 */
+	public Tuple formTuple(Object[] values, long[] primitives, byte[] kinds)
+	throws SQLException
+	{
+		return doInPG(() ->
+			_formTuple(this.getNativePointer(), values, primitives, kinds));
 	}
 
 	/**
@@ -159,8 +182,21 @@ public class TupleDesc
 		return doInPG(() -> _getOid(this.getNativePointer(), index));
 	}
 
+	/**
+	 * Returns the {@link TupleDeformer} for tuples of this descriptor, made
+	 * the first time it is needed; call only with the THREADLOCK held.
+	 */
+	TupleDeformer getDeformer()
+	throws SQLException
+	{
+		if ( null == m_deformer )
+			m_deformer = new TupleDeformer(_getLayout(this.getNativePointer()));
+		return m_deformer;
+	}
+
 	private static native String _getColumnName(long _this, int index) throws SQLException;
 	private static native int _getColumnIndex(long _this, String colName) throws SQLException;
-	private static native Tuple _formTuple(long _this, Object[] values) throws SQLException;
+	private static native Tuple _formTuple(long _this, Object[] values, long[] primitives, byte[] kinds) throws SQLException;
 	private static native Oid _getOid(long _this, int index) throws SQLException;
+	private static native int[] _getLayout(long _this);
 }
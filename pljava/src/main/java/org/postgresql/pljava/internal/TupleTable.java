@@ -6,9 +6,18 @@
  */
 package org.postgresql.pljava.internal;
 
+import static org.postgresql.pljava.internal.Backend.doInPG;
+
+import java.sql.SQLException;
+
 /**
  * The <code>SPITupleTable</code> correspons to the internal PostgreSQL
  * <code>SPITupleTable</code> type.
+ *<p>
+ * An instance either holds all of its {@link Tuple}s, converted when it was
+ * created, or (when created lazily by {@link Portal#fetchTable
+ * Portal.fetchTable}) holds on to the native {@code SPITupleTable} and
+ * creates each {@code Tuple} the first time it is asked for.
  *
  * @author Thomas Hallgren
  */
@@ -17,10 +26,52 @@ public class TupleTable
 	private final TupleDesc m_tupleDesc;
 	private final Tuple[] m_tuples;
 
+	/**
+	 * Only non-null for a lazily-converted table.
+	 */
+	private final State m_state;
+
 	TupleTable(TupleDesc tupleDesc, Tuple[] tuples)
 	{
 		m_tupleDesc = tupleDesc;
 		m_tuples = tuples;
+		m_state = null;
+	}
+
+	TupleTable(
+		DualState.Key cookie, long ro, long pointer,
+		TupleDesc tupleDesc, int count)
+	{
+		m_tupleDesc = tupleDesc;
+		m_tuples = new Tuple[count];
+		m_state = new State(cookie, this, ro, pointer);
+	}
+
+	private static class State
+	extends DualState.SingleSPIfreetuptable<TupleTable>
+	{
+		private State(
+			DualState.Key cookie, TupleTable tt, long ro, long spiTupTable)
+		{
+			super(cookie, tt, ro, spiTupTable);
+		}
+
+		/**
+		 * Create the {@code Tuple} at the given index, holding the pin
+		 * throughout.
+		 */
+		private Tuple slot(int position) throws SQLException
+		{
+			pin();
+			try
+			{
+				return _slot(guardedLong(), position);
+			}
+			finally
+			{
+				unpin();
+			}
+		}
 	}
 
 	public final TupleDesc getTupleDesc()
@@ -38,10 +89,28 @@ public class TupleTable
 
 	/**
 	 * Returns the <code>Tuple</code> at the given index.
-	 * @param position Index of desired slot. First slot has index zero. 
+	 * @param position Index of desired slot. First slot has index zero.
+	 * @throws SQLException if the table is lazily converted and its native
+	 * rows are no longer available.
 	 */
-	public final Tuple getSlot(int position)
+	public final Tuple getSlot(int position) throws SQLException
 	{
-		return m_tuples[position];
+		Tuple t = m_tuples[position];
+		if ( null != t  ||  null == m_state )
+			return t;
+		return m_tuples[position] = doInPG(() -> m_state.slot(position));
 	}
+
+	/**
+	 * Release the native rows held by a lazily-converted table. Any
+	 * {@code Tuple}s already obtained from it remain valid.
+	 */
+	public void close()
+	{
+		if ( null != m_state )
+			doInPG(m_state::releaseFromJava);
+	}
+
+	private static native Tuple _slot(long pointer, int position)
+	throws SQLException;
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2019 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -15,6 +15,7 @@ package org.postgresql.pljava.jdbc;
 import java.sql.PreparedStatement;
 import java.sql.SQLException;
 import java.util.ArrayList;
+import java.util.concurrent.Future;
 import java.util.logging.Logger;
 
 import org.postgresql.pljava.internal.Backend;
@@ -55,6 +56,18 @@ public class Invocation
 	 */
 	private PgSavepoint m_savepoint;
 
+	/**
+	 * Work (submitted to the compute pool) to be cancelled if not yet done
+	 * when this invocation exits.
+	 */
+	private ArrayList<Future<?>> m_cancelOnExit;
+
+	/**
+	 * Size {@code m_cancelOnExit} may reach before the work already done is
+	 * removed from it.
+	 */
+	private int m_pruneAt;
+
 	private Invocation(int level)
 	{
 		m_nestingLevel = level;
@@ -84,6 +97,30 @@ public class Invocation
 		m_savepoint = savepoint;
 	}
 
+	/**
+	 * Arrange for a {@code Future} to be cancelled (with interruption) if it
+	 * has not completed by the time this invocation exits.
+	 *<p>
+	 * Work already completed is dropped from the list as it grows, so a
+	 * long-running invocation submitting many tasks does not hold on to them
+	 * all. The list is pruned when it has doubled since it was last pruned,
+	 * keeping the cost per task constant.
+	 */
+	public void cancelOnExit(Future<?> work)
+	{
+		if ( null == m_cancelOnExit )
+		{
+			m_cancelOnExit = new ArrayList<>();
+			m_pruneAt = 16;
+		}
+		else if ( m_cancelOnExit.size() >= m_pruneAt )
+		{
+			m_cancelOnExit.removeIf(Future::isDone);
+			m_pruneAt = Math.max(16, 2 * m_cancelOnExit.size());
+		}
+		m_cancelOnExit.add(work);
+	}
+
 	/**
 	 * Called from the backend when the invokation exits. Should
 	 * not be invoked any other way.
@@ -93,6 +130,12 @@ public class Invocation
 	{
 		try
 		{
+			if ( null != m_cancelOnExit )
+			{
+				for ( Future<?> work : m_cancelOnExit )
+					work.cancel(true);
+				m_cancelOnExit = null;
+			}
 			if(m_savepoint != null)
 				m_savepoint.onInvocationExit(withError);
 		}
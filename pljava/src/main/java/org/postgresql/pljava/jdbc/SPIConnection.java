@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2020 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -383,12 +383,14 @@ public class SPIConnection implements Connection
 	/**
 	 * Creates a new instance of <code>SPIStatement</code>.
 	 * 
+	 *<p>
+	 * With {@link ResultSet#CONCUR_UPDATABLE}, a query that selects from a
+	 * single table produces an updatable result set; any other query produces
+	 * a read-only one, with a warning on the statement.
 	 * @throws SQLException
 	 *
 	 *             if the <code>resultSetType</code> differs from
-	 *             {@link ResultSet#TYPE_FORWARD_ONLY} or if the
-	 *             <code>resultSetConcurrencty</code> differs from
-	 *             {@link ResultSet#CONCUR_READ_ONLY}.
+	 *             {@link ResultSet#TYPE_FORWARD_ONLY}.
 	 */
 	@Override
 	public Statement createStatement(
@@ -399,9 +401,12 @@ public class SPIConnection implements Connection
 		if(resultSetType != ResultSet.TYPE_FORWARD_ONLY)
 			throw new UnsupportedOperationException("TYPE_FORWARD_ONLY supported ResultSet type");
 
-		if(resultSetConcurrency != ResultSet.CONCUR_READ_ONLY)
-			throw new UnsupportedOperationException("CONCUR_READ_ONLY is the supported ResultSet concurrency");
-		return this.createStatement();
+		if(resultSetConcurrency != ResultSet.CONCUR_READ_ONLY
+		&& resultSetConcurrency != ResultSet.CONCUR_UPDATABLE)
+			throw new UnsupportedOperationException("Unknown ResultSet concurrency");
+		if(this.isClosed())
+			throw new SQLException("Connection is closed");
+		return new SPIStatement(this, resultSetConcurrency);
 	}
 
 	/**
@@ -606,10 +611,13 @@ public class SPIConnection implements Connection
 	/**
 	 * Creates a new instance of <code>SPIPreparedStatement</code>.
 	 * 
+	 *<p>
+	 * With {@link ResultSet#CONCUR_UPDATABLE}, a query that selects from a
+	 * single table produces an updatable result set; any other query produces
+	 * a read-only one, with a warning on the statement.
 	 * @throws SQLException
 	 *             if the <code>resultSetType</code> differs from {@link
-	 *             ResultSet#TYPE_FORWARD_ONLY} or if the <code>resultSetConcurrencty</code>
-	 *             differs from {@link ResultSet#CONCUR_READ_ONLY}.
+	 *             ResultSet#TYPE_FORWARD_ONLY}.
 	 */
 	@Override
 	public PreparedStatement prepareStatement(
@@ -621,9 +629,16 @@ public class SPIConnection implements Connection
 		if(resultSetType != ResultSet.TYPE_FORWARD_ONLY)
 			throw new UnsupportedOperationException("TYPE_FORWARD_ONLY supported ResultSet type");
 
-		if(resultSetConcurrency != ResultSet.CONCUR_READ_ONLY)
-			throw new UnsupportedOperationException("CONCUR_READ_ONLY is the supported ResultSet concurrency");
-		return prepareStatement(sql);
+		if(resultSetConcurrency != ResultSet.CONCUR_READ_ONLY
+		&& resultSetConcurrency != ResultSet.CONCUR_UPDATABLE)
+			throw new UnsupportedOperationException("Unknown ResultSet concurrency");
+		if(this.isClosed())
+			throw new SQLException("Connection is closed");
+
+		int[] pcount = new int[] { 0 };
+		sql = this.nativeSQL(sql, pcount);
+		return new SPIPreparedStatement(
+			this, sql, pcount[0], resultSetConcurrency);
 	}
 
 	/**
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2005-2020 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2005-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -2965,8 +2965,9 @@ public class SPIDatabaseMetaData implements DatabaseMetaData
 		if(type != java.sql.ResultSet.TYPE_FORWARD_ONLY)
 			return false;
 
-		// We support only Concur Read Only
-		if(concurrency != java.sql.ResultSet.CONCUR_READ_ONLY)
+		// Updatable only for a select from one table, read-only otherwise
+		if(concurrency != java.sql.ResultSet.CONCUR_READ_ONLY
+		&& concurrency != java.sql.ResultSet.CONCUR_UPDATABLE)
 			return false;
 
 		// Everything else we do
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2020 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -55,9 +55,20 @@ public class SPIPreparedStatement extends SPIStatement implements PreparedStatem
 	private ExecutionPlan  m_plan;
 
 	public SPIPreparedStatement(SPIConnection conn, String statement, int paramCount)
+	throws SQLException
 	{
-		super(conn);
-		m_statement = statement;
+		this(conn, statement, paramCount, ResultSet.CONCUR_READ_ONLY);
+	}
+
+	/**
+	 * Prepare {@code statement} for result sets of the given concurrency.
+	 */
+	public SPIPreparedStatement(
+		SPIConnection conn, String statement, int paramCount, int concurrency)
+	throws SQLException
+	{
+		super(conn, concurrency);
+		m_statement = forConcurrency(statement);
 		m_typeIds   = new Oid[paramCount];
 		m_values    = new Object[paramCount];
 		m_sqlTypes  = new int[paramCount];
@@ -345,8 +356,14 @@ public class SPIPreparedStatement extends SPIStatement implements PreparedStatem
 			if(sqlTypes[idx] == Types.NULL)
 				throw new SQLException("Not all parameters have been set");
 
+		boolean parallel = wantsParallel();
+		if(m_plan != null  &&  m_plan.isParallelCapable() != parallel)
+		{
+			m_plan.close();
+			m_plan = null;
+		}
 		if(m_plan == null)
-			m_plan = ExecutionPlan.prepare(m_statement, m_typeIds);
+			m_plan = ExecutionPlan.prepare(m_statement, m_typeIds, parallel);
 
 		boolean result = executePlan(m_plan, m_values);
 		clearParameters(); // Parameters are cleared upon successful completion.
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2018 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -17,7 +17,6 @@ import java.sql.Statement;
 import java.sql.ResultSetMetaData;
 
 import org.postgresql.pljava.internal.Portal;
-import org.postgresql.pljava.internal.SPI;
 import org.postgresql.pljava.internal.TupleTable;
 import org.postgresql.pljava.internal.Tuple;
 import org.postgresql.pljava.internal.TupleDesc;
@@ -27,6 +26,15 @@ import org.postgresql.pljava.internal.TupleDesc;
  * org.postgresql.pljava.internal.Portal Portal}. At present, only
  * forward positioning is implemented. Attempts to use reverse or
  * absolute positioning will fail.
+ *<p>
+ * Rows are fetched from the portal {@link #getFetchSize} at a time, with a
+ * single call into PostgreSQL per batch. When the setting
+ * {@code pljava.lazy_row_conversion} is on, each row of a batch is converted
+ * for Java only when the result set reaches it.
+ *<p>
+ * A result set made from a statement whose fetch size is zero has no portal:
+ * the query was run to completion (so that it could use a parallel plan), and
+ * all of its rows are held in one {@link TupleTable} from the start.
  *
  * @author Thomas Hallgren
  */
@@ -57,6 +65,19 @@ public class SPIResultSet extends ResultSetBase
 		m_open = true;
 	}
 
+	SPIResultSet(SPIStatement statement, TupleTable table)
+	throws SQLException
+	{
+		super(statement.getFetchSize());
+		m_statement = statement;
+		m_portal = null;
+		m_maxRows = 0;
+		m_tupleDesc = table.getTupleDesc();
+		m_table = table;
+		m_tableRow = -1;
+		m_open = true;
+	}
+
 	@Override
 	public void close()
 	throws SQLException
@@ -64,8 +85,11 @@ public class SPIResultSet extends ResultSetBase
 		if(m_open)
 		{
 			m_open = false;
-			m_portal.close();
+			if(m_portal != null)
+				m_portal.close();
 			m_statement.resultSetClosed(this);
+			if(m_table != null)
+				m_table.close();
 			m_table      = null;
 			m_tableRow   = -1;
 			m_currentRow = null;
@@ -94,13 +118,14 @@ public class SPIResultSet extends ResultSetBase
 	/**
 	 * This method does return the name of the portal, but beware of attempting
 	 * positioned update/delete, because rows are read from the portal in
-	 * {@link #getFetchSize} batches.
+	 * {@link #getFetchSize} batches. A result set with no portal has no name.
 	 */
 	@Override
 	public String getCursorName()
 	throws SQLException
 	{
-		return this.getPortal().getName();
+		Portal portal = this.getPortal();
+		return null == portal ? null : portal.getName();
 	}
 
 	@Override
@@ -118,7 +143,8 @@ public class SPIResultSet extends ResultSetBase
 	}
 
 	/**
-	 * Return the {@code Portal} associated with this {@code ResultSet}.
+	 * Return the {@code Portal} associated with this {@code ResultSet}, or null
+	 * if all of its rows were fetched at once.
 	 */
 	protected final Portal getPortal()
 	throws SQLException
@@ -138,7 +164,7 @@ public class SPIResultSet extends ResultSetBase
 		if(m_table == null)
 		{
 			Portal portal = this.getPortal();
-			if(portal.isAtEnd())
+			if(portal == null  ||  portal.isAtEnd())
 				return null;
 
 			long mx;
@@ -154,17 +180,8 @@ public class SPIResultSet extends ResultSetBase
 			else
 				mx = fetchSize;
 
-			try
-			{
-				long result = portal.fetch(true, mx);
-				if(result > 0)
-					m_table = SPI.getTupTable(m_tupleDesc);
-				m_tableRow = -1;
-			}
-			finally
-			{
-				SPI.freeTupTable();
-			}
+			m_table = portal.fetchTable(true, mx, m_tupleDesc);
+			m_tableRow = -1;
 		}
 		return m_table;
 	}
@@ -199,6 +216,7 @@ public class SPIResultSet extends ResultSetBase
 			// Current table is exhausted, get the next
 			// one.
 			//
+			table.close();
 			m_table = null;
 			table = this.getTupleTable();
 			if(table == null)
@@ -219,6 +237,14 @@ public class SPIResultSet extends ResultSetBase
 		return this.getCurrentRow().getObject(m_tupleDesc, columnIndex, type);
 	}
 
+	/**
+	 * Return the {@link TupleDesc} of the rows.
+	 */
+	protected final TupleDesc getTupleDesc()
+	{
+		return m_tupleDesc;
+	}
+
 	/**
 	 * Returns an {@link SPIResultSetMetaData} instance.
 	 */
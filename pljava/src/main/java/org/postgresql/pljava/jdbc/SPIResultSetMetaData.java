@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2018 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -29,15 +29,26 @@ public class SPIResultSetMetaData extends AbstractResultSetMetaData
 {
 
 	private final TupleDesc m_tupleDesc;
+	private final int m_columnCount;
 
 	/**
 	 * Constructor.
 	 * @param tupleDesc The descriptor for the ResultSet tuples
 	 */
 	public SPIResultSetMetaData(TupleDesc tupleDesc)
+	{
+		this(tupleDesc, tupleDesc.size());
+	}
+
+	/**
+	 * Constructor for a result set that shows only the first
+	 * {@code columnCount} columns of its tuples.
+	 */
+	SPIResultSetMetaData(TupleDesc tupleDesc, int columnCount)
 	{
 		super();
 		m_tupleDesc = tupleDesc;
+		m_columnCount = columnCount;
 	}
 
     /**
@@ -48,7 +59,7 @@ public class SPIResultSetMetaData extends AbstractResultSetMetaData
      */
     public final int getColumnCount() throws SQLException
 	{
-		return m_tupleDesc.size();
+		return m_columnCount;
 	}
 
     /**
@@ -110,7 +121,7 @@ public class SPIResultSetMetaData extends AbstractResultSetMetaData
      */
     protected final void checkColumnIndex(int column) throws SQLException
 	{
-		if (column < 1 || column > m_tupleDesc.size())
+		if (column < 1 || column > m_columnCount)
 		{
 			throw new SQLException("Invalid column index: " + column);
 		}
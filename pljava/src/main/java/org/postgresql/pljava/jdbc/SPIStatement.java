@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2020 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -25,9 +25,16 @@ import org.postgresql.pljava.internal.ExecutionPlan;
 import org.postgresql.pljava.internal.Portal;
 import org.postgresql.pljava.internal.SPI;
 import org.postgresql.pljava.internal.SPIException;
+import org.postgresql.pljava.internal.TupleTable;
 
 /**
  * Implementation of {@link Statement} for the SPI connection.
+ *<p>
+ * A query that returns rows is ordinarily run through a cursor, and its rows
+ * fetched {@link #getFetchSize} at a time. PostgreSQL will not use a parallel
+ * plan for a query run that way. When the fetch size is set to zero, a query
+ * is instead planned to allow parallelism and run to completion before the
+ * {@code ResultSet} is returned, with all of its rows held in memory.
  * @author Thomas Hallgren
  */
 public class SPIStatement implements Statement, SPIReadOnlyControl
@@ -44,10 +51,26 @@ public class SPIStatement implements Statement, SPIReadOnlyControl
 	private ArrayList<Object> m_batch  = null;
 	private boolean   m_closed         = false;
 	private short     m_readonly_spec  = ExecutionPlan.SPI_READONLY_DEFAULT;
+	private final int m_concurrency;
+	private UpdatableQuery m_updatable = null;
+	private SQLWarning m_warnings      = null;
 
 	public SPIStatement(SPIConnection conn)
+	{
+		this(conn, ResultSet.CONCUR_READ_ONLY);
+	}
+
+	/**
+	 * Construct a statement whose result sets have the given concurrency.
+	 * A query to give a {@link ResultSet#CONCUR_UPDATABLE} result set must be
+	 * a simple select of columns from one table, as described for
+	 * {@link UpdatableQuery}; otherwise, the result set is read-only, and a
+	 * warning is added to the statement.
+	 */
+	public SPIStatement(SPIConnection conn, int concurrency)
 	{
 		m_connection = conn;
+		m_concurrency = concurrency;
 	}
 
 	public void addBatch(String statement)
@@ -73,6 +96,7 @@ public class SPIStatement implements Statement, SPIReadOnlyControl
 	public void clearWarnings()
 	throws SQLException
 	{
+		m_warnings = null;
 	}
 
 	private void clear()
@@ -106,7 +130,8 @@ public class SPIStatement implements Statement, SPIReadOnlyControl
 		this.clear();
 
 		ExecutionPlan plan = ExecutionPlan.prepare(
-			m_connection.nativeSQL(statement), null);
+			forConcurrency(m_connection.nativeSQL(statement)), null,
+			wantsParallel());
 
 		int result = SPI.getResult();
 		if(plan == null)
@@ -129,11 +154,27 @@ public class SPIStatement implements Statement, SPIReadOnlyControl
 		m_resultSet   = null;
 
 		boolean isResultSet = plan.isCursorPlan();
-		if(isResultSet)
+		if(isResultSet  &&  null == m_updatable
+			&&  ResultSet.CONCUR_UPDATABLE == m_concurrency)
+			warnReadOnly();
+		if(isResultSet  &&  plan.isParallelCapable())
+		{
+			TupleTable table = plan.executeTable(
+				paramValues, m_readonly_spec, m_maxRows, null);
+			if(table == null)
+				throw new SQLException("Query produced no result table");
+			m_resultSet = null != m_updatable
+				? new SPIUpdatableResultSet(this, table, m_updatable)
+				: new SPIResultSet(this, table);
+		}
+		else if(isResultSet)
 		{
 			Portal portal = plan.cursorOpen(
 				m_cursorName, paramValues, m_readonly_spec);
-			m_resultSet = new SPIResultSet(this, portal, m_maxRows);
+			m_resultSet = null != m_updatable
+				? new SPIUpdatableResultSet(
+					this, portal, m_maxRows, m_updatable)
+				: new SPIResultSet(this, portal, m_maxRows);
 		}
 		else
 		{
@@ -320,7 +361,7 @@ public class SPIStatement implements Statement, SPIReadOnlyControl
 
 	public int getResultSetConcurrency()
 	{
-		return ResultSet.CONCUR_READ_ONLY;
+		return m_concurrency;
 	}
 
 	public int getResultSetHoldability()
@@ -356,7 +397,7 @@ public class SPIStatement implements Statement, SPIReadOnlyControl
 			throw new SQLException("getWarnings: Statement is closed");
 		}
 
-		return null;
+		return m_warnings;
 	}
 
 	public void setCursorName(String cursorName)
@@ -384,6 +425,10 @@ public class SPIStatement implements Statement, SPIReadOnlyControl
 			throw new UnsupportedFeatureException("Non forward fetch direction");
 	}
 
+	/**
+	 * Set the number of rows fetched at a time from a cursor, or zero to run
+	 * queries to completion, without a cursor, so they can use parallel plans.
+	 */
 	public void setFetchSize(int size)
 	throws SQLException
 	{
@@ -433,6 +478,47 @@ public class SPIStatement implements Statement, SPIReadOnlyControl
 		return ret;
 	}
 
+	/**
+	 * Return the SQL to prepare for {@code sql}: if this statement was made
+	 * for updatable result sets and {@code sql} is recognized as a
+	 * {@link UpdatableQuery}, the query rewritten to return each row's
+	 * {@code ctid}; otherwise {@code sql} unchanged.
+	 */
+	protected String forConcurrency(String sql)
+	throws SQLException
+	{
+		m_updatable = null;
+		if ( ResultSet.CONCUR_UPDATABLE != m_concurrency )
+			return sql;
+		m_updatable = UpdatableQuery.parse(m_connection, sql);
+		return null != m_updatable ? m_updatable.getSQL() : sql;
+	}
+
+	/**
+	 * Add a warning that a result set is read-only though this statement was
+	 * made for updatable ones.
+	 */
+	private void warnReadOnly()
+	{
+		SQLWarning w = new SQLWarning(
+			"Query is not a simple select of columns from one table " +
+			"without inheritance children; its ResultSet is read-only",
+			"01000");
+		if ( null == m_warnings )
+			m_warnings = w;
+		else
+			m_warnings.setNextWarning(w);
+	}
+
+	/**
+	 * Whether a query should be prepared parallel-capable and run to
+	 * completion, because the fetch size is zero.
+	 */
+	protected boolean wantsParallel()
+	{
+		return 0 == m_fetchSize;
+	}
+
 	void resultSetClosed(ResultSet rs)
 	{
 		if(rs == m_resultSet)
@@ -0,0 +1,509 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+package org.postgresql.pljava.jdbc;
+
+import java.sql.PreparedStatement;
+import java.sql.ResultSet;
+import java.sql.ResultSetMetaData;
+import java.sql.SQLException;
+
+import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.BitSet;
+import java.util.LinkedHashMap;
+import java.util.List;
+import java.util.Map;
+
+import org.postgresql.pljava.internal.Portal;
+import org.postgresql.pljava.internal.TupleTable;
+
+/**
+ * An {@link SPIResultSet} over a query recognized by {@link UpdatableQuery},
+ * through which rows of the query's table can be updated, deleted, or
+ * inserted.
+ *<p>
+ * Each row is identified by its {@code ctid}, returned by the rewritten query
+ * in a last column that is not shown. Changes are not made one row at a time:
+ * {@link #updateRow updateRow} and {@link #deleteRow deleteRow} queue them,
+ * and the queue is applied, once it holds {@link #getFetchSize} rows (at most
+ * {@value #MAX_BATCH}), by the next call of {@link #next next}, and by
+ * {@link #close close}. Updates of the same set of columns are applied by one
+ * {@code UPDATE ... FROM (VALUES ...)} statement, and deletes by one
+ * {@code DELETE ... USING (VALUES ...)}, both naming the table {@code ONLY}.
+ * Each column of the result updates the table column it selects, whatever
+ * name it is selected under. A row made on the insert row is inserted at
+ * once by {@link #insertRow insertRow}.
+ *<p>
+ * The changes are made in the same transaction, after the query's snapshot
+ * was taken, so the result set does not see them. If a queued row is not
+ * found when the changes are applied (it was changed by something else since
+ * the query read it), an exception is thrown.
+ */
+public class SPIUpdatableResultSet extends SPIResultSet
+{
+	/**
+	 * Most rows to change with one statement.
+	 */
+	static final int MAX_BATCH = 1000;
+
+	/**
+	 * Most parameters to pass to one statement.
+	 */
+	private static final int MAX_PARAMS = 32767;
+
+	private final UpdatableQuery m_query;
+	private final int m_columnCount;
+	private final int m_batchSize;
+
+	private final Object[] m_values;
+	private final BitSet m_changed = new BitSet();
+
+	private boolean m_rowUpdated;
+	private boolean m_rowDeleted;
+	private boolean m_onInsertRow;
+
+	/*
+	 * The queued update of the current row, the columns it sets, and the list
+	 * it is in, so a further updateRow or deleteRow of the same row can
+	 * replace it.
+	 */
+	private Object[] m_queued;
+	private BitSet m_queuedColumns;
+	private List<Object[]> m_queuedIn;
+
+	private final Map<BitSet,List<Object[]>> m_updates = new LinkedHashMap<>();
+	private final List<Object[]> m_deletes = new ArrayList<>();
+	private int m_pending;
+
+	SPIUpdatableResultSet(
+		SPIStatement statement, Portal portal, long maxRows,
+		UpdatableQuery query)
+	throws SQLException
+	{
+		super(statement, portal, maxRows);
+		m_query = query;
+		m_columnCount = getTupleDesc().size() - 1;
+		m_values = new Object [ m_columnCount ];
+		m_batchSize = batchSize(getFetchSize());
+	}
+
+	SPIUpdatableResultSet(
+		SPIStatement statement, TupleTable table, UpdatableQuery query)
+	throws SQLException
+	{
+		super(statement, table);
+		m_query = query;
+		m_columnCount = getTupleDesc().size() - 1;
+		m_values = new Object [ m_columnCount ];
+		m_batchSize = batchSize(getFetchSize());
+	}
+
+	private static int batchSize(int fetchSize)
+	{
+		return 0 < fetchSize ? Math.min(fetchSize, MAX_BATCH) : MAX_BATCH;
+	}
+
+	/**
+	 * Returns {@link ResultSet#CONCUR_UPDATABLE}.
+	 */
+	@Override
+	public int getConcurrency()
+	throws SQLException
+	{
+		return ResultSet.CONCUR_UPDATABLE;
+	}
+
+	/**
+	 * Applies the queued changes if there are enough of them, then moves to
+	 * the next row.
+	 */
+	@Override
+	public boolean next()
+	throws SQLException
+	{
+		if ( m_pending >= m_batchSize )
+			applyChanges();
+		m_changed.clear();
+		Arrays.fill(m_values, null);
+		m_rowUpdated = false;
+		m_rowDeleted = false;
+		m_onInsertRow = false;
+		m_queued = null;
+		m_queuedColumns = null;
+		m_queuedIn = null;
+		return super.next();
+	}
+
+	/**
+	 * Applies any queued changes, then closes the result set.
+	 */
+	@Override
+	public void close()
+	throws SQLException
+	{
+		try
+		{
+			applyChanges();
+		}
+		finally
+		{
+			super.close();
+		}
+	}
+
+	/**
+	 * Returns an {@link SPIResultSetMetaData} that does not show the column
+	 * added for the {@code ctid}.
+	 */
+	@Override
+	public ResultSetMetaData getMetaData()
+	throws SQLException
+	{
+		return new SPIResultSetMetaData(getTupleDesc(), m_columnCount);
+	}
+
+	@Override // defined in ObjectResultSet
+	protected Object getObjectValue(int columnIndex, Class<?> type)
+	throws SQLException
+	{
+		checkColumn(columnIndex);
+		if ( m_onInsertRow )
+			throw new SQLException("Cannot read values on the insert row");
+		return super.getObjectValue(columnIndex, type);
+	}
+
+	/**
+	 * Records a new value for the column in the current row, to be queued by
+	 * {@link #updateRow updateRow}, or on the insert row, to be inserted by
+	 * {@link #insertRow insertRow}.
+	 */
+	@Override
+	public void updateObject(int columnIndex, Object x)
+	throws SQLException
+	{
+		checkColumn(columnIndex);
+		if ( ! m_onInsertRow )
+		{
+			if ( m_rowDeleted )
+				throw new SQLException("Row has been deleted");
+			getCurrentRow(); // throws if not positioned on a row
+		}
+		m_values[columnIndex - 1] = x;
+		m_changed.set(columnIndex - 1);
+	}
+
+	/**
+	 * The scale is not used; calls {@link #updateObject(int,Object)}.
+	 */
+	@Override
+	public void updateObject(int columnIndex, Object x, int scale)
+	throws SQLException
+	{
+		updateObject(columnIndex, x);
+	}
+
+	/**
+	 * Forgets values given since the last {@link #updateRow updateRow}.
+	 */
+	@Override
+	public void cancelRowUpdates()
+	throws SQLException
+	{
+		m_changed.clear();
+		Arrays.fill(m_values, null);
+	}
+
+	/**
+	 * Queues an update of the current row with the values given; if the row
+	 * already has an update queued, the two are combined.
+	 */
+	@Override
+	public void updateRow()
+	throws SQLException
+	{
+		checkNotOnInsertRow();
+		if ( m_rowDeleted )
+			throw new SQLException("Row has been deleted");
+		if ( m_changed.isEmpty() )
+			return;
+
+		BitSet columns = (BitSet)m_changed.clone();
+		Object[] prior = m_queued;
+		BitSet priorColumns = m_queuedColumns;
+		if ( null != prior )
+		{
+			columns.or(priorColumns);
+			unqueue();
+		}
+
+		Object[] entry = new Object [ 1 + columns.cardinality() ];
+		entry[0] = ctid();
+		int k = 1;
+		for ( int c = columns.nextSetBit(0); c >= 0;
+			c = columns.nextSetBit(c + 1) )
+		{
+			entry[k++] = m_changed.get(c)
+				? m_values[c]
+				: prior[1 + priorColumns.get(0, c).cardinality()];
+		}
+
+		List<Object[]> list =
+			m_updates.computeIfAbsent(columns, b -> new ArrayList<>());
+		list.add(entry);
+		++ m_pending;
+		m_queued = entry;
+		m_queuedColumns = columns;
+		m_queuedIn = list;
+		m_rowUpdated = true;
+		cancelRowUpdates();
+	}
+
+	/**
+	 * Queues a delete of the current row, in place of any update queued
+	 * for it.
+	 */
+	@Override
+	public void deleteRow()
+	throws SQLException
+	{
+		checkNotOnInsertRow();
+		if ( m_rowDeleted )
+			throw new SQLException("Row has been deleted");
+		Object[] entry = new Object[] { ctid() };
+		unqueue();
+		m_deletes.add(entry);
+		++ m_pending;
+		m_rowDeleted = true;
+		cancelRowUpdates();
+	}
+
+	@Override
+	public boolean rowUpdated()
+	throws SQLException
+	{
+		return m_rowUpdated;
+	}
+
+	@Override
+	public boolean rowDeleted()
+	throws SQLException
+	{
+		return m_rowDeleted;
+	}
+
+	/**
+	 * Moves to the insert row, where values given are kept for
+	 * {@link #insertRow insertRow}, and cannot be read back.
+	 */
+	@Override
+	public void moveToInsertRow()
+	throws SQLException
+	{
+		cancelRowUpdates();
+		m_onInsertRow = true;
+	}
+
+	/**
+	 * Moves back from the insert row to the current row.
+	 */
+	@Override
+	public void moveToCurrentRow()
+	throws SQLException
+	{
+		if ( ! m_onInsertRow )
+			return;
+		cancelRowUpdates();
+		m_onInsertRow = false;
+	}
+
+	/**
+	 * Inserts a row of the values given on the insert row into the table,
+	 * with defaults for the columns not given.
+	 */
+	@Override
+	public void insertRow()
+	throws SQLException
+	{
+		if ( ! m_onInsertRow )
+			throw new SQLException("ResultSet is not on the insert row");
+
+		int[] cols = m_changed.stream().toArray();
+		StringBuilder sql =
+			new StringBuilder("INSERT INTO ONLY ").append(m_query.getTable());
+		if ( 0 == cols.length )
+			sql.append(" DEFAULT VALUES");
+		else
+		{
+			StringBuilder values = new StringBuilder();
+			sql.append(" (");
+			for ( int k = 0 ; k < cols.length ; ++ k )
+			{
+				if ( 0 < k )
+				{
+					sql.append(", ");
+					values.append(", ");
+				}
+				sql.append(m_query.getColumn(cols[k] + 1));
+				values.append("CAST(? AS ")
+					.append(m_query.getTypeName(cols[k] + 1)).append(')');
+			}
+			sql.append(") VALUES (").append(values).append(')');
+		}
+
+		try ( PreparedStatement ps =
+			getStatement().getConnection().prepareStatement(sql.toString()) )
+		{
+			for ( int k = 0 ; k < cols.length ; ++ k )
+				ps.setObject(1 + k, m_values[cols[k]]);
+			ps.executeUpdate();
+		}
+		cancelRowUpdates();
+	}
+
+	private void checkColumn(int columnIndex)
+	throws SQLException
+	{
+		if ( columnIndex < 1  ||  columnIndex > m_columnCount )
+			throw new SQLException("Invalid column index: " + columnIndex);
+	}
+
+	private void checkNotOnInsertRow()
+	throws SQLException
+	{
+		if ( m_onInsertRow )
+			throw new SQLException("ResultSet is on the insert row");
+	}
+
+	private String ctid()
+	throws SQLException
+	{
+		return (String)
+			super.getObjectValue(m_columnCount + 1, String.class);
+	}
+
+	private void unqueue()
+	{
+		if ( null == m_queued )
+			return;
+		m_queuedIn.remove(m_queued);
+		-- m_pending;
+		m_queued = null;
+		m_queuedColumns = null;
+		m_queuedIn = null;
+	}
+
+	/**
+	 * Applies all queued changes.
+	 */
+	private void applyChanges()
+	throws SQLException
+	{
+		if ( 0 == m_pending )
+			return;
+		try
+		{
+			for ( Map.Entry<BitSet,List<Object[]>> e : m_updates.entrySet() )
+				applyUpdates(e.getKey(), e.getValue());
+			apply(m_deletes, null);
+		}
+		finally
+		{
+			m_updates.clear();
+			m_deletes.clear();
+			m_pending = 0;
+			m_queued = null;
+			m_queuedColumns = null;
+			m_queuedIn = null;
+		}
+	}
+
+	private void applyUpdates(BitSet columns, List<Object[]> rows)
+	throws SQLException
+	{
+		int[] cols = columns.stream().toArray();
+		StringBuilder set = new StringBuilder();
+		StringBuilder casts = new StringBuilder();
+		StringBuilder names = new StringBuilder("\"ctid\"");
+		for ( int k = 0 ; k < cols.length ; ++ k )
+		{
+			if ( 0 < k )
+				set.append(", ");
+			set.append(m_query.getColumn(cols[k] + 1))
+				.append(" = \"pljava_v\".\"c").append(k).append('"');
+			casts.append(", CAST(? AS ")
+				.append(m_query.getTypeName(cols[k] + 1)).append(')');
+			names.append(", \"c").append(k).append('"');
+		}
+		apply(rows, new String[] { set.toString(), casts.toString(),
+			names.toString() });
+	}
+
+	/**
+	 * Applies the changes in {@code rows}: deletes if {@code update} is null,
+	 * otherwise updates, given the SET list, the casts of the values in each
+	 * VALUES row after the {@code ctid}, and the VALUES column names.
+	 */
+	private void apply(List<Object[]> rows, String[] update)
+	throws SQLException
+	{
+		if ( rows.isEmpty() )
+			return;
+		int width = rows.get(0).length;
+		int perStatement =
+			Math.max(1, Math.min(m_batchSize, MAX_PARAMS / width));
+
+		for ( int from = 0 ; from < rows.size() ; from += perStatement )
+		{
+			List<Object[]> chunk =
+				rows.subList(from, Math.min(rows.size(), from + perStatement));
+			StringBuilder values = new StringBuilder();
+			for ( int r = 0 ; r < chunk.size() ; ++ r )
+			{
+				if ( 0 < r )
+					values.append(", ");
+				values.append("(CAST(? AS pg_catalog.tid)");
+				if ( null != update )
+					values.append(update[1]);
+				values.append(')');
+			}
+
+			String sql = null == update
+				? "DELETE FROM ONLY " + m_query.getTable() +
+					" AS \"pljava_t\"" +
+					" USING (VALUES " + values + ") AS \"pljava_v\"(\"ctid\")" +
+					" WHERE \"pljava_t\".ctid" +
+					" OPERATOR(pg_catalog.=) \"pljava_v\".\"ctid\""
+				: "UPDATE ONLY " + m_query.getTable() + " AS \"pljava_t\"" +
+					" SET " + update[0] +
+					" FROM (VALUES " + values + ") AS \"pljava_v\"(" +
+					update[2] + ")" +
+					" WHERE \"pljava_t\".ctid" +
+					" OPERATOR(pg_catalog.=) \"pljava_v\".\"ctid\"";
+
+			int changed;
+			try ( PreparedStatement ps =
+				getStatement().getConnection().prepareStatement(sql) )
+			{
+				int p = 0;
+				for ( Object[] row : chunk )
+					for ( Object v : row )
+						ps.setObject(++ p, v);
+				changed = ps.executeUpdate();
+			}
+			if ( changed != chunk.size() )
+				throw new SQLException(String.format(
+					"%d of %d rows to %s were not found; they may have been " +
+					"changed since they were read", chunk.size() - changed,
+					chunk.size(), null == update ? "delete" : "update"));
+		}
+	}
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2019 TADA AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 TADA AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -46,6 +46,8 @@ import java.sql.Struct;
 import java.sql.Time;
 import java.sql.Timestamp;
 
+import org.postgresql.pljava.internal.ForeignDowncalls;
+
 import static org.postgresql.pljava.internal.Backend.doInPG;
 
 /**
@@ -490,6 +492,10 @@ public class SQLOutputToChunk implements SQLOutput
 		{
 			if(m_handle == 0)
 				throw new SQLException("Stream is closed");
+			if ( ForeignDowncalls.enabled()
+				&& ForeignDowncalls.stringInfoTrySetLength(
+					m_handle, m_bb.position(), c) )
+				return;
 			ByteBuffer oldbb = m_bb;
 			m_bb = _ensureCapacity(m_handle, m_bb, m_bb.position(), c);
 			if ( m_bb != oldbb )
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2018-2021 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2018-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -175,6 +175,7 @@ import org.xml.sax.SAXParseException;
 
 import org.postgresql.pljava.internal.VarlenaXMLRenderer;
 import static org.postgresql.pljava.jdbc.TypeOid.PG_NODE_TREEOID;
+import static org.postgresql.pljava.jdbc.TypeOid.XMLOID;
 
 /**
  * Implementation of {@link SQLXML} for the SPI connection.
@@ -970,6 +971,11 @@ public abstract class SQLXMLImpl<V extends VarlenaWrapper> implements SQLXML
 			 * the verification is noticeably slower than not doing it, but that
 			 * fast case has to be reserved for when there is no funny business
 			 * with the PostgreSQL types.
+			 *<p>
+			 * The one exception is an instance created from the XML type
+			 * itself: its content was already checked by PostgreSQL, so there
+			 * is nothing to gain by parsing it again, whatever type it is now
+			 * being adopted as.
 			 */
 			@Override
 			protected VarlenaWrapper adopt(int oid) throws SQLException
@@ -981,7 +987,7 @@ public abstract class SQLXMLImpl<V extends VarlenaWrapper> implements SQLXML
 						"SQLXML object has already been read from", "55000");
 				if ( null == vw )
 					backingIfNotFreed(); /* shorthand to throw the exception */
-				if ( m_pgTypeID != oid )
+				if ( m_pgTypeID != oid  &&  XMLOID != m_pgTypeID )
 					vw.verify(new Verifier());
 				return vw;
 			}
@@ -1012,6 +1018,25 @@ public abstract class SQLXMLImpl<V extends VarlenaWrapper> implements SQLXML
 				return new InputStreamReader(is, m_serverCS.newDecoder());
 			}
 
+			/**
+			 * {@inheritDoc}
+			 *<p>
+			 * If this instance was created from the XML type, the result is a
+			 * {@link WellFormedStreamSource WellFormedStreamSource}, allowing
+			 * a copy made from it by {@code Adjusting.XML.SourceResult} to
+			 * skip verification.
+			 */
+			@Override
+			protected StreamSource toStreamSource(
+				VarlenaWrapper.Input.Stream backing)
+			throws SQLException, IOException
+			{
+				InputStream is = toBinaryStream(backing, true);
+				if ( XMLOID == m_pgTypeID )
+					return new WellFormedStreamSource(is);
+				return new StreamSource(is);
+			}
+
 			@Override
 			protected Adjusting.XML.SAXSource toSAXSource(
 				VarlenaWrapper.Input.Stream backing)
@@ -1500,6 +1525,22 @@ public abstract class SQLXMLImpl<V extends VarlenaWrapper> implements SQLXML
 		}
 	}
 
+	/**
+	 * A {@code StreamSource} over content PostgreSQL has already checked to be
+	 * well-formed XML, as presented by a readable instance of the XML type.
+	 *<p>
+	 * When it is copied unchanged into a {@code Writable} (that is, with no
+	 * transcoding and no parser adjustments requested), there is no need to
+	 * verify the copy.
+	 */
+	static class WellFormedStreamSource extends StreamSource
+	{
+		WellFormedStreamSource(InputStream is)
+		{
+			super(is);
+		}
+	}
+
 	static class Verifier extends VarlenaWrapper.Verifier.Base
 	{
 		private XMLReader m_xr;
@@ -3783,6 +3824,20 @@ public abstract class SQLXMLImpl<V extends VarlenaWrapper> implements SQLXML
 				return this;
 			}
 
+			/**
+			 * Note that the source content is known to be well-formed, so it
+			 * need not be verified unless parser adjustments are made.
+			 *<p>
+			 * Only meaningful for {@code Direct} itself; a transcoded copy is
+			 * still verified.
+			 */
+			Direct trustSource()
+			{
+				if ( Direct.class == getClass() )
+					m_asr.trustContent();
+				return this;
+			}
+
 			@Override
 			Writable finish() throws IOException, SQLException
 			{
@@ -4434,6 +4489,9 @@ public abstract class SQLXMLImpl<V extends VarlenaWrapper> implements SQLXML
 					m_copier = XMLCopier
 						.copierFor(m_result, m_serverCS, probedEncoding)
 						.prepare(probe, is);
+					if ( source instanceof WellFormedStreamSource
+						&& m_copier instanceof XMLCopier.Direct )
+						((XMLCopier.Direct)m_copier).trustSource();
 				}
 				else if ( null != r )
 				{
@@ -4666,6 +4724,7 @@ public abstract class SQLXMLImpl<V extends VarlenaWrapper> implements SQLXML
 		private AdjustingSAXSource m_verifierSource;
 		private boolean m_preferWriter = false;
 		private boolean m_hasCalledDefaults;
+		private boolean m_trusted;
 
 		AdjustingStreamResult(VarlenaWrapper.Output vwo, Charset serverCS)
 		throws SQLException
@@ -4725,6 +4784,17 @@ public abstract class SQLXMLImpl<V extends VarlenaWrapper> implements SQLXML
 			return m_verifierSource;
 		}
 
+		/**
+		 * Note that the content to be written is known to be well-formed, so
+		 * {@code get()} can use the {@code NoOp} verifier, provided no parser
+		 * adjustments have been made by then.
+		 */
+		void trustContent()
+		{
+			theVerifierSource(false); // shorthand error check
+			m_trusted = true;
+		}
+
 		@Override
 		public AdjustingStreamResult preferBinaryStream()
 		{
@@ -4748,11 +4818,15 @@ public abstract class SQLXMLImpl<V extends VarlenaWrapper> implements SQLXML
 				throw new IllegalStateException(
 					"AdjustingStreamResult get() called more than once");
 
-			XMLReader xr = theVerifierSource().get().getXMLReader();
+			boolean trusted = m_trusted  &&  m_verifierSource.isUnadjusted();
 			OutputStream os;
 			try
 			{
-				m_vwo.setVerifier(new Verifier(xr));
+				if ( trusted )
+					m_vwo.setVerifier(VarlenaWrapper.Verifier.NoOp.INSTANCE);
+				else
+					m_vwo.setVerifier(new Verifier(
+						theVerifierSource().get().getXMLReader()));
 				os = new DeclCheckedOutputStream(m_vwo, m_serverCS);
 			}
 			catch ( IOException e )
@@ -5001,6 +5075,16 @@ public abstract class SQLXMLImpl<V extends VarlenaWrapper> implements SQLXML
 			return ss;
 		}
 
+		/**
+		 * True if no adjustment at all (not even {@code defaults()}) has been
+		 * made to this source.
+		 */
+		boolean isUnadjusted()
+		{
+			return null != m_spf  &&  ! m_hasCalledDefaults
+				&&  null == m_spf.getSchema();
+		}
+
 		@Override
 		public AdjustingSAXSource defaults()
 		{
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2020 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  * Copyright (c) 2010, 2011 PostgreSQL Global Development Group
  *
  * All rights reserved. This program and the accompanying materials
@@ -31,6 +31,16 @@ import org.postgresql.pljava.internal.TupleDesc;
  * A {@link TupleDesc} must be passed to the constructor. After values have
  * been written, the native pointer to a formed {@link Tuple} can be retrieved
  * using {@link #getTupleAndClear}.
+ *<p>
+ * Values written with {@code updateBoolean}, {@code updateShort},
+ * {@code updateInt}, {@code updateLong}, {@code updateFloat}, or
+ * {@code updateDouble} into a column whose type maps to the corresponding
+ * boxed Java type (or a wider one, where the widening is exact) are not boxed;
+ * they are kept in a primitive array that is copied to native code in bulk,
+ * once per row, when the tuple is formed. For set-returning functions, one
+ * writer is created per result set and reused for every row, so a
+ * {@code ResultSetProvider} that sets only such columns allocates no object
+ * per cell.
  *
  * @author Thomas Hallgren
  */
@@ -40,6 +50,22 @@ public class SingleRowWriter extends SingleRowResultSet
 	private final Object[] m_values;
 	private Tuple m_tuple;
 
+	/*
+	 * Values stored by the primitive updaters, as the raw bits of the value
+	 * converted to the column's type, and, for each column, the JNI signature
+	 * character of the kind of value stored there (0 if the column's value,
+	 * if any, is in m_values instead). Native code consults these in bulk.
+	 */
+	private final long[] m_primitives;
+	private final byte[] m_kinds;
+
+	/*
+	 * For each column, the JNI signature character of the primitive type whose
+	 * boxed form is the column's Java class, or 0 if it has none. Computed on
+	 * first use of a primitive updater.
+	 */
+	private byte[] m_columnKinds;
+
 	/**
 	 * Construct a {@code SingleRowWriter} given a descriptor of the tuple
 	 * structure it should produce.
@@ -49,6 +75,8 @@ public class SingleRowWriter extends SingleRowResultSet
 	{
 		m_tupleDesc = tupleDesc;
 		m_values = new Object[tupleDesc.size()];
+		m_primitives = new long[m_values.length];
+		m_kinds = new byte[m_values.length];
 	}
 
 	/**
@@ -61,7 +89,18 @@ public class SingleRowWriter extends SingleRowResultSet
 	{
 		if(columnIndex < 1)
 			throw new SQLException("System columns cannot be obtained from this type of ResultSet");
-		return m_values[columnIndex - 1];
+		int idx = columnIndex - 1;
+		long bits = m_primitives[idx];
+		switch ( m_kinds[idx] )
+		{
+		case 'Z': return 0L != bits;
+		case 'S': return (short)bits;
+		case 'I': return (int)bits;
+		case 'J': return bits;
+		case 'F': return Float.intBitsToFloat((int)bits);
+		case 'D': return Double.longBitsToDouble(bits);
+		default:  return m_values[idx];
+		}
 	}
 
 	/**
@@ -74,11 +113,142 @@ public class SingleRowWriter extends SingleRowResultSet
 	{
 		int top = m_values.length;
 		while(--top >= 0)
-			if(m_values[top] != null)
+			if(m_values[top] != null || m_kinds[top] != 0)
 				return true;
 		return false;
 	}
 
+	/**
+	 * Stores the value without boxing if the column's type is {@code boolean}.
+	 */
+	@Override
+	public void updateBoolean(int columnIndex, boolean x)
+	throws SQLException
+	{
+		if ( 'Z' == columnKind(columnIndex) )
+			putPrimitive(columnIndex, 'Z', x ? 1L : 0L);
+		else
+			super.updateBoolean(columnIndex, x);
+	}
+
+	/**
+	 * Stores the value without boxing if the column's type is {@code int2},
+	 * {@code int4}, or {@code int8}.
+	 */
+	@Override
+	public void updateShort(int columnIndex, short x)
+	throws SQLException
+	{
+		byte kind = columnKind(columnIndex);
+		if ( 'S' == kind  ||  'I' == kind  ||  'J' == kind )
+			putPrimitive(columnIndex, kind, x);
+		else
+			super.updateShort(columnIndex, x);
+	}
+
+	/**
+	 * Stores the value without boxing if the column's type is {@code int4},
+	 * {@code int8}, or {@code float8}.
+	 */
+	@Override
+	public void updateInt(int columnIndex, int x)
+	throws SQLException
+	{
+		byte kind = columnKind(columnIndex);
+		switch ( kind )
+		{
+		case 'I':
+		case 'J':
+			putPrimitive(columnIndex, kind, x);
+			break;
+		case 'D':
+			putPrimitive(columnIndex, 'D', Double.doubleToRawLongBits(x));
+			break;
+		default:
+			super.updateInt(columnIndex, x);
+		}
+	}
+
+	/**
+	 * Stores the value without boxing if the column's type is {@code int8}.
+	 */
+	@Override
+	public void updateLong(int columnIndex, long x)
+	throws SQLException
+	{
+		if ( 'J' == columnKind(columnIndex) )
+			putPrimitive(columnIndex, 'J', x);
+		else
+			super.updateLong(columnIndex, x);
+	}
+
+	/**
+	 * Stores the value without boxing if the column's type is {@code float4}
+	 * or {@code float8}.
+	 */
+	@Override
+	public void updateFloat(int columnIndex, float x)
+	throws SQLException
+	{
+		switch ( columnKind(columnIndex) )
+		{
+		case 'F':
+			putPrimitive(columnIndex, 'F', Float.floatToRawIntBits(x));
+			break;
+		case 'D':
+			putPrimitive(columnIndex, 'D', Double.doubleToRawLongBits(x));
+			break;
+		default:
+			super.updateFloat(columnIndex, x);
+		}
+	}
+
+	/**
+	 * Stores the value without boxing if the column's type is {@code float8}.
+	 */
+	@Override
+	public void updateDouble(int columnIndex, double x)
+	throws SQLException
+	{
+		if ( 'D' == columnKind(columnIndex) )
+			putPrimitive(columnIndex, 'D', Double.doubleToRawLongBits(x));
+		else
+			super.updateDouble(columnIndex, x);
+	}
+
+	private void putPrimitive(int columnIndex, byte kind, long bits)
+	{
+		int idx = columnIndex - 1;
+		m_primitives[idx] = bits;
+		m_kinds[idx] = kind;
+		m_values[idx] = null;
+	}
+
+	private byte columnKind(int columnIndex)
+	throws SQLException
+	{
+		if(columnIndex < 1)
+			throw new SQLException("System columns cannot be updated");
+
+		if ( null == m_columnKinds )
+		{
+			byte[] kinds = new byte[m_values.length];
+			for ( int idx = 0; idx < kinds.length; ++ idx )
+			{
+				Class<?> c = m_tupleDesc.getColumnClass(idx + 1);
+				kinds[idx] =
+					Boolean.class == c ? (byte)'Z' :
+					Short.class   == c ? (byte)'S' :
+					Integer.class == c ? (byte)'I' :
+					Long.class    == c ? (byte)'J' :
+					Float.class   == c ? (byte)'F' :
+					Double.class  == c ? (byte)'D' : 0;
+			}
+			m_columnKinds = kinds;
+		}
+		return m_columnKinds[columnIndex - 1];
+	}
+
 	@Override
 	public void updateObject(int columnIndex, Object x)
 	throws SQLException
@@ -86,6 +256,8 @@ public class SingleRowWriter extends SingleRowResultSet
 		if(columnIndex < 1)
 			throw new SQLException("System columns cannot be updated");
 
+		m_kinds[columnIndex-1] = 0;
+
 		if(x == null)
 			m_values[columnIndex-1] = x;
 
@@ -112,6 +284,7 @@ public class SingleRowWriter extends SingleRowResultSet
 	throws SQLException
 	{
 		Arrays.fill(m_values, null);
+		Arrays.fill(m_kinds, (byte)0);
 	}
 
 	/**
@@ -122,6 +295,7 @@ public class SingleRowWriter extends SingleRowResultSet
 	throws SQLException
 	{
 		Arrays.fill(m_values, null);
+		Arrays.fill(m_kinds, (byte)0);
 		m_tuple = null;	// Feel free to garbage collect...
 	}
 
@@ -150,8 +324,10 @@ public class SingleRowWriter extends SingleRowResultSet
 		// another tuple. This behavior is connected to the internal behavior
 		// of Set Returning Functions (SRF) in the backend.
 		//
-		m_tuple = this.getTupleDesc().formTuple(m_values);
+		m_tuple = this.getTupleDesc().formTuple(
+			m_values, m_primitives, m_kinds);
 		Arrays.fill(m_values, null);
+		Arrays.fill(m_kinds, (byte)0);
 		return m_tuple.getNativePointer();
 	}
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2021 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -75,6 +75,10 @@ public class TypeOid
 	 * Likewise in 2020.
 	 */
 	public static final int TRIGGEROID = 2279;
+	/*
+	 * Likewise in 2026.
+	 */
+	public static final int XMLOID = 142;
 
 	/*
 	 * Before Java 8 with the @Native annotation, a class needs at least one
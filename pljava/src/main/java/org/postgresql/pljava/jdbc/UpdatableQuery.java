@@ -0,0 +1,255 @@
+/*
+ * Copyright (c) 2026 Tada AB and other contributors, as listed below.
+ *
+ * All rights reserved. This program and the accompanying materials
+ * are made available under the terms of the The BSD 3-Clause License
+ * which accompanies this distribution, and is available at
+ * http://opensource.org/licenses/BSD-3-Clause
+ *
+ * Contributors:
+ *   Tada AB
+ */
+package org.postgresql.pljava.jdbc;
+
+import java.sql.Connection;
+import java.sql.PreparedStatement;
+import java.sql.ResultSet;
+import java.sql.SQLException;
+
+import java.util.ArrayList;
+import java.util.LinkedHashMap;
+import java.util.List;
+import java.util.Locale;
+import java.util.Map;
+
+import static java.util.regex.Pattern.CASE_INSENSITIVE;
+import static java.util.regex.Pattern.DOTALL;
+
+import java.util.regex.Matcher;
+import java.util.regex.Pattern;
+
+/**
+ * A query recognized as selecting columns of a single table, rewritten to
+ * also return each row's {@code ctid} (as text, in a last column the result
+ * set hides) so that a {@link SPIUpdatableResultSet} can update or delete the
+ * row, with each column of the result mapped to the table column it is.
+ *<p>
+ * The form of the query is recognized by pattern: it must be
+ * {@code SELECT} <em>columns</em> {@code FROM} [{@code ONLY}] <em>table</em>,
+ * with an optional alias, followed by nothing, or by {@code WHERE},
+ * {@code ORDER BY}, {@code LIMIT}, {@code OFFSET}, {@code FETCH}, or
+ * {@code FOR UPDATE} clauses. Each of the <em>columns</em> must be {@code *},
+ * or the name of a column of the table, optionally qualified by the table
+ * name or alias and optionally renamed. Any expression in the select list, or
+ * a join, set operation, grouping, {@code DISTINCT}, or call of a common
+ * aggregate, keeps a query from being recognized.
+ *<p>
+ * Whether the table can be updated is then decided from the catalog: it must
+ * be an ordinary table, not a view, foreign or partitioned table, and must not
+ * have inheritance children, so that changing it {@code ONLY} changes every
+ * row the query could have returned.
+ */
+final class UpdatableQuery
+{
+	private static final String IDENT =
+		"(?:\"(?:[^\"]|\"\")+\"|[\\p{L}_][\\w$]*)";
+	private static final String CLAUSE =
+		"(?:WHERE|ORDER|LIMIT|OFFSET|FETCH|FOR)\\b";
+
+	private static final Pattern s_simpleSelect = Pattern.compile(
+		"^\\s*SELECT\\s+(?<cols>.+?)\\s+FROM\\s+(?:ONLY\\s+)?" +
+		"(?<table>(?:" + IDENT + "\\s*\\.\\s*)?(?<rel>" + IDENT + "))" +
+		"(?:\\s+(?:AS\\s+)?(?!" + CLAUSE + ")(?<alias>" + IDENT + "))?" +
+		"(?<rest>\\s+" + CLAUSE + ".*?)?\\s*;?\\s*$",
+		CASE_INSENSITIVE | DOTALL);
+
+	private static final Pattern s_selectItem = Pattern.compile(
+		"\\G\\s*(?:(?<qual>" + IDENT + ")\\s*\\.\\s*)?" +
+		"(?:(?<star>\\*)|(?<col>" + IDENT + ")" +
+		"(?:\\s+(?:AS\\s+)?" + IDENT + ")?)\\s*(?:,|\\z)",
+		CASE_INSENSITIVE);
+
+	private static final Pattern s_disqualifying = Pattern.compile(
+		"\\b(?:JOIN|UNION|INTERSECT|EXCEPT|GROUP|HAVING|DISTINCT|WINDOW|" +
+		"OVER|COUNT|SUM|AVG|MIN|MAX|ARRAY_AGG|STRING_AGG|BOOL_AND|BOOL_OR|" +
+		"EVERY)\\b",
+		CASE_INSENSITIVE);
+
+	/*
+	 * Unquoted words that, in a select list, are not column names.
+	 */
+	private static final Pattern s_notColumn = Pattern.compile(
+		"ALL|ARRAY|CASE|CAST|CURRENT_\\w+|DISTINCT|EXISTS|FALSE|LOCALTIME|" +
+		"LOCALTIMESTAMP|NOT|NULL|SESSION_USER|TRUE|USER",
+		CASE_INSENSITIVE);
+
+	private final String m_table;
+	private final String m_sql;
+	private final String[] m_columns;
+	private final String[] m_typeNames;
+
+	private UpdatableQuery(
+		String table, String sql, String[] columns, String[] typeNames)
+	{
+		m_table = table;
+		m_sql = sql;
+		m_columns = columns;
+		m_typeNames = typeNames;
+	}
+
+	/**
+	 * Return an {@code UpdatableQuery} for {@code sql}, or null if it is not
+	 * recognized as a select of columns from one table that can be updated.
+	 *<p>
+	 * The table is looked up in the catalog through {@code conn}; if it does
+	 * not exist, the exception is the one the query itself would raise.
+	 */
+	static UpdatableQuery parse(Connection conn, String sql)
+	throws SQLException
+	{
+		Matcher m = s_simpleSelect.matcher(sql);
+		if ( ! m.matches() )
+			return null;
+		String cols = m.group("cols");
+		String rest = m.group("rest");
+		if ( s_disqualifying.matcher(cols).find() )
+			return null;
+		if ( null != rest  &&  s_disqualifying.matcher(rest).find() )
+			return null;
+
+		String table = m.group("table");
+		String alias = m.group("alias");
+		String qualifier = null != alias ? alias : m.group("rel");
+
+		/*
+		 * Each item of the select list: null for *, else the column name.
+		 */
+		List<String> items = new ArrayList<>();
+		Matcher im = s_selectItem.matcher(cols);
+		for ( int end = 0 ; end < cols.length() ; end = im.end() )
+		{
+			if ( ! im.find() )
+				return null;
+			String qual = im.group("qual");
+			if ( null != qual  &&  ! name(qual).equals(name(qualifier)) )
+				return null;
+			String col = im.group("col");
+			if ( null != col  &&  ! col.startsWith("\"")
+				&&  s_notColumn.matcher(col).matches() )
+				return null;
+			items.add(null == col ? null : name(col));
+		}
+
+		String quotedTable = null;
+		Map<String,String> attributes = new LinkedHashMap<>();
+		try ( PreparedStatement ps = conn.prepareStatement(
+			"SELECT" +
+			"  pg_catalog.quote_ident(n.nspname) OPERATOR(pg_catalog.||)" +
+			"  '.' OPERATOR(pg_catalog.||) pg_catalog.quote_ident(c.relname)," +
+			"  c.relkind, c.relhassubclass, a.attname," +
+			"  pg_catalog.format_type(a.atttypid, a.atttypmod)" +
+			" FROM" +
+			"  pg_catalog.pg_class AS c" +
+			"  JOIN pg_catalog.pg_namespace AS n" +
+			"   ON n.oid OPERATOR(pg_catalog.=) c.relnamespace" +
+			"  JOIN pg_catalog.pg_attribute AS a" +
+			"   ON a.attrelid OPERATOR(pg_catalog.=) c.oid" +
+			" WHERE" +
+			"  c.oid OPERATOR(pg_catalog.=) CAST(? AS pg_catalog.regclass)" +
+			"  AND a.attnum OPERATOR(pg_catalog.>) 0" +
+			"  AND NOT a.attisdropped" +
+			" ORDER BY a.attnum") )
+		{
+			ps.setString(1, table);
+			try ( ResultSet rs = ps.executeQuery() )
+			{
+				while ( rs.next() )
+				{
+					if ( ! "r".equals(rs.getString(2))  ||  rs.getBoolean(3) )
+						return null;
+					quotedTable = rs.getString(1);
+					attributes.put(rs.getString(4), rs.getString(5));
+				}
+			}
+		}
+		if ( null == quotedTable )
+			return null;
+
+		List<String> columns = new ArrayList<>();
+		List<String> typeNames = new ArrayList<>();
+		for ( String item : items )
+		{
+			if ( null == item )
+			{
+				columns.addAll(attributes.keySet());
+				typeNames.addAll(attributes.values());
+				continue;
+			}
+			String typeName = attributes.get(item);
+			if ( null == typeName )
+				return null;
+			columns.add(item);
+			typeNames.add(typeName);
+		}
+
+		String rewritten = sql.substring(0, m.end("cols")) +
+			", CAST(" + qualifier + ".ctid AS pg_catalog.text)" +
+			sql.substring(m.end("cols"));
+		return new UpdatableQuery(quotedTable, rewritten,
+			columns.toArray(new String[0]), typeNames.toArray(new String[0]));
+	}
+
+	/**
+	 * The name an identifier denotes: the text inside the quotes of a quoted
+	 * one, otherwise the identifier folded to lower case.
+	 */
+	private static String name(String identifier)
+	{
+		if ( identifier.startsWith("\"") )
+			return identifier.substring(1, identifier.length() - 1)
+				.replace("\"\"", "\"");
+		return identifier.toLowerCase(Locale.ROOT);
+	}
+
+	/**
+	 * The table, schema-qualified and quoted as needed.
+	 */
+	String getTable()
+	{
+		return m_table;
+	}
+
+	/**
+	 * The query to run, returning the {@code ctid} in an added last column.
+	 */
+	String getSQL()
+	{
+		return m_sql;
+	}
+
+	/**
+	 * The number of columns in the result, not counting the {@code ctid}.
+	 */
+	int getColumnCount()
+	{
+		return m_columns.length;
+	}
+
+	/**
+	 * The name of the table column that a result column is, as an identifier
+	 * quoted for SQL.
+	 */
+	String getColumn(int columnIndex)
+	{
+		return '"' + m_columns[columnIndex - 1].replace("\"", "\"\"") + '"';
+	}
+
+	/**
+	 * The SQL type, with any modifier, of the table column that a result
+	 * column is.
+	 */
+	String getTypeName(int columnIndex)
+	{
+		return m_typeNames[columnIndex - 1];
+	}
+}
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2021 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -18,12 +18,19 @@ import java.io.ByteArrayOutputStream;
 import java.io.IOException;
 import java.io.InputStream;
 import java.io.InputStreamReader;
+import java.lang.management.ClassLoadingMXBean;
+import java.lang.management.CompilationMXBean;
+import java.lang.management.ManagementFactory;
+import java.lang.management.MemoryMXBean;
+import java.lang.management.MemoryUsage;
 import java.net.URL;
 import java.net.URLConnection;
 import java.nio.ByteBuffer;
 import static java.nio.charset.StandardCharsets.UTF_8;
 import java.nio.charset.CharsetDecoder;
 import java.nio.charset.CharacterCodingException;
+import java.security.MessageDigest;
+import java.security.NoSuchAlgorithmException;
 import java.sql.Connection;
 import java.sql.PreparedStatement;
 import java.sql.ResultSet;
@@ -34,8 +41,14 @@ import java.sql.SQLFeatureNotSupportedException;
 import java.sql.SQLNonTransientException;
 import java.sql.SQLSyntaxErrorException;
 import java.sql.Statement;
+import java.sql.Timestamp;
 import java.text.ParseException;
 import java.util.ArrayList;
+import java.util.Arrays;
+import java.util.HashMap;
+import java.util.List;
+import java.util.Map;
+import java.util.Objects;
 import java.util.jar.Attributes;
 import java.util.jar.JarEntry;
 import java.util.jar.JarInputStream;
@@ -45,6 +58,7 @@ import java.util.regex.Pattern;
 import java.util.zip.ZipEntry;
 import java.util.zip.ZipInputStream;
 
+import org.postgresql.pljava.ResultSetProvider;
 import org.postgresql.pljava.Session;
 import org.postgresql.pljava.SessionManager;
 
@@ -55,9 +69,13 @@ import static
 	org.postgresql.pljava.sqlgen.Lexicals.Identifier.Qualified.nameFromCatalog;
 
 import org.postgresql.pljava.internal.AclId;
+import org.postgresql.pljava.internal.Activity;
 import org.postgresql.pljava.internal.Backend;
 import org.postgresql.pljava.internal.Checked;
+import org.postgresql.pljava.internal.DualState;
+import org.postgresql.pljava.internal.InvocationBudget;
 import org.postgresql.pljava.internal.Oid;
+import org.postgresql.pljava.internal.Stats;
 import static org.postgresql.pljava.internal.Privilege.doPrivileged;
 import static org.postgresql.pljava.jdbc.SQLUtils.getDefaultConnection;
 import org.postgresql.pljava.sqlj.Loader;
@@ -169,6 +187,16 @@ import static org.postgresql.pljava.annotation.Function.Security.DEFINER;
  * descriptors}, false otherwise</td>
  * </tr>
  * </table></blockquote>
+ * <h4>Incremental replacement</h4>
+ * Entries whose content is unchanged from the jar being replaced (compared by
+ * SHA-256 digest) keep their existing rows in {@code sqlj.jar_entry}. If
+ * nothing in the jar changed at all, and it is replaced from the same origin
+ * by the same owner, its {@code sqlj.jar_repository} row is not updated and
+ * cached class loaders are left alone.
+ * Otherwise, only the class loaders (and resolved functions) of schemas whose
+ * class path includes the jar are discarded, and other sessions are notified
+ * through PostgreSQL's shared cache invalidation to do the same, lazily, the
+ * next time they look up a PL/Java function after the replacement commits.
  * <h3>remove_jar</h3>
  * The remove_jar procedure will drop the jar from the jar repository. Any
  * classpath that references this jar will be updated accordingly. It's an error
@@ -224,7 +252,8 @@ import static org.postgresql.pljava.annotation.Function.Security.DEFINER;
  * </table></blockquote>
  * <h3><a id='add_type_mapping'>add_type_mapping</a></h3>
  * The add_type_mapping procedure defines the mapping between an SQL type and a
- * Java class.
+ * Java class. The class implements {@code java.sql.SQLData}, or, for an SQL
+ * enum type, is a Java {@code enum} with a constant named as each label.
  * <h4>Usage</h4>
  * <blockquote><code>SELECT sqlj.add_type_mapping(&lt;sqlTypeName&gt;, &lt;className&gt;);</code>
  * </blockquote>
@@ -292,6 +321,128 @@ import static org.postgresql.pljava.annotation.Function.Security.DEFINER;
  * See {@link #aliasJavaLanguage the method documentation} for details.</td>
  * </tr>
  * </table></blockquote>
+ * <h3><a id='startup_report'>startup_report</a></h3>
+ * The {@link #startupReport startup_report function} returns the time taken
+ * by each stage of PL/Java's startup in the current session, the cumulative
+ * time spent resolving PL/Java functions on first use, and class-loading and
+ * JIT counters reported by the JVM.
+ * <h4>Usage</h4>
+ * <blockquote>
+ * {@code SELECT * FROM sqlj.startup_report();}
+ * </blockquote>
+ * <h3><a id='memory_report'>memory_report</a></h3>
+ * The {@link #memoryReport memory_report function} returns the sizes of the
+ * native memory contexts, caches, JNI references, and Java heap that PL/Java
+ * is using in the current session. Sampled over a long-running session, it can
+ * show a slow leak.
+ * <h4>Usage</h4>
+ * <blockquote>
+ * {@code SELECT * FROM sqlj.memory_report(gc => <boolean>);}
+ * </blockquote>
+ * <h4>Parameters</h4>
+ * <blockquote><table><caption>Parameters for sqlj.memory_report</caption>
+ * <tr>
+ * <td><b>gc</b></td>
+ * <td>Optional parameter, default false. Whether to ask the JVM to collect
+ * garbage first, so the heap figures reflect live objects.</td>
+ * </tr>
+ * </table></blockquote>
+ * <h3><a id='budget_report'>budget_report</a></h3>
+ * The {@link #budgetReport budget_report function} returns, for each function
+ * called in the current session while {@code pljava.cpu_budget} or
+ * {@code pljava.allocation_budget} was set, the CPU time and Java heap
+ * allocation its calls used, and how many exceeded a budget.
+ * <h4>Usage</h4>
+ * <blockquote>
+ * {@code SELECT * FROM sqlj.budget_report();}
+ * </blockquote>
+ * <h3><a id='pljava_stat'>pljava_stat_functions, pljava_stat_counters</a></h3>
+ * The views {@code sqlj.pljava_stat_functions} and
+ * {@code sqlj.pljava_stat_counters} show statistics kept in shared memory for
+ * the whole cluster, which outlive the sessions that contributed them: the
+ * calls of, and time in, each PL/Java function (counted when
+ * {@code track_functions} is {@code pl} or {@code all}), and the JVM starts,
+ * function resolutions, classes loaded, SPI statements, and garbage
+ * collection of all PL/Java sessions. Before PostgreSQL 17, PL/Java must be
+ * named in {@code shared_preload_libraries} for the statistics to be kept.
+ * The views are built on the functions {@link #statFunctions
+ * pljava_stat_get_functions} and {@link #statCounters
+ * pljava_stat_get_counters}, and the {@link #statReset pljava_stat_reset}
+ * function, executable by superusers unless granted to others, zeroes them.
+ * <h4>Usage</h4>
+ * <blockquote>
+ * {@code SELECT * FROM sqlj.pljava_stat_functions;}<br>
+ * {@code SELECT * FROM sqlj.pljava_stat_counters;}<br>
+ * {@code SELECT sqlj.pljava_stat_reset();}
+ * </blockquote>
+ * <h3><a id='pljava_stat_progress'>pljava_stat_progress</a></h3>
+ * The view {@code sqlj.pljava_stat_progress} shows, for each session running
+ * a PL/Java function that has reported its progress with
+ * {@link Session#reportProgress Session.reportProgress}, the function and the
+ * work it has done out of the total. Sessions appear only to roles that could
+ * see their activity in {@code pg_stat_activity}. It is built on the function
+ * {@link #statProgress pljava_stat_get_progress}, and shows nothing before
+ * PostgreSQL 14.
+ * <h4>Usage</h4>
+ * <blockquote>
+ * {@code SELECT * FROM sqlj.pljava_stat_progress;}
+ * </blockquote>
+ * <h3><a id='submit'>submit</a></h3>
+ * The {@link #submit submit function} queues a call of a function to be made
+ * by one of the PL/Java background workers in the current database, and
+ * returns a handle for the job. Workers are started as needed, up to the
+ * number set in {@code pljava.worker_count}, and stay running, so the cost of
+ * starting and warming up their JVMs is paid once and not in every session.
+ * The function is called as the role that submitted the job.
+ * <h4>Usage</h4>
+ * <blockquote>
+ * {@code SELECT sqlj.submit(<function>, <args>);}
+ * </blockquote>
+ * <h4>Parameters</h4>
+ * <blockquote><table><caption>Parameters for sqlj.submit</caption>
+ * <tr>
+ * <td><b>function</b></td>
+ * <td>The function to call, as a {@code regprocedure}, for example
+ * {@code 'myschema.render(integer,text)'}. It may not return a set.</td>
+ * </tr>
+ * <tr>
+ * <td><b>args</b></td>
+ * <td>Optional parameter, default empty. A text array with the arguments, in
+ * order, each in the text form of the corresponding parameter type.</td>
+ * </tr>
+ * </table></blockquote>
+ * <h3><a id='job_result'>job_result</a></h3>
+ * The {@link #jobResult job_result function} returns the result, as text, of
+ * a job returned by <a href='#submit'>submit</a>, and removes the job. If the
+ * job failed, the error is raised instead (and the job is not removed).
+ * <h4>Usage</h4>
+ * <blockquote>
+ * {@code SELECT sqlj.job_result(<handle>, wait => <boolean>);}
+ * </blockquote>
+ * <h4>Parameters</h4>
+ * <blockquote><table><caption>Parameters for sqlj.job_result</caption>
+ * <tr>
+ * <td><b>handle</b></td>
+ * <td>The handle returned by {@code submit}.</td>
+ * </tr>
+ * <tr>
+ * <td><b>wait</b></td>
+ * <td>Optional parameter, default true. Whether to wait for the job to finish;
+ * if false and the job has not finished, an exception is raised. Waiting is
+ * only useful at the {@code READ COMMITTED} isolation level, where each check
+ * sees the job's latest state, and for a job submitted in an earlier
+ * transaction; waiting for one submitted in the current transaction, which no
+ * worker can see until it commits, raises an exception.</td>
+ * </tr>
+ * </table></blockquote>
+ * <h3><a id='discard_job'>discard_job</a></h3>
+ * The {@link #discardJob discard_job function} removes a job that has not yet
+ * started, or has finished or failed, without obtaining its result. It
+ * returns false if the job is running.
+ * <h4>Usage</h4>
+ * <blockquote>
+ * {@code SELECT sqlj.discard_job(<handle>);}
+ * </blockquote>
  * 
  * @author Thomas Hallgren
  * @author Chapman Flack
@@ -306,12 +457,13 @@ import static org.postgresql.pljava.annotation.Function.Security.DEFINER;
  *
  * In this (1.5.0) incarnation of the schema, jar_repository and jar_entry are
  * both indexed by SERIAL columns. The replace_jar operation is an UPDATE to
- * jar_repository (so the jar's id is preserved), but deletes and reinserts to
- * jar_entry (so ALL classes get new ids). This makes the entryId sufficient as
- * a class-cache token to ensure old cached versions are recognized as invalid
- * (although at the cost of doing so for *every single class* in a jar even if
- * many are unchanged). It is used that way in the cache-token construction in
- * o.p.p.sqlj.Loader, which could need to be revisited if this behavior changes.
+ * jar_repository (so the jar's id is preserved), and deletes and reinserts to
+ * jar_entry every entry whose content has changed (so those classes get new
+ * ids), leaving the rows of unchanged entries alone. This makes the entryId
+ * sufficient as a class-cache token to ensure old cached versions are
+ * recognized as invalid, while unchanged classes keep their cached versions.
+ * It is used that way in the cache-token construction in o.p.p.sqlj.Loader,
+ * which could need to be revisited if this behavior changes.
  */
 @SQLAction(provides="sqlj.tables", install={
 "	CREATE TABLE sqlj.jar_repository(" +
@@ -379,6 +531,116 @@ import static org.postgresql.pljava.annotation.Function.Security.DEFINER;
 "		pg_catalog.set_config('pljava.implementors', 'alias_java_language,' " +
 "		|| pg_catalog.current_setting('pljava.implementors'), true)"
 })
+@SQLAction(provides="startup_report", install={
+"	SELECT " +
+"		pg_catalog.set_config('pljava.implementors', 'startup_report,' " +
+"		|| pg_catalog.current_setting('pljava.implementors'), true)"
+})
+@SQLAction(provides="memory_report", install={
+"	SELECT " +
+"		pg_catalog.set_config('pljava.implementors', 'memory_report,' " +
+"		|| pg_catalog.current_setting('pljava.implementors'), true)"
+})
+@SQLAction(provides="budget_report", install={
+"	SELECT " +
+"		pg_catalog.set_config('pljava.implementors', 'budget_report,' " +
+"		|| pg_catalog.current_setting('pljava.implementors'), true)"
+})
+@SQLAction(provides="pljava_stat", install={
+"	SELECT " +
+"		pg_catalog.set_config('pljava.implementors', 'pljava_stat,' " +
+"		|| pg_catalog.current_setting('pljava.implementors'), true)"
+})
+@SQLAction(
+	requires={
+		"pljava_stat_get_functions", "pljava_stat_get_counters",
+		"pljava_stat_reset"
+	},
+	implementor="pljava_stat", install={
+"	CREATE VIEW sqlj.pljava_stat_functions AS" +
+"	SELECT" +
+"		s.datid, d.datname, s.funcid," +
+"		CASE WHEN d.datname OPERATOR(pg_catalog.=)" +
+"			pg_catalog.current_database()" +
+"		THEN CAST(CAST(s.funcid AS pg_catalog.regprocedure)" +
+"			AS pg_catalog.text)" +
+"		END AS funcname," +
+"		s.calls, s.total_time" +
+"	FROM sqlj.pljava_stat_get_functions() AS s" +
+"	LEFT JOIN pg_catalog.pg_database AS d" +
+"		ON d.oid OPERATOR(pg_catalog.=) s.datid",
+"	COMMENT ON VIEW sqlj.pljava_stat_functions IS" +
+"	'Calls of, and milliseconds in, each PL/Java function, cumulative " +
+	"over the cluster since the last sqlj.pljava_stat_reset(); the name is " +
+	"shown for functions in the current database.'",
+"	GRANT SELECT ON sqlj.pljava_stat_functions TO public",
+
+"	CREATE VIEW sqlj.pljava_stat_counters AS" +
+"	SELECT * FROM sqlj.pljava_stat_get_counters()",
+"	COMMENT ON VIEW sqlj.pljava_stat_counters IS" +
+"	'PL/Java activity cumulative over the cluster since stats_reset.'",
+"	GRANT SELECT ON sqlj.pljava_stat_counters TO public",
+
+"	REVOKE EXECUTE ON FUNCTION sqlj.pljava_stat_reset() FROM public"
+}, remove={
+"	DROP VIEW sqlj.pljava_stat_counters",
+"	DROP VIEW sqlj.pljava_stat_functions"
+})
+@SQLAction(provides="pljava_progress", install={
+"	SELECT " +
+"		pg_catalog.set_config('pljava.implementors', 'pljava_progress,' " +
+"		|| pg_catalog.current_setting('pljava.implementors'), true)"
+})
+@SQLAction(
+	requires="pljava_stat_get_progress", implementor="pljava_progress",
+	install={
+"	CREATE VIEW sqlj.pljava_stat_progress AS" +
+"	SELECT" +
+"		p.pid, p.datid, d.datname, p.funcid," +
+"		CASE WHEN d.datname OPERATOR(pg_catalog.=)" +
+"			pg_catalog.current_database()" +
+"		THEN CAST(CAST(p.funcid AS pg_catalog.regprocedure)" +
+"			AS pg_catalog.text)" +
+"		END AS funcname," +
+"		p.done, p.total" +
+"	FROM sqlj.pljava_stat_get_progress() AS p" +
+"	LEFT JOIN pg_catalog.pg_database AS d" +
+"		ON d.oid OPERATOR(pg_catalog.=) p.datid",
+"	COMMENT ON VIEW sqlj.pljava_stat_progress IS" +
+"	'Progress reported by running PL/Java functions with " +
+	"Session.reportProgress.'",
+"	GRANT SELECT ON sqlj.pljava_stat_progress TO public"
+}, remove={
+"	DROP VIEW sqlj.pljava_stat_progress"
+})
+@SQLAction(provides="worker_pool", install={
+"	SELECT " +
+"		pg_catalog.set_config('pljava.implementors', 'worker_pool,' " +
+"		|| pg_catalog.current_setting('pljava.implementors'), true)"
+})
+@SQLAction(
+	requires="sqlj.tables", provides="sqlj.worker_job",
+	implementor="worker_pool", install={
+"	CREATE TABLE sqlj.worker_job(" +
+"		jobId       BIGSERIAL PRIMARY KEY," +
+"		jobOwner    pg_catalog.NAME NOT NULL," +
+"		jobFunction pg_catalog.REGPROCEDURE NOT NULL," +
+"		jobArgs     pg_catalog.TEXT[] NOT NULL," +
+"		jobState    pg_catalog.TEXT NOT NULL DEFAULT 'pending'," +
+"		jobWorker   pg_catalog.INT4," +
+"		jobResult   pg_catalog.TEXT," +
+"		jobSqlState pg_catalog.TEXT," +
+"		jobError    pg_catalog.TEXT," +
+"		submitted   pg_catalog.TIMESTAMPTZ NOT NULL" +
+"					DEFAULT pg_catalog.now()," +
+"		finished    pg_catalog.TIMESTAMPTZ" +
+"	)",
+"	COMMENT ON TABLE sqlj.worker_job IS" +
+"	'Jobs submitted to PL/Java background workers with sqlj.submit, a row " +
+	"for each job until its result is obtained or it is discarded.'"
+}, remove={
+"	DROP TABLE sqlj.worker_job"
+})
 public class Commands
 {
 	private final static Logger s_logger = Logger.getLogger(Commands.class
@@ -396,6 +658,19 @@ public class Commands
 	 */
 	static void addClassImages(int jarId, String urlString)
 	throws SQLException
+	{
+		addClassImages(jarId, urlString, null);
+	}
+
+	/**
+	 * Reads the jar found at the specified URL and stores the entries in the
+	 * jar_entry table, reusing rows from <em>prior</em> where possible.
+	 * @return true if any entry was added, changed, or removed
+	 * @see #addClassImages(int, InputStream, long, Map)
+	 */
+	static boolean addClassImages(
+		int jarId, String urlString, Map<String,PriorEntry> prior)
+	throws SQLException
 	{
 		try
 		{
@@ -416,7 +691,7 @@ public class Commands
 				}, null, uc.getPermission())
 			)
 			{
-				addClassImages(jarId, urlStream, sz[0]);
+				return addClassImages(jarId, urlStream, sz[0], prior);
 			}
 		}
 		catch(IOException e)
@@ -437,11 +712,35 @@ public class Commands
 	static void addClassImages(int jarId, InputStream urlStream, long sz)
 	throws SQLException
 	{
+		addClassImages(jarId, urlStream, sz, null);
+	}
+
+	/**
+	 * Add class images from an already opened stream, reusing the existing
+	 * rows for entries of a jar being replaced.
+	 * @param prior Map from entry name to the existing entry, as returned by
+	 * {@link #priorEntries priorEntries}, or null when there are none. An
+	 * existing row whose digest matches the new content is left untouched; one
+	 * whose content differs is deleted and inserted anew, so its entryId (which
+	 * the class loader uses as a class-cache token) changes. The map is
+	 * consumed, and any entries left in it (absent from the new jar) are
+	 * deleted.
+	 * @return true if any entry was added, changed, or removed
+	 */
+	static boolean addClassImages(
+		int jarId, InputStream urlStream, long sz,
+		Map<String,PriorEntry> prior)
+	throws SQLException
+	{
+		boolean changed = false;
 		try (
 			Connection conn = getDefaultConnection();
 			PreparedStatement stmt = conn.prepareStatement(
 				"INSERT INTO sqlj.jar_entry(entryName, jarId, entryImage) " +
 				"VALUES (?, ?, ?)");
+			PreparedStatement delStmt = conn.prepareStatement(
+				"DELETE FROM sqlj.jar_entry " +
+				"WHERE entryId OPERATOR(pg_catalog.=) ?");
 			PreparedStatement descIdFetchStmt = conn.prepareStatement(
 				"SELECT entryId FROM sqlj.jar_entry " +
 				"WHERE jarId OPERATOR(pg_catalog.=) ?" +
@@ -457,20 +756,23 @@ public class Commands
 			BufferedInputStream bis = new BufferedInputStream( urlStream);
 			String manifest = rawManifest( bis, sz);
 			JarInputStream jis = new JarInputStream(bis);
-			if(manifest != null)
+			/*
+			 * The row is updated only if the manifest differs, so replacing a
+			 * jar with an identical one leaves its xmin (part of the class path
+			 * stamp of schema loaders) alone.
+			 */
+			try ( PreparedStatement us = conn
+				.prepareStatement(
+					"UPDATE sqlj.jar_repository SET jarManifest = ? " +
+					"WHERE jarId OPERATOR(pg_catalog.=) ?" +
+					"  AND jarManifest IS DISTINCT FROM" +
+					"   CAST(? AS pg_catalog.text)");
+			)
 			{
-				try ( PreparedStatement us = conn
-					.prepareStatement(
-						"UPDATE sqlj.jar_repository SET jarManifest = ? " +
-						"WHERE jarId OPERATOR(pg_catalog.=) ?");
-				)
-				{
-					us.setString(1, manifest);
-					us.setInt(2, jarId);
-					if(us.executeUpdate() != 1)
-						throw new SQLException(
-							"Jar repository update did not update 1 row");
-				}
+				us.setString(1, manifest);
+				us.setInt(2, jarId);
+				us.setString(3, manifest);
+				us.executeUpdate();
 			}
 
 			for(;;)
@@ -490,12 +792,34 @@ public class Commands
 					img.write(buf, 0, nBytes);
 				jis.closeEntry();
 
+				byte[] image = img.toByteArray();
+				PriorEntry pe = null == prior ? null : prior.remove(entryName);
+				if ( null != pe )
+				{
+					if ( Arrays.equals(pe.digest, digest(image)) )
+						continue;
+					delStmt.setInt(1, pe.entryId);
+					delStmt.executeUpdate();
+				}
+
 				stmt.setString(1, entryName);
 				stmt.setInt(2, jarId);
-				stmt.setBytes(3, img.toByteArray());
+				stmt.setBytes(3, image);
 				if(stmt.executeUpdate() != 1)
 					throw new SQLException(
 						"Jar entry insert did not insert 1 row");
+				changed = true;
+			}
+
+			if ( null != prior )
+			{
+				for ( PriorEntry pe : prior.values() )
+				{
+					delStmt.setInt(1, pe.entryId);
+					delStmt.executeUpdate();
+					changed = true;
+				}
+				prior.clear();
 			}
 
 			Matcher ddr = ddrSection.matcher( null != manifest ? manifest : "");
@@ -531,6 +855,73 @@ public class Commands
 			throw new SQLException("I/O exception reading jar file: "
 				+ e.getMessage(), "58030", e);
 		}
+		return changed;
+	}
+
+	/**
+	 * An existing {@code sqlj.jar_entry} row of a jar being replaced.
+	 */
+	static final class PriorEntry
+	{
+		final int entryId;
+		final byte[] digest;
+
+		PriorEntry(int entryId, byte[] digest)
+		{
+			this.entryId = entryId;
+			this.digest = digest;
+		}
+	}
+
+	/**
+	 * Returns the existing entries of a jar, by name, with the digests of
+	 * their content.
+	 */
+	static Map<String,PriorEntry> priorEntries(int jarId) throws SQLException
+	{
+		Map<String,PriorEntry> prior = new HashMap<>();
+		try ( PreparedStatement stmt = getDefaultConnection().prepareStatement(
+			"SELECT entryId, entryName, entryImage FROM sqlj.jar_entry " +
+			"WHERE jarId OPERATOR(pg_catalog.=) ?");
+		)
+		{
+			stmt.setInt(1, jarId);
+			try ( ResultSet rs = stmt.executeQuery() )
+			{
+				while ( rs.next() )
+					prior.put(rs.getString(2),
+						new PriorEntry(rs.getInt(1), digest(rs.getBytes(3))));
+			}
+		}
+		return prior;
+	}
+
+	private static byte[] digest(byte[] image) throws SQLException
+	{
+		try
+		{
+			return MessageDigest.getInstance("SHA-256").digest(image);
+		}
+		catch ( NoSuchAlgorithmException e )
+		{
+			throw new SQLException(
+				"No SHA-256 digest available: " + e.getMessage(), "58000", e);
+		}
+	}
+
+	private static String jarManifest(int jarId) throws SQLException
+	{
+		try ( PreparedStatement stmt = getDefaultConnection().prepareStatement(
+			"SELECT jarManifest FROM sqlj.jar_repository " +
+			"WHERE jarId OPERATOR(pg_catalog.=) ?");
+		)
+		{
+			stmt.setInt(1, jarId);
+			try ( ResultSet rs = stmt.executeQuery() )
+			{
+				return rs.next() ? rs.getString(1) : null;
+			}
+		}
 	}
 
 	private final static Pattern ddrSection = Pattern.compile(
@@ -595,6 +986,11 @@ public class Commands
 
 	/**
 	 * Defines the mapping between an SQL type and a Java class.
+	 *<p>
+	 * The class must implement {@link SQLData}, unless the SQL type is an
+	 * enum type, which can be mapped to a Java {@code enum} having a constant
+	 * with the name of each label. Values are then converted by matching
+	 * labels and constants by name.
 	 * 
 	 * @param sqlTypeName The name of the SQL type. The name can be
 	 *            qualified with a schema (namespace). If the schema is omitted,
@@ -617,9 +1013,10 @@ public class Commands
 		{
 			ClassLoader loader = Loader.getCurrentLoader();
 			Class cls = loader.loadClass(javaClassName);
-			if(!SQLData.class.isAssignableFrom(cls))
+			if(!SQLData.class.isAssignableFrom(cls) && !cls.isEnum())
 				throw new SQLException("Class " + javaClassName
-					+ " does not implement java.sql.SQLData");
+					+ " does not implement java.sql.SQLData"
+					+ " and is not an enum");
 
 			sqlTypeName = getFullSqlNameOwned(sqlTypeName);
 			stmt.setString(1, javaClassName);
@@ -1130,6 +1527,631 @@ public class Commands
 		}
 	}
 
+	/**
+	 * Report the time taken by PL/Java's startup in this session, one row per
+	 * item.
+	 *<p>
+	 * The first rows give milliseconds spent in each stage of the native
+	 * initialization sequence (loading {@code libjvm}, creating the JVM,
+	 * loading PL/Java's own classes, setting up the policy, and so on),
+	 * followed by the cumulative time and count of PL/Java function
+	 * resolutions (the first call of each function in the session, which is
+	 * where user classes are loaded). The remaining rows are counters reported
+	 * by the JVM itself: classes loaded and unloaded, time spent in JIT
+	 * compilation, and uptime. The JVM's standard management interfaces do
+	 * not report time spent loading classes, only counts.
+	 */
+	@Function(
+		schema="sqlj", name="startup_report",
+		out={
+			"item pg_catalog.text", "value pg_catalog.float8",
+			"unit pg_catalog.text"
+		},
+		requires="sqlj.tables", implementor="startup_report"
+	)
+	public static ResultSetProvider startupReport()
+	{
+		List<Object[]> rows = new ArrayList<>();
+		String[] names = Backend.startupStageNames();
+		double[] timings = Backend.startupTimings();
+
+		for ( int i = 0 ; i < names.length ; ++ i )
+			rows.add(new Object[] { names[i], timings[i], "ms" });
+		rows.add(new Object[] {
+			"PL/Java functions resolved", timings[names.length], "count" });
+
+		ClassLoadingMXBean cl = ManagementFactory.getClassLoadingMXBean();
+		rows.add(new Object[] {
+			"classes loaded", (double)cl.getTotalLoadedClassCount(), "count" });
+		rows.add(new Object[] {
+			"classes unloaded", (double)cl.getUnloadedClassCount(), "count" });
+
+		CompilationMXBean jit = ManagementFactory.getCompilationMXBean();
+		if ( null != jit  &&  jit.isCompilationTimeMonitoringSupported() )
+			rows.add(new Object[] {
+				"JIT compilation", (double)jit.getTotalCompilationTime(), "ms"
+			});
+
+		rows.add(new Object[] {
+			"JVM uptime",
+			(double)ManagementFactory.getRuntimeMXBean().getUptime(), "ms" });
+
+		return report(rows);
+	}
+
+	/**
+	 * Report the memory PL/Java is using in this session, one row per item.
+	 *<p>
+	 * The first rows are native: bytes allocated in PostgreSQL's
+	 * {@code TopMemoryContext} and in PL/Java's own context (each including
+	 * child contexts; omitted before PostgreSQL 13, which cannot report them
+	 * cheaply), the JNI global references PL/Java holds, and the entries in
+	 * its function and type caches. Then come the {@code DualState} objects
+	 * not yet released, and the JVM's heap and non-heap usage and count of
+	 * loaded classes.
+	 *<p>
+	 * None of these should keep growing while a session repeats the same work;
+	 * the soak harness in PL/Java's test tools samples this report to check.
+	 * @param gc whether to request a garbage collection first, so that the
+	 * heap figures reflect live objects
+	 */
+	@Function(
+		schema="sqlj", name="memory_report",
+		out={
+			"item pg_catalog.text", "value pg_catalog.float8",
+			"unit pg_catalog.text"
+		},
+		requires="sqlj.tables", implementor="memory_report"
+	)
+	public static ResultSetProvider memoryReport(
+		@SQLType(defaultValue="false") boolean gc)
+	{
+		if ( gc )
+			System.gc();
+
+		List<Object[]> rows = new ArrayList<>();
+		double[] natives = Backend.memoryReport();
+
+		if ( 0 <= natives[0] )
+			rows.add(new Object[] { "TopMemoryContext", natives[0], "bytes" });
+		if ( 0 <= natives[1] )
+			rows.add(new Object[] {
+				"PL/Java memory context", natives[1], "bytes" });
+		rows.add(new Object[] { "JNI global references", natives[2], "count" });
+		rows.add(new Object[] { "cached functions", natives[3], "count" });
+		rows.add(new Object[] { "cached types", natives[4], "count" });
+		rows.add(new Object[] {
+			"live DualState objects", (double)DualState.liveCount(), "count" });
+
+		MemoryMXBean mem = ManagementFactory.getMemoryMXBean();
+		MemoryUsage heap = mem.getHeapMemoryUsage();
+		MemoryUsage nonHeap = mem.getNonHeapMemoryUsage();
+		rows.add(new Object[] { "JVM heap used", (double)heap.getUsed(),
+			"bytes" });
+		rows.add(new Object[] { "JVM heap committed",
+			(double)heap.getCommitted(), "bytes" });
+		rows.add(new Object[] { "JVM non-heap used",
+			(double)nonHeap.getUsed(), "bytes" });
+		rows.add(new Object[] { "classes loaded now", (double)
+			ManagementFactory.getClassLoadingMXBean().getLoadedClassCount(),
+			"count" });
+
+		return report(rows);
+	}
+
+	/**
+	 * Report, for each function with calls made in this session under
+	 * {@code pljava.cpu_budget} or {@code pljava.allocation_budget}, the
+	 * number of those calls, the total and greatest CPU time and Java heap
+	 * allocation of a call, and the number of calls that exceeded a budget.
+	 *<p>
+	 * Calls made while neither setting is in effect are not measured. The
+	 * figures are for the current session only.
+	 */
+	@Function(
+		schema="sqlj", name="budget_report",
+		out={
+			"fn pg_catalog.regprocedure", "calls pg_catalog.int8",
+			"cpu_ms pg_catalog.float8", "max_cpu_ms pg_catalog.float8",
+			"allocated_bytes pg_catalog.int8",
+			"max_allocated_bytes pg_catalog.int8", "exceeded pg_catalog.int8"
+		},
+		requires="sqlj.tables", implementor="budget_report"
+	)
+	public static ResultSetProvider budgetReport()
+	{
+		List<long[]> rows = InvocationBudget.report();
+
+		return new ResultSetProvider()
+		{
+			@Override
+			public boolean assignRowValues(ResultSet receiver, int currentRow)
+			throws SQLException
+			{
+				if ( currentRow >= rows.size() )
+					return false;
+				long[] row = rows.get(currentRow);
+				/*
+				 * regprocedure input accepts a bare oid, and output shows
+				 * the function's name and signature.
+				 */
+				receiver.updateString(1, Long.toString(row[0]));
+				receiver.updateLong(2, row[1]);
+				receiver.updateDouble(3, row[2] / 1e6);
+				receiver.updateDouble(4, row[3] / 1e6);
+				receiver.updateLong(5, row[4]);
+				receiver.updateLong(6, row[5]);
+				receiver.updateLong(7, row[6]);
+				return true;
+			}
+
+			@Override
+			public void close()
+			{
+			}
+		};
+	}
+
+	/**
+	 * Return, for each PL/Java function counted in the cluster-wide
+	 * statistics, the database and function oids, the number of calls, and
+	 * the total milliseconds spent in them.
+	 *<p>
+	 * Calls are counted when {@code track_functions} is {@code pl} or
+	 * {@code all}. The totals include the current session's counts so far,
+	 * and those of every session that has ended since the last reset.
+	 */
+	@Function(
+		schema="sqlj", name="pljava_stat_get_functions",
+		out={
+			"datid pg_catalog.oid", "funcid pg_catalog.oid",
+			"calls pg_catalog.int8", "total_time pg_catalog.float8"
+		},
+		requires="sqlj.tables", provides="pljava_stat_get_functions",
+		implementor="pljava_stat"
+	)
+	public static ResultSetProvider statFunctions() throws SQLException
+	{
+		long[] f = Stats.functions();
+
+		return new ResultSetProvider()
+		{
+			@Override
+			public boolean assignRowValues(ResultSet receiver, int currentRow)
+			throws SQLException
+			{
+				int i = 4 * currentRow;
+				if ( i >= f.length )
+					return false;
+				receiver.updateString(1, Long.toString(f[i]));
+				receiver.updateString(2, Long.toString(f[i + 1]));
+				receiver.updateLong(3, f[i + 2]);
+				receiver.updateDouble(4, f[i + 3] / 1e3);
+				return true;
+			}
+
+			@Override
+			public void close()
+			{
+			}
+		};
+	}
+
+	/**
+	 * Return one row of the cluster-wide PL/Java counters: JVM starts and the
+	 * milliseconds they took, functions resolved and the milliseconds that
+	 * took, classes loaded, SPI statements executed, garbage collections and
+	 * their milliseconds, calls not counted by function for lack of room, and
+	 * the time of the last reset.
+	 */
+	@Function(
+		schema="sqlj", name="pljava_stat_get_counters",
+		out={
+			"jvm_starts pg_catalog.int8", "jvm_start_time pg_catalog.float8",
+			"functions_resolved pg_catalog.int8",
+			"resolution_time pg_catalog.float8",
+			"classes_loaded pg_catalog.int8", "spi_statements pg_catalog.int8",
+			"gc_count pg_catalog.int8", "gc_time pg_catalog.float8",
+			"untracked_calls pg_catalog.int8",
+			"stats_reset pg_catalog.timestamptz"
+		},
+		requires="sqlj.tables", provides="pljava_stat_get_counters",
+		implementor="pljava_stat"
+	)
+	public static ResultSetProvider statCounters() throws SQLException
+	{
+		long[] c = Stats.counters();
+
+		return new ResultSetProvider()
+		{
+			@Override
+			public boolean assignRowValues(ResultSet receiver, int currentRow)
+			throws SQLException
+			{
+				if ( 0 < currentRow )
+					return false;
+				receiver.updateLong(1, c[Stats.JVM_STARTS]);
+				receiver.updateDouble(2, c[Stats.JVM_START_MICROS] / 1e3);
+				receiver.updateLong(3, c[Stats.FUNCTIONS_RESOLVED]);
+				receiver.updateDouble(4, c[Stats.RESOLUTION_MICROS] / 1e3);
+				receiver.updateLong(5, c[Stats.CLASSES_LOADED]);
+				receiver.updateLong(6, c[Stats.SPI_STATEMENTS]);
+				receiver.updateLong(7, c[Stats.GC_COUNT]);
+				receiver.updateDouble(8, c[Stats.GC_MICROS] / 1e3);
+				receiver.updateLong(9, c[Stats.UNTRACKED_CALLS]);
+				receiver.updateTimestamp(10,
+					new Timestamp(1000 * c[Stats.COUNTERS]));
+				return true;
+			}
+
+			@Override
+			public void close()
+			{
+			}
+		};
+	}
+
+	/**
+	 * Zero the cluster-wide PL/Java statistics, recording the time of the
+	 * reset.
+	 *<p>
+	 * {@code EXECUTE} on this function is revoked from {@code public} when it
+	 * is installed.
+	 */
+	@Function(
+		schema="sqlj", name="pljava_stat_reset",
+		requires="sqlj.tables", provides="pljava_stat_reset",
+		implementor="pljava_stat"
+	)
+	public static void statReset() throws SQLException
+	{
+		Stats.reset();
+	}
+
+	/**
+	 * Return, for each session now showing the progress of a PL/Java function
+	 * reported with {@link Session#reportProgress Session.reportProgress},
+	 * its process id, database oid, function oid, and the work done and total.
+	 *<p>
+	 * Only sessions whose activity the current role may see are included.
+	 */
+	@Function(
+		schema="sqlj", name="pljava_stat_get_progress",
+		out={
+			"pid pg_catalog.int4", "datid pg_catalog.oid",
+			"funcid pg_catalog.oid", "done pg_catalog.int8",
+			"total pg_catalog.int8"
+		},
+		requires="sqlj.tables", provides="pljava_stat_get_progress",
+		implementor="pljava_progress"
+	)
+	public static ResultSetProvider statProgress()
+	{
+		long[] p = Activity.progress();
+
+		return new ResultSetProvider()
+		{
+			@Override
+			public boolean assignRowValues(ResultSet receiver, int currentRow)
+			throws SQLException
+			{
+				int i = 5 * currentRow;
+				if ( i >= p.length )
+					return false;
+				receiver.updateInt(1, (int)p[i]);
+				receiver.updateString(2, Long.toString(p[i + 1]));
+				receiver.updateString(3, Long.toString(p[i + 2]));
+				receiver.updateLong(4, p[i + 3]);
+				receiver.updateLong(5, p[i + 4]);
+				return true;
+			}
+
+			@Override
+			public void close()
+			{
+			}
+		};
+	}
+
+	/**
+	 * A {@code ResultSetProvider} over rows of item, value, and unit, for the
+	 * report functions.
+	 */
+	private static ResultSetProvider report(List<Object[]> rows)
+	{
+		return new ResultSetProvider()
+		{
+			@Override
+			public boolean assignRowValues(ResultSet receiver, int currentRow)
+			throws SQLException
+			{
+				if ( currentRow >= rows.size() )
+					return false;
+				Object[] row = rows.get(currentRow);
+				receiver.updateString(1, (String)row[0]);
+				receiver.updateDouble(2, (Double)row[1]);
+				receiver.updateString(3, (String)row[2]);
+				return true;
+			}
+
+			@Override
+			public void close()
+			{
+			}
+		};
+	}
+
+	/**
+	 * The {@code bgw_type} of PL/Java's background workers, shown as their
+	 * {@code backend_type} in {@code pg_stat_activity} from PostgreSQL 11 on,
+	 * and before that as their {@code application_name}; must match
+	 * {@code PLJAVA_WORKER_NAME} in the native code.
+	 */
+	private static final String WORKER_NAME = "PL/Java worker";
+
+	/**
+	 * Count the PL/Java workers running in the current database.
+	 *<p>
+	 * Any client can set its {@code application_name}, so that counts only
+	 * where {@code backend_type} is not there to go by, and then only for
+	 * backends with no client port, as a client connection has.
+	 */
+	private static int runningWorkers(Connection conn) throws SQLException
+	{
+		boolean hasBgwType = Integer.parseInt(
+			Backend.getConfigOption("server_version_num")) >= 110000;
+
+		try ( PreparedStatement ps = conn.prepareStatement(
+			"SELECT pg_catalog.count(*) FROM pg_catalog.pg_stat_activity" +
+			" WHERE datname OPERATOR(pg_catalog.=)" +
+			"  pg_catalog.current_database()" +
+			( hasBgwType
+			? " AND backend_type OPERATOR(pg_catalog.=) ?"
+			: " AND client_port IS NULL" +
+			  " AND application_name OPERATOR(pg_catalog.=) ?" )) )
+		{
+			ps.setString(1, WORKER_NAME);
+			try ( ResultSet rs = ps.executeQuery() )
+			{
+				rs.next();
+				return rs.getInt(1);
+			}
+		}
+	}
+
+	/**
+	 * Submit a call of a function to be run by a PL/Java background worker,
+	 * returning a handle from which {@link #jobResult jobResult} can later
+	 * obtain the result.
+	 *<p>
+	 * If fewer than {@code pljava.worker_count} workers are running in the
+	 * current database, more are started. The job will be run as the role
+	 * calling this function, which must have {@code EXECUTE} permission on
+	 * {@code function}.
+	 * @param function The function to call, which must take exactly as many
+	 * arguments as are supplied, and may not return a set.
+	 * @param args The arguments, in the text forms of the function's parameter
+	 * types.
+	 * @return A handle identifying the job.
+	 */
+	@Function(schema="sqlj", name="submit", security=DEFINER,
+		requires="sqlj.worker_job", implementor="worker_pool")
+	public static long submit(
+		@SQLType("pg_catalog.regprocedure") String function,
+		@SQLType(defaultValue={}) String[] args)
+	throws SQLException
+	{
+		int workers = Backend.getWorkerCount();
+		if ( 0 == workers )
+			throw new SQLNonTransientException(
+				"PL/Java jobs cannot be submitted while " +
+				"pljava.worker_count is zero", "55000");
+
+		AclId user = AclId.getOuterUser();
+		Connection conn = getDefaultConnection();
+
+		try ( PreparedStatement ps = conn.prepareStatement(
+			"SELECT p.proretset, p.pronargs," +
+			"  pg_catalog.has_function_privilege(" +
+			"   CAST(? AS pg_catalog.name), p.oid, 'EXECUTE')" +
+			" FROM pg_catalog.pg_proc AS p" +
+			" WHERE p.oid OPERATOR(pg_catalog.=)" +
+			"  CAST(? AS pg_catalog.regprocedure)") )
+		{
+			ps.setString(1, user.getName());
+			ps.setString(2, function);
+			try ( ResultSet rs = ps.executeQuery() )
+			{
+				rs.next(); // the regprocedure cast fails if there is no such
+				if ( ! rs.getBoolean(3) )
+					throw new SQLSyntaxErrorException(
+						"permission denied for function " + function, "42501");
+				if ( rs.getBoolean(1) )
+					throw new SQLFeatureNotSupportedException(
+						"a set-returning function cannot be submitted as " +
+						"a PL/Java job", "0A000");
+				if ( rs.getInt(2) != args.length )
+					throw new SQLDataException(
+						"function " + function + " takes " + rs.getInt(2) +
+						" arguments, not " + args.length, "22023");
+			}
+		}
+
+		StringBuilder argList = new StringBuilder();
+		for ( int i = 0 ; i < args.length ; ++ i )
+			argList.append(0 == i ? "?" : ", ?");
+
+		long jobId;
+		try ( PreparedStatement ps = conn.prepareStatement(
+			"INSERT INTO sqlj.worker_job(jobOwner, jobFunction, jobArgs)" +
+			" VALUES (?, CAST(? AS pg_catalog.regprocedure)," +
+			"  CAST(ARRAY[" + argList + "] AS pg_catalog.text[]))" +
+			" RETURNING jobId") )
+		{
+			ps.setString(1, user.getName());
+			ps.setString(2, function);
+			for ( int i = 0 ; i < args.length ; ++ i )
+				ps.setString(3 + i, args[i]);
+			try ( ResultSet rs = ps.executeQuery() )
+			{
+				rs.next();
+				jobId = rs.getLong(1);
+			}
+		}
+
+		int running = runningWorkers(conn);
+
+		/*
+		 * Workers just started by a concurrent submit may not be counted yet,
+		 * so this can start too many; the surplus ones will simply exit.
+		 */
+		if ( running < workers )
+			Backend.launchWorkers(Backend.myLibraryPath(), workers - running);
+
+		return jobId;
+	}
+
+	/**
+	 * Return the result of a job submitted with {@link #submit submit},
+	 * removing the job, or raise its error if it failed.
+	 *<p>
+	 * Only the role that submitted the job, or a superuser, may obtain its
+	 * result. A failed job is not removed (the removal would be rolled back
+	 * with the error anyway); it can be removed with
+	 * {@link #discardJob discardJob}.
+	 * @param handle The handle returned by {@code submit}.
+	 * @param wait Whether to wait for the job to finish, polling its state
+	 * every tenth of a second. If false, an exception is raised if the job has
+	 * not finished. An exception is also raised, rather than waiting forever,
+	 * if the job was submitted in the current transaction.
+	 * @return The function's result, in text form, which may be null.
+	 */
+	@Function(schema="sqlj", name="job_result", security=DEFINER,
+		requires="sqlj.worker_job", implementor="worker_pool")
+	public static String jobResult(
+		long handle, @SQLType(defaultValue="true") boolean wait)
+	throws SQLException
+	{
+		AclId user = AclId.getOuterUser();
+		Connection conn = getDefaultConnection();
+
+		try (
+			PreparedStatement ps = conn.prepareStatement(
+				"SELECT jobOwner, jobState, jobResult, jobSqlState, jobError," +
+				"  CAST(CAST(xmin AS pg_catalog.text) AS pg_catalog.int8)" +
+				" FROM sqlj.worker_job WHERE jobId OPERATOR(pg_catalog.=) ?");
+			PreparedStatement nap = conn.prepareStatement(
+				"SELECT pg_catalog.pg_sleep(0.1)");
+		)
+		{
+			ps.setLong(1, handle);
+			for ( ;; )
+			{
+				String state;
+				String result;
+				String sqlState;
+				String error;
+				long xmin;
+				try ( ResultSet rs = ps.executeQuery() )
+				{
+					if ( ! rs.next() )
+						throw new SQLNonTransientException(
+							"no PL/Java job with handle " + handle, "42704");
+					assertJobOwner(user, rs.getString(1), handle);
+					state    = rs.getString(2);
+					result   = rs.getString(3);
+					sqlState = rs.getString(4);
+					error    = rs.getString(5);
+					xmin     = rs.getLong(6);
+				}
+
+				if ( "failed".equals(state) )
+					throw new SQLException(
+						"PL/Java job " + handle + " failed: " + error,
+						sqlState);
+
+				if ( "done".equals(state) )
+				{
+					discardJob(conn, handle);
+					return result;
+				}
+
+				if ( ! wait )
+					throw new SQLNonTransientException(
+						"PL/Java job " + handle + " has not finished", "55000");
+
+				/*
+				 * A job still pending in the transaction that submitted it
+				 * can't be seen by any worker until that transaction commits,
+				 * so waiting for it here would never end.
+				 */
+				if ( "pending".equals(state)
+					&& Backend.isCurrentTransaction(xmin) )
+					throw new SQLNonTransientException(
+						"PL/Java job " + handle + " cannot be waited for in " +
+						"the transaction that submitted it", "55000");
+
+				nap.execute();
+			}
+		}
+	}
+
+	/**
+	 * Remove a job submitted with {@link #submit submit} without obtaining its
+	 * result.
+	 *<p>
+	 * A job that has not yet started will not be run. A running job cannot be
+	 * discarded.
+	 * @param handle The handle returned by {@code submit}.
+	 * @return True if the job was removed, false if it is running.
+	 */
+	@Function(schema="sqlj", name="discard_job", security=DEFINER,
+		requires="sqlj.worker_job", implementor="worker_pool")
+	public static boolean discardJob(long handle) throws SQLException
+	{
+		AclId user = AclId.getOuterUser();
+		Connection conn = getDefaultConnection();
+
+		try ( PreparedStatement ps = conn.prepareStatement(
+			"SELECT jobOwner, jobState FROM sqlj.worker_job" +
+			" WHERE jobId OPERATOR(pg_catalog.=) ? FOR UPDATE") )
+		{
+			ps.setLong(1, handle);
+			try ( ResultSet rs = ps.executeQuery() )
+			{
+				if ( ! rs.next() )
+					throw new SQLNonTransientException(
+						"no PL/Java job with handle " + handle, "42704");
+				assertJobOwner(user, rs.getString(1), handle);
+				if ( "running".equals(rs.getString(2)) )
+					return false;
+			}
+		}
+
+		discardJob(conn, handle);
+		return true;
+	}
+
+	private static void assertJobOwner(AclId user, String owner, long handle)
+	throws SQLException
+	{
+		if ( ! ( user.isSuperuser() || user.getName().equals(owner) ) )
+			throw new SQLSyntaxErrorException(
+				"Only super user or submitter can use PL/Java job " + handle,
+				"42501");
+	}
+
+	private static void discardJob(Connection conn, long handle)
+	throws SQLException
+	{
+		try ( PreparedStatement ps = conn.prepareStatement(
+			"DELETE FROM sqlj.worker_job WHERE jobId OPERATOR(pg_catalog.=) ?") )
+		{
+			ps.setLong(1, handle);
+			ps.executeUpdate();
+		}
+	}
+
 	/**
 	 * Throws an exception if the given name cannot be used as the name of a
 	 * jar.
@@ -1399,38 +2421,58 @@ public class Commands
 		if(redeploy)
 			deployRemove(jarId, jarName);
 
+		String priorManifest = jarManifest(jarId);
+		Map<String,PriorEntry> prior = priorEntries(jarId);
+
+		/*
+		 * Like the manifest, the origin and owner are only updated if they
+		 * differ, so a replacement that changes nothing doesn't change the
+		 * row's xmin and with it the stamps of the schema loaders using it.
+		 */
 		try ( PreparedStatement stmt = getDefaultConnection()
 			.prepareStatement(
 				"UPDATE sqlj.jar_repository "
-				+ "SET jarOrigin = ?, jarOwner = ?, jarManifest = NULL "
-				+ "WHERE jarId OPERATOR(pg_catalog.=) ?");
+				+ "SET jarOrigin = ?, jarOwner = ? "
+				+ "WHERE jarId OPERATOR(pg_catalog.=) ?"
+				+ "  AND (jarOrigin OPERATOR(pg_catalog.<>)"
+				+ "    CAST(? AS pg_catalog.text)"
+				+ "   OR jarOwner OPERATOR(pg_catalog.<>)"
+				+ "    CAST(? AS pg_catalog.name))");
 		)
 		{
 			stmt.setString(1, urlString);
 			stmt.setString(2, user.getName());
 			stmt.setInt(3, jarId);
-			if(stmt.executeUpdate() != 1)
-				throw new SQLException(
-					"Jar repository update did not update 1 row");
+			stmt.setString(4, urlString);
+			stmt.setString(5, user.getName());
+			stmt.executeUpdate();
 		}
 
+		/*
+		 * The descriptor rows are rebuilt from the new manifest; the entry
+		 * rows are reused where their content has not changed.
+		 */
 		try ( PreparedStatement stmt = getDefaultConnection().prepareStatement(
-			"DELETE FROM sqlj.jar_entry WHERE jarId OPERATOR(pg_catalog.=) ?");
+			"DELETE FROM sqlj.jar_descriptor " +
+			"WHERE jarId OPERATOR(pg_catalog.=) ?");
 		)
 		{
 			stmt.setInt(1, jarId);
 			stmt.executeUpdate();
 		}
 
+		boolean changed;
 		if(image == null)
-			addClassImages(jarId, urlString);
+			changed = addClassImages(jarId, urlString, prior);
 		else
 		{
 			InputStream imageStream = new ByteArrayInputStream(image);
-			addClassImages(jarId, imageStream, image.length);
+			changed = addClassImages(jarId, imageStream, image.length, prior);
 		}
+		changed |= ! Objects.equals(priorManifest, jarManifest(jarId));
 
-		Loader.clearSchemaLoaders();
+		if ( changed )
+			Loader.refreshSchemaLoaders();
 
 		if(!redeploy)
 			return;
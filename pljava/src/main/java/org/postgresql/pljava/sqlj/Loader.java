@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2004-2021 Tada AB and other contributors, as listed below.
+ * Copyright (c) 2004-2026 Tada AB and other contributors, as listed below.
  *
  * All rights reserved. This program and the accompanying materials
  * are made available under the terms of the The BSD 3-Clause License
@@ -34,9 +34,12 @@ import java.sql.SQLData;
 import java.sql.SQLException;
 import java.sql.Statement;
 
+import java.util.ArrayList;
 import java.util.Collections;
 import java.util.Enumeration;
 import java.util.HashMap;
+import java.util.Iterator;
+import java.util.List;
 import java.util.Map;
 import java.util.NoSuchElementException;
 
@@ -47,6 +50,8 @@ import static java.util.stream.Collectors.groupingBy;
 
 import org.postgresql.pljava.sqlgen.Lexicals.Identifier;
 
+import org.postgresql.pljava.internal.Activity;
+import static org.postgresql.pljava.internal.Activity.WAIT_CLASS_LOAD;
 import org.postgresql.pljava.internal.Backend;
 import org.postgresql.pljava.internal.Checked;
 import org.postgresql.pljava.internal.Oid;
@@ -137,9 +142,16 @@ public class Loader extends ClassLoader
 		s_schemaLoaders = new HashMap<>();
 
 	private static final
-		Map<Identifier.Simple, Map<Oid, Class<? extends SQLData>>>
+		Map<Identifier.Simple, Map<Oid, Class<?>>>
 			s_typeMap = new HashMap<>();
 
+	/**
+	 * For each schema with a cached loader, the {@link #classPathStamp stamp}
+	 * of its class path when the loader was made.
+	 */
+	private static final Map<Identifier.Simple, String>
+		s_schemaStamps = new HashMap<>();
+
 	/**
 	 * Removes all cached schema loaders, functions, and type maps. This
 	 * method is called by the utility functions that manipulate the
@@ -150,9 +162,97 @@ public class Loader extends ClassLoader
 	{
 		s_schemaLoaders.clear();
 		s_typeMap.clear();
+		s_schemaStamps.clear();
 		Backend.clearFunctionCache();
 	}
 
+	/**
+	 * Removes the cached schema loaders (and their functions and type maps)
+	 * for only those schemas whose class path has changed since the loader was
+	 * made, and arranges for other backends to do the same when this
+	 * transaction commits.
+	 *<p>
+	 * Called by {@code replace_jar}; not intended to be called from user code.
+	 */
+	public static void refreshSchemaLoaders() throws SQLException
+	{
+		dropStaleSchemaLoaders();
+		Backend.invalidateLoaders();
+	}
+
+	/**
+	 * Removes the cached schema loaders, and their functions and type maps,
+	 * for any schema whose class path, or any jar on it, has changed since the
+	 * loader was made.
+	 *<p>
+	 * Called from native code when a shared invalidation for the jar
+	 * repository has been received. A schema with no class path of its own
+	 * shares the loader of {@code public}, and is dropped along with it.
+	 */
+	private static void dropStaleSchemaLoaders() throws SQLException
+	{
+		List<ClassLoader> stale = new ArrayList<>();
+
+		for ( Iterator<Map.Entry<Identifier.Simple,String>> it =
+				s_schemaStamps.entrySet().iterator(); it.hasNext(); )
+		{
+			Map.Entry<Identifier.Simple,String> e = it.next();
+			if ( e.getValue().equals(classPathStamp(e.getKey())) )
+				continue;
+			it.remove();
+			s_typeMap.remove(e.getKey());
+			ClassLoader loader = s_schemaLoaders.remove(e.getKey());
+			if ( null != loader )
+				stale.add(loader);
+		}
+
+		if ( stale.isEmpty() )
+			return;
+
+		s_schemaLoaders.entrySet().removeIf(e ->
+		{
+			if ( ! stale.contains(e.getValue()) )
+				return false;
+			s_typeMap.remove(e.getKey());
+			s_schemaStamps.remove(e.getKey());
+			return true;
+		});
+
+		Backend.clearFunctionCache(stale.toArray(new ClassLoader[0]));
+	}
+
+	/**
+	 * A string identifying the jars on a schema's class path, in order, and
+	 * the row version of each in {@code sqlj.jar_repository}, which changes
+	 * whenever a jar is replaced.
+	 */
+	private static String classPathStamp(Identifier.Simple schema)
+	throws SQLException
+	{
+		StringBuilder sb = new StringBuilder();
+		try (
+			PreparedStatement stmt = getDefaultConnection().prepareStatement(
+				"SELECT r.jarId, CAST(r.xmin AS pg_catalog.text)" +
+				" FROM" +
+				"  sqlj.jar_repository r" +
+				"  INNER JOIN sqlj.classpath_entry c" +
+				"  ON r.jarId OPERATOR(pg_catalog.=) c.jarId" +
+				" WHERE c.schemaName OPERATOR(pg_catalog.=) ?" +
+				" ORDER BY c.ordinal DESC");
+		)
+		{
+			stmt.unwrap(SPIReadOnlyControl.class).clearReadOnly();
+			stmt.setString(1, schema.pgFolded());
+			try ( ResultSet rs = stmt.executeQuery() )
+			{
+				while ( rs.next() )
+					sb.append(rs.getInt(1)).append(':')
+						.append(rs.getString(2)).append(';');
+			}
+		}
+		return sb.toString();
+	}
+
 	/**
 	 * Obtains the loader that is in effect for the current schema (i.e. the
 	 * schema that is first in the search path).
@@ -205,12 +305,17 @@ public class Loader extends ClassLoader
 		 */
 		Map<Integer,CodeSource> codeSources = new HashMap<>();
 
+		/*
+		 * The same stamp classPathStamp would compute, built along the way.
+		 */
+		StringBuilder stamp = new StringBuilder();
+
 		Connection conn = getDefaultConnection();
 		try (
 			// Read the entries so that the one with highest prio is read last.
 			//
 			PreparedStatement outer = conn.prepareStatement(
-				"SELECT r.jarId, r.jarName" +
+				"SELECT r.jarId, r.jarName, CAST(r.xmin AS pg_catalog.text)" +
 				" FROM" +
 				"  sqlj.jar_repository r" +
 				"  INNER JOIN sqlj.classpath_entry c" +
@@ -231,6 +336,8 @@ public class Loader extends ClassLoader
 				{
 					URL jarUrl = new URL("sqlj:" + rs.getString(2));
 					CodeSource cs = new CodeSource(jarUrl, (CodeSigner[])null);
+					stamp.append(rs.getInt(1)).append(':')
+						.append(rs.getString(3)).append(';');
 
 					inner.setInt(1, rs.getInt(1));
 					try ( ResultSet rs2 = inner.executeQuery() )
@@ -278,6 +385,7 @@ public class Loader extends ClassLoader
 		}
 
 		s_schemaLoaders.put(schema, loader);
+		s_schemaStamps.put(schema, stamp.toString());
 		return loader;
 	}
 
@@ -290,19 +398,19 @@ public class Loader extends ClassLoader
 	 * @param schema The schema
 	 * @return The Map, possibly empty but never <code>null</code>.
 	 */
-	public static Map<Oid,Class<? extends SQLData>> getTypeMap(
+	public static Map<Oid,Class<?>> getTypeMap(
 		final Identifier.Simple schema)
 		throws SQLException
 	{
-		Map<Oid,Class<? extends SQLData>> typesForSchema =
+		Map<Oid,Class<?>> typesForSchema =
 			s_typeMap.get(schema);
 		if(typesForSchema != null)
 			return typesForSchema;
 
 		s_logger.finer("Creating typeMappings for schema " + schema);
-		typesForSchema = new HashMap<Oid,Class<? extends SQLData>>()
+		typesForSchema = new HashMap<Oid,Class<?>>()
 		{
-			public Class<? extends SQLData> get(Oid key)
+			public Class<?> get(Oid key)
 			{
 				s_logger.finer("Obtaining type mapping for OID " + key +
 					" for schema " + schema);
@@ -328,12 +436,13 @@ public class Loader extends ClassLoader
 					String javaClassName = rs.getString(1);
 					String sqlName = rs.getString(2);
 					Class<?> cls = loader.loadClass(javaClassName);
-					if(!SQLData.class.isAssignableFrom(cls))
+					if(!SQLData.class.isAssignableFrom(cls) && !cls.isEnum())
 						throw new SQLException("Class " + javaClassName +
-							" does not implement java.sql.SQLData");
+							" does not implement java.sql.SQLData" +
+							" and is not an enum");
 					
 					Oid typeOid = Oid.forTypeName(sqlName);
-					typesForSchema.put(typeOid, cls.asSubclass(SQLData.class));
+					typesForSchema.put(typeOid, cls);
 					s_logger.finer("Adding type mapping for OID " + typeOid +
 						" -> class " + cls.getName() + " for schema " + schema);
 				}
@@ -443,6 +552,9 @@ public class Loader extends ClassLoader
 			String ifJ9token = (String) o; // used below when storing class
 
 			try (
+				// Shown as a wait event in pg_stat_activity meanwhile.
+				Activity.Wait wait = Activity.waitFor(WAIT_CLASS_LOAD);
+
 				// This code relies heavily on the fact that the connection
 				// is a singleton and that the prepared statement will live
 				// for the duration of the loader. (This comment has said so